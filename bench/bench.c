@@ -0,0 +1,1320 @@
+/**
+ * The Mojibake library
+ *
+ * This file is distributed under the MIT License. See LICENSE for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// clang-format off
+#ifdef _WIN32
+    #include "../src/shell/getopt/getopt.h"
+    #include <windows.h>
+#else
+    #include <getopt.h>
+#endif
+// clang-format on
+
+#include "../src/mojibake-internal.h"
+#include "../src/mojibake.h"
+#include "../src/unicode-tables.h"
+
+// Every corpus is built by repeating its lines until it reaches this size.
+#define BENCH_CORPUS_BYTES (256 * 1024)
+
+// Domain labels and user names are capped like real identifiers.
+#define BENCH_TOKEN_MAX_BYTES 63
+
+#define BENCH_MAX_UNITS 65536
+
+// Keeps the results of the benchmarked calls from being discarded.
+static volatile size_t bench_sink;
+
+typedef struct bench_corpus_source {
+    const char *name;
+    const char *const *lines;
+    size_t line_count;
+} bench_corpus_source;
+
+// A unit is a line or a token of a corpus, passed to the benchmarked function one at a time.
+typedef struct bench_unit {
+    const char *buffer;
+    size_t byte_length;
+} bench_unit;
+
+typedef struct bench_corpus {
+    const char *name;
+    char *buffer;
+    size_t byte_length;
+    bench_unit *lines;
+    size_t line_count;
+    size_t line_codepoints;
+    bench_unit *tokens;
+    size_t token_count;
+    size_t token_bytes;
+    size_t token_codepoints;
+    bench_unit whole;
+    size_t codepoints;
+} bench_corpus;
+
+typedef bool (*bench_fn)(const char *buffer, size_t byte_length);
+
+// The units a benchmark is run over.
+typedef enum bench_units {
+    BENCH_LINES,
+    BENCH_TOKENS, // Whitespace-separated tokens
+    BENCH_CORPUS  // The whole corpus as one string
+} bench_units;
+
+typedef struct bench_case {
+    const char *name;
+    bench_fn function;
+    bench_units units;
+    const char *corpus; // Run over this corpus only, or over all of them when NULL
+} bench_case;
+
+typedef struct bench_options {
+    const char *filter;
+    const char *corpus_filter;
+    double min_seconds;
+    FILE *output;
+} bench_options;
+
+static const char *const bench_ascii_lines[] = {
+    "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs.",
+    "GET /api/v2/users?id=42&sort=name HTTP/1.1 Host: example.com User-Agent: curl/8.5.0",
+    "In 2024, the server handled 1,250,000 requests per second with a p99 latency of 3.2 ms.",
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt.",
+    "{\"name\": \"mojibake\", \"version\": \"0.3.6\", \"tags\": [\"unicode\", \"utf-8\", \"c\"]}",
+    "She said: \"Don't worry -- it's fine.\" Then she left (at 10:45 p.m.) without a word.",
+};
+
+static const char *const bench_latin_lines[] = {
+    "Ça va très bien, merci. L'été dernier, nous sommes allés à Besançon voir l'œuvre de Zoé.",
+    "Größere Straßen führen über die Brücke nach Köln; die Bürger begrüßen die Änderung.",
+    "El niño comió piña en la mañana; ¿qué pasó después? ¡Nadie lo sabe, señor Muñoz!",
+    "Tiếng Việt có nhiều dấu: người, được, những, trường, nghiêng, khuyến khích học tập.",
+    "Příliš žluťoučký kůň úpěl ďábelské ódy. Łódź, Kraków i Gdańsk leżą w Polsce.",
+    "Ångström och Ærø: Søren købte æbler på torvet. Þórður fór með ferjunni til Eyja.",
+};
+
+static const char *const bench_cjk_lines[] = {
+    "统一码为每一个字符提供了唯一的数字，不论是什么平台、什么程序、什么语言。",
+    "日本語の文章は漢字、ひらがな、カタカナを組み合わせて書かれます。東京は晴れです。",
+    "한국어는 한글로 표기하며, 음절 단위로 모아 씁니다. 서울의 날씨는 맑습니다.",
+    "漢字文化圏では、同じ字形でも地域によって異なる読み方をすることがあります。",
+    "我们在２０２４年举办了第十届国际会议，共有３５０名代表参加。（详见附件）",
+    "カタカナ語：コンピューター、インターネット、ソフトウェア、データベース。",
+};
+
+static const char *const bench_rtl_lines[] = {
+    "مرحبا بالعالم! هذه جملة عربية تحتوي على أرقام ١٢٣ وكلمات English مختلطة.",
+    "שלום עולם! זהו משפט בעברית עם מספרים 123 ומילים באנגלית mixed בתוכו.",
+    "اللغة العربية تُكتب من اليمين إلى اليسار، وتستخدم الحركات مثل الفتحة والضمة.",
+    "הטקסט העברי נכתב מימין לשמאל (RTL), אבל המספר 2024 נכתב משמאל לימין.",
+    "يقع المكتب في الطابق 3، الغرفة رقم 42 — اتصل على +971-4-555-0100 للاستفسار.",
+    "ספר תורה נכתב בְּקֻלְמוֹס עַל קְלָף, עִם נִקּוּד וְטְעָמִים.",
+};
+
+static const char *const bench_emoji_lines[] = {
+    "Great job team! 🎉🎉 Shipping on Friday 🚀 — coffee's on me ☕️ 👍🏽 #launch",
+    "👨‍👩‍👧‍👦 family trip to 🇯🇵🇮🇹🇺🇸 was amazing 😍😍😍 can't wait for the next one ✈️",
+    "Status: ✅ build ❌ lint ⚠️ tests 🔥🔥🔥 on-call 👩🏻‍💻👨🏿‍💻 please check 🙏",
+    "Weather ☀️🌤⛅️🌧⛈🌩 — stay safe! 🏳️‍🌈 🏴‍☠️ 1️⃣2️⃣3️⃣ #️⃣ done 💯",
+    "Reactions: 😂 😭 🥺 🤔 🙃 😎 🤖 👻 💀 🐱‍👤 🧑‍🚀 🧙🏾‍♀️ 🫶🏼 🫠",
+    "Order 🍕🍔🍟🌮🍣🍜 for 🧑‍🤝‍🧑 at 🕖, pay with 💳 or 💵 — thanks! ❤️🧡💛💚💙💜",
+};
+
+#define BENCH_SOURCE(NAME, LINES) { NAME, LINES, sizeof(LINES) / sizeof(LINES[0]) }
+
+static const bench_corpus_source bench_sources[] = {
+    BENCH_SOURCE("ascii", bench_ascii_lines),
+    BENCH_SOURCE("latin", bench_latin_lines),
+    BENCH_SOURCE("cjk", bench_cjk_lines),
+    BENCH_SOURCE("rtl", bench_rtl_lines),
+    BENCH_SOURCE("emoji", bench_emoji_lines),
+};
+
+#define BENCH_CORPUS_COUNT (sizeof(bench_sources) / sizeof(bench_sources[0]))
+
+static bool bench_result_consume(mjb_status status, mjb_result *result) {
+    if(status != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += result->output_size;
+
+    return mjb_result_free(result) == MJB_STATUS_OK;
+}
+
+static bool bench_normalize(const char *buffer, size_t byte_length, mjb_normalization form) {
+    mjb_result result;
+
+    return bench_result_consume(mjb_normalize(buffer, byte_length, MJB_ENC_UTF_8, form,
+                                    MJB_ENC_UTF_8, &result),
+        &result);
+}
+
+static bool bench_normalize_nfc(const char *buffer, size_t byte_length) {
+    return bench_normalize(buffer, byte_length, MJB_NORMALIZATION_NFC);
+}
+
+static bool bench_normalize_nfd(const char *buffer, size_t byte_length) {
+    return bench_normalize(buffer, byte_length, MJB_NORMALIZATION_NFD);
+}
+
+static bool bench_normalize_nfkc(const char *buffer, size_t byte_length) {
+    return bench_normalize(buffer, byte_length, MJB_NORMALIZATION_NFKC);
+}
+
+static bool bench_normalize_nfkd(const char *buffer, size_t byte_length) {
+    return bench_normalize(buffer, byte_length, MJB_NORMALIZATION_NFKD);
+}
+
+static mjb_normalizer bench_normalizer;
+static bool bench_normalizer_ready;
+static char bench_normalizer_output[16384];
+
+// Normalize the corpus as a stream of 4 KiB chunks.
+static bool bench_normalizer_nfc(const char *buffer, size_t byte_length) {
+    if(!bench_normalizer_ready) {
+        if(mjb_normalizer_init(&bench_normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+               MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+            return false;
+        }
+
+        bench_normalizer_ready = true;
+    }
+
+    size_t output_size;
+
+    for(size_t i = 0; i < byte_length; i += 4096) {
+        size_t chunk = byte_length - i < 4096 ? byte_length - i : 4096;
+        output_size = sizeof(bench_normalizer_output);
+
+        if(mjb_normalizer_feed(&bench_normalizer, buffer + i, chunk, bench_normalizer_output,
+               &output_size) != MJB_STATUS_OK) {
+            return false;
+        }
+
+        bench_sink += output_size;
+    }
+
+    output_size = sizeof(bench_normalizer_output);
+
+    if(mjb_normalizer_finish(&bench_normalizer, bench_normalizer_output, &output_size) !=
+        MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += output_size;
+
+    return true;
+}
+
+// The pairs NFC tries to compose in a corpus: every NFD codepoint with the one before it.
+typedef struct bench_compose_probes {
+    const char *buffer;
+    mjb_codepoint *starters;
+    mjb_codepoint *combinings;
+    size_t count;
+} bench_compose_probes;
+
+static bench_compose_probes bench_probes;
+
+// The composition pairs sorted by starter and combining codepoint, packed like the generated
+// table, for the binary search the composition table replaced.
+static uint64_t *bench_compose_pairs;
+static size_t bench_compose_pair_count;
+
+static int bench_compare_pairs(const void *a, const void *b) {
+    uint64_t left = *(const uint64_t *)a & 0x3FFFFFFFFFFULL;
+    uint64_t right = *(const uint64_t *)b & 0x3FFFFFFFFFFULL;
+    uint64_t left_key = (left & 0x1FFFFF) << 21 | left >> 21;
+    uint64_t right_key = (right & 0x1FFFFF) << 21 | right >> 21;
+
+    return left_key < right_key ? -1 : left_key > right_key;
+}
+
+// Collect the pairs by composing every canonical decomposition back, as mjb_recompose does.
+static bool bench_compose_pairs_build(void) {
+    if(bench_compose_pairs != NULL) {
+        return true;
+    }
+
+    bench_compose_pairs = (uint64_t *)malloc(4096 * sizeof(uint64_t));
+
+    if(bench_compose_pairs == NULL) {
+        return false;
+    }
+
+    for(mjb_codepoint codepoint = 0; codepoint <= MJB_CODEPOINT_MAX; ++codepoint) {
+        const mjb_codepoint *values = NULL;
+        uint8_t length = 0;
+
+        if(!mjb_unicode_decomposition_lookup(codepoint, false, &values, &length) || length < 2) {
+            continue;
+        }
+
+        mjb_codepoint starter = values[0];
+
+        for(uint8_t i = 1; i < length - 1 && starter != MJB_CODEPOINT_NOT_VALID; ++i) {
+            starter = mjb_unicode_compose_pair(starter, values[i]);
+        }
+
+        mjb_codepoint combining = values[length - 1];
+
+        if(starter == MJB_CODEPOINT_NOT_VALID ||
+            mjb_unicode_compose_pair(starter, combining) != codepoint ||
+            bench_compose_pair_count == 4096) {
+            continue;
+        }
+
+        bench_compose_pairs[bench_compose_pair_count++] = (uint64_t)starter |
+            (uint64_t)combining << 21 | (uint64_t)codepoint << 42;
+    }
+
+    qsort(bench_compose_pairs, bench_compose_pair_count, sizeof(uint64_t), bench_compare_pairs);
+
+    return true;
+}
+
+static mjb_codepoint bench_compose_pair_bsearch(mjb_codepoint starter, mjb_codepoint combining) {
+    size_t low = 0;
+    size_t high = bench_compose_pair_count;
+
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+        uint64_t entry = bench_compose_pairs[mid];
+        mjb_codepoint entry_starter = (mjb_codepoint)(entry & 0x1FFFFF);
+        mjb_codepoint entry_combining = (mjb_codepoint)((entry >> 21) & 0x1FFFFF);
+
+        if(starter < entry_starter || (starter == entry_starter && combining < entry_combining)) {
+            high = mid;
+        } else if(starter > entry_starter ||
+            (starter == entry_starter && combining > entry_combining)) {
+            low = mid + 1;
+        } else {
+            return (mjb_codepoint)((entry >> 42) & 0x1FFFFF);
+        }
+    }
+
+    return MJB_CODEPOINT_NOT_VALID;
+}
+
+static void bench_compose_probes_free(void) {
+    free(bench_probes.starters);
+    free(bench_probes.combinings);
+    memset(&bench_probes, 0, sizeof(bench_probes));
+}
+
+// Decompose a corpus once and keep its pairs, so that only the lookups are timed.
+static bool bench_compose_probes_build(const char *buffer, size_t byte_length) {
+    if(bench_probes.buffer == buffer) {
+        return true;
+    }
+
+    bench_compose_probes_free();
+    mjb_result result;
+
+    if(mjb_normalize(buffer, byte_length, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD, MJB_ENC_UTF_32BE,
+           &result) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    size_t count = result.output_size / 4;
+    const unsigned char *output = (const unsigned char *)result.output;
+    bench_probes.starters = (mjb_codepoint *)malloc(count * sizeof(mjb_codepoint));
+    bench_probes.combinings = (mjb_codepoint *)malloc(count * sizeof(mjb_codepoint));
+
+    if(bench_probes.starters == NULL || bench_probes.combinings == NULL) {
+        mjb_result_free(&result);
+
+        return false;
+    }
+
+    mjb_codepoint previous = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        mjb_codepoint codepoint = (mjb_codepoint)output[i * 4] << 24 |
+            (mjb_codepoint)output[i * 4 + 1] << 16 | (mjb_codepoint)output[i * 4 + 2] << 8 |
+            (mjb_codepoint)output[i * 4 + 3];
+        bench_probes.starters[i] = previous;
+        bench_probes.combinings[i] = codepoint;
+        previous = codepoint;
+    }
+
+    bench_probes.buffer = buffer;
+    bench_probes.count = count;
+    mjb_result_free(&result);
+
+    return true;
+}
+
+static bool bench_compose_pair_table(const char *buffer, size_t byte_length) {
+    if(!bench_compose_probes_build(buffer, byte_length)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < bench_probes.count; ++i) {
+        bench_sink += mjb_unicode_compose_pair(bench_probes.starters[i], bench_probes.combinings[i]);
+    }
+
+    return true;
+}
+
+static bool bench_compose_pair_binary_search(const char *buffer, size_t byte_length) {
+    if(!bench_compose_pairs_build() || !bench_compose_probes_build(buffer, byte_length)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < bench_probes.count; ++i) {
+        bench_sink += bench_compose_pair_bsearch(bench_probes.starters[i],
+            bench_probes.combinings[i]);
+    }
+
+    return true;
+}
+
+// The corpus decoded once to codepoints, and room for one property value per codepoint.
+typedef struct bench_property_probes {
+    const char *buffer;
+    mjb_codepoint *codepoints;
+    int32_t *values;
+    size_t count;
+} bench_property_probes;
+
+static bench_property_probes bench_properties;
+
+static void bench_property_probes_free(void) {
+    free(bench_properties.codepoints);
+    free(bench_properties.values);
+    memset(&bench_properties, 0, sizeof(bench_properties));
+}
+
+static bool bench_property_probes_build(const char *buffer, size_t byte_length) {
+    if(bench_properties.buffer == buffer) {
+        return true;
+    }
+
+    bench_property_probes_free();
+    mjb_result result;
+
+    if(mjb_convert_encoding(buffer, byte_length, MJB_ENC_UTF_8, MJB_ENC_UTF_32BE, &result) !=
+        MJB_STATUS_OK) {
+        return false;
+    }
+
+    size_t count = result.output_size / 4;
+    const unsigned char *output = (const unsigned char *)result.output;
+    bench_properties.codepoints = (mjb_codepoint *)malloc((count + 1) * sizeof(mjb_codepoint));
+    bench_properties.values = (int32_t *)malloc((count + 1) * sizeof(int32_t));
+
+    if(bench_properties.codepoints == NULL || bench_properties.values == NULL) {
+        mjb_result_free(&result);
+
+        return false;
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        bench_properties.codepoints[i] = (mjb_codepoint)output[i * 4] << 24 |
+            (mjb_codepoint)output[i * 4 + 1] << 16 | (mjb_codepoint)output[i * 4 + 2] << 8 |
+            (mjb_codepoint)output[i * 4 + 3];
+    }
+
+    bench_properties.buffer = buffer;
+    bench_properties.count = count;
+    mjb_result_free(&result);
+
+    return true;
+}
+
+static bool bench_codepoint_property_script(const char *buffer, size_t byte_length) {
+    if(!bench_property_probes_build(buffer, byte_length)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < bench_properties.count; ++i) {
+        int32_t value = 0;
+
+        if(mjb_codepoint_property_int(bench_properties.codepoints[i], MJB_PR_SCRIPT, &value) ==
+            MJB_STATUS_OK) {
+            bench_sink += (size_t)value;
+        }
+    }
+
+    return true;
+}
+
+static bool bench_codepoints_property_script(const char *buffer, size_t byte_length) {
+    if(!bench_property_probes_build(buffer, byte_length) ||
+        mjb_codepoints_property_int(bench_properties.codepoints, bench_properties.count,
+            MJB_PR_SCRIPT, bench_properties.values) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += (size_t)bench_properties.values[bench_properties.count / 2];
+
+    return true;
+}
+
+static bool bench_string_property_script(const char *buffer, size_t byte_length) {
+    if(!bench_property_probes_build(buffer, byte_length)) {
+        return false;
+    }
+
+    size_t count = bench_properties.count + 1;
+
+    if(mjb_string_property_int(buffer, byte_length, MJB_ENC_UTF_8, MJB_PR_SCRIPT,
+            bench_properties.values, &count) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += count;
+
+    return true;
+}
+
+static bool bench_filter(const char *buffer, size_t byte_length) {
+    mjb_result result;
+
+    return bench_result_consume(mjb_filter(buffer, byte_length, MJB_ENC_UTF_8,
+                                    (mjb_filter_flags)(MJB_FILTER_SPACES |
+                                        MJB_FILTER_COLLAPSE_SPACES | MJB_FILTER_CONTROLS |
+                                        MJB_FILTER_NUMERIC | MJB_FILTER_LIMIT_COMBINING),
+                                    MJB_ENC_UTF_8, &result),
+        &result);
+}
+
+static bool bench_map_case(const char *buffer, size_t byte_length, mjb_map_case_type type) {
+    mjb_result result;
+
+    return bench_result_consume(mjb_map_case(buffer, byte_length, MJB_ENC_UTF_8, type,
+                                    MJB_ENC_UTF_8, &result),
+        &result);
+}
+
+static bool bench_map_case_upper(const char *buffer, size_t byte_length) {
+    return bench_map_case(buffer, byte_length, MJB_CASE_UPPER);
+}
+
+static bool bench_map_case_lower(const char *buffer, size_t byte_length) {
+    return bench_map_case(buffer, byte_length, MJB_CASE_LOWER);
+}
+
+static bool bench_map_case_casefold(const char *buffer, size_t byte_length) {
+    return bench_map_case(buffer, byte_length, MJB_CASE_CASEFOLD);
+}
+
+#if MJB_FEATURE_COLLATION
+static bool bench_collation_key(const char *buffer, size_t byte_length) {
+    mjb_result result;
+
+    return bench_result_consume(mjb_collation_key(buffer, byte_length, MJB_ENC_UTF_8,
+                                    MJB_COLLATION_SHIFTED, MJB_COLLATION_TERTIARY, &result),
+        &result);
+}
+
+// Equal strings are the slowest case for a comparison: every level is walked to the end.
+static bool bench_collation_compare(const char *buffer, size_t byte_length) {
+    int order = 0;
+
+    if(mjb_collation_compare(buffer, byte_length, MJB_ENC_UTF_8, buffer, byte_length,
+           MJB_ENC_UTF_8, MJB_COLLATION_SHIFTED, MJB_COLLATION_TERTIARY, &order) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += (size_t)(order + 1);
+
+    return true;
+}
+
+// One collator for every row, the way a sort keys its input.
+static mjb_collator bench_collator;
+static bool bench_collator_ready;
+static unsigned char bench_collation_output[16384];
+
+static bool bench_collator_key_into(const char *buffer, size_t byte_length) {
+    if(!bench_collator_ready) {
+        if(mjb_collator_init(&bench_collator, MJB_COLLATION_SHIFTED, MJB_COLLATION_TERTIARY) !=
+            MJB_STATUS_OK) {
+            return false;
+        }
+
+        bench_collator_ready = true;
+    }
+
+    size_t output_size = sizeof(bench_collation_output);
+
+    if(mjb_collator_key_into(&bench_collator, buffer, byte_length, MJB_ENC_UTF_8,
+           bench_collation_output, &output_size) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += output_size;
+
+    return true;
+}
+
+#define BENCH_KEY_BATCH 1024
+
+static const char *bench_key_rows[BENCH_KEY_BATCH];
+static size_t bench_key_lengths[BENCH_KEY_BATCH];
+static size_t bench_key_offsets[BENCH_KEY_BATCH + 1];
+static unsigned char *bench_key_arena;
+static size_t bench_key_arena_size;
+
+static bool bench_collator_keys_flush(size_t count) {
+    size_t arena_size = bench_key_arena_size;
+    mjb_status status = mjb_collator_keys_into(&bench_collator, bench_key_rows,
+        bench_key_lengths, count, MJB_ENC_UTF_8, bench_key_arena, &arena_size, bench_key_offsets);
+
+    // The arena only grows, so it stops being reallocated after the largest batch.
+    if(status == MJB_STATUS_OUTPUT_TOO_SMALL) {
+        unsigned char *arena = (unsigned char *)realloc(bench_key_arena, arena_size);
+
+        if(arena == NULL) {
+            return false;
+        }
+
+        bench_key_arena = arena;
+        bench_key_arena_size = arena_size;
+        status = mjb_collator_keys_into(&bench_collator, bench_key_rows, bench_key_lengths, count,
+            MJB_ENC_UTF_8, bench_key_arena, &arena_size, bench_key_offsets);
+    }
+
+    bench_sink += arena_size;
+
+    return status == MJB_STATUS_OK;
+}
+
+// The lines of the corpus keyed as a column, in batches sharing one arena.
+static bool bench_collator_keys_into(const char *buffer, size_t byte_length) {
+    if(!bench_collator_ready) {
+        if(mjb_collator_init(&bench_collator, MJB_COLLATION_SHIFTED, MJB_COLLATION_TERTIARY) !=
+            MJB_STATUS_OK) {
+            return false;
+        }
+
+        bench_collator_ready = true;
+    }
+
+    size_t count = 0;
+    size_t start = 0;
+
+    while(start < byte_length) {
+        const char *end = (const char *)memchr(buffer + start, '\n', byte_length - start);
+        size_t length = end == NULL ? byte_length - start : (size_t)(end - buffer) - start;
+
+        bench_key_rows[count] = buffer + start;
+        bench_key_lengths[count] = length;
+        start += length + 1;
+
+        if(++count == BENCH_KEY_BATCH) {
+            if(!bench_collator_keys_flush(count)) {
+                return false;
+            }
+
+            count = 0;
+        }
+    }
+
+    return count == 0 || bench_collator_keys_flush(count);
+}
+#endif
+
+// A line against itself, which has to be folded and normalized to the end.
+static bool bench_caseless_match(const char *buffer, size_t byte_length) {
+    bool matches = false;
+
+    if(mjb_caseless_match(buffer, byte_length, MJB_ENC_UTF_8, buffer, byte_length, MJB_ENC_UTF_8,
+           MJB_CASELESS_COMPATIBILITY, &matches) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += matches;
+
+    return true;
+}
+
+static bool bench_caseless_hash(const char *buffer, size_t byte_length) {
+    uint64_t hash = 0;
+
+    if(mjb_caseless_hash(buffer, byte_length, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0, &hash) !=
+        MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += (size_t)hash;
+
+    return true;
+}
+
+static bool bench_grapheme_break(const char *buffer, size_t byte_length) {
+    mjb_next_state state;
+    state.index = 0;
+    mjb_break_type bt;
+
+    while((bt = mjb_next_grapheme_break(buffer, byte_length, MJB_ENC_UTF_8, &state)) !=
+        MJB_BT_NOT_SET) {
+        bench_sink += bt;
+    }
+
+    return true;
+}
+
+static bool bench_word_break(const char *buffer, size_t byte_length) {
+    mjb_next_word_state state;
+    state.index = 0;
+    mjb_break_type bt;
+
+    while((bt = mjb_next_word_break(buffer, byte_length, MJB_ENC_UTF_8, &state)) !=
+        MJB_BT_NOT_SET) {
+        bench_sink += bt;
+    }
+
+    return true;
+}
+
+static bool bench_line_break(const char *buffer, size_t byte_length) {
+    mjb_next_line_state state;
+    state.index = 0;
+    mjb_break_type bt;
+
+    while((bt = mjb_next_line_break(buffer, byte_length, MJB_ENC_UTF_8, &state)) !=
+        MJB_BT_NOT_SET) {
+        bench_sink += bt;
+    }
+
+    return true;
+}
+
+static bool bench_sentence_break(const char *buffer, size_t byte_length) {
+    mjb_next_sentence_state state;
+    state.index = 0;
+    mjb_break_type bt;
+
+    while((bt = mjb_next_sentence_break(buffer, byte_length, MJB_ENC_UTF_8, &state)) !=
+        MJB_BT_NOT_SET) {
+        bench_sink += bt;
+    }
+
+    return true;
+}
+
+// Every boundary is at least one byte past the previous one
+static size_t bench_segment_offsets[BENCH_CORPUS_BYTES];
+
+static bool bench_segment_word(const char *buffer, size_t byte_length) {
+    size_t count = BENCH_CORPUS_BYTES;
+
+    if(mjb_segment(buffer, byte_length, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, bench_segment_offsets,
+           &count) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += count;
+
+    return true;
+}
+
+static bool bench_segment_line(const char *buffer, size_t byte_length) {
+    size_t count = BENCH_CORPUS_BYTES;
+
+    if(mjb_segment(buffer, byte_length, MJB_ENC_UTF_8, MJB_SEGMENT_LINE, bench_segment_offsets,
+           &count) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += count;
+
+    return true;
+}
+
+static bool bench_bidi_resolve(const char *buffer, size_t byte_length) {
+    mjb_bidi_paragraph paragraph;
+
+    if(mjb_bidi_resolve(buffer, byte_length, MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, &paragraph) !=
+        MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += paragraph.count;
+    mjb_bidi_paragraph_free(&paragraph);
+
+    return true;
+}
+
+static mjb_bidi_workspace bench_bidi_workspace;
+
+static bool bench_bidi_workspace_resolve(const char *buffer, size_t byte_length) {
+    mjb_bidi_paragraph paragraph;
+
+    if(mjb_bidi_workspace_resolve(&bench_bidi_workspace, buffer, byte_length, MJB_ENC_UTF_8,
+           MJB_DIRECTION_AUTO, &paragraph) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += paragraph.count;
+
+    return true;
+}
+
+static bool bench_bidi_resolve_document(const char *buffer, size_t byte_length) {
+    mjb_bidi_document document;
+
+    if(mjb_bidi_resolve_document(buffer, byte_length, MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, NULL,
+           NULL, &document) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += document.count;
+    mjb_bidi_document_free(&document);
+
+    return true;
+}
+
+#if MJB_FEATURE_IDNA
+static bool bench_idna_to_ascii(const char *buffer, size_t byte_length) {
+    mjb_idna_info info;
+    mjb_result result;
+
+    // Tokens are not always valid domain names. UTS #46 errors are reported in info.
+    return bench_result_consume(mjb_idna_to_ascii(buffer, byte_length, MJB_ENC_UTF_8,
+                                    MJB_ENC_UTF_8, &info, &result),
+        &result);
+}
+
+static char bench_idna_list[BENCH_CORPUS_BYTES];
+
+// The tokens of the corpus, one per line, converted as one domain list.
+static bool bench_idna_to_ascii_lines(const char *buffer, size_t byte_length) {
+    mjb_idna_batch batch;
+
+    for(size_t i = 0; i < byte_length; ++i) {
+        bench_idna_list[i] = buffer[i] == ' ' ? '\n' : buffer[i];
+    }
+
+    if(mjb_idna_to_ascii_lines(bench_idna_list, byte_length, MJB_ENC_UTF_8, NULL, NULL, &batch) !=
+        MJB_STATUS_OK) {
+        return false;
+    }
+
+    bench_sink += batch.offsets[batch.count];
+    mjb_idna_batch_free(&batch);
+
+    return true;
+}
+#endif
+
+#if MJB_FEATURE_SECURITY
+static bool bench_confusable_skeleton(const char *buffer, size_t byte_length) {
+    mjb_result result;
+
+    return bench_result_consume(mjb_confusable_skeleton(buffer, byte_length, MJB_ENC_UTF_8,
+                                    MJB_ENC_UTF_8, &result),
+        &result);
+}
+
+// The whitespace-separated tokens of the corpus, indexed once by skeleton.
+typedef struct bench_confusable_references {
+    const char *buffer;
+    mjb_confusable_index index;
+} bench_confusable_references;
+
+static bench_confusable_references bench_references;
+
+static void bench_confusable_references_free(void) {
+    mjb_confusable_index_free(&bench_references.index);
+    bench_references.buffer = NULL;
+}
+
+static bool bench_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool bench_confusable_references_build(const char *buffer, size_t byte_length) {
+    if(bench_references.buffer == buffer) {
+        return true;
+    }
+
+    bench_confusable_references_free();
+
+    if(mjb_confusable_index_init(&bench_references.index) != MJB_STATUS_OK) {
+        return false;
+    }
+
+    uint32_t id = 0;
+
+    for(size_t i = 0; i < byte_length;) {
+        size_t start = i;
+
+        while(i < byte_length && !bench_is_space(buffer[i])) {
+            ++i;
+        }
+
+        // Tokens cut inside a UTF-8 sequence are skipped.
+        if(i > start && mjb_confusable_index_add(&bench_references.index, buffer + start,
+                            i - start, MJB_ENC_UTF_8, id++) == MJB_STATUS_NO_MEMORY) {
+            return false;
+        }
+
+        while(i < byte_length && bench_is_space(buffer[i])) {
+            ++i;
+        }
+    }
+
+    bench_references.buffer = buffer;
+
+    return true;
+}
+
+static bool bench_confusable_index_find(const char *buffer, size_t byte_length) {
+    if(!bench_confusable_references_build(buffer, byte_length)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < byte_length;) {
+        size_t start = i;
+
+        while(i < byte_length && !bench_is_space(buffer[i])) {
+            ++i;
+        }
+
+        size_t count = 0;
+
+        if(i > start && mjb_confusable_index_find(&bench_references.index, buffer + start,
+                            i - start, MJB_ENC_UTF_8, NULL, &count) == MJB_STATUS_OK) {
+            bench_sink += count;
+        }
+
+        while(i < byte_length && bench_is_space(buffer[i])) {
+            ++i;
+        }
+    }
+
+    return true;
+}
+#endif
+
+static bool bench_is_utf8(const char *buffer, size_t byte_length) {
+    bench_sink += mjb_is_utf8(buffer, byte_length);
+
+    return true;
+}
+
+static bool bench_is_ascii(const char *buffer, size_t byte_length) {
+    bench_sink += mjb_is_ascii(buffer, byte_length);
+
+    return true;
+}
+
+static bool bench_convert_encoding(const char *buffer, size_t byte_length, mjb_encoding encoding) {
+    mjb_result result;
+
+    return bench_result_consume(mjb_convert_encoding(buffer, byte_length, MJB_ENC_UTF_8, encoding,
+                                    &result),
+        &result);
+}
+
+static bool bench_convert_utf16le(const char *buffer, size_t byte_length) {
+    return bench_convert_encoding(buffer, byte_length, MJB_ENC_UTF_16LE);
+}
+
+static bool bench_convert_utf32be(const char *buffer, size_t byte_length) {
+    return bench_convert_encoding(buffer, byte_length, MJB_ENC_UTF_32BE);
+}
+
+static const bench_case bench_cases[] = {
+    { "normalize_nfc", bench_normalize_nfc, BENCH_LINES, NULL },
+    { "normalize_nfd", bench_normalize_nfd, BENCH_LINES, NULL },
+    { "normalize_nfkc", bench_normalize_nfkc, BENCH_LINES, NULL },
+    { "normalize_nfkd", bench_normalize_nfkd, BENCH_LINES, NULL },
+    { "normalizer_nfc", bench_normalizer_nfc, BENCH_CORPUS, NULL },
+    { "compose_pair_table", bench_compose_pair_table, BENCH_CORPUS, NULL },
+    { "compose_pair_binary_search", bench_compose_pair_binary_search, BENCH_CORPUS, NULL },
+    { "codepoint_property_script", bench_codepoint_property_script, BENCH_CORPUS, NULL },
+    { "codepoints_property_script", bench_codepoints_property_script, BENCH_CORPUS, NULL },
+    { "string_property_script", bench_string_property_script, BENCH_CORPUS, NULL },
+    { "filter", bench_filter, BENCH_LINES, NULL },
+    { "map_case_upper", bench_map_case_upper, BENCH_LINES, NULL },
+    { "map_case_lower", bench_map_case_lower, BENCH_LINES, NULL },
+    { "map_case_casefold", bench_map_case_casefold, BENCH_LINES, NULL },
+#if MJB_FEATURE_COLLATION
+    { "collation_key", bench_collation_key, BENCH_LINES, NULL },
+    { "collation_compare", bench_collation_compare, BENCH_LINES, NULL },
+    { "collator_key_into", bench_collator_key_into, BENCH_LINES, NULL },
+    { "collator_keys_into", bench_collator_keys_into, BENCH_CORPUS, NULL },
+#endif
+    { "caseless_match", bench_caseless_match, BENCH_LINES, NULL },
+    { "caseless_hash", bench_caseless_hash, BENCH_LINES, NULL },
+    { "next_grapheme_break", bench_grapheme_break, BENCH_LINES, NULL },
+    { "next_word_break", bench_word_break, BENCH_LINES, NULL },
+    { "next_line_break", bench_line_break, BENCH_LINES, NULL },
+    { "next_sentence_break", bench_sentence_break, BENCH_LINES, NULL },
+    { "segment_word", bench_segment_word, BENCH_CORPUS, NULL },
+    { "segment_line", bench_segment_line, BENCH_CORPUS, NULL },
+    { "bidi_resolve", bench_bidi_resolve, BENCH_LINES, NULL },
+    { "bidi_workspace_resolve", bench_bidi_workspace_resolve, BENCH_LINES, NULL },
+    { "bidi_resolve_document", bench_bidi_resolve_document, BENCH_CORPUS, NULL },
+#if MJB_FEATURE_IDNA
+    { "idna_to_ascii", bench_idna_to_ascii, BENCH_TOKENS, NULL },
+    { "idna_to_ascii_lines", bench_idna_to_ascii_lines, BENCH_CORPUS, NULL },
+#endif
+#if MJB_FEATURE_SECURITY
+    { "confusable_skeleton", bench_confusable_skeleton, BENCH_TOKENS, NULL },
+    { "confusable_index_find", bench_confusable_index_find, BENCH_CORPUS, NULL },
+#endif
+    { "is_utf8", bench_is_utf8, BENCH_CORPUS, NULL },
+    // mjb_is_ascii stops at the first non-ASCII byte, so the other corpora would time a prefix.
+    { "is_ascii", bench_is_ascii, BENCH_CORPUS, "ascii" },
+    { "convert_encoding_utf16le", bench_convert_utf16le, BENCH_LINES, NULL },
+    { "convert_encoding_utf32be", bench_convert_utf32be, BENCH_LINES, NULL },
+};
+
+static double bench_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
+
+static size_t bench_codepoints(const bench_unit *units, size_t count) {
+    size_t total = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        size_t codepoints = 0;
+
+        if(mjb_codepoint_count(units[i].buffer, units[i].byte_length, MJB_ENC_UTF_8,
+               &codepoints) == MJB_STATUS_OK) {
+            total += codepoints;
+        }
+    }
+
+    return total;
+}
+
+// Split a line into whitespace-separated tokens, trimming them to BENCH_TOKEN_MAX_BYTES on a
+// codepoint boundary.
+static void bench_tokenize(bench_corpus *corpus, const char *line, size_t byte_length) {
+    size_t i = 0;
+
+    while(i < byte_length && corpus->token_count < BENCH_MAX_UNITS) {
+        while(i < byte_length && line[i] == ' ') {
+            ++i;
+        }
+
+        size_t start = i;
+
+        while(i < byte_length && line[i] != ' ') {
+            ++i;
+        }
+
+        size_t length = i - start;
+
+        if(length > BENCH_TOKEN_MAX_BYTES) {
+            length = BENCH_TOKEN_MAX_BYTES;
+
+            while(length > 0 && ((unsigned char)line[start + length] & 0xC0) == 0x80) {
+                --length;
+            }
+        }
+
+        if(length > 0) {
+            corpus->tokens[corpus->token_count].buffer = line + start;
+            corpus->tokens[corpus->token_count].byte_length = length;
+            corpus->token_bytes += length;
+            ++corpus->token_count;
+        }
+    }
+}
+
+static bool bench_corpus_build(const bench_corpus_source *source, bench_corpus *corpus) {
+    memset(corpus, 0, sizeof(*corpus));
+    corpus->name = source->name;
+    corpus->buffer = (char *)malloc(BENCH_CORPUS_BYTES);
+    corpus->lines = (bench_unit *)malloc(BENCH_MAX_UNITS * sizeof(bench_unit));
+    corpus->tokens = (bench_unit *)malloc(BENCH_MAX_UNITS * sizeof(bench_unit));
+
+    if(corpus->buffer == NULL || corpus->lines == NULL || corpus->tokens == NULL) {
+        return false;
+    }
+
+    for(size_t i = 0; corpus->line_count < BENCH_MAX_UNITS; ++i) {
+        const char *line = source->lines[i % source->line_count];
+        size_t length = strlen(line);
+
+        // Lines are separated by a newline.
+        if(corpus->byte_length + length + 1 > BENCH_CORPUS_BYTES) {
+            break;
+        }
+
+        char *copy = corpus->buffer + corpus->byte_length;
+        memcpy(copy, line, length);
+        copy[length] = '\n';
+        corpus->byte_length += length + 1;
+
+        corpus->lines[corpus->line_count].buffer = copy;
+        corpus->lines[corpus->line_count].byte_length = length;
+        ++corpus->line_count;
+
+        bench_tokenize(corpus, copy, length);
+    }
+
+    corpus->whole.buffer = corpus->buffer;
+    corpus->whole.byte_length = corpus->byte_length;
+    corpus->line_codepoints = bench_codepoints(corpus->lines, corpus->line_count);
+    corpus->token_codepoints = bench_codepoints(corpus->tokens, corpus->token_count);
+    corpus->codepoints = bench_codepoints(&corpus->whole, 1);
+
+    return true;
+}
+
+static void bench_corpus_free(bench_corpus *corpus) {
+    free(corpus->buffer);
+    free(corpus->lines);
+    free(corpus->tokens);
+}
+
+static bool bench_run_units(bench_fn function, const bench_unit *units, size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        if(!function(units[i].buffer, units[i].byte_length)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool bench_run(const bench_case *test, const bench_corpus *corpus,
+    const bench_options *options, bool first) {
+    const bench_unit *units = corpus->lines;
+    size_t count = corpus->line_count;
+    size_t bytes = corpus->byte_length - corpus->line_count;
+    size_t codepoints = corpus->line_codepoints;
+
+    if(test->units == BENCH_TOKENS) {
+        units = corpus->tokens;
+        count = corpus->token_count;
+        bytes = corpus->token_bytes;
+        codepoints = corpus->token_codepoints;
+    } else if(test->units == BENCH_CORPUS) {
+        units = &corpus->whole;
+        count = 1;
+        bytes = corpus->byte_length;
+        codepoints = corpus->codepoints;
+    }
+
+    // Warm up the caches and validate the corpus once.
+    bool ok = bench_run_units(test->function, units, count);
+    size_t iterations = 0;
+    double elapsed = 0;
+
+    if(ok) {
+        double start = bench_now();
+
+        do {
+            ok = bench_run_units(test->function, units, count);
+            ++iterations;
+            elapsed = bench_now() - start;
+        } while(ok && elapsed < options->min_seconds);
+    }
+
+    double total_bytes = (double)bytes * (double)iterations;
+    double total_codepoints = (double)codepoints * (double)iterations;
+    double mb_per_s = ok && elapsed > 0 ? total_bytes / elapsed / 1e6 : 0;
+    double ns_per_codepoint = ok && total_codepoints > 0 ? elapsed * 1e9 / total_codepoints : 0;
+
+    fprintf(options->output,
+        "%s    { \"case\": \"%s\", \"corpus\": \"%s\", \"ok\": %s, \"units\": %zu, "
+        "\"bytes\": %zu, \"codepoints\": %zu, \"iterations\": %zu, \"seconds\": %.6f, "
+        "\"mb_per_s\": %.3f, \"ns_per_codepoint\": %.3f }",
+        first ? "" : ",\n", test->name, corpus->name, ok ? "true" : "false", count, bytes,
+        codepoints, iterations, elapsed, mb_per_s, ns_per_codepoint);
+
+    if(!ok) {
+        fprintf(stderr, "%s failed on the %s corpus\n", test->name, corpus->name);
+    }
+
+    return ok;
+}
+
+static bool bench_matches(const char *name, const char *filter) {
+    if(filter == NULL) {
+        return true;
+    }
+
+    // Filters are in the form name1,name2,...
+    size_t name_length = strlen(name);
+
+    for(const char *start = filter; *start;) {
+        const char *end = strchr(start, ',');
+        size_t length = end ? (size_t)(end - start) : strlen(start);
+
+        if(length > 0 && length <= name_length) {
+            for(size_t i = 0; i + length <= name_length; ++i) {
+                if(strncmp(name + i, start, length) == 0) {
+                    return true;
+                }
+            }
+        }
+
+        if(end == NULL) {
+            break;
+        }
+
+        start = end + 1;
+    }
+
+    return false;
+}
+
+static void show_help(const char *executable, struct option options[], const char *descriptions[],
+    const char *error) {
+    FILE *stream = error ? stderr : stdout;
+
+    fprintf(stream, "%s%smojibake - Mojibake benchmark client [v%s]\n\nUsage: %s [OPTIONS]\n",
+        error ? error : "", error ? "\n\n" : "", MJB_VERSION, executable);
+    fprintf(stream, "Options:\n");
+
+    for(unsigned long i = 0; options[i].name != NULL; ++i) {
+        fprintf(stream, "  -%c%s, --%s%s\n\t%s\n", options[i].val,
+            options[i].has_arg == no_argument ? "" : " ARG", options[i].name,
+            options[i].has_arg == no_argument ? "" : "=ARG", descriptions[i]);
+    }
+}
+
+int main(int argc, char *const argv[]) {
+    int option = 0;
+    int option_index = 0;
+    const char *output_path = NULL;
+    bench_options options = { NULL, NULL, 0.2, stdout };
+
+    struct option long_options[] = { { "corpus", required_argument, NULL, 'c' },
+        { "filter", required_argument, NULL, 'f' }, { "help", no_argument, NULL, 'h' },
+        { "output", required_argument, NULL, 'o' }, { "time", required_argument, NULL, 't' },
+        { "version", no_argument, NULL, 'V' }, { NULL, 0, NULL, 0 } };
+    const char *descriptions[] = { "Filter corpora by name in the form name1,name2,...",
+        "Filter benchmarks by name in the form name1,name2,...", "Show this help message",
+        "Write the JSON report to the given file instead of stdout",
+        "Minimum seconds to run each benchmark on each corpus (default 0.2)", "Print version" };
+
+    while((option = getopt_long(argc, argv, "c:f:ho:t:V", long_options, &option_index)) != -1) {
+        switch(option) {
+            case 'c':
+                options.corpus_filter = optarg;
+                break;
+            case 'f':
+                options.filter = optarg;
+                break;
+            case 'h':
+                show_help(argv[0], long_options, descriptions, NULL);
+                return 0;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 't':
+                options.min_seconds = strtod(optarg, NULL);
+                break;
+            case 'V':
+                printf("Mojibake v%s\n", MJB_VERSION);
+                return 0;
+            case '?':
+                // getopt_long already printed an error message
+                return 1;
+            default:
+                abort();
+        }
+    }
+
+    if(output_path != NULL) {
+        options.output = fopen(output_path, "w");
+
+        if(options.output == NULL) {
+            perror("output");
+
+            return 1;
+        }
+    }
+
+    bench_corpus corpora[BENCH_CORPUS_COUNT];
+    bool valid = true;
+
+    for(size_t i = 0; i < BENCH_CORPUS_COUNT; ++i) {
+        if(!bench_corpus_build(&bench_sources[i], &corpora[i])) {
+            fputs("Failed to allocate the benchmark corpora\n", stderr);
+
+            return 1;
+        }
+    }
+
+    fprintf(options.output,
+        "{\n  \"version\": \"%s\",\n  \"unicode_version\": \"%s\",\n  \"corpora\": [\n",
+        mjb_version(), mjb_unicode_version());
+
+    for(size_t i = 0; i < BENCH_CORPUS_COUNT; ++i) {
+        fprintf(options.output,
+            "    { \"name\": \"%s\", \"bytes\": %zu, \"lines\": %zu, \"tokens\": %zu }%s\n",
+            corpora[i].name, corpora[i].byte_length, corpora[i].line_count,
+            corpora[i].token_count, i + 1 == BENCH_CORPUS_COUNT ? "" : ",");
+    }
+
+    fputs("  ],\n  \"results\": [\n", options.output);
+
+    bool first = true;
+
+    for(size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); ++i) {
+        if(!bench_matches(bench_cases[i].name, options.filter)) {
+            continue;
+        }
+
+        for(size_t j = 0; j < BENCH_CORPUS_COUNT; ++j) {
+            if(!bench_matches(corpora[j].name, options.corpus_filter) ||
+                (bench_cases[i].corpus != NULL &&
+                    strcmp(bench_cases[i].corpus, corpora[j].name) != 0)) {
+                continue;
+            }
+
+            valid = bench_run(&bench_cases[i], &corpora[j], &options, first) && valid;
+            first = false;
+            fflush(options.output);
+        }
+    }
+
+    fputs("\n  ]\n}\n", options.output);
+
+    if(options.output != stdout) {
+        fclose(options.output);
+    }
+
+    for(size_t i = 0; i < BENCH_CORPUS_COUNT; ++i) {
+        bench_corpus_free(&corpora[i]);
+    }
+
+    mjb_normalizer_free(&bench_normalizer);
+    bench_compose_probes_free();
+    bench_property_probes_free();
+#if MJB_FEATURE_SECURITY
+    bench_confusable_references_free();
+#endif
+    free(bench_compose_pairs);
+    mjb_bidi_workspace_free(&bench_bidi_workspace);
+
+#if MJB_FEATURE_COLLATION
+    mjb_collator_free(&bench_collator);
+    free(bench_key_arena);
+#endif
+
+    return valid ? 0 : 1;
+}
@@ -549,6 +549,12 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
             fuzz_sink += segment_count;
             fuzz_sink += (size_t)mjb_word_count(buffer, size, encoding, &segment_count);
             fuzz_sink += segment_count;
+
+            size_t offsets[16];
+            segment_count = variant % 17;
+            fuzz_sink += (size_t)mjb_segment(buffer, size, encoding,
+                (mjb_segment_kind)((variant >> 5) % 4), offsets, &segment_count);
+            fuzz_sink += segment_count;
             break;
         }
 
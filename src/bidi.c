@@ -328,16 +328,104 @@ static bool bidi_query(mjb_codepoint cp, mjb_bidi_class *out_class, bool *out_mi
     return true;
 }
 
-// Pass 1: decode string + build working array + P2/P3 paragraph level.
-static size_t pass1_decode(const char *buffer, size_t byte_length, mjb_encoding encoding,
-    mjb_bidi_work *work, size_t capacity, uint8_t *out_level, mjb_direction base_dir) {
+// Grow the workspace buffers to hold |count| codepoints, keeping their contents.
+static mjb_status bidi_workspace_reserve(mjb_bidi_workspace *workspace, size_t count) {
+    if(count <= workspace->capacity) {
+        return MJB_STATUS_OK;
+    }
+
+    if(count > SIZE_MAX / sizeof(mjb_bidi_work) || count > SIZE_MAX / sizeof(mjb_bidi_char)) {
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    void *work = mjb_realloc(workspace->work, count * sizeof(mjb_bidi_work));
+
+    if(work != NULL) {
+        workspace->work = work;
+    }
+
+    size_t *indices = (size_t *)mjb_realloc(workspace->indices, count * sizeof(size_t));
+
+    if(indices != NULL) {
+        workspace->indices = indices;
+    }
+
+    bool *done = (bool *)mjb_realloc(workspace->done, count * sizeof(bool));
+
+    if(done != NULL) {
+        workspace->done = done;
+    }
+
+    mjb_bidi_char *chars = (mjb_bidi_char *)mjb_realloc(workspace->chars,
+        count * sizeof(mjb_bidi_char));
+
+    if(chars != NULL) {
+        workspace->chars = chars;
+    }
+
+    if(work == NULL || indices == NULL || done == NULL || chars == NULL) {
+        mjb_bidi_workspace_free(workspace);
+
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    workspace->capacity = count;
+
+    return MJB_STATUS_OK;
+}
+
+/**
+ * Estimate the number of codepoints. For UTF-8 this counts the bytes that are not continuation
+ * bytes, which is exact for well-formed input and far cheaper than decoding. Malformed input can
+ * decode to more codepoints, in which case pass 1 grows the buffers.
+ */
+static size_t bidi_estimate_count(const char *buffer, size_t byte_length, mjb_encoding encoding) {
+    switch(encoding) {
+        case MJB_ENC_UTF_16:
+        case MJB_ENC_UTF_16BE:
+        case MJB_ENC_UTF_16LE:
+            return (byte_length + 1) / 2;
+        case MJB_ENC_UTF_32:
+        case MJB_ENC_UTF_32BE:
+        case MJB_ENC_UTF_32LE:
+            return (byte_length + 3) / 4;
+        default:
+            break;
+    }
+
+    size_t count = 0;
+
+    for(size_t i = 0; i < byte_length; ++i) {
+        count += ((uint8_t)buffer[i] & 0xC0) != 0x80;
+    }
+
+    return count;
+}
+
+// Classes that can raise a level above the paragraph level: right-to-left strong and number types
+// and the explicit formatting characters.
+#define MJB_BIDI_NON_LTR_CLASSES                                                                   \
+    ((1u << MJB_PR_BIDI_CLASS_R) | (1u << MJB_PR_BIDI_CLASS_AL) | (1u << MJB_PR_BIDI_CLASS_AN) |  \
+        (1u << MJB_PR_BIDI_CLASS_LRE) | (1u << MJB_PR_BIDI_CLASS_LRO) |                            \
+        (1u << MJB_PR_BIDI_CLASS_RLE) | (1u << MJB_PR_BIDI_CLASS_RLO) |                            \
+        (1u << MJB_PR_BIDI_CLASS_PDF) | (1u << MJB_PR_BIDI_CLASS_LRI) |                            \
+        (1u << MJB_PR_BIDI_CLASS_RLI) | (1u << MJB_PR_BIDI_CLASS_FSI) |                            \
+        (1u << MJB_PR_BIDI_CLASS_PDI))
+
+// Pass 1: decode string + build working array + P2/P3 paragraph level. out_classes is the set of
+// bidi classes seen, one bit per class.
+static mjb_status pass1_decode(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    mjb_bidi_workspace *workspace, size_t *out_count, uint8_t *out_level, uint32_t *out_classes,
+    mjb_direction base_dir) {
     uint8_t state = MJB_UTF_ACCEPT;
     bool in_error = false;
     mjb_codepoint cp = 0;
     size_t count = 0;
+    uint32_t classes = 0;
     size_t i = 0;
+    mjb_bidi_work *work = (mjb_bidi_work *)workspace->work;
 
-    while(i < byte_length && count < capacity) {
+    while(i < byte_length) {
         size_t byte_offset = i;
         mjb_decode_result dr = mjb_next_codepoint(buffer, byte_length, &state, &i, encoding, &cp,
             &in_error);
@@ -357,6 +445,17 @@ static size_t pass1_decode(const char *buffer, size_t byte_length, mjb_encoding
             continue;
         }
 
+        if(count == workspace->capacity) {
+            // Only malformed input decodes to more codepoints than estimated.
+            mjb_status status = bidi_workspace_reserve(workspace, count + count / 2 + 16);
+
+            if(status != MJB_STATUS_OK) {
+                return status;
+            }
+
+            work = (mjb_bidi_work *)workspace->work;
+        }
+
         work[count].codepoint = cp;
         work[count].byte_offset = byte_offset;
         work[count].level = 0;
@@ -364,14 +463,20 @@ static size_t pass1_decode(const char *buffer, size_t byte_length, mjb_encoding
         work[count].orig = bc;
         work[count].mirrored = mirrored;
         work[count].removed = false;
+        classes |= 1u << bc;
         ++count;
     }
 
+    *out_classes = classes;
+
     // P2/P3: determine paragraph embedding level.
     if(base_dir == MJB_DIRECTION_LTR) {
         *out_level = 0;
     } else if(base_dir == MJB_DIRECTION_RTL) {
         *out_level = 1;
+    } else if((classes & ((1u << MJB_PR_BIDI_CLASS_R) | (1u << MJB_PR_BIDI_CLASS_AL))) == 0) {
+        // AUTO without right-to-left strong types.
+        *out_level = 0;
     } else {
         // AUTO: scan for first strong type, skipping isolate-scoped content.
         *out_level = 0; // default LTR
@@ -393,7 +498,9 @@ static size_t pass1_decode(const char *buffer, size_t byte_length, mjb_encoding
         }
     }
 
-    return count;
+    *out_count = count;
+
+    return MJB_STATUS_OK;
 }
 
 // Pass 2: X rules, explicit levels
@@ -648,17 +755,8 @@ static size_t collect_irs(const mjb_bidi_work *work, size_t count, size_t start,
 }
 
 // Pass 3: W rules, weak types (per Isolating Run Sequence).
-static void pass3_weak(mjb_bidi_work *work, size_t count, uint8_t para_level) {
-    size_t *irs_idx = (size_t *)mjb_alloc(count * sizeof(size_t));
-    bool *done = (bool *)mjb_alloc(count * sizeof(bool));
-
-    if(!irs_idx || !done) {
-        mjb_free(irs_idx);
-        mjb_free(done);
-
-        return;
-    }
-
+static void pass3_weak(mjb_bidi_work *work, size_t count, uint8_t para_level, size_t *irs_idx,
+    bool *done) {
     memset(done, 0, count * sizeof(bool));
 
     size_t scan = 0;
@@ -815,9 +913,6 @@ static void pass3_weak(mjb_bidi_work *work, size_t count, uint8_t para_level) {
 
         ++scan;
     }
-
-    mjb_free(done);
-    mjb_free(irs_idx);
 }
 
 // Pass 4: N0, bracket pairs (per Isolating Run Sequence).
@@ -829,17 +924,8 @@ typedef struct {
     size_t close_irs; // IRS index of close bracket
 } mjb_bracket_pair;
 
-static void pass4_brackets(mjb_bidi_work *work, size_t count, uint8_t para_level) {
-    size_t *irs_idx = (size_t *)mjb_alloc(count * sizeof(size_t));
-    bool *done = (bool *)mjb_alloc(count * sizeof(bool));
-
-    if(!irs_idx || !done) {
-        mjb_free(irs_idx);
-        mjb_free(done);
-
-        return;
-    }
-
+static void pass4_brackets(mjb_bidi_work *work, size_t count, uint8_t para_level, size_t *irs_idx,
+    bool *done) {
     memset(done, 0, count * sizeof(bool));
 
     size_t scan = 0;
@@ -1032,25 +1118,13 @@ static void pass4_brackets(mjb_bidi_work *work, size_t count, uint8_t para_level
 
         ++scan;
     }
-
-    mjb_free(done);
-    mjb_free(irs_idx);
 }
 
 /**
  * Pass 5: N1/N2 - other neutrals (per Isolating Run Sequence)
  */
-static void pass5_neutrals(mjb_bidi_work *work, size_t count, uint8_t para_level) {
-    size_t *irs_idx = (size_t *)mjb_alloc(count * sizeof(size_t));
-    bool *done = (bool *)mjb_alloc(count * sizeof(bool));
-
-    if(!irs_idx || !done) {
-        mjb_free(irs_idx);
-        mjb_free(done);
-
-        return;
-    }
-
+static void pass5_neutrals(mjb_bidi_work *work, size_t count, uint8_t para_level, size_t *irs_idx,
+    bool *done) {
     memset(done, 0, count * sizeof(bool));
 
     size_t scan = 0;
@@ -1143,9 +1217,6 @@ static void pass5_neutrals(mjb_bidi_work *work, size_t count, uint8_t para_level
 
         ++scan;
     }
-
-    mjb_free(done);
-    mjb_free(irs_idx);
 }
 
 // Pass 6: I1/I2, implicit levels.
@@ -1175,9 +1246,12 @@ static void pass6_implicit(mjb_bidi_work *work, size_t count) {
     }
 }
 
-// Resolve bidirectional text (TR9) for a paragraph.
-MJB_EXPORT mjb_status mjb_bidi_resolve(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_direction direction, mjb_bidi_paragraph *result) {
+/**
+ * Resolve a paragraph into the workspace. On success result->chars points to workspace->chars,
+ * or is NULL for an empty paragraph.
+ */
+static mjb_status bidi_resolve(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    mjb_direction direction, mjb_bidi_workspace *workspace, mjb_bidi_paragraph *result) {
     if(result == NULL || (buffer == NULL && byte_length > 0)) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
@@ -1197,25 +1271,48 @@ MJB_EXPORT mjb_status mjb_bidi_resolve(const char *buffer, size_t byte_length,
         return MJB_STATUS_OK;
     }
 
-    // Upper bound: size bytes cannot produce more than size codepoints.
-    if(byte_length > SIZE_MAX / sizeof(mjb_bidi_work)) {
-        return MJB_STATUS_OVERFLOW;
-    }
+    // Size the buffers by codepoints, not bytes: UTF-8 CJK and Arabic text has 2-3 bytes each.
+    status = bidi_workspace_reserve(workspace, bidi_estimate_count(buffer, byte_length, encoding));
 
-    mjb_bidi_work *work = (mjb_bidi_work *)mjb_alloc(byte_length * sizeof(mjb_bidi_work));
-
-    if(!work) {
-        return MJB_STATUS_NO_MEMORY;
+    if(status != MJB_STATUS_OK) {
+        return status;
     }
 
     uint8_t para_level = 0;
+    size_t count = 0;
+    uint32_t classes = 0;
 
     // Pass 1.
-    size_t count = pass1_decode(buffer, byte_length, encoding, work, byte_length, &para_level,
+    status = pass1_decode(buffer, byte_length, encoding, workspace, &count, &para_level, &classes,
         direction);
 
-    if(count == 0) {
-        mjb_free(work);
+    if(status != MJB_STATUS_OK || count == 0) {
+        return status;
+    }
+
+    mjb_bidi_work *work = (mjb_bidi_work *)workspace->work;
+
+    if(para_level == 0 && (classes & MJB_BIDI_NON_LTR_CLASSES) == 0) {
+        /*
+            Pure left-to-right paragraph: X1-X8 leave every level at 0, W7 turns EN into L, N1/N2
+            resolve every neutral to L and I1 keeps L at 0, so only X9 has something to do.
+        */
+        mjb_bidi_char *out = workspace->chars;
+        size_t out_count = 0;
+
+        for(size_t i = 0; i < count; ++i) {
+            if(work[i].bidi != MJB_PR_BIDI_CLASS_BN) {
+                out[out_count].codepoint = work[i].codepoint;
+                out[out_count].byte_offset = work[i].byte_offset;
+                out[out_count].level = 0;
+                out[out_count].resolved_class = MJB_PR_BIDI_CLASS_L;
+                out[out_count].mirroring_glyph = 0;
+                ++out_count;
+            }
+        }
+
+        result->chars = out_count > 0 ? out : NULL;
+        result->count = out_count;
 
         return MJB_STATUS_OK;
     }
@@ -1239,13 +1336,13 @@ MJB_EXPORT mjb_status mjb_bidi_resolve(const char *buffer, size_t byte_length,
     }
 
     // Pass 3.
-    pass3_weak(work, count, para_level);
+    pass3_weak(work, count, para_level, workspace->indices, workspace->done);
 
     // Pass 4.
-    pass4_brackets(work, count, para_level);
+    pass4_brackets(work, count, para_level, workspace->indices, workspace->done);
 
     // Pass 5.
-    pass5_neutrals(work, count, para_level);
+    pass5_neutrals(work, count, para_level, workspace->indices, workspace->done);
 
     // Pass 6.
     pass6_implicit(work, count);
@@ -1302,62 +1399,377 @@ MJB_EXPORT mjb_status mjb_bidi_resolve(const char *buffer, size_t byte_length,
     }
 
     // Collect non-removed characters.
+    mjb_bidi_char *out = workspace->chars;
     size_t out_count = 0;
 
     for(size_t i = 0; i < count; ++i) {
         if(!work[i].removed) {
+            out[out_count].codepoint = work[i].codepoint;
+            out[out_count].byte_offset = work[i].byte_offset;
+            out[out_count].level = work[i].level;
+            out[out_count].resolved_class = work[i].bidi;
+
+            // L4: if Bidi_Mirrored and at an odd level, look up the mirroring glyph.
+            if(work[i].mirrored && (work[i].level & 1)) {
+                out[out_count].mirroring_glyph = bidi_mirroring_glyph(work[i].codepoint);
+            } else {
+                out[out_count].mirroring_glyph = 0;
+            }
+
             ++out_count;
         }
     }
 
-    mjb_bidi_char *out = NULL;
+    result->chars = out_count > 0 ? out : NULL;
+    result->count = out_count;
+    result->paragraph_level = para_level;
+    result->direction = (para_level & 1) ? MJB_DIRECTION_RTL : MJB_DIRECTION_LTR;
 
-    if(out_count > 0) {
-        if(out_count > SIZE_MAX / sizeof(mjb_bidi_char)) {
-            mjb_free(work);
+    return MJB_STATUS_OK;
+}
 
-            return MJB_STATUS_OVERFLOW;
-        }
+// Resolve bidirectional text (TR9) for a paragraph.
+MJB_EXPORT mjb_status mjb_bidi_resolve(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_direction direction, mjb_bidi_paragraph *result) {
+    mjb_bidi_workspace workspace;
+    memset(&workspace, 0, sizeof(workspace));
 
-        out = (mjb_bidi_char *)mjb_alloc(out_count * sizeof(mjb_bidi_char));
+    mjb_status status = bidi_resolve(buffer, byte_length, encoding, direction, &workspace, result);
 
-        if(!out) {
-            mjb_free(work);
+    // The paragraph takes over the characters; the rest of the workspace is released.
+    if(status == MJB_STATUS_OK && result->chars != NULL) {
+        workspace.chars = NULL;
+    }
 
-            return MJB_STATUS_NO_MEMORY;
-        }
+    mjb_bidi_workspace_free(&workspace);
 
-        size_t k = 0;
+    return status;
+}
 
-        for(size_t i = 0; i < count; ++i) {
-            if(!work[i].removed) {
-                out[k].codepoint = work[i].codepoint;
-                out[k].byte_offset = work[i].byte_offset;
-                out[k].level = work[i].level;
-                out[k].resolved_class = work[i].bidi;
-
-                // L4: if Bidi_Mirrored and at an odd level, look up the mirroring glyph.
-                if(work[i].mirrored && (work[i].level & 1)) {
-                    out[k].mirroring_glyph = bidi_mirroring_glyph(work[i].codepoint);
-                } else {
-                    out[k].mirroring_glyph = 0;
+// Initialize a reusable bidi workspace.
+MJB_EXPORT mjb_status mjb_bidi_workspace_init(mjb_bidi_workspace *workspace) {
+    if(workspace == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(workspace, 0, sizeof(*workspace));
+
+    return MJB_STATUS_OK;
+}
+
+// Free the buffers of a bidi workspace.
+MJB_EXPORT void mjb_bidi_workspace_free(mjb_bidi_workspace *workspace) {
+    if(workspace == NULL) {
+        return;
+    }
+
+    mjb_free(workspace->work);
+    mjb_free(workspace->indices);
+    mjb_free(workspace->done);
+    mjb_free(workspace->chars);
+    memset(workspace, 0, sizeof(*workspace));
+}
+
+// Resolve bidirectional text (TR9) for a paragraph into a reusable workspace.
+MJB_EXPORT mjb_status mjb_bidi_workspace_resolve(mjb_bidi_workspace *workspace,
+    const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_direction direction,
+    mjb_bidi_paragraph *result) {
+    if(workspace == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    return bidi_resolve(buffer, byte_length, encoding, direction, workspace, result);
+}
+
+// A paragraph of a document: its bytes, and its slot and resolution in the document characters.
+typedef struct {
+    size_t byte_start;
+    size_t byte_length;
+    size_t first;    // Index of the first slot in the document characters
+    size_t capacity; // Codepoints decoded while splitting, an upper bound of the characters
+    size_t count;
+    uint8_t level;
+    mjb_status status;
+} mjb_bidi_document_job;
+
+typedef struct {
+    const char *buffer;
+    mjb_encoding encoding;
+    mjb_direction direction;
+    mjb_bidi_document_job *jobs;
+    mjb_bidi_char *chars;
+    mjb_bidi_workspace *workspace; // Shared when resolving serially, NULL otherwise
+} mjb_bidi_document_context;
+
+// P1: paragraph separators are the B characters.
+static inline bool bidi_is_paragraph_separator(mjb_codepoint cp) {
+    if(cp < 0x80) {
+        return cp == 0x0A || cp == 0x0D || (cp >= 0x1C && cp <= 0x1E);
+    }
+
+    mjb_bidi_class bc;
+    bool mirrored;
+
+    return bidi_query(cp, &bc, &mirrored) && bc == MJB_PR_BIDI_CLASS_B;
+}
+
+/**
+ * Split the input into paragraphs (TR9 P1). A separator is kept with the paragraph it ends, and a
+ * CR LF pair is a single separator.
+ */
+static mjb_status bidi_document_split(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, size_t start, mjb_bidi_document_job **out_jobs, size_t *out_count) {
+    mjb_bidi_document_job *jobs = NULL;
+    size_t job_count = 0;
+    size_t job_capacity = 0;
+    size_t total = 0;
+    size_t paragraph_start = start;
+    size_t paragraph_count = 0;
+    uint8_t state = MJB_UTF_ACCEPT;
+    bool in_error = false;
+    mjb_codepoint cp = 0;
+    size_t i = start;
+
+    while(paragraph_start < byte_length) {
+        bool end = true;
+
+        while(i < byte_length) {
+            mjb_decode_result dr = mjb_next_codepoint(buffer, byte_length, &state, &i, encoding,
+                &cp, &in_error);
+
+            if(dr == MJB_DECODE_END) {
+                break;
+            }
+
+            if(dr == MJB_DECODE_INCOMPLETE) {
+                continue;
+            }
+
+            ++paragraph_count;
+
+            if(dr == MJB_DECODE_OK && bidi_is_paragraph_separator(cp)) {
+                if(cp == 0x0D && i < byte_length) {
+                    size_t next = i;
+                    uint8_t next_state = state;
+                    bool next_in_error = in_error;
+                    mjb_codepoint next_cp = 0;
+
+                    if(mjb_next_codepoint(buffer, byte_length, &next_state, &next, encoding,
+                           &next_cp, &next_in_error) == MJB_DECODE_OK &&
+                        next_cp == 0x0A) {
+                        i = next;
+                        ++paragraph_count;
+                    }
                 }
 
-                ++k;
+                end = i >= byte_length;
+
+                break;
+            }
+        }
+
+        if(job_count == job_capacity) {
+            size_t capacity = job_capacity == 0 ? 16 : job_capacity * 2;
+            mjb_bidi_document_job *grown = (mjb_bidi_document_job *)mjb_realloc(jobs,
+                capacity * sizeof(mjb_bidi_document_job));
+
+            if(grown == NULL) {
+                mjb_free(jobs);
+
+                return MJB_STATUS_NO_MEMORY;
             }
+
+            jobs = grown;
+            job_capacity = capacity;
         }
+
+        mjb_bidi_document_job *job = &jobs[job_count++];
+        job->byte_start = paragraph_start;
+        job->byte_length = (end ? byte_length : i) - paragraph_start;
+        job->first = total;
+        job->capacity = paragraph_count;
+        job->count = 0;
+        job->level = 0;
+        job->status = MJB_STATUS_OK;
+        total += paragraph_count;
+        paragraph_count = 0;
+        paragraph_start = end ? byte_length : i;
     }
 
-    mjb_free(work);
+    *out_jobs = jobs;
+    *out_count = job_count;
 
-    result->chars = out;
-    result->count = out_count;
-    result->paragraph_level = para_level;
-    result->direction = (para_level & 1) ? MJB_DIRECTION_RTL : MJB_DIRECTION_LTR;
+    return MJB_STATUS_OK;
+}
+
+// Resolve one paragraph of a document into its slot of the document characters.
+static void bidi_document_task(void *context, size_t index) {
+    mjb_bidi_document_context *document = (mjb_bidi_document_context *)context;
+    mjb_bidi_document_job *job = &document->jobs[index];
+    mjb_bidi_workspace local;
+    mjb_bidi_workspace *workspace = document->workspace;
+    mjb_bidi_paragraph paragraph;
+
+    if(workspace == NULL) {
+        memset(&local, 0, sizeof(local));
+        workspace = &local;
+    }
+
+    job->status = bidi_resolve(document->buffer + job->byte_start, job->byte_length,
+        document->encoding, document->direction, workspace, &paragraph);
+
+    if(job->status == MJB_STATUS_OK && paragraph.count > job->capacity) {
+        job->status = MJB_STATUS_OVERFLOW;
+    }
+
+    if(job->status == MJB_STATUS_OK) {
+        mjb_bidi_char *out = document->chars + job->first;
+
+        for(size_t i = 0; i < paragraph.count; ++i) {
+            out[i] = paragraph.chars[i];
+            out[i].byte_offset += job->byte_start;
+        }
+
+        job->count = paragraph.count;
+        job->level = paragraph.paragraph_level;
+    }
+
+    if(workspace == &local) {
+        mjb_bidi_workspace_free(&local);
+    }
+}
+
+// Resolve bidirectional text (TR9) for every paragraph of a document.
+MJB_EXPORT mjb_status mjb_bidi_resolve_document(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_direction direction, mjb_parallel_for_fn parallel_for, void *pool,
+    mjb_bidi_document *result) {
+    if(result == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(result, 0, sizeof(*result));
+
+    if(buffer == NULL && byte_length > 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+
+    if(status != MJB_STATUS_OK || byte_length == 0) {
+        return status;
+    }
+
+    // Paragraphs after the first have no BOM, so split and resolve with the byte order it gives.
+    size_t start = 0;
+    mjb_encoding resolved = mjb_resolve_input_encoding(buffer, byte_length, encoding, &start);
+
+    if(resolved == MJB_ENC_UTF_16 || resolved == MJB_ENC_UTF_32) {
+        // No BOM: the whole input decodes as a single error, as in mjb_bidi_resolve.
+        resolved = encoding;
+        start = 0;
+    }
+
+    mjb_bidi_document_job *jobs = NULL;
+    size_t job_count = 0;
+    status = bidi_document_split(buffer, byte_length, resolved, start, &jobs, &job_count);
+
+    if(status != MJB_STATUS_OK || job_count == 0) {
+        return status;
+    }
+
+    size_t total = jobs[job_count - 1].first + jobs[job_count - 1].capacity;
+
+    if(total > SIZE_MAX / sizeof(mjb_bidi_char) ||
+        job_count > SIZE_MAX / sizeof(mjb_bidi_paragraph)) {
+        mjb_free(jobs);
+
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    mjb_bidi_document_context context;
+    context.buffer = buffer;
+    context.encoding = resolved;
+    context.direction = direction;
+    context.jobs = jobs;
+    context.chars = (mjb_bidi_char *)mjb_alloc((total == 0 ? 1 : total) * sizeof(mjb_bidi_char));
+    context.workspace = NULL;
+    mjb_bidi_paragraph *paragraphs = (mjb_bidi_paragraph *)mjb_alloc(
+        job_count * sizeof(mjb_bidi_paragraph));
+
+    if(context.chars == NULL || paragraphs == NULL) {
+        mjb_free(context.chars);
+        mjb_free(paragraphs);
+        mjb_free(jobs);
+
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    if(parallel_for != NULL) {
+        parallel_for(pool, job_count, bidi_document_task, &context);
+    } else {
+        // Serially, one workspace serves every paragraph.
+        mjb_bidi_workspace workspace;
+        memset(&workspace, 0, sizeof(workspace));
+        context.workspace = &workspace;
+
+        for(size_t i = 0; i < job_count && status == MJB_STATUS_OK; ++i) {
+            bidi_document_task(&context, i);
+            status = jobs[i].status;
+        }
+
+        mjb_bidi_workspace_free(&workspace);
+    }
+
+    // Pack the paragraphs, whose X9-removed characters leave gaps at the end of their slots.
+    size_t count = 0;
+
+    for(size_t i = 0; i < job_count && status == MJB_STATUS_OK; ++i) {
+        status = jobs[i].status;
+
+        if(status != MJB_STATUS_OK) {
+            break;
+        }
+
+        if(count != jobs[i].first && jobs[i].count != 0) {
+            memmove(context.chars + count, context.chars + jobs[i].first,
+                jobs[i].count * sizeof(mjb_bidi_char));
+        }
+
+        paragraphs[i].chars = jobs[i].count != 0 ? context.chars + count : NULL;
+        paragraphs[i].count = jobs[i].count;
+        paragraphs[i].paragraph_level = jobs[i].level;
+        paragraphs[i].direction = (jobs[i].level & 1) ? MJB_DIRECTION_RTL : MJB_DIRECTION_LTR;
+        count += jobs[i].count;
+    }
+
+    mjb_free(jobs);
+
+    if(status != MJB_STATUS_OK) {
+        mjb_free(context.chars);
+        mjb_free(paragraphs);
+
+        return status;
+    }
+
+    result->chars = context.chars;
+    result->count = count;
+    result->paragraphs = paragraphs;
+    result->paragraph_count = job_count;
 
     return MJB_STATUS_OK;
 }
 
+// Free a bidi document allocated by mjb_bidi_resolve_document.
+MJB_EXPORT void mjb_bidi_document_free(mjb_bidi_document *document) {
+    if(document == NULL) {
+        return;
+    }
+
+    mjb_free(document->chars);
+    mjb_free(document->paragraphs);
+    memset(document, 0, sizeof(*document));
+}
+
 // Free a bidi paragraph allocated by mjb_bidi_resolve.
 MJB_EXPORT void mjb_bidi_paragraph_free(mjb_bidi_paragraph *paragraph) {
     if(paragraph == NULL) {
@@ -1404,36 +1816,26 @@ MJB_EXPORT mjb_status mjb_bidi_reorder_line(const mjb_bidi_paragraph *paragraph,
         }
     }
 
-    // Build level array for the line
-    uint8_t *levels = (uint8_t *)mjb_alloc(n * sizeof(uint8_t));
-
-    if(!levels) {
-        return MJB_STATUS_NO_MEMORY;
-    }
-
-    for(size_t i = 0; i < n; ++i) {
-        levels[i] = paragraph->chars[line_start + i].level;
-    }
+    // Levels of the line, read in place so that reordering does not allocate.
+    const mjb_bidi_char *line = paragraph->chars + line_start;
 
     // Find max level and minimum odd level
     uint8_t max_level = para_level;
     uint8_t min_odd = 255;
 
     for(size_t i = 0; i < n; ++i) {
-        if(levels[i] > max_level) {
-            max_level = levels[i];
+        if(line[i].level > max_level) {
+            max_level = line[i].level;
         }
 
-        if((levels[i] & 1) && levels[i] < min_odd) {
-            min_odd = levels[i];
+        if((line[i].level & 1) && line[i].level < min_odd) {
+            min_odd = line[i].level;
         }
     }
 
     // L2: reverse substrings from max_level down to min_odd. If no odd levels exist (min_odd==255)
     // there is nothing to reverse.
     if(min_odd == 255) {
-        mjb_free(levels);
-
         return MJB_STATUS_OK;
     }
 
@@ -1441,7 +1843,7 @@ MJB_EXPORT mjb_status mjb_bidi_reorder_line(const mjb_bidi_paragraph *paragraph,
         size_t start = SIZE_MAX;
 
         for(size_t i = 0; i <= n; ++i) {
-            if(i < n && levels[i] >= lv) {
+            if(i < n && line[i].level >= lv) {
                 if(start == SIZE_MAX) {
                     start = i;
                 }
@@ -1469,8 +1871,6 @@ MJB_EXPORT mjb_status mjb_bidi_reorder_line(const mjb_bidi_paragraph *paragraph,
         }
     }
 
-    mjb_free(levels);
-
     return MJB_STATUS_OK;
 }
 
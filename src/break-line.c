@@ -23,16 +23,54 @@ static inline bool mjb_is_ea(mjb_east_asian_width ea) {
     return ea == MJB_EAW_FULL_WIDTH || ea == MJB_EAW_WIDE || ea == MJB_EAW_HALF_WIDTH;
 }
 
+// LB1 Resolve ambiguous and context-dependent classes before applying pairwise rules.
+// AI, SG, XX -> AL
+// CJ -> NS
+// SA -> CM if the codepoint is a non-spacing or spacing-combining mark, otherwise AL
+static inline mjb_lbp mjb_resolve_lbp(mjb_codepoint codepoint,
+    mjb_segmentation_properties properties) {
+    mjb_lbp lbp = MJB_SEGMENTATION_LBP(properties);
+
+    if(lbp == MJB_LBP_NOT_SET) {
+        // # @missing: 0000..10FFFF; XX
+        lbp = MJB_LBP_XX;
+    }
+
+    if(lbp == MJB_LBP_AI || lbp == MJB_LBP_SG || lbp == MJB_LBP_XX) {
+        lbp = MJB_LBP_AL;
+    } else if(lbp == MJB_LBP_CJ) {
+        lbp = MJB_LBP_NS;
+    } else if(lbp == MJB_LBP_SA) {
+        mjb_category gc = mjb_lbp_category(codepoint);
+        lbp = (gc == MJB_CATEGORY_MN || gc == MJB_CATEGORY_MC) ? MJB_LBP_CM : MJB_LBP_AL;
+    }
+
+    return lbp;
+}
+
 // Peek at the next codepoint and return its LBP (resolved by LB1) and EA width.
-// Returns MJB_LBP_NOT_SET for EOT.
-static inline mjb_lbp mjb_peek_next(const char *buffer, size_t byte_length, size_t peek_index,
-    mjb_encoding encoding, mjb_east_asian_width *ea_out) {
+// Returns MJB_LBP_NOT_SET for EOT. The codepoint is kept in the look-ahead of the state, so the
+// next step and later peeks reuse it.
+static inline mjb_lbp mjb_peek_next(const char *buffer, size_t byte_length,
+    mjb_next_line_state *state, mjb_encoding encoding, mjb_east_asian_width *ea_out) {
+    const mjb_break_lookahead_entry *entry = mjb_break_lookahead_at(&state->lookahead,
+        state->index);
+
+    if(entry != NULL) {
+        if(ea_out) {
+            *ea_out = MJB_SEGMENTATION_EAW(entry->properties);
+        }
+
+        return (mjb_lbp)entry->resolved;
+    }
+
     uint8_t peek_state = MJB_UTF_ACCEPT;
     mjb_codepoint peek_cp = 0;
     bool peek_error = false;
-    size_t i = peek_index;
+    size_t peek_index = state->index;
 
-    for(; i < byte_length;) {
+    for(;;) {
+        size_t start = peek_index;
         mjb_decode_result dr = mjb_next_codepoint(buffer, byte_length, &peek_state, &peek_index,
             encoding, &peek_cp, &peek_error);
 
@@ -45,37 +83,23 @@ static inline mjb_lbp mjb_peek_next(const char *buffer, size_t byte_length, size
         }
 
         if(dr == MJB_DECODE_OK) {
-            uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+            mjb_segmentation_properties properties = 0;
 
-            if(mjb_codepoint_properties_lookup(peek_cp, cpb) != MJB_STATUS_OK) {
+            if(!mjb_codepoint_segmentation_properties(peek_cp, &properties)) {
                 return MJB_LBP_NOT_SET;
             }
 
-            mjb_lbp lbp = (mjb_lbp)mjb_codepoint_properties_get(cpb, MJB_PR_LINE_BREAK);
-
-            if(lbp == MJB_LBP_NOT_SET) {
-                lbp = MJB_LBP_XX;
-            }
-
-            // Apply LB1 resolution
-            if(lbp == MJB_LBP_AI || lbp == MJB_LBP_SG || lbp == MJB_LBP_XX) {
-                lbp = MJB_LBP_AL;
-            } else if(lbp == MJB_LBP_CJ) {
-                lbp = MJB_LBP_NS;
-            } else if(lbp == MJB_LBP_SA) {
-                mjb_category gc = mjb_lbp_category(peek_cp);
-                lbp = (gc == MJB_CATEGORY_MN || gc == MJB_CATEGORY_MC) ? MJB_LBP_CM : MJB_LBP_AL;
-            }
+            mjb_lbp lbp = mjb_resolve_lbp(peek_cp, properties);
+            mjb_break_lookahead_push(&state->lookahead, state->index, start, peek_index, peek_cp,
+                properties, (uint8_t)lbp);
 
             if(ea_out) {
-                *ea_out = (mjb_east_asian_width)cpb[MJB_PR_EAST_ASIAN_WIDTH];
+                *ea_out = MJB_SEGMENTATION_EAW(properties);
             }
 
             return lbp;
         }
     }
-
-    return MJB_LBP_NOT_SET;
 }
 
 // Return true if lbp is in the LB15b follower set
@@ -86,35 +110,32 @@ static inline bool mjb_is_lb15b_follower(mjb_lbp lbp) {
         lbp == MJB_LBP_LF || lbp == MJB_LBP_NL || lbp == MJB_LBP_ZW;
 }
 
-// Line breaking algorithm
-// see: https://www.unicode.org/reports/tr14
-MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_next_line_state *state) {
-    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
-        return MJB_BT_NOT_SET;
-    }
-
-    if(state->index == 0) {
-        // Initialize the state.
-        state->state = MJB_UTF_ACCEPT;
-        state->previous = MJB_LBP_NOT_SET;
-        state->current = MJB_LBP_NOT_SET;
-        state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->in_error = false;
-        state->ri_count = 0;
-        state->zw_seen = false;
-        state->prev_resolved = MJB_LBP_NOT_SET;
-        state->prev_ea = MJB_EAW_NOT_SET;
-        state->qu_prev_ea = MJB_EAW_NOT_SET;
-        state->prev_prev_lbp = MJB_LBP_NOT_SET;
-        state->prev_num_lbp = MJB_LBP_NOT_SET;
-        state->prev_prev_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->pi_qu_context = false;
-        state->cm_merged = false;
-        state->zwj_absorbed = false;
-    }
+static inline void mjb_line_state_init(mjb_next_line_state *state) {
+    state->state = MJB_UTF_ACCEPT;
+    state->previous = MJB_LBP_NOT_SET;
+    state->current = MJB_LBP_NOT_SET;
+    state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->in_error = false;
+    state->ri_count = 0;
+    state->zw_seen = false;
+    state->prev_resolved = MJB_LBP_NOT_SET;
+    state->prev_ea = MJB_EAW_NOT_SET;
+    state->qu_prev_ea = MJB_EAW_NOT_SET;
+    state->prev_prev_lbp = MJB_LBP_NOT_SET;
+    state->prev_num_lbp = MJB_LBP_NOT_SET;
+    state->prev_prev_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->pi_qu_context = false;
+    state->cm_merged = false;
+    state->zwj_absorbed = false;
+    state->codepoint_index = 0;
+    state->lookahead.start = 0;
+    state->lookahead.count = 0;
+}
 
+// The line breaking loop shared by mjb_next_line_break and mjb_line_boundaries.
+static mjb_break_type mjb_line_step(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_line_state *state) {
     if(state->state == MJB_UTF_TERMINATED) {
         return MJB_BT_NOT_SET;
     }
@@ -133,54 +154,62 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
 
     mjb_codepoint codepoint = 0;
     bool first_codepoint = state->index == 0;
-    uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+    size_t codepoint_index = state->index;
 
     for(; state->index < byte_length;) {
-        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state->state,
-            &state->index, encoding, &codepoint, &state->in_error);
+        mjb_lbp lbp;
+        mjb_east_asian_width ea;
+        const mjb_break_lookahead_entry *ahead = NULL;
+
+        if(state->lookahead.count != 0 && state->state == MJB_UTF_ACCEPT) {
+            ahead = mjb_break_lookahead_at(&state->lookahead, state->index);
+        }
+
+        if(ahead != NULL) {
+            // Decoded and classified by a look-ahead rule of the previous step.
+            codepoint_index = ahead->index;
+            codepoint = ahead->codepoint;
+            state->index = ahead->next_index;
+            state->in_error = false;
+            lbp = (mjb_lbp)ahead->resolved;
+            ea = MJB_SEGMENTATION_EAW(ahead->properties);
+            mjb_break_lookahead_pop(&state->lookahead);
+        } else {
+            // A codepoint starts where the decoder is between sequences, also after a code unit
+            // dropped from an ill-formed subsequence.
+            if(state->state == MJB_UTF_ACCEPT) {
+                codepoint_index = state->index;
+            }
 
-        if(decode_status == MJB_DECODE_END) {
-            mjb_mark_decode_terminated(&state->state, &state->index, &state->current_codepoint,
-                encoding);
+            mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length,
+                &state->state, &state->index, encoding, &codepoint, &state->in_error);
 
-            return MJB_BT_ALLOWED;
-        }
+            if(decode_status == MJB_DECODE_END) {
+                mjb_mark_decode_terminated(&state->state, &state->index,
+                    &state->current_codepoint, encoding);
 
-        if(decode_status == MJB_DECODE_INCOMPLETE) {
-            continue;
-        }
+                return MJB_BT_ALLOWED;
+            }
 
-        // LB2 Never break at the start of text.
-        // sot ×
-        // Not needed
+            if(decode_status == MJB_DECODE_INCOMPLETE) {
+                continue;
+            }
 
-        memset(cpb, 0, MJB_PR_BUFFER_SIZE);
+            // LB2 Never break at the start of text.
+            // sot ×
+            // Not needed
 
-        if(mjb_codepoint_properties_lookup(codepoint, cpb) != MJB_STATUS_OK) {
-            continue;
-        }
-
-        mjb_lbp lbp = (mjb_lbp)mjb_codepoint_properties_get(cpb, MJB_PR_LINE_BREAK);
+            mjb_segmentation_properties properties = 0;
 
-        if(lbp == MJB_LBP_NOT_SET) {
-            // # @missing: 0000..10FFFF; XX
-            lbp = MJB_LBP_XX;
-        }
+            if(!mjb_codepoint_segmentation_properties(codepoint, &properties)) {
+                continue;
+            }
 
-        // LB1 Resolve ambiguous and context-dependent classes before applying pairwise rules.
-        // AI, SG, XX -> AL
-        // CJ -> NS
-        // SA -> CM if the codepoint is a non-spacing or spacing-combining mark, otherwise AL
-        if(lbp == MJB_LBP_AI || lbp == MJB_LBP_SG || lbp == MJB_LBP_XX) {
-            lbp = MJB_LBP_AL;
-        } else if(lbp == MJB_LBP_CJ) {
-            lbp = MJB_LBP_NS;
-        } else if(lbp == MJB_LBP_SA) {
-            mjb_category gc = mjb_lbp_category(codepoint);
-            lbp = (gc == MJB_CATEGORY_MN || gc == MJB_CATEGORY_MC) ? MJB_LBP_CM : MJB_LBP_AL;
+            lbp = mjb_resolve_lbp(codepoint, properties);
+            ea = MJB_SEGMENTATION_EAW(properties);
         }
 
-        mjb_east_asian_width ea = (mjb_east_asian_width)cpb[MJB_PR_EAST_ASIAN_WIDTH];
+        state->codepoint_index = codepoint_index;
 
         if(first_codepoint) {
             // First codepoint
@@ -453,7 +482,7 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
         // × [\p{Pf}&QU] ( SP | GL | WJ | CL | QU | CP | EX | IS | SY | BK | CR | LF | NL | ZW |
         // eot) NOTE: This rule must be checked BEFORE LB18 (SP ÷) because it overrides it.
         if(state->current == MJB_LBP_QU && qu_cur_cat == MJB_CATEGORY_PF) {
-            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state->index, encoding, NULL);
+            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state, encoding, NULL);
 
             if(mjb_is_lb15b_follower(next_lbp)) {
                 return MJB_BT_NO_BREAK;
@@ -464,7 +493,7 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
         // SP ÷ IS NU
         // (Requires look-ahead: next after IS must be NU. Implemented below before LB15d.)
         if(state->previous == MJB_LBP_SP && state->current == MJB_LBP_IS) {
-            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state->index, encoding, NULL);
+            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state, encoding, NULL);
 
             if(next_lbp == MJB_LBP_NU) {
                 // SP ÷ IS NU: break between SP and IS
@@ -533,7 +562,7 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
             // Look ahead: check EA of next character (or EOT)
             {
                 mjb_east_asian_width next_ea = MJB_EAW_NOT_SET;
-                mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state->index, encoding,
+                mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state, encoding,
                     &next_ea);
 
                 if(next_lbp == MJB_LBP_NOT_SET || !mjb_is_ea(next_ea)) {
@@ -683,7 +712,7 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
         // (b) At the OP × NU position: confirm prev_prev was PO|PR (redundant safety net).
         if(state->current == MJB_LBP_OP &&
             (state->previous == MJB_LBP_PO || state->previous == MJB_LBP_PR)) {
-            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state->index, encoding, NULL);
+            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state, encoding, NULL);
 
             if(next_lbp == MJB_LBP_NU) {
                 return MJB_BT_NO_BREAK;
@@ -793,7 +822,7 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
                state->previous == MJB_LBP_AS) &&
             (state->current == MJB_LBP_AK || state->current_codepoint == 0x25CC ||
                 state->current == MJB_LBP_AS)) {
-            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state->index, encoding, NULL);
+            mjb_lbp next_lbp = mjb_peek_next(buffer, byte_length, state, encoding, NULL);
 
             if(next_lbp == MJB_LBP_VF) {
                 return MJB_BT_NO_BREAK;
@@ -848,15 +877,14 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
 
             // Check [\p{Extended_Pictographic} & Cn]
             // Cn (unassigned) means the codepoint has no row in unicode_data.
-            uint8_t prev_props[MJB_PR_BUFFER_SIZE] = { 0 };
-            uint8_t ext_pic = 0;
+            mjb_segmentation_properties prev_props = 0;
+            bool ext_pic = false;
 
-            if(mjb_codepoint_properties_lookup(state->previous_codepoint, prev_props) ==
-                MJB_STATUS_OK) {
-                ext_pic = mjb_codepoint_properties_get(prev_props, MJB_PR_EXTENDED_PICTOGRAPHIC);
+            if(mjb_codepoint_segmentation_properties(state->previous_codepoint, &prev_props)) {
+                ext_pic = MJB_SEGMENTATION_EXT_PICT(prev_props);
             }
 
-            if(ext_pic != 0) {
+            if(ext_pic) {
                 // Preserve the previous value, assignment check.
                 bool is_assigned = mjb_unicode_codepoint_assigned(state->previous_codepoint);
 
@@ -876,3 +904,48 @@ MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_le
 
     return MJB_BT_ALLOWED;
 }
+
+// Line breaking algorithm
+// see: https://www.unicode.org/reports/tr14
+MJB_EXPORT mjb_break_type mjb_next_line_break(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_line_state *state) {
+    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
+        return MJB_BT_NOT_SET;
+    }
+
+    if(state->index == 0) {
+        mjb_line_state_init(state);
+    }
+
+    return mjb_line_step(buffer, byte_length, encoding, state);
+}
+
+// Write the line break boundaries of a string to offsets, up to capacity, and return their count.
+size_t mjb_line_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity) {
+    mjb_next_line_state state;
+    state.index = 0;
+    mjb_line_state_init(&state);
+
+    mjb_break_type bt;
+    size_t count = 0;
+    size_t last_break = 0;
+
+    while((bt = mjb_line_step(buffer, byte_length, encoding, &state)) != MJB_BT_NOT_SET) {
+        if(bt == MJB_BT_NO_BREAK) {
+            continue;
+        }
+
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
+
+        if(count < capacity) {
+            offsets[count] = break_pos;
+        }
+
+        ++count;
+        last_break = break_pos;
+    }
+
+    return count;
+}
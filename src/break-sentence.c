@@ -38,13 +38,13 @@ static inline bool mjb_peek_lower_sentence(const char *buffer, size_t byte_lengt
         }
 
         if(dr == MJB_DECODE_OK) {
-            uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+            mjb_segmentation_properties properties = 0;
 
-            if(mjb_codepoint_properties_lookup(peek_cp, cpb) != MJB_STATUS_OK) {
+            if(!mjb_codepoint_segmentation_properties(peek_cp, &properties)) {
                 return false;
             }
 
-            mjb_sbp sbp = (mjb_sbp)mjb_codepoint_properties_get(cpb, MJB_PR_SENTENCE_BREAK);
+            mjb_sbp sbp = MJB_SEGMENTATION_SBP(properties);
 
             if(sbp == MJB_SBP_NOT_SET) {
                 sbp = MJB_SBP_OTHER;
@@ -72,29 +72,24 @@ static inline bool mjb_peek_lower_sentence(const char *buffer, size_t byte_lengt
     return false;
 }
 
-// Sentence boundaries breaking
-// See: https://unicode.org/reports/tr29/
-MJB_EXPORT mjb_break_type mjb_next_sentence_break(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_next_sentence_state *state) {
-    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
-        return MJB_BT_NOT_SET;
-    }
-
-    if(state->index == 0) {
-        // Initialize the state.
-        state->state = MJB_UTF_ACCEPT;
-        state->previous = MJB_SBP_NOT_SET;
-        state->current = MJB_SBP_NOT_SET;
-        state->prev_prev = MJB_SBP_NOT_SET;
-        state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->in_error = false;
-        state->sb5_merged = false;
-        state->in_sat = false;
-        state->sat_has_sp = false;
-        state->sat_is_aterm = false;
-    }
+static inline void mjb_sentence_state_init(mjb_next_sentence_state *state) {
+    state->state = MJB_UTF_ACCEPT;
+    state->previous = MJB_SBP_NOT_SET;
+    state->current = MJB_SBP_NOT_SET;
+    state->prev_prev = MJB_SBP_NOT_SET;
+    state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->in_error = false;
+    state->sb5_merged = false;
+    state->in_sat = false;
+    state->sat_has_sp = false;
+    state->sat_is_aterm = false;
+    state->codepoint_index = 0;
+}
 
+// Apply the SB rules up to the next break opportunity. Arguments are checked by the callers.
+static mjb_break_type mjb_sentence_step(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_sentence_state *state) {
     if(state->state == MJB_UTF_TERMINATED) {
         return MJB_BT_NOT_SET;
     }
@@ -112,9 +107,16 @@ MJB_EXPORT mjb_break_type mjb_next_sentence_break(const char *buffer, size_t byt
 
     mjb_codepoint codepoint = 0;
     bool first_codepoint = state->index == 0;
-    uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+    mjb_segmentation_properties properties = 0;
+    size_t codepoint_index = state->index;
 
     for(; state->index < byte_length;) {
+        // A codepoint starts where the decoder is between sequences, also after a code unit
+        // dropped from an ill-formed subsequence.
+        if(state->state == MJB_UTF_ACCEPT) {
+            codepoint_index = state->index;
+        }
+
         mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state->state,
             &state->index, encoding, &codepoint, &state->in_error);
 
@@ -133,19 +135,19 @@ MJB_EXPORT mjb_break_type mjb_next_sentence_break(const char *buffer, size_t byt
         // SB1 sot ÷ Any
         // Not needed
 
-        memset(cpb, 0, MJB_PR_BUFFER_SIZE);
-
-        if(mjb_codepoint_properties_lookup(codepoint, cpb) != MJB_STATUS_OK) {
+        if(!mjb_codepoint_segmentation_properties(codepoint, &properties)) {
             continue;
         }
 
-        mjb_sbp wbp = (mjb_sbp)mjb_codepoint_properties_get(cpb, MJB_PR_SENTENCE_BREAK);
+        mjb_sbp wbp = MJB_SEGMENTATION_SBP(properties);
 
         if(wbp == MJB_SBP_NOT_SET) {
             // # @missing: 0000..10FFFF; Other
             wbp = MJB_SBP_OTHER;
         }
 
+        state->codepoint_index = codepoint_index;
+
         if(first_codepoint) {
             // First codepoint: store and initialize SAT context if needed.
             state->current = wbp;
@@ -300,6 +302,51 @@ MJB_EXPORT mjb_break_type mjb_next_sentence_break(const char *buffer, size_t byt
     return MJB_BT_ALLOWED;
 }
 
+// Sentence boundaries breaking
+// See: https://unicode.org/reports/tr29/
+MJB_EXPORT mjb_break_type mjb_next_sentence_break(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_sentence_state *state) {
+    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
+        return MJB_BT_NOT_SET;
+    }
+
+    if(state->index == 0) {
+        mjb_sentence_state_init(state);
+    }
+
+    return mjb_sentence_step(buffer, byte_length, encoding, state);
+}
+
+// Write the sentence boundaries of a string to offsets, up to capacity, and return their count.
+size_t mjb_sentence_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity) {
+    mjb_next_sentence_state state;
+    state.index = 0;
+    mjb_sentence_state_init(&state);
+
+    mjb_break_type bt;
+    size_t count = 0;
+    size_t last_break = 0;
+
+    while((bt = mjb_sentence_step(buffer, byte_length, encoding, &state)) != MJB_BT_NOT_SET) {
+        if(bt == MJB_BT_NO_BREAK) {
+            continue;
+        }
+
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
+
+        if(count < capacity) {
+            offsets[count] = break_pos;
+        }
+
+        ++count;
+        last_break = break_pos;
+    }
+
+    return count;
+}
+
 // Count the sentence segments in a string.
 MJB_EXPORT mjb_status mjb_sentence_count(const char *buffer, size_t byte_length,
     mjb_encoding encoding, size_t *count) {
@@ -11,16 +11,43 @@
 
 extern mojibake mjb_global;
 
+static inline mjb_wbp mjb_resolve_wbp(mjb_segmentation_properties properties) {
+    mjb_wbp wbp = MJB_SEGMENTATION_WBP(properties);
+
+    // # @missing: 0000..10FFFF; Other
+    return wbp == MJB_WBP_NOT_SET ? MJB_WBP_OTHER : wbp;
+}
+
+static inline bool mjb_is_wb4_transparent(mjb_wbp wbp) {
+    return wbp == MJB_WBP_EXTEND || wbp == MJB_WBP_FORMAT || wbp == MJB_WBP_ZWJ;
+}
+
 // Peek at the next codepoint's WBP (for look-ahead rules WB6, WB7b, WB12).
 // When skip_wb4 is true, Extend/Format/ZWJ characters are skipped (WB4 transparency).
-static inline mjb_wbp mjb_peek_next_word(const char *buffer, size_t byte_length, size_t peek_index,
-    mjb_encoding encoding, bool skip_wb4) {
+// The codepoints read are kept in the look-ahead of the state, so the steps that reach them and
+// later peeks reuse them.
+static inline mjb_wbp mjb_peek_next_word(const char *buffer, size_t byte_length,
+    mjb_next_word_state *state, mjb_encoding encoding, bool skip_wb4) {
+    size_t peek_index = state->index;
+    const mjb_break_lookahead_entry *entry = mjb_break_lookahead_at(&state->lookahead,
+        peek_index);
+
+    for(; entry != NULL; entry = mjb_break_lookahead_next(&state->lookahead, entry)) {
+        mjb_wbp wbp = (mjb_wbp)entry->resolved;
+
+        if(!skip_wb4 || !mjb_is_wb4_transparent(wbp)) {
+            return wbp;
+        }
+
+        peek_index = entry->next_index;
+    }
+
     uint8_t peek_state = MJB_UTF_ACCEPT;
     mjb_codepoint peek_cp = 0;
     bool peek_error = false;
-    size_t i = peek_index;
 
-    for(; i < byte_length;) {
+    for(;;) {
+        size_t start = peek_index;
         mjb_decode_result dr = mjb_next_codepoint(buffer, byte_length, &peek_state, &peek_index,
             encoding, &peek_cp, &peek_error);
 
@@ -29,54 +56,47 @@ static inline mjb_wbp mjb_peek_next_word(const char *buffer, size_t byte_length,
         }
 
         if(dr == MJB_DECODE_OK) {
-            uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+            mjb_segmentation_properties properties = 0;
 
-            if(mjb_codepoint_properties_lookup(peek_cp, cpb) != MJB_STATUS_OK) {
+            if(!mjb_codepoint_segmentation_properties(peek_cp, &properties)) {
                 return MJB_WBP_NOT_SET;
             }
 
-            mjb_wbp wbp = (mjb_wbp)mjb_codepoint_properties_get(cpb, MJB_PR_WORD_BREAK);
-
-            if(wbp == MJB_WBP_NOT_SET) {
-                wbp = MJB_WBP_OTHER;
-            }
+            mjb_wbp wbp = mjb_resolve_wbp(properties);
+            mjb_break_lookahead_push(&state->lookahead, state->index, start, peek_index, peek_cp,
+                properties, (uint8_t)wbp);
 
             // Skip WB4-transparent characters (Extend, Format, ZWJ).
-            if(skip_wb4 && (wbp == MJB_WBP_EXTEND || wbp == MJB_WBP_FORMAT || wbp == MJB_WBP_ZWJ)) {
+            if(skip_wb4 && mjb_is_wb4_transparent(wbp)) {
                 continue;
             }
 
             return wbp;
         }
     }
+}
 
-    return MJB_WBP_NOT_SET;
+static inline void mjb_word_state_init(mjb_next_word_state *state) {
+    state->state = MJB_UTF_ACCEPT;
+    state->previous = MJB_WBP_NOT_SET;
+    state->current = MJB_WBP_NOT_SET;
+    state->prev_prev_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->prev_prev_wbp = MJB_WBP_NOT_SET;
+    state->in_error = false;
+    state->ri_count = 0;
+    state->wb4_merged = false;
+    state->zwj_pending = false;
+    state->prev_was_zwj = false;
+    state->codepoint_index = 0;
+    state->lookahead.start = 0;
+    state->lookahead.count = 0;
 }
 
-// Word cluster breaking
-// See: https://unicode.org/reports/tr29/
-MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_length,
+// The body of mjb_next_word_break, past the argument checks and the state initialization.
+static mjb_break_type mjb_word_step(const char *buffer, size_t byte_length,
     mjb_encoding encoding, mjb_next_word_state *state) {
-    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
-        return MJB_BT_NOT_SET;
-    }
-
-    if(state->index == 0) {
-        // Initialize the state.
-        state->state = MJB_UTF_ACCEPT;
-        state->previous = MJB_WBP_NOT_SET;
-        state->current = MJB_WBP_NOT_SET;
-        state->prev_prev_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->prev_prev_wbp = MJB_WBP_NOT_SET;
-        state->in_error = false;
-        state->ri_count = 0;
-        state->wb4_merged = false;
-        state->zwj_pending = false;
-        state->prev_was_zwj = false;
-    }
-
     if(state->state == MJB_UTF_TERMINATED) {
         return MJB_BT_NOT_SET;
     }
@@ -94,40 +114,60 @@ MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_le
 
     mjb_codepoint codepoint = 0;
     bool first_codepoint = state->index == 0;
-    uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+    mjb_segmentation_properties properties = 0;
+    size_t codepoint_index = state->index;
 
     for(; state->index < byte_length;) {
-        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state->state,
-            &state->index, encoding, &codepoint, &state->in_error);
+        mjb_wbp wbp;
+        const mjb_break_lookahead_entry *ahead = NULL;
+
+        if(state->lookahead.count != 0 && state->state == MJB_UTF_ACCEPT) {
+            ahead = mjb_break_lookahead_at(&state->lookahead, state->index);
+        }
+
+        if(ahead != NULL) {
+            // Decoded and classified by a look-ahead rule of an earlier step.
+            codepoint_index = ahead->index;
+            codepoint = ahead->codepoint;
+            state->index = ahead->next_index;
+            state->in_error = false;
+            properties = ahead->properties;
+            wbp = (mjb_wbp)ahead->resolved;
+            mjb_break_lookahead_pop(&state->lookahead);
+        } else {
+            // A codepoint starts where the decoder is between sequences, also after a code unit
+            // dropped from an ill-formed subsequence.
+            if(state->state == MJB_UTF_ACCEPT) {
+                codepoint_index = state->index;
+            }
 
-        if(decode_status == MJB_DECODE_END) {
-            mjb_mark_decode_terminated(&state->state, &state->index, &state->current_codepoint,
-                encoding);
+            mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length,
+                &state->state, &state->index, encoding, &codepoint, &state->in_error);
 
-            return MJB_BT_ALLOWED;
-        }
+            if(decode_status == MJB_DECODE_END) {
+                mjb_mark_decode_terminated(&state->state, &state->index,
+                    &state->current_codepoint, encoding);
 
-        if(decode_status == MJB_DECODE_INCOMPLETE) {
-            continue;
-        }
+                return MJB_BT_ALLOWED;
+            }
 
-        // Break at the start and end of text, unless the text is empty.
-        // WB1 sot ÷ Any
-        // Not needed
+            if(decode_status == MJB_DECODE_INCOMPLETE) {
+                continue;
+            }
 
-        memset(cpb, 0, MJB_PR_BUFFER_SIZE);
+            // Break at the start and end of text, unless the text is empty.
+            // WB1 sot ÷ Any
+            // Not needed
 
-        if(mjb_codepoint_properties_lookup(codepoint, cpb) != MJB_STATUS_OK) {
-            continue;
-        }
-
-        mjb_wbp wbp = (mjb_wbp)mjb_codepoint_properties_get(cpb, MJB_PR_WORD_BREAK);
+            if(!mjb_codepoint_segmentation_properties(codepoint, &properties)) {
+                continue;
+            }
 
-        if(wbp == MJB_WBP_NOT_SET) {
-            // # @missing: 0000..10FFFF; Other
-            wbp = MJB_WBP_OTHER;
+            wbp = mjb_resolve_wbp(properties);
         }
 
+        state->codepoint_index = codepoint_index;
+
         if(first_codepoint) {
             // First codepoint
             state->current = wbp;
@@ -184,7 +224,7 @@ MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_le
 
         // Do not break within emoji zwj sequences.
         // WB3c ZWJ × \p{Extended_Pictographic}
-        if(state->prev_was_zwj && mjb_codepoint_properties_get(cpb, MJB_PR_EXTENDED_PICTOGRAPHIC)) {
+        if(state->prev_was_zwj && MJB_SEGMENTATION_EXT_PICT(properties)) {
             return MJB_BT_NO_BREAK;
         }
 
@@ -225,7 +265,7 @@ MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_le
         if((state->previous == MJB_WBP_A_LETTER || state->previous == MJB_WBP_HEBREW_LETTER) &&
             (state->current == MJB_WBP_MID_LETTER || state->current == MJB_WBP_MID_NUM_LET ||
                 state->current == MJB_WBP_SINGLE_QUOTE)) {
-            mjb_wbp next_wbp = mjb_peek_next_word(buffer, byte_length, state->index, encoding,
+            mjb_wbp next_wbp = mjb_peek_next_word(buffer, byte_length, state, encoding,
                 true);
 
             if(next_wbp == MJB_WBP_A_LETTER || next_wbp == MJB_WBP_HEBREW_LETTER) {
@@ -250,7 +290,7 @@ MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_le
         // WB7b Hebrew_Letter × Double_Quote Hebrew_Letter
         // (look-ahead: next effective char must be Hebrew_Letter)
         if(state->previous == MJB_WBP_HEBREW_LETTER && state->current == MJB_WBP_DOUBLE_QUOTE) {
-            mjb_wbp next_wbp = mjb_peek_next_word(buffer, byte_length, state->index, encoding,
+            mjb_wbp next_wbp = mjb_peek_next_word(buffer, byte_length, state, encoding,
                 true);
 
             if(next_wbp == MJB_WBP_HEBREW_LETTER) {
@@ -296,7 +336,7 @@ MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_le
         if(state->previous == MJB_WBP_NUMERIC &&
             (state->current == MJB_WBP_MID_NUM || state->current == MJB_WBP_MID_NUM_LET ||
                 state->current == MJB_WBP_SINGLE_QUOTE)) {
-            mjb_wbp next_wbp = mjb_peek_next_word(buffer, byte_length, state->index, encoding,
+            mjb_wbp next_wbp = mjb_peek_next_word(buffer, byte_length, state, encoding,
                 true);
 
             if(next_wbp == MJB_WBP_NUMERIC) {
@@ -349,6 +389,51 @@ MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_le
     return MJB_BT_ALLOWED;
 }
 
+// Word cluster breaking
+// See: https://unicode.org/reports/tr29/
+MJB_EXPORT mjb_break_type mjb_next_word_break(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_word_state *state) {
+    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
+        return MJB_BT_NOT_SET;
+    }
+
+    if(state->index == 0) {
+        mjb_word_state_init(state);
+    }
+
+    return mjb_word_step(buffer, byte_length, encoding, state);
+}
+
+// Write the word boundaries of a string to offsets, up to capacity, and return their count.
+size_t mjb_word_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity) {
+    mjb_next_word_state state;
+    state.index = 0;
+    mjb_word_state_init(&state);
+
+    mjb_break_type bt;
+    size_t count = 0;
+    size_t last_break = 0;
+
+    while((bt = mjb_word_step(buffer, byte_length, encoding, &state)) != MJB_BT_NOT_SET) {
+        if(bt == MJB_BT_NO_BREAK) {
+            continue;
+        }
+
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
+
+        if(count < capacity) {
+            offsets[count] = break_pos;
+        }
+
+        ++count;
+        last_break = break_pos;
+    }
+
+    return count;
+}
+
 // Return the number of bytes that form the first max_segments word-break segments.
 MJB_EXPORT size_t mjb_truncate_word(const char *buffer, size_t byte_length, mjb_encoding encoding,
     size_t max_segments) {
@@ -373,8 +458,8 @@ MJB_EXPORT size_t mjb_truncate_word(const char *buffer, size_t byte_length, mjb_
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state.index, byte_length,
-            state.current_codepoint, encoding, state.state == MJB_UTF_TERMINATED, last_break);
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
         last_break = break_pos;
 
         if(++segment_count >= max_segments) {
@@ -462,8 +547,8 @@ MJB_EXPORT mjb_status mjb_word_count(const char *buffer, size_t byte_length, mjb
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state.index, byte_length,
-            state.current_codepoint, encoding, state.state == MJB_UTF_TERMINATED, last_break);
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
 
         if(break_pos > last_break &&
             mjb_segment_is_word_like(buffer + last_break, break_pos - last_break, encoding)) {
@@ -502,8 +587,8 @@ MJB_EXPORT size_t mjb_truncate_word_width(const char *buffer, size_t byte_length
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state.index, byte_length,
-            state.current_codepoint, encoding, state.state == MJB_UTF_TERMINATED, prev_break);
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, prev_break);
         size_t segment_width = 0;
 
         if(mjb_terminal_width(buffer + prev_break, break_pos - prev_break, encoding, profile,
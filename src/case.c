@@ -30,22 +30,22 @@ typedef struct mjb_map_case_context {
 
 // Cased: Lu, Ll and Lt plus Other_Uppercase and Other_Lowercase.
 static bool mjb_is_cased(mjb_codepoint codepoint) {
-    return mjb_unicode_has_property(codepoint, MJB_PR_CASED, NULL);
+    mjb_codepoint_record record;
+
+    return mjb_unicode_record_lookup(codepoint, &record) && record.cased;
 }
 
 // Characters that do not interrupt a casing context, like combining marks and apostrophes.
 static bool mjb_is_case_ignorable(mjb_codepoint codepoint) {
-    return mjb_unicode_has_property(codepoint, MJB_PR_CASE_IGNORABLE, NULL);
+    mjb_codepoint_record record;
+
+    return mjb_unicode_record_lookup(codepoint, &record) && record.case_ignorable;
 }
 
 static uint8_t mjb_combining_class(mjb_codepoint codepoint) {
-    mjb_n_character character;
-
-    if(!mjb_unicode_n_character_lookup(codepoint, &character)) {
-        return 0;
-    }
+    mjb_codepoint_record record;
 
-    return character.combining;
+    return mjb_unicode_record_lookup(codepoint, &record) ? record.combining : 0;
 }
 
 static void mjb_map_case_lookup_or_identity(mjb_codepoint codepoint,
@@ -60,21 +60,25 @@ static void mjb_map_case_lookup_or_identity(mjb_codepoint codepoint,
     mapping->lowercase = 0;
     mapping->titlecase = 0;
 
-    if(mjb_unicode_category_lookup(codepoint, &mapping->category)) {
-        return;
-    }
-
-    mjb_character character;
+    mjb_codepoint_record record;
 
-    if(mjb_codepoint_info(codepoint, &character) == MJB_STATUS_OK) {
-        mapping->category = character.category;
+    if(mjb_codepoint_record_lookup(codepoint, &record)) {
+        mapping->category = (mjb_category)record.category;
     }
 }
 
 static void mjb_map_case_context_update(mjb_map_case_context *context, mjb_codepoint codepoint) {
-    if(mjb_is_cased(codepoint)) {
+    mjb_codepoint_record record;
+
+    if(!mjb_unicode_record_lookup(codepoint, &record)) {
+        record.combining = MJB_CCC_NOT_REORDERED;
+        record.cased = false;
+        record.case_ignorable = false;
+    }
+
+    if(record.cased) {
         context->preceded_by_cased = true;
-    } else if(!mjb_is_case_ignorable(codepoint)) {
+    } else if(!record.case_ignorable) {
         context->preceded_by_cased = false;
     }
 
@@ -82,7 +86,7 @@ static void mjb_map_case_context_update(mjb_map_case_context *context, mjb_codep
         return;
     }
 
-    uint8_t combining = mjb_combining_class(codepoint);
+    uint8_t combining = record.combining;
 
     if(codepoint == 0x49) { // U+0049 LATIN CAPITAL LETTER I
         context->after_i = true;
@@ -153,8 +157,8 @@ static size_t mjb_titlecase_next_word_boundary(const char *buffer, size_t byte_l
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state->index, byte_length,
-            state->current_codepoint, encoding, state->state == MJB_UTF_TERMINATED, previous);
+        size_t break_pos = mjb_break_boundary_position(state->index, byte_length,
+            state->codepoint_index, state->state == MJB_UTF_TERMINATED, previous);
 
         if(break_pos > previous) {
             return break_pos;
@@ -522,28 +526,13 @@ static mjb_status mjb_map_case_process(const char *buffer, size_t byte_length,
                 continue;
             }
 
-            const mjb_codepoint *values = NULL;
-            uint8_t length = 0;
-
-            if(mjb_unicode_case_folding_lookup(codepoint, &values, &length)) {
-                // A single codepoint is a common (C) fold, valid for both folding types. A
-                // multi-char fold is full (F) only: without a simple (S) alternative, simple
-                // folding maps the character to itself.
-                if(type == MJB_CASE_CASEFOLD_SIMPLE) {
-                    mjb_status status = mjb_map_case_output_codepoint(length == 1 ? values[0] :
-                                                                                    codepoint,
-                        output, output_encoding);
-
-                    if(status != MJB_STATUS_OK) {
-                        return status;
-                    }
-
-                    continue;
-                }
-
+            if(type == MJB_CASE_CASEFOLD) {
                 // Emit up to 3 mapped codepoints (F entries have 2-3, C exceptions have 1)
+                mjb_codepoint folded[3];
+                uint8_t length = mjb_casefold_codepoint(codepoint, folded);
+
                 for(uint8_t k = 0; k < length; ++k) {
-                    mjb_status status = mjb_map_case_output_codepoint(values[k], output,
+                    mjb_status status = mjb_map_case_output_codepoint(folded[k], output,
                         output_encoding);
 
                     if(status != MJB_STATUS_OK) {
@@ -554,19 +543,29 @@ static mjb_status mjb_map_case_process(const char *buffer, size_t byte_length,
                 continue;
             }
 
-            // Common one-codepoint folds that equal the lowercase mapping are omitted from the
-            // compact fold table.
-            // Changes_When_Casefolded distinguishes them from true identity mappings, including
-            // uppercase Cherokee.
-            mjb_unicode_case_mapping mapping;
+            const mjb_codepoint *values = NULL;
+            uint8_t length = 0;
 
-            if(mjb_codepoint_has_binary_property(codepoint, MJB_PR_CHANGES_WHEN_CASEFOLDED) &&
-                mjb_unicode_case_lookup(codepoint, &mapping) && mapping.lowercase != 0) {
-                codepoint = mapping.lowercase;
+            // A single codepoint is a common (C) fold, valid for both folding types. A multi-char
+            // fold is full (F) only: without a simple (S) alternative, simple folding maps the
+            // character to itself.
+            if(mjb_unicode_case_folding_lookup(codepoint, &values, &length)) {
+                mjb_status status = mjb_map_case_output_codepoint(length == 1 ? values[0] :
+                                                                                codepoint,
+                    output, output_encoding);
+
+                if(status != MJB_STATUS_OK) {
+                    return status;
+                }
+
+                continue;
             }
 
+            mjb_codepoint folded[3];
+            mjb_casefold_codepoint(codepoint, folded);
+
             // Identity: codepoint unchanged if no lowercase found
-            mjb_status status = mjb_map_case_output_codepoint(codepoint, output, output_encoding);
+            mjb_status status = mjb_map_case_output_codepoint(folded[0], output, output_encoding);
 
             if(status != MJB_STATUS_OK) {
                 return status;
@@ -751,6 +750,40 @@ MJB_EXPORT mjb_status mjb_map_case(const char *buffer, size_t byte_length, mjb_e
         turkic_case_folding, result);
 }
 
+uint8_t mjb_casefold_codepoint(mjb_codepoint codepoint, mjb_codepoint *folded) {
+    if(codepoint < 0x80) {
+        folded[0] = codepoint >= 'A' && codepoint <= 'Z' ? codepoint + 0x20 : codepoint;
+
+        return 1;
+    }
+
+    const mjb_codepoint *values = NULL;
+    uint8_t length = 0;
+
+    if(mjb_unicode_case_folding_lookup(codepoint, &values, &length)) {
+        for(uint8_t i = 0; i < length; ++i) {
+            folded[i] = values[i];
+        }
+
+        return length;
+    }
+
+    // Common one-codepoint folds that equal the lowercase mapping are omitted from the compact
+    // fold table.
+    // Changes_When_Casefolded distinguishes them from true identity mappings, including uppercase
+    // Cherokee.
+    mjb_unicode_case_mapping mapping;
+
+    if(mjb_codepoint_has_binary_property(codepoint, MJB_PR_CHANGES_WHEN_CASEFOLDED) &&
+        mjb_unicode_case_lookup(codepoint, &mapping) && mapping.lowercase != 0) {
+        codepoint = mapping.lowercase;
+    }
+
+    folded[0] = codepoint;
+
+    return 1;
+}
+
 mjb_status mjb_casefold_default(const char *buffer, size_t byte_length, mjb_encoding encoding,
     mjb_encoding output_encoding, mjb_result *result) {
     if(result == NULL || (buffer == NULL && byte_length > 0)) {
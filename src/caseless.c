@@ -7,6 +7,8 @@
 #include <string.h>
 
 #include "mojibake-internal.h"
+#include "unicode-tables.h"
+#include "unicode.h"
 #include "utf.h"
 
 typedef struct mjb_caseless_value {
@@ -135,6 +137,355 @@ static mjb_status mjb_caseless_transform(mjb_caseless_value *value, mjb_caseless
     return MJB_STATUS_INVALID_ARGUMENT;
 }
 
+/*
+    Streaming caseless matching. Every step of a caseless transform maps codepoints one at a time,
+    and the decompositions are followed by canonical ordering, which only sorts the combining
+    characters between two starters. Both strings are pushed through the steps one codepoint at a
+    time and compared as soon as both sides produce output, without intermediate strings.
+*/
+typedef enum mjb_caseless_step {
+    MJB_CASELESS_STEP_FOLD,
+    MJB_CASELESS_STEP_NFD,
+    MJB_CASELESS_STEP_NFKD
+} mjb_caseless_step;
+
+#define MJB_CASELESS_MAX_STEPS 5
+
+// Same size as the combining characters buffer of mjb_normalize, which sorts at most that many.
+#define MJB_CASELESS_RUN_SIZE 32
+
+// The output of one input codepoint, flushed runs included.
+#define MJB_CASELESS_QUEUE_SIZE 128
+
+// A starter and the combining characters after it, waiting for canonical ordering.
+typedef struct mjb_caseless_run {
+    mjb_codepoint codepoints[MJB_CASELESS_RUN_SIZE];
+    uint8_t combining[MJB_CASELESS_RUN_SIZE];
+    size_t count;
+} mjb_caseless_run;
+
+typedef struct mjb_caseless_stream {
+    const char *buffer;
+    size_t byte_length;
+    mjb_encoding encoding;
+    size_t index;
+    uint8_t state;
+    bool in_error;
+    bool end;
+    const mjb_caseless_step *steps;
+    size_t step_count;
+    mjb_caseless_run runs[MJB_CASELESS_MAX_STEPS];
+    mjb_codepoint queue[MJB_CASELESS_QUEUE_SIZE];
+    size_t queue_first;
+    size_t queue_count;
+} mjb_caseless_stream;
+
+// toCasefold(X) is the first fold, the others make the transform idempotent.
+static const mjb_caseless_step mjb_caseless_unnormalized_steps[] = { MJB_CASELESS_STEP_FOLD };
+static const mjb_caseless_step mjb_caseless_canonical_steps[] = { MJB_CASELESS_STEP_NFD,
+    MJB_CASELESS_STEP_FOLD, MJB_CASELESS_STEP_NFD };
+static const mjb_caseless_step mjb_caseless_compatibility_steps[] = { MJB_CASELESS_STEP_NFD,
+    MJB_CASELESS_STEP_FOLD, MJB_CASELESS_STEP_NFKD, MJB_CASELESS_STEP_FOLD,
+    MJB_CASELESS_STEP_NFKD };
+
+static bool mjb_caseless_push(mjb_caseless_stream *stream, size_t step, mjb_codepoint codepoint);
+
+// The steps of a mode. Returns false for the identifier mode: NFKC_Casefold repeats its transform
+// until it is stable.
+static bool mjb_caseless_steps(mjb_caseless_mode mode, const mjb_caseless_step **steps,
+    size_t *step_count) {
+    switch(mode) {
+        case MJB_CASELESS_UNNORMALIZED:
+            *steps = mjb_caseless_unnormalized_steps;
+            *step_count = sizeof(mjb_caseless_unnormalized_steps) / sizeof(mjb_caseless_step);
+
+            return true;
+
+        case MJB_CASELESS_CANONICAL:
+            *steps = mjb_caseless_canonical_steps;
+            *step_count = sizeof(mjb_caseless_canonical_steps) / sizeof(mjb_caseless_step);
+
+            return true;
+
+        case MJB_CASELESS_COMPATIBILITY:
+            *steps = mjb_caseless_compatibility_steps;
+            *step_count = sizeof(mjb_caseless_compatibility_steps) / sizeof(mjb_caseless_step);
+
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+// Sort the run by combining class and pass it to the next step.
+static bool mjb_caseless_flush(mjb_caseless_stream *stream, size_t step) {
+    mjb_caseless_run *run = &stream->runs[step];
+
+    for(size_t i = 1; i < run->count; ++i) {
+        mjb_codepoint codepoint = run->codepoints[i];
+        uint8_t combining = run->combining[i];
+        size_t j = i;
+
+        while(j > 0 && run->combining[j - 1] > combining) {
+            run->codepoints[j] = run->codepoints[j - 1];
+            run->combining[j] = run->combining[j - 1];
+            --j;
+        }
+
+        run->codepoints[j] = codepoint;
+        run->combining[j] = combining;
+    }
+
+    // The next steps have runs of their own, this one is not touched until it is emptied.
+    for(size_t i = 0; i < run->count; ++i) {
+        if(!mjb_caseless_push(stream, step + 1, run->codepoints[i])) {
+            return false;
+        }
+    }
+
+    run->count = 0;
+
+    return true;
+}
+
+// Append a decomposed character, flushing the run at a starter or when it is full as
+// mjb_normalize does.
+static bool mjb_caseless_append(mjb_caseless_stream *stream, size_t step, mjb_codepoint codepoint,
+    uint8_t combining) {
+    mjb_caseless_run *run = &stream->runs[step];
+
+    if(run->count != 0 &&
+        (combining == MJB_CCC_NOT_REORDERED || run->count == MJB_CASELESS_RUN_SIZE)) {
+        if(!mjb_caseless_flush(stream, step)) {
+            return false;
+        }
+    }
+
+    run->codepoints[run->count] = codepoint;
+    run->combining[run->count] = combining;
+    ++run->count;
+
+    return true;
+}
+
+// Decompose a codepoint like mjb_normalize with the NFD or NFKD form.
+static bool mjb_caseless_decompose(mjb_caseless_stream *stream, size_t step,
+    mjb_codepoint codepoint, bool compatibility) {
+    // ASCII is made of starters without decompositions.
+    if(codepoint < 0x80) {
+        return mjb_caseless_append(stream, step, codepoint, MJB_CCC_NOT_REORDERED);
+    }
+
+    mjb_n_character character;
+
+    if(!mjb_n_codepoint_character(codepoint, &character)) {
+        return true;
+    }
+
+    if(mjb_codepoint_is_hangul_syllable(codepoint)) {
+        mjb_codepoint jamo[3];
+
+        if(mjb_hangul_syllable_decomposition(codepoint, jamo) != MJB_STATUS_OK) {
+            return true;
+        }
+
+        for(size_t i = 0; i < 3; ++i) {
+            mjb_n_character decomposed;
+
+            if(jamo[i] != 0 && mjb_n_codepoint_character(jamo[i], &decomposed) &&
+                !mjb_caseless_append(stream, step, jamo[i], decomposed.combining)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    if(compatibility || character.decomposition == MJB_DECOMPOSITION_CANONICAL) {
+        const mjb_codepoint *decompositions = NULL;
+        uint8_t decomposition_count = 0;
+        size_t appended = 0;
+
+        if(mjb_unicode_decomposition_lookup(codepoint, compatibility, &decompositions,
+               &decomposition_count)) {
+            for(uint8_t i = 0; i < decomposition_count; ++i) {
+                mjb_n_character decomposed;
+
+                if(decompositions[i] == MJB_CODEPOINT_NOT_VALID ||
+                    !mjb_n_codepoint_character(decompositions[i], &decomposed)) {
+                    continue;
+                }
+
+                if(!mjb_caseless_append(stream, step, decompositions[i], decomposed.combining)) {
+                    return false;
+                }
+
+                ++appended;
+            }
+        }
+
+        if(appended != 0) {
+            return true;
+        }
+    }
+
+    return mjb_caseless_append(stream, step, codepoint, character.combining);
+}
+
+// Pass a codepoint to a step, or to the output queue after the last one. Returns false if the
+// queue is full.
+static bool mjb_caseless_push(mjb_caseless_stream *stream, size_t step, mjb_codepoint codepoint) {
+    if(step == stream->step_count) {
+        if(stream->queue_count == MJB_CASELESS_QUEUE_SIZE) {
+            return false;
+        }
+
+        stream->queue[stream->queue_count++] = codepoint;
+
+        return true;
+    }
+
+    switch(stream->steps[step]) {
+        case MJB_CASELESS_STEP_FOLD: {
+            mjb_codepoint folded[3];
+            uint8_t length = mjb_casefold_codepoint(codepoint, folded);
+
+            for(uint8_t i = 0; i < length; ++i) {
+                if(!mjb_caseless_push(stream, step + 1, folded[i])) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        case MJB_CASELESS_STEP_NFD:
+            return mjb_caseless_decompose(stream, step, codepoint, false);
+
+        case MJB_CASELESS_STEP_NFKD:
+            return mjb_caseless_decompose(stream, step, codepoint, true);
+    }
+
+    return true;
+}
+
+static void mjb_caseless_stream_init(mjb_caseless_stream *stream, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, const mjb_caseless_step *steps,
+    size_t step_count) {
+    stream->buffer = buffer;
+    stream->byte_length = byte_length;
+    stream->encoding = encoding;
+    stream->index = 0;
+    stream->state = MJB_UTF_ACCEPT;
+    stream->in_error = false;
+    stream->end = false;
+    stream->steps = steps;
+    stream->step_count = step_count;
+    stream->queue_first = 0;
+    stream->queue_count = 0;
+
+    for(size_t i = 0; i < step_count; ++i) {
+        stream->runs[i].count = 0;
+    }
+}
+
+// Refill the empty output queue from the next input codepoint, or from the runs at the end.
+static bool mjb_caseless_stream_next(mjb_caseless_stream *stream) {
+    mjb_codepoint codepoint = 0;
+
+    stream->queue_first = 0;
+    stream->queue_count = 0;
+
+    while(stream->index < stream->byte_length) {
+        mjb_decode_result result = mjb_next_codepoint(stream->buffer, stream->byte_length,
+            &stream->state, &stream->index, stream->encoding, &codepoint, &stream->in_error);
+
+        if(result == MJB_DECODE_END) {
+            break;
+        }
+
+        if(result != MJB_DECODE_INCOMPLETE) {
+            return mjb_caseless_push(stream, 0, codepoint);
+        }
+    }
+
+    stream->end = true;
+
+    for(size_t i = 0; i < stream->step_count; ++i) {
+        if(!mjb_caseless_flush(stream, i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Compare the transformed strings as they are produced, stopping at the first difference. Returns
+ * false if a string needs more buffering than the streams have, the caller then transforms it
+ * whole.
+ */
+static bool mjb_caseless_stream_match(const char *s1, size_t s1_byte_length,
+    mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding,
+    mjb_caseless_mode mode, bool *matches) {
+    const mjb_caseless_step *steps;
+    size_t step_count;
+
+    if(!mjb_caseless_steps(mode, &steps, &step_count)) {
+        return false;
+    }
+
+    mjb_caseless_stream streams[2];
+    mjb_caseless_stream_init(&streams[0], s1, s1_byte_length, s1_encoding, steps, step_count);
+    mjb_caseless_stream_init(&streams[1], s2, s2_byte_length, s2_encoding, steps, step_count);
+
+    while(true) {
+        for(size_t i = 0; i < 2; ++i) {
+            mjb_caseless_stream *stream = &streams[i];
+
+            while(stream->queue_first == stream->queue_count && !stream->end) {
+                if(!mjb_caseless_stream_next(stream)) {
+                    return false;
+                }
+            }
+        }
+
+        bool left_empty = streams[0].queue_first == streams[0].queue_count;
+        bool right_empty = streams[1].queue_first == streams[1].queue_count;
+
+        if(left_empty || right_empty) {
+            *matches = left_empty && right_empty;
+
+            return true;
+        }
+
+        if(streams[0].queue[streams[0].queue_first++] !=
+            streams[1].queue[streams[1].queue_first++]) {
+            *matches = false;
+
+            return true;
+        }
+    }
+}
+
+// Resolve the length of an input and check that it is well-formed.
+static mjb_status mjb_caseless_input(const char *buffer, size_t *byte_length,
+    mjb_encoding encoding) {
+    if(buffer == NULL && *byte_length > 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_status status = mjb_resolve_input_byte_length(buffer, byte_length, encoding);
+
+    if(status != MJB_STATUS_OK || *byte_length == 0) {
+        return status;
+    }
+
+    return mjb_validate_code_unit_sequence(buffer, *byte_length, encoding);
+}
+
 MJB_EXPORT mjb_status mjb_caseless_match(const char *s1, size_t s1_byte_length,
     mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding,
     mjb_caseless_mode mode, bool *matches) {
@@ -144,39 +495,27 @@ MJB_EXPORT mjb_status mjb_caseless_match(const char *s1, size_t s1_byte_length,
 
     *matches = false;
 
-    if(!mjb_caseless_mode_is_valid(mode) || (s1 == NULL && s1_byte_length > 0) ||
-        (s2 == NULL && s2_byte_length > 0)) {
+    if(!mjb_caseless_mode_is_valid(mode)) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
     // First string.
-    mjb_status status = mjb_resolve_input_byte_length(s1, &s1_byte_length, s1_encoding);
+    mjb_status status = mjb_caseless_input(s1, &s1_byte_length, s1_encoding);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
     // Second string.
-    status = mjb_resolve_input_byte_length(s2, &s2_byte_length, s2_encoding);
+    status = mjb_caseless_input(s2, &s2_byte_length, s2_encoding);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    if(s1_byte_length > 0) {
-        status = mjb_validate_code_unit_sequence(s1, s1_byte_length, s1_encoding);
-
-        if(status != MJB_STATUS_OK) {
-            return status;
-        }
-    }
-
-    if(s2_byte_length > 0) {
-        status = mjb_validate_code_unit_sequence(s2, s2_byte_length, s2_encoding);
-
-        if(status != MJB_STATUS_OK) {
-            return status;
-        }
+    if(mjb_caseless_stream_match(s1, s1_byte_length, s1_encoding, s2, s2_byte_length, s2_encoding,
+           mode, matches)) {
+        return MJB_STATUS_OK;
     }
 
     mjb_caseless_value left = { s1, s1_byte_length, s1_encoding, false };
@@ -197,3 +536,96 @@ MJB_EXPORT mjb_status mjb_caseless_match(const char *s1, size_t s1_byte_length,
 
     return status;
 }
+
+// 64-bit FNV-1a of the UTF-8 bytes of a codepoint.
+static uint64_t mjb_caseless_hash_codepoint(uint64_t hash, mjb_codepoint codepoint) {
+    uint8_t bytes[4];
+    size_t length;
+
+    if(codepoint < 0x80) {
+        bytes[0] = (uint8_t)codepoint;
+        length = 1;
+    } else if(codepoint < 0x800) {
+        bytes[0] = (uint8_t)(0xC0 | (codepoint >> 6));
+        bytes[1] = (uint8_t)(0x80 | (codepoint & 0x3F));
+        length = 2;
+    } else if(codepoint < 0x10000) {
+        bytes[0] = (uint8_t)(0xE0 | (codepoint >> 12));
+        bytes[1] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+        bytes[2] = (uint8_t)(0x80 | (codepoint & 0x3F));
+        length = 3;
+    } else {
+        bytes[0] = (uint8_t)(0xF0 | (codepoint >> 18));
+        bytes[1] = (uint8_t)(0x80 | ((codepoint >> 12) & 0x3F));
+        bytes[2] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+        bytes[3] = (uint8_t)(0x80 | (codepoint & 0x3F));
+        length = 4;
+    }
+
+    for(size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+MJB_EXPORT mjb_status mjb_caseless_hash(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_caseless_mode mode, uint64_t seed, uint64_t *hash) {
+    if(hash == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    *hash = 0;
+
+    if(!mjb_caseless_mode_is_valid(mode)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_status status = mjb_caseless_input(buffer, &byte_length, encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    uint64_t value = 0xCBF29CE484222325ull ^ seed;
+    const mjb_caseless_step *steps;
+    size_t step_count;
+
+    // Hash the folded form as it is produced, the codepoints mjb_caseless_match compares.
+    if(mjb_caseless_steps(mode, &steps, &step_count)) {
+        mjb_caseless_stream stream;
+        mjb_caseless_stream_init(&stream, buffer, byte_length, encoding, steps, step_count);
+
+        while(!stream.end && mjb_caseless_stream_next(&stream)) {
+            for(size_t i = 0; i < stream.queue_count; ++i) {
+                value = mjb_caseless_hash_codepoint(value, stream.queue[i]);
+            }
+        }
+
+        if(stream.end) {
+            *hash = value;
+
+            return MJB_STATUS_OK;
+        }
+
+        value = 0xCBF29CE484222325ull ^ seed;
+    }
+
+    mjb_caseless_value folded = { buffer, byte_length, encoding, false };
+    status = mjb_caseless_transform(&folded, mode);
+
+    if(status == MJB_STATUS_OK) {
+        // The transforms write UTF-8.
+        for(size_t i = 0; i < folded.byte_length; ++i) {
+            value ^= (uint8_t)folded.buffer[i];
+            value *= 0x100000001B3ull;
+        }
+
+        *hash = value;
+    }
+
+    mjb_caseless_value_free(&folded);
+
+    return status;
+}
@@ -60,7 +60,27 @@ MJB_EXPORT bool mjb_codepoint_is_valid(mjb_codepoint codepoint) {
     return true;
 }
 
+// Return true for the codepoints named by rule that have no character entry
+static bool mjb_codepoint_is_cjk_th(mjb_codepoint codepoint) {
+    return mjb_codepoint_is_hangul_syllable(codepoint) || mjb_codepoint_is_cjk_ideograph(codepoint) ||
+        (codepoint >= MJB_TANGUT_IDEOGRAPH_START && codepoint <= MJB_TANGUT_IDEOGRAPH_END) ||
+        (codepoint >= MJB_TANGUT_IDEOGRAPH_SUPPLEMENT_START &&
+            codepoint <= MJB_TANGUT_IDEOGRAPH_SUPPLEMENT_END) ||
+        (codepoint >= MJB_TANGUT_COMPONENT_START && codepoint <= MJB_TANGUT_COMPONENT_END) ||
+        (codepoint >= MJB_TANGUT_COMPONENT_SUPPLEMENT_START &&
+            codepoint <= MJB_TANGUT_COMPONENT_SUPPLEMENT_END) ||
+        (codepoint >= MJB_KHITAN_SMALL_SCRIPT_CHARACTER_START &&
+            codepoint <= MJB_KHITAN_SMALL_SCRIPT_CHARACTER_END) ||
+        // Last valid is EGYPTIAN HIEROGLYPH-143FA
+        (codepoint >= MJB_EGYPTIAN_H_FORMAT_EXT_START && codepoint <= MJB_EGYPTIAN_H_EXT_END &&
+            codepoint < 0x143FF);
+}
+
 static bool mjb_codepoint_cjk_th_character(mjb_codepoint codepoint, mjb_character *character) {
+    if(!mjb_codepoint_is_cjk_th(codepoint)) {
+        return false;
+    }
+
     character->name[0] = '\0';
 #if MJB_FEATURE_CHARACTER_NAMES
     const char *format = NULL;
@@ -100,17 +120,11 @@ static bool mjb_codepoint_cjk_th_character(mjb_codepoint codepoint, mjb_characte
 #if MJB_FEATURE_CHARACTER_NAMES
         format = "KHITAN SMALL SCRIPT CHARACTER-%X";
 #endif
-    } else if(codepoint >= MJB_EGYPTIAN_H_FORMAT_EXT_START && codepoint <= MJB_EGYPTIAN_H_EXT_END) {
-        if(codepoint >= 0x143FF) {
-            // Last valid is EGYPTIAN HIEROGLYPH-143FA
-            return false;
-        }
-
+    } else {
+        // Egyptian Hieroglyphs Extended-A
 #if MJB_FEATURE_CHARACTER_NAMES
         format = "EGYPTIAN HIEROGLYPH-%X";
 #endif
-    } else {
-        return false;
     }
 
 #if MJB_FEATURE_CHARACTER_NAMES
@@ -234,6 +248,30 @@ MJB_EXPORT mjb_status mjb_codepoint_info(mjb_codepoint codepoint, mjb_character
     return MJB_STATUS_OK;
 }
 
+// Return the properties read by the string loops, as mjb_codepoint_info() would set them
+bool mjb_codepoint_record_lookup(mjb_codepoint codepoint, mjb_codepoint_record *record) {
+    if(!mjb_codepoint_is_valid(codepoint)) {
+        return false;
+    }
+
+    if(mjb_unicode_record_lookup(codepoint, record)) {
+        return true;
+    }
+
+    if(!mjb_codepoint_is_cjk_th(codepoint)) {
+        return false;
+    }
+
+    record->category = MJB_CATEGORY_LO;
+    record->combining = MJB_CCC_NOT_REORDERED;
+    record->bidirectional = MJB_PR_BIDI_CLASS_L;
+    record->decimal = MJB_NUMBER_NOT_VALID;
+    record->cased = false;
+    record->case_ignorable = false;
+
+    return true;
+}
+
 MJB_EXPORT bool mjb_category_is_graphic(mjb_category category) {
     // All C categories can be printed
     switch(category) {
@@ -268,13 +306,13 @@ MJB_EXPORT mjb_status mjb_codepoint_block(mjb_codepoint codepoint, mjb_block_inf
 
 // Return true if the codepoint is graphic
 MJB_EXPORT bool mjb_codepoint_is_graphic(mjb_codepoint codepoint) {
-    mjb_character character;
+    mjb_codepoint_record record;
 
-    if(mjb_codepoint_info(codepoint, &character) != MJB_STATUS_OK) {
+    if(!mjb_codepoint_record_lookup(codepoint, &record)) {
         return false;
     }
 
-    return mjb_category_is_graphic(character.category);
+    return mjb_category_is_graphic((mjb_category)record.category);
 }
 
 // Return the numeric value of a codepoint (decimal, digit, numeric string)
@@ -28,6 +28,7 @@ typedef struct {
     mjb_ce *data;
     size_t count;
     size_t cap;
+    bool fixed; // data is caller storage that cannot grow
 } mjb_cea;
 
 // Dynamic sort-key array (uint16_t)
@@ -48,6 +49,10 @@ static bool cea_grow(mjb_cea *a, size_t need) {
         return true;
     }
 
+    if(a->fixed) {
+        return false;
+    }
+
     size_t new_cap = a->cap == 0 ? 16 : a->cap;
 
     while(new_cap < required) {
@@ -90,13 +95,6 @@ static bool cea_push(mjb_cea *a, uint16_t p, uint16_t s, uint16_t t, bool var) {
     return true;
 }
 
-static void cea_free(mjb_cea *a) {
-    mjb_free(a->data);
-    a->data = NULL;
-    a->count = 0;
-    a->cap = 0;
-}
-
 static bool sk_push(mjb_sort_key *sk, uint16_t w) {
     if(sk->count >= sk->cap) {
         if(sk->cap > SIZE_MAX / 2) {
@@ -124,14 +122,6 @@ static bool sk_push(mjb_sort_key *sk, uint16_t w) {
     return true;
 }
 
-static void sk_free(mjb_sort_key *sk) {
-    mjb_free(sk->data);
-
-    sk->data = NULL;
-    sk->count = 0;
-    sk->cap = 0;
-}
-
 static void sk_clear_if_all_ignorable(mjb_sort_key *sk) {
     for(size_t i = 0; i < sk->count; ++i) {
         if(sk->data[i] != 0) {
@@ -139,7 +129,7 @@ static void sk_clear_if_all_ignorable(mjb_sort_key *sk) {
         }
     }
 
-    sk_free(sk);
+    sk->count = 0;
 }
 
 /**
@@ -265,53 +255,58 @@ static bool cea_append_packed(mjb_cea *cea, const uint32_t *entry) {
     return true;
 }
 
-// Decode UTF-8 to a codepoint array
-static bool utf8_to_codepoints(const char *buf, size_t len, mjb_codepoint **out_codepoints,
-    size_t *out_count) {
-    *out_codepoints = NULL;
-    *out_count = 0;
-
-    // First pass: count
-    size_t count = 0;
-    size_t i = 0;
-    uint8_t state = MJB_UTF_ACCEPT;
-    bool in_error = false;
-    mjb_codepoint cp = 0;
+// Make room for `count` codepoints and their used[] flags in the collator scratch.
+static bool collator_reserve_codepoints(mjb_collator *collator, size_t count) {
+    if(count <= collator->codepoints_capacity) {
+        return true;
+    }
 
-    while(i < len) {
-        mjb_decode_result dr = mjb_next_codepoint(buf, len, &state, &i, MJB_ENC_UTF_8, &cp,
-            &in_error);
+    if(count > SIZE_MAX / sizeof(mjb_codepoint)) {
+        return false;
+    }
 
-        if(dr == MJB_DECODE_END) {
-            break;
-        }
+    mjb_codepoint *codepoints = (mjb_codepoint *)mjb_realloc(collator->codepoints,
+        count * sizeof(mjb_codepoint));
 
-        if(dr != MJB_DECODE_INCOMPLETE) {
-            ++count;
-        }
+    if(!codepoints) {
+        return false;
     }
 
-    if(count == 0) {
-        return true;
-    }
+    collator->codepoints = codepoints;
 
-    if(count > SIZE_MAX / sizeof(mjb_codepoint)) {
+    bool *used = (bool *)mjb_realloc(collator->used, count * sizeof(bool));
+
+    if(!used) {
         return false;
     }
 
-    mjb_codepoint *arr = (mjb_codepoint *)mjb_alloc(count * sizeof(mjb_codepoint));
+    collator->used = used;
+    collator->codepoints_capacity = count;
+
+    return true;
+}
+
+// Decode UTF-8 to the collator codepoint array. A codepoint takes at least one byte, so `len`
+// entries are always enough.
+static bool utf8_to_codepoints(const char *buf, size_t len, mjb_collator *collator,
+    size_t *out_count) {
+    *out_count = 0;
+
+    if(len == 0) {
+        return true;
+    }
 
-    if(!arr) {
+    if(!collator_reserve_codepoints(collator, len)) {
         return false;
     }
 
-    // Second pass: fill
-    i = 0;
-    state = MJB_UTF_ACCEPT;
-    in_error = false;
+    size_t i = 0;
     size_t j = 0;
+    uint8_t state = MJB_UTF_ACCEPT;
+    bool in_error = false;
+    mjb_codepoint cp = 0;
 
-    while(i < len && j < count) {
+    while(i < len) {
         mjb_decode_result dr = mjb_next_codepoint(buf, len, &state, &i, MJB_ENC_UTF_8, &cp,
             &in_error);
 
@@ -320,12 +315,11 @@ static bool utf8_to_codepoints(const char *buf, size_t len, mjb_codepoint **out_
         }
 
         if(dr != MJB_DECODE_INCOMPLETE) {
-            arr[j++] = cp;
+            collator->codepoints[j++] = cp;
         }
     }
 
     *out_count = j;
-    *out_codepoints = arr;
 
     return true;
 }
@@ -461,7 +455,7 @@ static bool lookup_sequence(const mjb_codepoint *seq, int seq_len, uint8_t *out_
 }
 
 /**
- * Build the Collation Element Array from NFD codepoints.
+ * Append the CEs of the longest match starting at cps[i].
  *
  * Implements UTS#10 S2.1 (longest consecutive match) followed by S2.1.1-S2.1.3 (discontiguous
  * extension via unblocked non-starters).
@@ -471,327 +465,219 @@ static bool lookup_sequence(const mjb_codepoint *seq, int seq_len, uint8_t *out_
  * weight 3133, but 0DCA is unblocked by 0334 (CCC 1 < 9), so we extend to [0DD9,0DCF,0DCA] ->
  * weight 3134.
  *
- * `used[]` tracks positions consumed by discontiguous extension so that the main loop skips them
- * (they were already incorporated into a prior CE). `cons_advance` tracks how many consecutive
- * positions to skip after a match.
+ * `used[]` tracks positions consumed by discontiguous extension so that the caller skips them
+ * (they were already incorporated into a prior CE). `advance` receives how many consecutive
+ * positions to skip after a match. `cccs`, if not NULL, holds the combining classes of `cps`.
  */
-static bool build_cea(const mjb_codepoint *cps, size_t len, mjb_cea *cea) {
-    cea->data = NULL;
-    cea->count = 0;
-    cea->cap = 0;
+static bool cea_append_match(const mjb_codepoint *cps, const uint8_t *cccs, size_t len, bool *used,
+    size_t i, mjb_cea *cea, size_t *advance) {
+    // Build S: start with the longest consecutive match
+    mjb_codepoint cur_seq[18];
+    cur_seq[0] = cps[i];
+    int cur_len = 1;
+    size_t last_pos = i;     // Position of last char in S
+    size_t cons_advance = 1; // Positions to skip after the consecutive part
+
+    uint8_t best_w[18 * 4];
+    int best_bytes = 0;
+    bool have_match = false;
+
+    // S2.1: find longest consecutive contraction starting at i
+    if(i + 1 < len) {
+        uint8_t cons_w[18 * 4];
+        int cons_bytes = 0;
+        size_t ca = 0;
+
+        if(consecutive_contraction(cps, i, len, cons_w, &cons_bytes, &ca)) {
+            for(size_t k = 1; k < ca && cur_len < 18; ++k) {
+                cur_seq[cur_len++] = cps[i + k];
+            }
 
-    if(len == 0) {
-        return true;
-    }
+            last_pos = i + ca - 1;
+            cons_advance = ca;
 
-    bool *used = (bool *)mjb_alloc(len * sizeof(bool));
+            memcpy(best_w, cons_w, (size_t)cons_bytes);
 
-    if(!used) {
-        return false;
+            best_bytes = cons_bytes;
+            have_match = true;
+        }
     }
 
-    memset(used, 0, len * sizeof(*used));
-
-    size_t i = 0;
-
-    while(i < len) {
-        if(used[i]) {
-            ++i;
-
-            continue;
-        }
+    // S2.1.1 – S2.1.3: extend S via unblocked non-starters
+    bool keep_extending = true;
 
-        // Build S: start with the longest consecutive match
-        mjb_codepoint cur_seq[18];
-        cur_seq[0] = cps[i];
-        int cur_len = 1;
-        size_t last_pos = i;     // Position of last char in S
-        size_t cons_advance = 1; // Positions to skip after the consecutive part
-
-        uint8_t best_w[18 * 4];
-        int best_bytes = 0;
-        bool have_match = false;
-
-        // S2.1: find longest consecutive contraction starting at i
-        if(i + 1 < len) {
-            uint8_t cons_w[18 * 4];
-            int cons_bytes = 0;
-            size_t ca = 0;
-
-            if(consecutive_contraction(cps, i, len, cons_w, &cons_bytes, &ca)) {
-                for(size_t k = 1; k < ca && cur_len < 18; ++k) {
-                    cur_seq[cur_len++] = cps[i + k];
-                }
+    while(keep_extending) {
+        keep_extending = false;
 
-                last_pos = i + ca - 1;
-                cons_advance = ca;
+        for(size_t j = last_pos + 1; j < len; ++j) {
+            if(used[j]) {
+                continue;
+            }
 
-                memcpy(best_w, cons_w, (size_t)cons_bytes);
+            uint8_t cj_ccc = cccs ? cccs[j] : ccc_of(cps[j]);
 
-                best_bytes = cons_bytes;
-                have_match = true;
+            // A starter ends the non-starter run
+            if(cj_ccc == 0) {
+                break;
             }
-        }
 
-        // S2.1.1 – S2.1.3: extend S via unblocked non-starters
-        bool keep_extending = true;
+            // S2.1.2: blocked if any non-used B in (last_pos, j) has CCC(B) >= CCC(cps[j]).
+            bool blocked = false;
 
-        while(keep_extending) {
-            keep_extending = false;
-
-            for(size_t j = last_pos + 1; j < len; ++j) {
-                if(used[j]) {
+            for(size_t k = last_pos + 1; k < j; ++k) {
+                if(used[k]) {
                     continue;
                 }
 
-                uint8_t cj_ccc = ccc_of(cps[j]);
-
-                // A starter ends the non-starter run
-                if(cj_ccc == 0) {
+                if((cccs ? cccs[k] : ccc_of(cps[k])) >= cj_ccc) {
+                    blocked = true;
                     break;
                 }
+            }
 
-                // S2.1.2: blocked if any non-used B in (last_pos, j) has CCC(B) >= CCC(cps[j]).
-                bool blocked = false;
-
-                for(size_t k = last_pos + 1; k < j; ++k) {
-                    if(used[k]) {
-                        continue;
-                    }
-
-                    if(ccc_of(cps[k]) >= cj_ccc) {
-                        blocked = true;
-                        break;
-                    }
-                }
-
-                if(blocked) {
-                    continue;
-                }
+            if(blocked) {
+                continue;
+            }
 
-                // S2.1.3: does S + cps[j] have a table entry?
-                if(cur_len >= 18) {
-                    break;
-                }
+            // S2.1.3: does S + cps[j] have a table entry?
+            if(cur_len >= 18) {
+                break;
+            }
 
-                cur_seq[cur_len] = cps[j];
+            cur_seq[cur_len] = cps[j];
 
-                uint8_t tmp_w[18 * 4];
-                int tmp_bytes = 0;
+            uint8_t tmp_w[18 * 4];
+            int tmp_bytes = 0;
 
-                if(lookup_sequence(cur_seq, cur_len + 1, tmp_w, &tmp_bytes)) {
-                    ++cur_len;
-                    last_pos = j;
-                    used[j] = true;
+            if(lookup_sequence(cur_seq, cur_len + 1, tmp_w, &tmp_bytes)) {
+                ++cur_len;
+                last_pos = j;
+                used[j] = true;
 
-                    memcpy(best_w, tmp_w, (size_t)tmp_bytes);
+                memcpy(best_w, tmp_w, (size_t)tmp_bytes);
 
-                    best_bytes = tmp_bytes;
-                    have_match = true;
-                    keep_extending = true;
+                best_bytes = tmp_bytes;
+                have_match = true;
+                keep_extending = true;
 
-                    // Restart S2.1.1 from new last_pos.
-                    break;
-                }
+                // Restart S2.1.1 from new last_pos.
+                break;
             }
         }
+    }
 
-        if(have_match) {
-            if(!cea_append_blob(cea, best_w, best_bytes)) {
-                mjb_free(used);
-
-                return false;
-            }
-        } else if(!cea_lookup_or_implicit(cea, cps[i])) {
-            mjb_free(used);
-
-            return false;
-        }
+    *advance = cons_advance;
 
-        i += cons_advance;
+    if(have_match) {
+        return cea_append_blob(cea, best_w, best_bytes);
     }
 
-    mjb_free(used);
-
-    return true;
+    return cea_lookup_or_implicit(cea, cps[i]);
 }
 
-// Sort key construction
-static bool build_sort_key_non_ignorable(const mjb_cea *cea, mjb_collation_strength strength,
-    mjb_sort_key *sk) {
-    // L1: non-zero primary weights
-    for(size_t i = 0; i < cea->count; ++i) {
-        if(cea->data[i].primary != 0 && !sk_push(sk, cea->data[i].primary)) {
-            return false;
-        }
-    }
-
-    if(!sk_push(sk, 0x0000)) { // Level separator
-        return false;
-    }
+// Build the Collation Element Array from NFD codepoints. `used` has room for `len` flags.
+static bool build_cea(const mjb_codepoint *cps, size_t len, bool *used, mjb_cea *cea) {
+    cea->count = 0;
 
-    if(strength == MJB_COLLATION_PRIMARY) {
+    if(len == 0) {
         return true;
     }
 
-    // L2: non-zero secondary weights
-    for(size_t i = 0; i < cea->count; ++i) {
-        if(cea->data[i].secondary != 0 && !sk_push(sk, cea->data[i].secondary)) {
-            return false;
-        }
-    }
+    memset(used, 0, len * sizeof(*used));
 
-    if(!sk_push(sk, 0x0000)) {
-        return false;
-    }
+    size_t i = 0;
 
-    if(strength == MJB_COLLATION_SECONDARY) {
-        return true;
-    }
+    while(i < len) {
+        if(used[i]) {
+            ++i;
+
+            continue;
+        }
 
-    // L3: non-zero tertiary weights
-    for(size_t i = 0; i < cea->count; ++i) {
-        if(cea->data[i].tertiary != 0 && !sk_push(sk, cea->data[i].tertiary)) {
+        size_t advance = 1;
+
+        if(!cea_append_match(cps, NULL, len, used, i, cea, &advance)) {
             return false;
         }
-    }
 
-    if(!sk_push(sk, 0x0000)) {
-        return false;
+        i += advance;
     }
 
     return true;
 }
 
-static bool build_sort_key_shifted(const mjb_cea *cea, mjb_collation_strength strength,
-    mjb_sort_key *sk) {
-    size_t n = cea->count;
-
-    if(n > SIZE_MAX / sizeof(uint16_t)) {
-        return false;
-    }
-
-    // We need adjusted weights; avoid dynamic allocation by iterating twice. Compute L1/L2/L3 and
-    // L4 in three passes: first collect into a scratch array (malloc), then emit.
-    uint16_t *l1 = (uint16_t *)mjb_alloc(n * sizeof(uint16_t));
-    uint16_t *l2 = (uint16_t *)mjb_alloc(n * sizeof(uint16_t));
-    uint16_t *l3 = (uint16_t *)mjb_alloc(n * sizeof(uint16_t));
-    uint16_t *l4 = (uint16_t *)mjb_alloc(n * sizeof(uint16_t));
-
-    if(!l1 || !l2 || !l3 || !l4) {
-        mjb_free(l1);
-        mjb_free(l2);
-        mjb_free(l3);
-        mjb_free(l4);
-
-        return false;
-    }
+// Sort key construction
 
-    bool after_variable = false;
+// The weight a CE contributes to a sort key level, 0 if none. With SHIFTED variable weighting
+// (UTS#10 §4) variable elements move their primary to level 4, completely ignorable elements
+// that follow a variable are ignored at every level, and other elements get FFFF at level 4.
+static uint16_t collation_level_weight(const mjb_ce *ce, int level, bool shifted,
+    bool *after_variable) {
+    if(shifted) {
+        if(ce->variable) {
+            *after_variable = true;
 
-    for(size_t i = 0; i < n; ++i) {
-        const mjb_ce *ce = &cea->data[i];
+            return level == 4 ? ce->primary : 0;
+        }
 
-        if(ce->variable) {
-            // Original primary -> L4
-            l4[i] = ce->primary;
-            l1[i] = 0;
-            l2[i] = 0;
-            l3[i] = 0;
-            after_variable = true;
-        } else if(ce->primary == 0 && after_variable) {
-            // Completely ignorable following a variable: all levels zero
-            l1[i] = 0;
-            l2[i] = 0;
-            l3[i] = 0;
-            l4[i] = 0;
-        } else {
-            l1[i] = ce->primary;
-            l2[i] = ce->secondary;
-            l3[i] = ce->tertiary;
-            // UTS#10 §4 SHIFTED: non-variable primary≠0 -> L4=FFFF; primary=0 -> L4=0
-            l4[i] = (ce->primary != 0) ? 0xFFFF : 0x0000;
-
-            if(ce->primary != 0)
-                after_variable = false;
+        if(ce->primary == 0 && *after_variable) {
+            return 0;
         }
-    }
 
-    // Emit L1
-    for(size_t i = 0; i < n; ++i) {
-        if(l1[i] != 0) {
-            if(!sk_push(sk, l1[i])) {
-                goto fail;
-            }
+        if(ce->primary != 0) {
+            *after_variable = false;
         }
     }
 
-    if(!sk_push(sk, 0x0000)) {
-        goto fail;
+    switch(level) {
+        case 1:
+            return ce->primary;
+        case 2:
+            return ce->secondary;
+        case 3:
+            return ce->tertiary;
+        default:
+            return ce->primary != 0 ? 0xFFFF : 0x0000;
     }
+}
 
-    if(strength == MJB_COLLATION_PRIMARY) {
-        goto success;
+// The number of sort key levels. NON_IGNORABLE has no level 4, so quaternary equals tertiary.
+static int collation_levels(bool shifted, mjb_collation_strength strength) {
+    switch(strength) {
+        case MJB_COLLATION_PRIMARY:
+            return 1;
+        case MJB_COLLATION_SECONDARY:
+            return 2;
+        case MJB_COLLATION_QUATERNARY:
+            return shifted ? 4 : 3;
+        default:
+            return 3;
     }
+}
 
-    // Emit L2
-    for(size_t i = 0; i < n; ++i) {
-        if(l2[i] != 0) {
-            if(!sk_push(sk, l2[i])) {
-                goto fail;
-            }
-        }
-    }
+// Emit the non-zero weights of each level, the first three followed by a 0000 separator.
+static bool build_sort_key(const mjb_cea *cea, bool shifted, mjb_collation_strength strength,
+    mjb_sort_key *sk) {
+    int levels = collation_levels(shifted, strength);
 
-    if(!sk_push(sk, 0x0000)) {
-        goto fail;
-    }
+    for(int level = 1; level <= levels; ++level) {
+        bool after_variable = false;
 
-    if(strength == MJB_COLLATION_SECONDARY) {
-        goto success;
-    }
+        for(size_t i = 0; i < cea->count; ++i) {
+            uint16_t weight = collation_level_weight(&cea->data[i], level, shifted,
+                &after_variable);
 
-    // Emit L3
-    for(size_t i = 0; i < n; ++i) {
-        if(l3[i] != 0) {
-            if(!sk_push(sk, l3[i])) {
-                goto fail;
+            if(weight != 0 && !sk_push(sk, weight)) {
+                return false;
             }
         }
-    }
-
-    if(!sk_push(sk, 0x0000)) {
-        goto fail;
-    }
-
-    if(strength != MJB_COLLATION_QUATERNARY) {
-        goto success;
-    }
 
-    // Emit L4: only the shifted primaries (non-zero)
-    for(size_t i = 0; i < n; ++i) {
-        if(l4[i] != 0) {
-            if(!sk_push(sk, l4[i])) {
-                goto fail;
-            }
+        if(level < 4 && !sk_push(sk, 0x0000)) {
+            return false;
         }
     }
 
-success:
-    mjb_free(l1);
-    mjb_free(l2);
-    mjb_free(l3);
-    mjb_free(l4);
-
     return true;
-
-fail:
-    mjb_free(l1);
-    mjb_free(l2);
-    mjb_free(l3);
-    mjb_free(l4);
-
-    return false;
 }
 
 static bool
@@ -805,75 +691,83 @@ static bool mjb_collation_strength_is_valid(mjb_collation_strength strength) {
         strength == MJB_COLLATION_TERTIARY || strength == MJB_COLLATION_QUATERNARY;
 }
 
-static mjb_status compute_sort_key(const char *buffer, size_t byte_length, mjb_encoding encoding,
-    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength,
-    mjb_sort_key *sk) {
-    sk->data = NULL;
-    sk->count = 0;
-    sk->cap = 0;
-
-    if(!mjb_collation_variable_weighting_is_valid(variable_weighting) ||
-        !mjb_collation_strength_is_valid(strength)) {
-        return MJB_STATUS_INVALID_ARGUMENT;
-    }
-
-    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+// Decompose to NFD UTF-8. Input that already is NFD UTF-8 is used in place, anything else is
+// written to the collator normalization buffer.
+static mjb_status collator_normalize(mjb_collator *collator, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, const char **normalized, size_t *normalized_size) {
+    mjb_quick_check_result is_normalized;
+    size_t span = 0;
+    mjb_status status = mjb_normalization_quick_check_span(buffer, byte_length, encoding,
+        MJB_NORMALIZATION_NFD, &is_normalized, &span);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    if(byte_length == 0) {
+    if(is_normalized == MJB_QC_YES && encoding == MJB_ENC_UTF_8) {
+        *normalized = buffer;
+        *normalized_size = byte_length;
+
         return MJB_STATUS_OK;
     }
 
-    status = mjb_validate_code_unit_sequence(buffer, byte_length, encoding);
+    size_t size = 0;
+    status = mjb_normalize_buffer(buffer, byte_length, encoding, MJB_NORMALIZATION_NFD, span,
+        &collator->normalized, &collator->normalized_capacity, &size);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    mjb_result r;
-    status = mjb_normalize(buffer, byte_length, encoding, MJB_NORMALIZATION_NFD, MJB_ENC_UTF_8, &r);
+    *normalized = collator->normalized;
+    *normalized_size = size;
+
+    return MJB_STATUS_OK;
+}
+
+/**
+ * Compute the sort key of validated, non-empty input into the collator key buffer `slot`. `sk`
+ * receives a view of the key, valid until the next call that uses the same slot.
+ */
+static mjb_status collator_build_key(mjb_collator *collator, size_t slot, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, mjb_sort_key *sk) {
+    sk->data = collator->keys[slot];
+    sk->count = 0;
+    sk->cap = collator->keys_capacity[slot];
+
+    const char *normalized = NULL;
+    size_t normalized_size = 0;
+    mjb_status status = collator_normalize(collator, buffer, byte_length, encoding, &normalized,
+        &normalized_size);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
     size_t len = 0;
-    mjb_codepoint *cps = NULL;
-    bool codepoints_ok = utf8_to_codepoints(r.output, r.output_size, &cps, &len);
-    mjb_result_free(&r);
 
-    if(!codepoints_ok) {
+    if(!utf8_to_codepoints(normalized, normalized_size, collator, &len)) {
         return MJB_STATUS_NO_MEMORY;
     }
 
-    mjb_cea cea = { 0, 0, 0 };
+    mjb_cea cea = { (mjb_ce *)collator->elements, 0, collator->elements_capacity, false };
+    bool cea_ok = build_cea(collator->codepoints, len, collator->used, &cea);
 
-    if(len > 0) {
-        if(!build_cea(cps, len, &cea)) {
-            mjb_free(cps);
-            cea_free(&cea);
+    collator->elements = cea.data;
+    collator->elements_capacity = cea.cap;
 
-            return MJB_STATUS_NO_MEMORY;
-        }
+    if(!cea_ok) {
+        return MJB_STATUS_NO_MEMORY;
     }
 
-    mjb_free(cps);
-
-    bool key_ok = false;
-
-    if(variable_weighting == MJB_COLLATION_SHIFTED) {
-        key_ok = build_sort_key_shifted(&cea, strength, sk);
-    } else {
-        key_ok = build_sort_key_non_ignorable(&cea, strength, sk);
-    }
+    bool key_ok = build_sort_key(&cea, collator->variable_weighting == MJB_COLLATION_SHIFTED,
+        collator->strength, sk);
 
-    cea_free(&cea);
+    collator->keys[slot] = sk->data;
+    collator->keys_capacity[slot] = sk->cap;
 
     if(!key_ok) {
-        sk_free(sk);
+        sk->count = 0;
 
         return MJB_STATUS_NO_MEMORY;
     }
@@ -886,6 +780,32 @@ static mjb_status compute_sort_key(const char *buffer, size_t byte_length, mjb_e
     return MJB_STATUS_OK;
 }
 
+// Resolve, validate and compute the sort key of the input into the collator key buffer `slot`.
+static mjb_status collator_sort_key(mjb_collator *collator, size_t slot, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, mjb_sort_key *sk) {
+    sk->data = collator->keys[slot];
+    sk->count = 0;
+    sk->cap = collator->keys_capacity[slot];
+
+    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    if(byte_length == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    status = mjb_validate_code_unit_sequence(buffer, byte_length, encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    return collator_build_key(collator, slot, buffer, byte_length, encoding, sk);
+}
+
 static int compare_sort_keys(const mjb_sort_key *k1, const mjb_sort_key *k2) {
     size_t min_count = k1->count < k2->count ? k1->count : k2->count;
 
@@ -910,58 +830,536 @@ static int compare_sort_keys(const mjb_sort_key *k1, const mjb_sort_key *k2) {
     return 0;
 }
 
-static mjb_status mjb_collation_key_write(mjb_output *output, const void *context) {
-    const mjb_sort_key *sort_key = (const mjb_sort_key *)context;
+/**
+ * Incremental comparison.
+ *
+ * Each string is walked through a small window of NFD codepoints that is filled lazily from the
+ * input and drained from the front into collation elements. A position is only collated once the
+ * segments up to two codepoints past it are complete (a contraction spans at most three
+ * codepoints), so its elements equal the ones build_cea would produce.
+ *
+ * Every sort key level has its own cursor over the buffered elements of both strings. The levels
+ * advance together, a difference at a level only decides the order once all the lower levels tie,
+ * and a primary difference ends the comparison. Inputs that do not fit the buffers fall back to
+ * the full sort keys.
+ */
+#define MJB_COLLATION_WINDOW 128
+#define MJB_COLLATION_SEGMENT_MAX 30
+#define MJB_COLLATION_STREAM_CES 96
+#define MJB_COLLATION_STEP_CES 16
+#define MJB_COLLATION_LEVELS 4
+#define MJB_COLLATION_NO_STARTER SIZE_MAX
+
+typedef enum {
+    MJB_COLLATION_NEXT_WEIGHT,
+    MJB_COLLATION_NEXT_MORE,
+    MJB_COLLATION_NEXT_END
+} mjb_collation_next;
 
-    for(size_t i = 0; i < sort_key->count; ++i) {
-        uint8_t bytes[2] = { (uint8_t)(sort_key->data[i] >> 8),
-            (uint8_t)(sort_key->data[i] & 0xFF) };
-        mjb_status status = mjb_output_write(output, bytes, sizeof(bytes));
+typedef struct {
+    const char *buffer;
+    size_t byte_length;
+    mjb_encoding encoding;
+    size_t index;
+    uint8_t state;
+    bool in_error;
+    bool input_end;
+    // NFD codepoints not collated yet, from cps[first]
+    mjb_codepoint cps[MJB_COLLATION_WINDOW];
+    uint8_t ccc[MJB_COLLATION_WINDOW];
+    bool used[MJB_COLLATION_WINDOW];
+    size_t first;
+    size_t count;
+    size_t last_starter;
+    size_t segment_length;
+    // Collation elements not read by every level yet. ces[0] is element number `base`.
+    mjb_ce ces[MJB_COLLATION_STREAM_CES];
+    size_t base;
+    size_t ce_count;
+    bool exhausted;
+} mjb_collation_stream;
+
+// A level read position in a stream.
+typedef struct {
+    size_t position;
+    uint16_t weight; // Read but not compared yet, 0 if none
+    bool after_variable;
+} mjb_collation_cursor;
+
+static void collation_stream_init(mjb_collation_stream *stream, const char *buffer,
+    size_t byte_length, mjb_encoding encoding) {
+    stream->buffer = buffer;
+    stream->byte_length = byte_length;
+    stream->encoding = encoding;
+    stream->index = 0;
+    stream->state = MJB_UTF_ACCEPT;
+    stream->in_error = false;
+    stream->input_end = false;
+    stream->first = 0;
+    stream->count = 0;
+    stream->last_starter = MJB_COLLATION_NO_STARTER;
+    stream->segment_length = 0;
+    stream->base = 0;
+    stream->ce_count = 0;
+    stream->exhausted = false;
+}
 
-        if(status != MJB_STATUS_OK) {
-            return status;
+// Append a NFD codepoint, keeping the open segment in canonical order.
+static bool collation_stream_push(mjb_collation_stream *stream, mjb_codepoint codepoint,
+    uint8_t ccc) {
+    if(stream->first + stream->count == MJB_COLLATION_WINDOW) {
+        if(stream->first == 0) {
+            return false;
         }
-    }
 
-    return MJB_STATUS_OK;
-}
+        memmove(stream->cps, stream->cps + stream->first, stream->count * sizeof(stream->cps[0]));
+        memmove(stream->ccc, stream->ccc + stream->first, stream->count * sizeof(stream->ccc[0]));
+        memmove(stream->used, stream->used + stream->first,
+            stream->count * sizeof(stream->used[0]));
 
-static mjb_status mjb_collation_key_byte_count(const mjb_sort_key *sort_key, size_t *byte_count) {
-    if(sort_key->count > SIZE_MAX / 2) {
-        return MJB_STATUS_OVERFLOW;
+        if(stream->last_starter != MJB_COLLATION_NO_STARTER) {
+            stream->last_starter -= stream->first;
+        }
+
+        stream->first = 0;
     }
 
-    *byte_count = sort_key->count * 2;
+    size_t j = stream->first + stream->count++;
 
-    return MJB_STATUS_OK;
-}
+    if(ccc == 0) {
+        stream->last_starter = j;
+        stream->segment_length = 0;
+    }
 
-MJB_EXPORT mjb_status mjb_collation_key(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_collation_variable_weighting variable_weighting,
-    mjb_collation_strength strength, mjb_result *result) {
-    if(result == NULL || (buffer == NULL && byte_length > 0)) {
-        return MJB_STATUS_INVALID_ARGUMENT;
+    // mjb_normalize splits longer segments, leave them to the full path
+    if(++stream->segment_length > MJB_COLLATION_SEGMENT_MAX) {
+        return false;
     }
 
-    result->output = NULL;
-    result->output_size = 0;
-    result->transformed = false;
+    while(ccc != 0 && j > stream->first && stream->ccc[j - 1] > ccc) {
+        stream->cps[j] = stream->cps[j - 1];
+        stream->ccc[j] = stream->ccc[j - 1];
+        stream->used[j] = stream->used[j - 1];
+        --j;
+    }
 
-    mjb_sort_key sk = { 0, 0, 0 };
+    stream->cps[j] = codepoint;
+    stream->ccc[j] = ccc;
+    stream->used[j] = false;
 
-    mjb_status status = compute_sort_key(buffer, byte_length, encoding, variable_weighting,
-        strength, &sk);
+    return true;
+}
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+// Decode the next codepoint and append its canonical decomposition, as mjb_normalize does.
+static bool collation_stream_decode(mjb_collation_stream *stream) {
+    mjb_codepoint codepoint = 0;
+
+    while(true) {
+        if(stream->index >= stream->byte_length) {
+            stream->input_end = true;
+
+            return true;
+        }
+
+        mjb_decode_result result = mjb_next_codepoint(stream->buffer, stream->byte_length,
+            &stream->state, &stream->index, stream->encoding, &codepoint, &stream->in_error);
+
+        if(result == MJB_DECODE_END) {
+            stream->input_end = true;
+
+            return true;
+        }
+
+        if(result != MJB_DECODE_INCOMPLETE) {
+            break;
+        }
+    }
+
+    // ASCII is made of starters without decompositions
+    if(codepoint < 0x80) {
+        return collation_stream_push(stream, codepoint, 0);
+    }
+
+    mjb_n_character character;
+
+    if(!mjb_n_codepoint_character(codepoint, &character)) {
+        return true;
+    }
+
+    if(mjb_codepoint_is_hangul_syllable(codepoint)) {
+        mjb_codepoint jamo[3];
+
+        if(mjb_hangul_syllable_decomposition(codepoint, jamo) != MJB_STATUS_OK) {
+            return true;
+        }
+
+        for(size_t i = 0; i < 3; ++i) {
+            if(jamo[i] != 0 && !collation_stream_push(stream, jamo[i], ccc_of(jamo[i]))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    if(character.decomposition == MJB_DECOMPOSITION_CANONICAL) {
+        const mjb_codepoint *decompositions = NULL;
+        uint8_t decomposition_count = 0;
+        size_t pushed = 0;
+
+        if(mjb_unicode_decomposition_lookup(codepoint, false, &decompositions,
+               &decomposition_count)) {
+            for(uint8_t i = 0; i < decomposition_count; ++i) {
+                mjb_n_character decomposed;
+
+                if(decompositions[i] == MJB_CODEPOINT_NOT_VALID ||
+                    !mjb_n_codepoint_character(decompositions[i], &decomposed)) {
+                    continue;
+                }
+
+                if(!collation_stream_push(stream, decompositions[i], decomposed.combining)) {
+                    return false;
+                }
+
+                ++pushed;
+            }
+        }
+
+        if(pushed != 0) {
+            return true;
+        }
+    }
+
+    return collation_stream_push(stream, codepoint, character.combining);
+}
+
+static void collation_stream_shift(mjb_collation_stream *stream, size_t n) {
+    stream->first += n;
+    stream->count -= n;
+
+    if(stream->last_starter != MJB_COLLATION_NO_STARTER && stream->last_starter < stream->first) {
+        stream->last_starter = MJB_COLLATION_NO_STARTER;
+    }
+}
+
+/**
+ * Collate window positions until a few elements are buffered. `keep` is the first element a level
+ * still has to read; the ones before it are dropped to make room. Returns false if the input needs
+ * the full sort key.
+ */
+static bool collation_stream_step(mjb_collation_stream *stream, size_t keep) {
+    size_t drop = keep - stream->base;
+
+    if(drop != 0) {
+        memmove(stream->ces, stream->ces + drop, (stream->ce_count - drop) * sizeof(mjb_ce));
+
+        stream->base = keep;
+        stream->ce_count -= drop;
+    }
+
+    while(true) {
+        // Positions 0-2 must belong to closed segments: a starter after them, or the input end.
+        while(!stream->input_end &&
+            (stream->last_starter == MJB_COLLATION_NO_STARTER ||
+                stream->last_starter < stream->first + 3)) {
+            if(!collation_stream_decode(stream)) {
+                return false;
+            }
+        }
+
+        if(stream->count == 0) {
+            stream->exhausted = true;
+
+            return true;
+        }
+
+        if(stream->used[stream->first]) {
+            collation_stream_shift(stream, 1);
+
+            continue;
+        }
+
+        mjb_cea cea = { stream->ces + stream->ce_count, 0,
+            MJB_COLLATION_STREAM_CES - stream->ce_count, true };
+        size_t advance = 1;
+
+        if(!cea_append_match(stream->cps + stream->first, stream->ccc + stream->first,
+               stream->count, stream->used + stream->first, 0, &cea, &advance)) {
+            return false;
+        }
+
+        collation_stream_shift(stream, advance);
+        stream->ce_count += cea.count;
+
+        if(stream->ce_count >= MJB_COLLATION_STEP_CES) {
+            return true;
+        }
+    }
+}
+
+static mjb_collation_next collation_cursor_next(const mjb_collation_stream *stream,
+    mjb_collation_cursor *cursor, int level, bool shifted) {
+    while(cursor->weight == 0) {
+        if(cursor->position == stream->base + stream->ce_count) {
+            return stream->exhausted ? MJB_COLLATION_NEXT_END : MJB_COLLATION_NEXT_MORE;
+        }
+
+        cursor->weight = collation_level_weight(&stream->ces[cursor->position - stream->base],
+            level, shifted, &cursor->after_variable);
+        ++cursor->position;
+    }
+
+    return MJB_COLLATION_NEXT_WEIGHT;
+}
+
+/**
+ * Compare the weights of both strings, stopping at the first primary difference. A string whose
+ * weights at a level run out first sorts first, as its level separator (or empty key) does in
+ * compare_sort_keys. Returns false if either string needs the full sort key.
+ */
+static bool compare_incremental(const char *s1, size_t s1_byte_length, mjb_encoding s1_encoding,
+    const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding,
+    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength,
+    int *order) {
+    bool shifted = variable_weighting == MJB_COLLATION_SHIFTED;
+    int levels = collation_levels(shifted, strength);
+
+    mjb_collation_stream streams[2];
+    mjb_collation_cursor cursors[MJB_COLLATION_LEVELS][2];
+    bool tied[MJB_COLLATION_LEVELS] = { false, false, false, false };
+
+    collation_stream_init(&streams[0], s1, s1_byte_length, s1_encoding);
+    collation_stream_init(&streams[1], s2, s2_byte_length, s2_encoding);
+    memset(cursors, 0, sizeof(cursors));
+
+    // Levels from `levels` down are ignored once a difference is found at a lower one.
+    int decided = 0;
+
+    while(true) {
+        bool more[2] = { false, false };
+        bool pending = false;
+
+        for(int level = 1; level <= levels; ++level) {
+            mjb_collation_cursor *cursor = cursors[level - 1];
+
+            while(!tied[level - 1]) {
+                mjb_collation_next n1 = collation_cursor_next(&streams[0], &cursor[0], level,
+                    shifted);
+                mjb_collation_next n2 = collation_cursor_next(&streams[1], &cursor[1], level,
+                    shifted);
+
+                if(n1 == MJB_COLLATION_NEXT_MORE || n2 == MJB_COLLATION_NEXT_MORE) {
+                    more[0] |= n1 == MJB_COLLATION_NEXT_MORE;
+                    more[1] |= n2 == MJB_COLLATION_NEXT_MORE;
+                    pending = true;
+
+                    break;
+                }
+
+                if(n1 == MJB_COLLATION_NEXT_END && n2 == MJB_COLLATION_NEXT_END) {
+                    tied[level - 1] = true;
+
+                    break;
+                }
+
+                int difference = 0;
+
+                if(n1 == MJB_COLLATION_NEXT_END || n2 == MJB_COLLATION_NEXT_END) {
+                    difference = n1 == MJB_COLLATION_NEXT_END ? -1 : 1;
+                } else if(cursor[0].weight != cursor[1].weight) {
+                    difference = cursor[0].weight < cursor[1].weight ? -1 : 1;
+                }
+
+                if(difference != 0) {
+                    decided = difference;
+                    levels = level - 1;
+
+                    break;
+                }
+
+                cursor[0].weight = 0;
+                cursor[1].weight = 0;
+            }
+        }
+
+        if(levels == 0 || !pending) {
+            *order = decided;
+
+            return true;
+        }
+
+        for(size_t i = 0; i < 2; ++i) {
+            if(!more[i]) {
+                continue;
+            }
+
+            size_t keep = SIZE_MAX;
+
+            for(int level = 1; level <= levels; ++level) {
+                if(!tied[level - 1] && cursors[level - 1][i].position < keep) {
+                    keep = cursors[level - 1][i].position;
+                }
+            }
+
+            if(!collation_stream_step(&streams[i], keep)) {
+                return false;
+            }
+        }
+    }
+}
+
+static mjb_status mjb_collation_key_write(mjb_output *output, const void *context) {
+    const mjb_sort_key *sort_key = (const mjb_sort_key *)context;
+
+    for(size_t i = 0; i < sort_key->count; ++i) {
+        uint8_t bytes[2] = { (uint8_t)(sort_key->data[i] >> 8),
+            (uint8_t)(sort_key->data[i] & 0xFF) };
+        mjb_status status = mjb_output_write(output, bytes, sizeof(bytes));
+
+        if(status != MJB_STATUS_OK) {
+            return status;
+        }
+    }
+
+    return MJB_STATUS_OK;
+}
+
+static mjb_status mjb_collation_key_byte_count(const mjb_sort_key *sort_key, size_t *byte_count) {
+    if(sort_key->count > SIZE_MAX / 2) {
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    *byte_count = sort_key->count * 2;
+
+    return MJB_STATUS_OK;
+}
+
+MJB_EXPORT mjb_status mjb_collator_init(mjb_collator *collator,
+    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength) {
+    if(collator == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(collator, 0, sizeof(*collator));
+
+    if(!mjb_collation_variable_weighting_is_valid(variable_weighting) ||
+        !mjb_collation_strength_is_valid(strength)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    collator->variable_weighting = variable_weighting;
+    collator->strength = strength;
+
+    return MJB_STATUS_OK;
+}
+
+MJB_EXPORT void mjb_collator_free(mjb_collator *collator) {
+    if(collator == NULL) {
+        return;
+    }
+
+    mjb_free(collator->normalized);
+    mjb_free(collator->codepoints);
+    mjb_free(collator->used);
+    mjb_free(collator->elements);
+    mjb_free(collator->keys[0]);
+    mjb_free(collator->keys[1]);
+
+    memset(collator, 0, sizeof(*collator));
+}
+
+MJB_EXPORT mjb_status mjb_collator_compare(mjb_collator *collator, const char *s1,
+    size_t s1_byte_length, mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length,
+    mjb_encoding s2_encoding, int *order) {
+    if(order == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    *order = 0;
+
+    if(collator == NULL || (s1 == NULL && s1_byte_length > 0) ||
+        (s2 == NULL && s2_byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_status status = mjb_resolve_input_byte_length(s1, &s1_byte_length, s1_encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    status = mjb_resolve_input_byte_length(s2, &s2_byte_length, s2_encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    if(s1_byte_length == 0 && s2_byte_length == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    status = mjb_validate_code_unit_sequence(s1, s1_byte_length, s1_encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    status = mjb_validate_code_unit_sequence(s2, s2_byte_length, s2_encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    if(compare_incremental(s1, s1_byte_length, s1_encoding, s2, s2_byte_length, s2_encoding,
+           collator->variable_weighting, collator->strength, order)) {
+        return MJB_STATUS_OK;
+    }
+
+    mjb_sort_key sk1 = { NULL, 0, 0 };
+    mjb_sort_key sk2 = { NULL, 0, 0 };
+
+    if(s1_byte_length > 0) {
+        status = collator_build_key(collator, 0, s1, s1_byte_length, s1_encoding, &sk1);
+
+        if(status != MJB_STATUS_OK) {
+            return status;
+        }
+    }
+
+    if(s2_byte_length > 0) {
+        status = collator_build_key(collator, 1, s2, s2_byte_length, s2_encoding, &sk2);
+
+        if(status != MJB_STATUS_OK) {
+            return status;
+        }
+    }
+
+    *order = compare_sort_keys(&sk1, &sk2);
+
+    return MJB_STATUS_OK;
+}
+
+MJB_EXPORT mjb_status mjb_collator_key(mjb_collator *collator, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, mjb_result *result) {
+    if(collator == NULL || result == NULL || (buffer == NULL && byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    result->output = NULL;
+    result->output_size = 0;
+    result->transformed = false;
+
+    mjb_sort_key sk;
+    mjb_status status = collator_sort_key(collator, 0, buffer, byte_length, encoding, &sk);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
     }
 
     size_t byte_count = 0;
     status = mjb_collation_key_byte_count(&sk, &byte_count);
 
     if(status != MJB_STATUS_OK) {
-        sk_free(&sk);
-
         return status;
     }
 
@@ -974,7 +1372,6 @@ MJB_EXPORT mjb_status mjb_collation_key(const char *buffer, size_t byte_length,
     uint8_t *bytes = (uint8_t *)mjb_alloc(byte_count);
 
     if(!bytes) {
-        sk_free(&sk);
         return MJB_STATUS_NO_MEMORY;
     }
 
@@ -983,13 +1380,10 @@ MJB_EXPORT mjb_status mjb_collation_key(const char *buffer, size_t byte_length,
 
     if(status != MJB_STATUS_OK) {
         mjb_free(bytes);
-        sk_free(&sk);
 
         return status;
     }
 
-    sk_free(&sk);
-
     result->output = (char *)bytes;
     result->output_size = byte_count;
     result->transformed = true;
@@ -997,22 +1391,20 @@ MJB_EXPORT mjb_status mjb_collation_key(const char *buffer, size_t byte_length,
     return MJB_STATUS_OK;
 }
 
-MJB_EXPORT mjb_status mjb_collation_key_into(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_collation_variable_weighting variable_weighting,
-    mjb_collation_strength strength, void *output, size_t *output_size) {
+MJB_EXPORT mjb_status mjb_collator_key_into(mjb_collator *collator, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, void *output, size_t *output_size) {
     if(output_size == NULL) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    if(buffer == NULL && byte_length > 0) {
+    if(collator == NULL || (buffer == NULL && byte_length > 0)) {
         *output_size = 0;
 
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    mjb_sort_key sort_key = { 0, 0, 0 };
-    mjb_status status = compute_sort_key(buffer, byte_length, encoding, variable_weighting,
-        strength, &sort_key);
+    mjb_sort_key sort_key;
+    mjb_status status = collator_sort_key(collator, 0, buffer, byte_length, encoding, &sort_key);
 
     if(status != MJB_STATUS_OK) {
         *output_size = 0;
@@ -1023,76 +1415,206 @@ MJB_EXPORT mjb_status mjb_collation_key_into(const char *buffer, size_t byte_len
     size_t byte_count = 0;
     status = mjb_collation_key_byte_count(&sort_key, &byte_count);
 
-    if(status == MJB_STATUS_OK) {
-        status = mjb_output_into(output, output_size, mjb_collation_key_write, &sort_key);
-    } else {
+    if(status != MJB_STATUS_OK) {
         *output_size = 0;
-    }
 
-    sk_free(&sort_key);
+        return status;
+    }
 
-    return status;
+    return mjb_output_into(output, output_size, mjb_collation_key_write, &sort_key);
 }
 
-MJB_EXPORT mjb_status mjb_collation_compare(const char *s1, size_t s1_byte_length,
-    mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding,
-    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength,
-    int *order) {
-    if(order == NULL) {
+MJB_EXPORT mjb_status mjb_collator_keys_into(mjb_collator *collator, const char *const *strings,
+    const size_t *byte_lengths, size_t count, mjb_encoding encoding, void *arena,
+    size_t *arena_size, size_t *offsets) {
+    if(arena_size == NULL) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    *order = 0;
+    size_t capacity = arena == NULL ? 0 : *arena_size;
+    *arena_size = 0;
 
-    if(!mjb_collation_variable_weighting_is_valid(variable_weighting) ||
-        !mjb_collation_strength_is_valid(strength) || (s1 == NULL && s1_byte_length > 0) ||
-        (s2 == NULL && s2_byte_length > 0)) {
+    if(collator == NULL || offsets == NULL || (strings == NULL && count > 0)) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    mjb_status status = mjb_resolve_input_byte_length(s1, &s1_byte_length, s1_encoding);
+    size_t total = 0;
+    offsets[0] = 0;
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+    for(size_t i = 0; i < count; ++i) {
+        size_t byte_length = byte_lengths == NULL ? MJB_NUL_TERMINATED : byte_lengths[i];
+
+        if(strings[i] == NULL && byte_length > 0) {
+            return MJB_STATUS_INVALID_ARGUMENT;
+        }
+
+        mjb_sort_key sort_key;
+        mjb_status status = collator_sort_key(collator, 0, strings[i], byte_length, encoding,
+            &sort_key);
+        size_t byte_count = 0;
+
+        if(status == MJB_STATUS_OK) {
+            status = mjb_collation_key_byte_count(&sort_key, &byte_count);
+        }
+
+        if(status == MJB_STATUS_OK && byte_count > SIZE_MAX - total) {
+            status = MJB_STATUS_OVERFLOW;
+        }
+
+        if(status != MJB_STATUS_OK) {
+            return status;
+        }
+
+        // Keep measuring once the arena is full so the caller learns the whole batch size
+        if(arena != NULL && total + byte_count <= capacity) {
+            mjb_output output = { (char *)arena + total, 0, byte_count, MJB_OUTPUT_FIXED };
+            status = mjb_collation_key_write(&output, &sort_key);
+
+            if(status != MJB_STATUS_OK) {
+                return status;
+            }
+        }
+
+        total += byte_count;
+        offsets[i + 1] = total;
     }
 
-    status = mjb_resolve_input_byte_length(s2, &s2_byte_length, s2_encoding);
+    *arena_size = total;
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+    return arena != NULL && total > capacity ? MJB_STATUS_OUTPUT_TOO_SMALL : MJB_STATUS_OK;
+}
+
+MJB_EXPORT mjb_status mjb_collation_key(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_collation_variable_weighting variable_weighting,
+    mjb_collation_strength strength, mjb_result *result) {
+    if(result == NULL || (buffer == NULL && byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    if(s1_byte_length == 0 && s2_byte_length == 0) {
-        return MJB_STATUS_OK;
+    result->output = NULL;
+    result->output_size = 0;
+    result->transformed = false;
+
+    mjb_collator collator;
+    mjb_status status = mjb_collator_init(&collator, variable_weighting, strength);
+
+    if(status == MJB_STATUS_OK) {
+        status = mjb_collator_key(&collator, buffer, byte_length, encoding, result);
     }
 
-    mjb_sort_key sk1 = { 0, 0, 0 };
-    mjb_sort_key sk2 = { 0, 0, 0 };
+    mjb_collator_free(&collator);
 
-    status = compute_sort_key(s1, s1_byte_length, s1_encoding, variable_weighting, strength, &sk1);
+    return status;
+}
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+MJB_EXPORT mjb_status mjb_collation_key_into(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_collation_variable_weighting variable_weighting,
+    mjb_collation_strength strength, void *output, size_t *output_size) {
+    if(output_size == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    status = compute_sort_key(s2, s2_byte_length, s2_encoding, variable_weighting, strength, &sk2);
+    mjb_collator collator;
+    mjb_status status = mjb_collator_init(&collator, variable_weighting, strength);
 
-    if(status != MJB_STATUS_OK) {
-        sk_free(&sk1);
+    if(status == MJB_STATUS_OK) {
+        status = mjb_collator_key_into(&collator, buffer, byte_length, encoding, output,
+            output_size);
+    } else {
+        *output_size = 0;
+    }
 
-        return status;
+    mjb_collator_free(&collator);
+
+    return status;
+}
+
+MJB_EXPORT mjb_status mjb_collation_compare(const char *s1, size_t s1_byte_length,
+    mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding,
+    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength,
+    int *order) {
+    if(order == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    *order = compare_sort_keys(&sk1, &sk2);
+    *order = 0;
 
-    sk_free(&sk1);
-    sk_free(&sk2);
+    mjb_collator collator;
+    mjb_status status = mjb_collator_init(&collator, variable_weighting, strength);
 
-    return MJB_STATUS_OK;
+    if(status == MJB_STATUS_OK) {
+        status = mjb_collator_compare(&collator, s1, s1_byte_length, s1_encoding, s2,
+            s2_byte_length, s2_encoding, order);
+    }
+
+    mjb_collator_free(&collator);
+
+    return status;
 }
 
 #else
 
+MJB_EXPORT mjb_status mjb_collator_init(mjb_collator *collator,
+    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength) {
+    (void)collator;
+    (void)variable_weighting;
+    (void)strength;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT void mjb_collator_free(mjb_collator *collator) {
+    (void)collator;
+}
+
+MJB_EXPORT mjb_status mjb_collator_compare(mjb_collator *collator, const char *s1,
+    size_t s1_byte_length, mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length,
+    mjb_encoding s2_encoding, int *order) {
+    (void)collator;
+    (void)s1;
+    (void)s1_byte_length;
+    (void)s1_encoding;
+    (void)s2;
+    (void)s2_byte_length;
+    (void)s2_encoding;
+    (void)order;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT mjb_status mjb_collator_key(mjb_collator *collator, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, mjb_result *result) {
+    (void)collator;
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)result;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT mjb_status mjb_collator_key_into(mjb_collator *collator, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, void *output, size_t *output_size) {
+    (void)collator;
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)output;
+    (void)output_size;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT mjb_status mjb_collator_keys_into(mjb_collator *collator, const char *const *strings,
+    const size_t *byte_lengths, size_t count, mjb_encoding encoding, void *arena,
+    size_t *arena_size, size_t *offsets) {
+    (void)collator;
+    (void)strings;
+    (void)byte_lengths;
+    (void)count;
+    (void)encoding;
+    (void)arena;
+    (void)arena_size;
+    (void)offsets;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
 MJB_EXPORT mjb_status mjb_collation_key(const char *buffer, size_t byte_length,
     mjb_encoding encoding, mjb_collation_variable_weighting variable_weighting,
     mjb_collation_strength strength, mjb_result *result) {
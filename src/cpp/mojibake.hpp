@@ -175,6 +175,35 @@ struct ResultAccess {
     return value;
 }
 
+[[nodiscard]] inline std::vector<int32_t> property_int(const std::vector<mjb_codepoint> &codepoints,
+    mjb_property property) {
+    std::vector<int32_t> values(codepoints.size());
+
+    detail::check_status(mjb_codepoints_property_int(codepoints.data(), codepoints.size(),
+                             property, values.data()),
+        "Unable to read the property values");
+
+    return values;
+}
+
+[[nodiscard]] inline std::vector<int32_t> property_int(std::string_view input,
+    mjb_property property, mjb_encoding encoding = MJB_ENC_UTF_8) {
+    size_t count = 0;
+    detail::check_status(mjb_string_property_int(input.data(), input.size(), encoding, property,
+                             nullptr, &count),
+        "Unable to count the codepoints");
+
+    std::vector<int32_t> values(count);
+
+    detail::check_status(mjb_string_property_int(input.data(), input.size(), encoding, property,
+                             values.data(), &count),
+        "Unable to read the property values");
+
+    values.resize(count);
+
+    return values;
+}
+
 [[nodiscard]] inline std::string_view property_name(mjb_property property) noexcept {
     const char *name = mjb_property_name(property);
 
@@ -742,6 +771,89 @@ struct NumericValue {
     return confusable_skeleton_result(input, input_encoding, output_encoding).str();
 }
 
+/**
+ * See the mjb_confusable_index struct for details. Lookups do not modify the index.
+ */
+class ConfusableIndex {
+    mjb_confusable_index data{};
+
+  public:
+    ConfusableIndex() {
+        detail::check_status(mjb_confusable_index_init(&data),
+            "Confusable index initialization failed");
+    }
+
+    // Open a serialized image in place. The image must outlive the index.
+    [[nodiscard]] static ConfusableIndex open(const void *image, size_t size) {
+        ConfusableIndex index;
+        detail::check_status(mjb_confusable_index_open(&index.data, image, size),
+            "Confusable index open failed");
+
+        return index;
+    }
+
+    ConfusableIndex(const ConfusableIndex &) = delete;
+    ConfusableIndex &operator=(const ConfusableIndex &) = delete;
+
+    ConfusableIndex(ConfusableIndex &&other) noexcept : data(other.data) {
+        other.data = {};
+    }
+
+    ConfusableIndex &operator=(ConfusableIndex &&other) noexcept {
+        if(this != &other) {
+            mjb_confusable_index_free(&data);
+            data = other.data;
+            other.data = {};
+        }
+
+        return *this;
+    }
+
+    ~ConfusableIndex() {
+        mjb_confusable_index_free(&data);
+    }
+
+    void add(std::string_view input, uint32_t id, mjb_encoding encoding = MJB_ENC_UTF_8) {
+        detail::check_status(mjb_confusable_index_add(&data, input.data(), input.size(), encoding,
+                                 id),
+            "Confusable index add failed");
+    }
+
+    [[nodiscard]] std::vector<uint32_t> find(std::string_view input,
+        mjb_encoding encoding = MJB_ENC_UTF_8) const {
+        size_t count = 0;
+        detail::check_status(mjb_confusable_index_find(&data, input.data(), input.size(), encoding,
+                                 nullptr, &count),
+            "Confusable index find failed");
+        std::vector<uint32_t> ids(count);
+
+        if(count != 0) {
+            detail::check_status(mjb_confusable_index_find(&data, input.data(), input.size(),
+                                     encoding, ids.data(), &count),
+                "Confusable index find failed");
+        }
+
+        return ids;
+    }
+
+    // The image is returned as 32-bit words so that it can be opened in place.
+    [[nodiscard]] std::vector<uint32_t> serialize() const {
+        size_t size = 0;
+        detail::check_status(mjb_confusable_index_serialize(&data, nullptr, &size),
+            "Confusable index serialization failed");
+        std::vector<uint32_t> image((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        size = image.size() * sizeof(uint32_t);
+        detail::check_status(mjb_confusable_index_serialize(&data, image.data(), &size),
+            "Confusable index serialization failed");
+
+        return image;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return data.count;
+    }
+};
+
 enum class NormalizationForm {
     NFC = MJB_NORMALIZATION_NFC,
     NFD = MJB_NORMALIZATION_NFD,
@@ -793,6 +905,75 @@ enum class NormalizationForm {
     return quick_check;
 }
 
+// Streaming normalization of a string that arrives in chunks. feed and finish append the output
+// that is ready to `output`.
+class Normalizer {
+    mjb_normalizer data{};
+
+    void collect(std::string &output, size_t size, bool finish) {
+        const size_t offset = output.size();
+        output.resize(offset + size);
+        const mjb_status status = finish ?
+            mjb_normalizer_finish(&data, output.data() + offset, &size) :
+            mjb_normalizer_feed(&data, nullptr, 0, output.data() + offset, &size);
+
+        if(status != MJB_STATUS_OK) {
+            output.resize(offset);
+            detail::check_status(status, "Normalization failed");
+        }
+
+        output.resize(offset + size);
+    }
+
+  public:
+    explicit Normalizer(NormalizationForm form, mjb_encoding input_encoding = MJB_ENC_UTF_8,
+        mjb_encoding output_encoding = MJB_ENC_UTF_8) {
+        const mjb_status status = mjb_normalizer_init(&data, input_encoding,
+            static_cast<mjb_normalization>(form), output_encoding);
+
+        if(status != MJB_STATUS_OK) {
+            mjb_normalizer_free(&data);
+            detail::check_status(status, "Normalizer initialization failed");
+        }
+    }
+
+    Normalizer(const Normalizer &) = delete;
+    Normalizer &operator=(const Normalizer &) = delete;
+
+    Normalizer(Normalizer &&other) noexcept : data(other.data) {
+        other.data = {};
+    }
+
+    Normalizer &operator=(Normalizer &&other) noexcept {
+        if(this != &other) {
+            mjb_normalizer_free(&data);
+            data = other.data;
+            other.data = {};
+        }
+
+        return *this;
+    }
+
+    ~Normalizer() {
+        mjb_normalizer_free(&data);
+    }
+
+    void feed(std::string_view chunk, std::string &output) {
+        size_t size = 0;
+        detail::check_status(mjb_normalizer_feed(&data, chunk.data(), chunk.size(), nullptr,
+                                 &size),
+            "Normalization failed");
+        collect(output, size, false);
+    }
+
+    void finish(std::string &output) {
+        size_t size = 0;
+        detail::check_status(mjb_normalizer_finish(&data, nullptr, &size),
+            "Normalization failed");
+        collect(output, size, true);
+    }
+};
+
 enum class Filter : unsigned int {
     None = MJB_FILTER_NONE,
     Normalize = MJB_FILTER_NORMALIZE,
@@ -911,6 +1092,86 @@ class IdnaResult {
     return IdnaResult(std::move(result), info.errors);
 }
 
+// The ASCII forms of a list of domains, stored back to back in one buffer.
+class IdnaBatch {
+    mjb_idna_batch data{};
+
+    IdnaBatch() = default;
+
+  public:
+    explicit IdnaBatch(const std::vector<std::string_view> &domains,
+        mjb_encoding encoding = MJB_ENC_UTF_8, mjb_parallel_for_fn parallel_for = nullptr,
+        void *pool = nullptr) {
+        std::vector<const char *> pointers;
+        std::vector<size_t> lengths;
+        pointers.reserve(domains.size());
+        lengths.reserve(domains.size());
+
+        for(std::string_view domain : domains) {
+            pointers.push_back(domain.data());
+            lengths.push_back(domain.size());
+        }
+
+        detail::check_status(mjb_idna_to_ascii_batch(pointers.data(), lengths.data(),
+                                 domains.size(), encoding, parallel_for, pool, &data),
+            "IDNA batch conversion failed");
+    }
+
+    // One domain per line of the input.
+    [[nodiscard]] static IdnaBatch lines(std::string_view input,
+        mjb_encoding encoding = MJB_ENC_UTF_8, mjb_parallel_for_fn parallel_for = nullptr,
+        void *pool = nullptr) {
+        IdnaBatch batch;
+        detail::check_status(mjb_idna_to_ascii_lines(input.data(), input.size(), encoding,
+                                 parallel_for, pool, &batch.data),
+            "IDNA batch conversion failed");
+
+        return batch;
+    }
+
+    IdnaBatch(const IdnaBatch &) = delete;
+    IdnaBatch &operator=(const IdnaBatch &) = delete;
+
+    IdnaBatch(IdnaBatch &&other) noexcept : data(other.data) {
+        other.data = {};
+    }
+
+    IdnaBatch &operator=(IdnaBatch &&other) noexcept {
+        if(this != &other) {
+            mjb_idna_batch_free(&data);
+            data = other.data;
+            other.data = {};
+        }
+
+        return *this;
+    }
+
+    ~IdnaBatch() {
+        mjb_idna_batch_free(&data);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return data.count == 0;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return data.count;
+    }
+
+    [[nodiscard]] std::string_view operator[](size_t index) const noexcept {
+        return std::string_view(data.domains + data.offsets[index],
+            data.offsets[index + 1] - data.offsets[index]);
+    }
+
+    [[nodiscard]] uint32_t errors(size_t index) const noexcept {
+        return data.infos[index].errors;
+    }
+
+    [[nodiscard]] const mjb_idna_batch &raw() const noexcept {
+        return data;
+    }
+};
+
 [[nodiscard]] inline TextResult case_map_result(std::string_view input, mjb_map_case_type type,
     mjb_encoding input_encoding = MJB_ENC_UTF_8, mjb_encoding output_encoding = MJB_ENC_UTF_8) {
     TextResult result = detail::ResultAccess::create();
@@ -968,6 +1229,17 @@ enum class CaselessMode {
     return matches;
 }
 
+[[nodiscard]] inline uint64_t caseless_hash(std::string_view input,
+    CaselessMode mode = CaselessMode::Canonical, uint64_t seed = 0,
+    mjb_encoding encoding = MJB_ENC_UTF_8) {
+    uint64_t hash = 0;
+    detail::check_status(mjb_caseless_hash(input.data(), input.size(), encoding,
+                             static_cast<mjb_caseless_mode>(mode), seed, &hash),
+        "Caseless hashing failed");
+
+    return hash;
+}
+
 enum class CollationStrength {
     Primary = MJB_COLLATION_PRIMARY,
     Secondary = MJB_COLLATION_SECONDARY,
@@ -1014,6 +1286,120 @@ enum class CollationVariableWeighting {
     return collation_key_result(input, variable_weighting, strength, encoding).str();
 }
 
+/**
+ * See the mjb_collator struct for details. Reuses its buffers across calls; not thread-safe.
+ */
+class Collator {
+    mjb_collator data{};
+
+  public:
+    explicit Collator(
+        CollationVariableWeighting variable_weighting = CollationVariableWeighting::NonIgnorable,
+        CollationStrength strength = CollationStrength::Tertiary) {
+        const mjb_status status = mjb_collator_init(&data,
+            static_cast<mjb_collation_variable_weighting>(variable_weighting),
+            static_cast<mjb_collation_strength>(strength));
+
+        if(status != MJB_STATUS_OK) {
+            mjb_collator_free(&data);
+            detail::check_status(status, "Collator initialization failed");
+        }
+    }
+
+    Collator(const Collator &) = delete;
+    Collator &operator=(const Collator &) = delete;
+
+    Collator(Collator &&other) noexcept : data(other.data) {
+        other.data = {};
+    }
+
+    Collator &operator=(Collator &&other) noexcept {
+        if(this != &other) {
+            mjb_collator_free(&data);
+            data = other.data;
+            other.data = {};
+        }
+
+        return *this;
+    }
+
+    ~Collator() {
+        mjb_collator_free(&data);
+    }
+
+    [[nodiscard]] int compare(std::string_view s1, std::string_view s2,
+        mjb_encoding s1_encoding = MJB_ENC_UTF_8, mjb_encoding s2_encoding = MJB_ENC_UTF_8) {
+        int order = 0;
+        detail::check_status(mjb_collator_compare(&data, s1.data(), s1.size(), s1_encoding,
+                                 s2.data(), s2.size(), s2_encoding, &order),
+            "Collation comparison failed");
+
+        return order;
+    }
+
+    [[nodiscard]] std::string key(std::string_view input, mjb_encoding encoding = MJB_ENC_UTF_8) {
+        std::string output;
+        key_into(input, output, encoding);
+
+        return output;
+    }
+
+    // Replace the contents of `output` with the sort key, reusing its storage.
+    void key_into(std::string_view input, std::string &output,
+        mjb_encoding encoding = MJB_ENC_UTF_8) {
+        size_t size = output.capacity();
+        output.resize(size);
+        mjb_status status = mjb_collator_key_into(&data, input.data(), input.size(), encoding,
+            output.data(), &size);
+
+        if(status == MJB_STATUS_OUTPUT_TOO_SMALL) {
+            output.resize(size);
+            status = mjb_collator_key_into(&data, input.data(), input.size(), encoding,
+                output.data(), &size);
+        }
+
+        if(status != MJB_STATUS_OK) {
+            output.clear();
+            detail::check_status(status, "Collation key generation failed");
+        }
+
+        output.resize(size);
+    }
+
+    // Replace `arena` with the sort keys of `inputs` back to back. The key of input `i` spans
+    // `offsets[i]` to `offsets[i + 1]`. Both containers keep their storage between batches.
+    void keys_into(const std::vector<std::string_view> &inputs, std::string &arena,
+        std::vector<size_t> &offsets, mjb_encoding encoding = MJB_ENC_UTF_8) {
+        std::vector<const char *> strings(inputs.size());
+        std::vector<size_t> byte_lengths(inputs.size());
+
+        for(size_t i = 0; i < inputs.size(); ++i) {
+            strings[i] = inputs[i].data();
+            byte_lengths[i] = inputs[i].size();
+        }
+
+        size_t size = arena.capacity();
+        arena.resize(size);
+        offsets.resize(inputs.size() + 1);
+        mjb_status status = mjb_collator_keys_into(&data, strings.data(), byte_lengths.data(),
+            inputs.size(), encoding, arena.data(), &size, offsets.data());
+
+        if(status == MJB_STATUS_OUTPUT_TOO_SMALL) {
+            arena.resize(size);
+            status = mjb_collator_keys_into(&data, strings.data(), byte_lengths.data(),
+                inputs.size(), encoding, arena.data(), &size, offsets.data());
+        }
+
+        if(status != MJB_STATUS_OK) {
+            arena.clear();
+            offsets.clear();
+            detail::check_status(status, "Collation key generation failed");
+        }
+
+        arena.resize(size);
+    }
+};
+
 struct EmojiSequence {
     mjb_emoji_sequence data{};
 
@@ -1225,6 +1611,22 @@ inline void set_allocator(const mjb_allocator *allocator) {
     return input.substr(0, n);
 }
 
+[[nodiscard]] inline std::vector<size_t> segment(std::string_view input, mjb_segment_kind kind,
+    mjb_encoding encoding = MJB_ENC_UTF_8) {
+    size_t count = 0;
+    detail::check_status(mjb_segment(input.data(), input.size(), encoding, kind, nullptr, &count),
+        "Segmentation failed");
+    std::vector<size_t> offsets(count);
+
+    if(count != 0) {
+        detail::check_status(mjb_segment(input.data(), input.size(), encoding, kind,
+                                 offsets.data(), &count),
+            "Segmentation failed");
+    }
+
+    return offsets;
+}
+
 class BidiParagraph {
     mjb_bidi_paragraph data{};
 
@@ -1345,6 +1747,123 @@ class BidiParagraph {
     }
 };
 
+/**
+ * See the mjb_bidi_workspace struct for details. Reuses its buffers across calls; not thread-safe.
+ */
+class BidiWorkspace {
+    mjb_bidi_workspace data{};
+    mjb_bidi_paragraph paragraph{};
+
+  public:
+    BidiWorkspace() {
+        detail::check_status(mjb_bidi_workspace_init(&data),
+            "Bidirectional workspace initialization failed");
+    }
+
+    BidiWorkspace(const BidiWorkspace &) = delete;
+    BidiWorkspace &operator=(const BidiWorkspace &) = delete;
+
+    BidiWorkspace(BidiWorkspace &&other) noexcept : data(other.data), paragraph(other.paragraph) {
+        other.data = {};
+        other.paragraph = {};
+    }
+
+    BidiWorkspace &operator=(BidiWorkspace &&other) noexcept {
+        if(this != &other) {
+            mjb_bidi_workspace_free(&data);
+            data = other.data;
+            paragraph = other.paragraph;
+            other.data = {};
+            other.paragraph = {};
+        }
+
+        return *this;
+    }
+
+    ~BidiWorkspace() {
+        mjb_bidi_workspace_free(&data);
+    }
+
+    // The paragraph is valid until the next call to resolve.
+    const mjb_bidi_paragraph &resolve(std::string_view input,
+        mjb_direction direction = MJB_DIRECTION_AUTO, mjb_encoding encoding = MJB_ENC_UTF_8) {
+        detail::check_status(mjb_bidi_workspace_resolve(&data, input.data(), input.size(), encoding,
+                                 direction, &paragraph),
+            "Bidirectional paragraph resolution failed");
+
+        return paragraph;
+    }
+};
+
+/**
+ * See the mjb_bidi_document struct for details. Iterates over the paragraphs of the document.
+ */
+class BidiDocument {
+    mjb_bidi_document data{};
+
+  public:
+    explicit BidiDocument(std::string_view input, mjb_direction direction = MJB_DIRECTION_AUTO,
+        mjb_encoding encoding = MJB_ENC_UTF_8, mjb_parallel_for_fn parallel_for = nullptr,
+        void *pool = nullptr) {
+        detail::check_status(mjb_bidi_resolve_document(input.data(), input.size(), encoding,
+                                 direction, parallel_for, pool, &data),
+            "Bidirectional document resolution failed");
+    }
+
+    BidiDocument(const BidiDocument &) = delete;
+    BidiDocument &operator=(const BidiDocument &) = delete;
+
+    BidiDocument(BidiDocument &&other) noexcept : data(other.data) {
+        other.data = {};
+    }
+
+    BidiDocument &operator=(BidiDocument &&other) noexcept {
+        if(this != &other) {
+            mjb_bidi_document_free(&data);
+            data = other.data;
+            other.data = {};
+        }
+
+        return *this;
+    }
+
+    ~BidiDocument() {
+        mjb_bidi_document_free(&data);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return data.paragraph_count == 0;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return data.paragraph_count;
+    }
+
+    [[nodiscard]] const mjb_bidi_paragraph *begin() const noexcept {
+        return data.paragraphs;
+    }
+
+    [[nodiscard]] const mjb_bidi_paragraph *end() const noexcept {
+        return data.paragraphs == nullptr ? nullptr : data.paragraphs + data.paragraph_count;
+    }
+
+    [[nodiscard]] const mjb_bidi_paragraph &operator[](size_t index) const noexcept {
+        return data.paragraphs[index];
+    }
+
+    [[nodiscard]] const mjb_bidi_paragraph &at(size_t index) const {
+        if(index >= data.paragraph_count) {
+            throw std::out_of_range("BidiDocument paragraph index out of range");
+        }
+
+        return data.paragraphs[index];
+    }
+
+    [[nodiscard]] const mjb_bidi_document &raw() const noexcept {
+        return data;
+    }
+};
+
 struct BreakResult {
     size_t index;
     mjb_codepoint codepoint;
@@ -97,9 +97,19 @@ MJB_EXPORT bool mjb_is_utf8(const char *buffer, size_t byte_length) {
     mjb_codepoint codepoint = MJB_CODEPOINT_NOT_VALID;
 
     // Loop through the string.
-    for(size_t i = 0; i < byte_length; ++i) {
+    for(size_t i = 0; i < byte_length;) {
+        if(state == MJB_UTF_ACCEPT) {
+            // Skip ASCII runs in bulk between multibyte sequences.
+            i += mjb_utf8_ascii_span(buffer + i, byte_length - i);
+
+            if(i == byte_length) {
+                break;
+            }
+        }
+
         // Find next codepoint.
         state = mjb_utf8_decode_step(state, buffer[i], &codepoint);
+        ++i;
 
         if(state == MJB_UTF_REJECT) {
             // The string is not well-formed.
@@ -123,14 +133,8 @@ MJB_EXPORT bool mjb_is_ascii(const char *buffer, size_t byte_length) {
         return false;
     }
 
-    for(size_t i = 0; i < byte_length; ++i) {
-        // Every character must have leading bit at zero.
-        if(buffer[i] & 0x80) {
-            return false;
-        }
-    }
-
-    return 1;
+    // Every character must have leading bit at zero.
+    return mjb_utf8_ascii_span(buffer, byte_length) == byte_length;
 }
 
 /**
@@ -19,7 +19,7 @@ static mjb_status mjb_filter_process(const mjb_filter_context *context, mjb_outp
     bool *transformed) {
     uint8_t state = MJB_UTF_ACCEPT;
     mjb_codepoint codepoint = 0;
-    mjb_character character;
+    mjb_codepoint_record record;
     bool last_was_whitespace = false;
     size_t combining_mark_count = 0;
     bool any_transformation = false;
@@ -41,25 +41,25 @@ static mjb_status mjb_filter_process(const mjb_filter_context *context, mjb_outp
             any_transformation = true;
         }
 
-        // Get current character.
-        if(mjb_codepoint_info(codepoint, &character) != MJB_STATUS_OK) {
+        // Get current character properties.
+        if(!mjb_codepoint_record_lookup(codepoint, &record)) {
             continue;
         }
 
         mjb_codepoint original_codepoint = codepoint;
 
         // Check if current codepoint is whitespace.
-        bool is_whitespace = (character.category == MJB_CATEGORY_ZS ||
-            character.category == MJB_CATEGORY_ZL || character.category == MJB_CATEGORY_ZP ||
+        bool is_whitespace = (record.category == MJB_CATEGORY_ZS ||
+            record.category == MJB_CATEGORY_ZL || record.category == MJB_CATEGORY_ZP ||
             codepoint == 0x09 || // Tab
             codepoint == 0x0A || // Line feed
             codepoint == 0x0B || // Vertical tab
             codepoint == 0x0C || // Form feed
             codepoint == 0x0D);  // Carriage return
-        bool is_combining = mjb_category_is_combining(character.category);
+        bool is_combining = mjb_category_is_combining((mjb_category)record.category);
 
         if(context->filters & MJB_FILTER_CONTROLS) {
-            if(character.category == MJB_CATEGORY_CC && codepoint != 0x09 && // Tab
+            if(record.category == MJB_CATEGORY_CC && codepoint != 0x09 && // Tab
                 codepoint != 0x0A &&                                         // Line feed
                 codepoint != 0x0B &&                                         // Vertical tab
                 codepoint != 0x0C &&                                         // Form feed
@@ -97,8 +97,8 @@ static mjb_status mjb_filter_process(const mjb_filter_context *context, mjb_outp
             }
         }
 
-        if((context->filters & MJB_FILTER_NUMERIC) && character.decimal != MJB_NUMBER_NOT_VALID) {
-            codepoint = 0x30 + character.decimal; // U+0030 DIGIT ZERO
+        if((context->filters & MJB_FILTER_NUMERIC) && record.decimal != MJB_NUMBER_NOT_VALID) {
+            codepoint = 0x30 + record.decimal; // U+0030 DIGIT ZERO
 
             if(original_codepoint != codepoint) {
                 any_transformation = true;
@@ -12,6 +12,8 @@
 #include "utf.h"
 
 #if MJB_FEATURE_IDNA
+#define MJB_IDNA_DOMAIN_MAX 253
+
 typedef struct mjb_idna_codepoints {
     mjb_codepoint *values;
     size_t count;
@@ -25,29 +27,94 @@ typedef enum mjb_idna_joining_type {
     MJB_IDNA_TRANSPARENT
 } mjb_idna_joining_type;
 
-static void mjb_idna_codepoints_free(mjb_idna_codepoints *codepoints) {
-    mjb_free(codepoints->values);
-    codepoints->values = NULL;
-    codepoints->count = 0;
+/**
+ * The scratch of one IDNA call, over the storage of an mjb_idna_context. Stage outputs grow from
+ * the start and live until the end of the call, while label codepoints are taken from the end and
+ * released after each label. Running out of room reports MJB_STATUS_OUTPUT_TOO_SMALL, and the call
+ * is repeated with a larger scratch.
+ */
+typedef struct mjb_idna_arena {
+    char *base;
+    size_t used;
+    size_t end;
+} mjb_idna_arena;
+
+/**
+ * A direct-mapped cache of top-level labels, used by batches where most domains end in a handful
+ * of TLDs. An entry is keyed by the Unicode form of the label and keeps its validation errors, as
+ * checked in a bidi domain, and its ASCII form once encoded. Labels over 63 bytes are not cached.
+ */
+#define MJB_IDNA_CACHE_SIZE 16
+#define MJB_IDNA_LABEL_MAX 63
+
+typedef struct mjb_idna_cached_label {
+    char label[MJB_IDNA_LABEL_MAX];
+    char ascii[MJB_IDNA_LABEL_MAX];
+    uint8_t label_length;
+    uint8_t ascii_length;
+    uint32_t errors;
+} mjb_idna_cached_label;
+
+typedef struct mjb_idna_label_cache {
+    mjb_idna_cached_label labels[MJB_IDNA_CACHE_SIZE];
+} mjb_idna_label_cache;
+
+// Open an output over the free space of the arena.
+static void mjb_idna_arena_open(mjb_idna_arena *arena, mjb_output *output) {
+    output->buffer = arena->base + arena->used;
+    output->size = 0;
+    output->capacity = arena->end - arena->used;
+    output->mode = MJB_OUTPUT_FIXED;
 }
 
-static mjb_status mjb_idna_decode_utf8(const char *buffer, size_t byte_length,
-    mjb_idna_codepoints *codepoints) {
-    codepoints->values = NULL;
-    codepoints->count = 0;
+static void mjb_idna_arena_commit(mjb_idna_arena *arena, const mjb_output *output) {
+    arena->used += output->size;
+}
 
-    if(byte_length == 0) {
-        return MJB_STATUS_OK;
+/**
+ * Take room for `count` codepoints from the end of the arena, above the bytes already written to
+ * the open output, if any. Release it with mjb_idna_arena_release and the previous end.
+ */
+static mjb_codepoint *mjb_idna_arena_codepoints(mjb_idna_arena *arena, mjb_output *open,
+    size_t count) {
+    uintptr_t floor = (uintptr_t)(arena->base + arena->used + (open != NULL ? open->size : 0));
+    uintptr_t end = (uintptr_t)(arena->base + arena->end);
+
+    if(count > (end - floor) / sizeof(mjb_codepoint)) {
+        return NULL;
     }
 
-    if(byte_length > SIZE_MAX / sizeof(mjb_codepoint)) {
-        return MJB_STATUS_OVERFLOW;
+    uintptr_t start = (end - count * sizeof(mjb_codepoint)) &
+        ~(uintptr_t)(sizeof(mjb_codepoint) - 1);
+
+    if(start < floor) {
+        return NULL;
+    }
+
+    arena->end = (size_t)(start - (uintptr_t)arena->base);
+
+    if(open != NULL) {
+        open->capacity = arena->end - arena->used;
+    }
+
+    return (mjb_codepoint *)start;
+}
+
+static void mjb_idna_arena_release(mjb_idna_arena *arena, mjb_output *open, size_t end) {
+    arena->end = end;
+
+    if(open != NULL) {
+        open->capacity = end - arena->used;
     }
+}
 
-    codepoints->values = (mjb_codepoint *)mjb_alloc(byte_length * sizeof(mjb_codepoint));
+static mjb_status mjb_idna_decode_utf8(mjb_idna_arena *arena, mjb_output *open,
+    const char *buffer, size_t byte_length, mjb_idna_codepoints *codepoints) {
+    codepoints->count = 0;
+    codepoints->values = mjb_idna_arena_codepoints(arena, open, byte_length);
 
     if(codepoints->values == NULL) {
-        return MJB_STATUS_NO_MEMORY;
+        return MJB_STATUS_OUTPUT_TOO_SMALL;
     }
 
     uint8_t state = MJB_UTF_ACCEPT;
@@ -63,7 +130,6 @@ static mjb_status mjb_idna_decode_utf8(const char *buffer, size_t byte_length,
         }
 
         if(decoded == MJB_DECODE_ERROR) {
-            mjb_idna_codepoints_free(codepoints);
             return MJB_STATUS_MALFORMED_INPUT;
         }
 
@@ -75,31 +141,8 @@ static mjb_status mjb_idna_decode_utf8(const char *buffer, size_t byte_length,
     return MJB_STATUS_OK;
 }
 
-static mjb_status mjb_idna_new_output(size_t capacity, mjb_output *output) {
-    if(capacity == 0) {
-        capacity = 1;
-    }
-
-    char *buffer = (char *)mjb_alloc(capacity);
-
-    if(buffer == NULL) {
-        return MJB_STATUS_NO_MEMORY;
-    }
-
-    buffer[0] = '\0';
-    mjb_output_init_dynamic(output, buffer, capacity);
-
-    return MJB_STATUS_OK;
-}
-
 static mjb_status mjb_idna_map(const char *buffer, size_t byte_length, mjb_encoding encoding,
     mjb_output *mapped) {
-    mjb_status status = mjb_idna_new_output(byte_length, mapped);
-
-    if(status != MJB_STATUS_OK) {
-        return status;
-    }
-
     uint8_t state = MJB_UTF_ACCEPT;
     bool in_error = false;
     mjb_codepoint codepoint = 0;
@@ -117,8 +160,7 @@ static mjb_status mjb_idna_map(const char *buffer, size_t byte_length, mjb_encod
         }
 
         if(decoded == MJB_DECODE_ERROR) {
-            status = MJB_STATUS_MALFORMED_INPUT;
-            goto fail;
+            return MJB_STATUS_MALFORMED_INPUT;
         }
 
         mjb_unicode_idna_status mapping_status;
@@ -126,37 +168,29 @@ static mjb_status mjb_idna_map(const char *buffer, size_t byte_length, mjb_encod
         uint8_t mapping_length;
 
         if(!mjb_unicode_idna_lookup(codepoint, &mapping_status, &mapping, &mapping_length)) {
-            status = MJB_STATUS_INVALID_CODEPOINT;
-            goto fail;
+            return MJB_STATUS_INVALID_CODEPOINT;
         }
 
         if(mapping_status == MJB_UNICODE_IDNA_IGNORED) {
             continue;
         }
 
+        mjb_status status = MJB_STATUS_OK;
+
         if(mapping_status == MJB_UNICODE_IDNA_MAPPED) {
-            for(uint8_t i = 0; i < mapping_length; ++i) {
+            for(uint8_t i = 0; i < mapping_length && status == MJB_STATUS_OK; ++i) {
                 status = mjb_output_codepoint(mapped, mapping[i], MJB_ENC_UTF_8);
-
-                if(status != MJB_STATUS_OK) {
-                    goto fail;
-                }
             }
         } else {
             status = mjb_output_codepoint(mapped, codepoint, MJB_ENC_UTF_8);
+        }
 
-            if(status != MJB_STATUS_OK) {
-                goto fail;
-            }
+        if(status != MJB_STATUS_OK) {
+            return status;
         }
     }
 
     return MJB_STATUS_OK;
-
-fail:
-    mjb_free(mapped->buffer);
-    mapped->buffer = NULL;
-    return status;
 }
 
 static bool mjb_idna_starts_with_ace(const char *label, size_t byte_length) {
@@ -164,45 +198,21 @@ static bool mjb_idna_starts_with_ace(const char *label, size_t byte_length) {
         label[3] == '-';
 }
 
-static mjb_status mjb_idna_decode_label(const char *label, size_t byte_length, mjb_output *unicode,
-    mjb_idna_info *info) {
-    if(!mjb_idna_starts_with_ace(label, byte_length)) {
-        return mjb_output_write(unicode, label, byte_length);
-    }
-
-    mjb_codepoint *decoded = NULL;
-    size_t count = 0;
-    mjb_status status = mjb_punycode_decode(label + 4, byte_length - 4, &decoded, &count);
-
-    if(status == MJB_STATUS_NO_MEMORY || status == MJB_STATUS_OVERFLOW) {
-        return status;
-    }
-
-    if(status != MJB_STATUS_OK) {
-        info->errors |= MJB_IDNA_ERROR_PUNYCODE;
-        mjb_free(decoded);
-        return mjb_output_write(unicode, label, byte_length);
-    }
-
+static mjb_status mjb_idna_decode_punycode(const char *label, size_t byte_length,
+    const mjb_codepoint *decoded, size_t count, mjb_output *unicode, mjb_idna_info *info) {
     if(count == 0) {
         info->errors |= MJB_IDNA_ERROR_PUNYCODE;
-        mjb_free(decoded);
-
-        if(byte_length == 4) {
-            return MJB_STATUS_OK;
-        }
 
-        return mjb_output_write(unicode, label, byte_length);
+        return byte_length == 4 ? MJB_STATUS_OK : mjb_output_write(unicode, label, byte_length);
     }
 
     bool ascii_only = true;
 
     for(size_t i = 0; i < count; ++i) {
         ascii_only = ascii_only && decoded[i] < 0x80;
-        status = mjb_output_codepoint(unicode, decoded[i], MJB_ENC_UTF_8);
+        mjb_status status = mjb_output_codepoint(unicode, decoded[i], MJB_ENC_UTF_8);
 
         if(status != MJB_STATUS_OK) {
-            mjb_free(decoded);
             return status;
         }
     }
@@ -211,18 +221,40 @@ static mjb_status mjb_idna_decode_label(const char *label, size_t byte_length, m
         info->errors |= MJB_IDNA_ERROR_PUNYCODE;
     }
 
-    mjb_free(decoded);
     return MJB_STATUS_OK;
 }
 
-static mjb_status mjb_idna_decode_domain(const char *buffer, size_t byte_length,
-    mjb_output *unicode, mjb_idna_info *info) {
-    mjb_status status = mjb_idna_new_output(byte_length, unicode);
+static mjb_status mjb_idna_decode_label(mjb_idna_arena *arena, const char *label,
+    size_t byte_length, mjb_output *unicode, mjb_idna_info *info) {
+    if(!mjb_idna_starts_with_ace(label, byte_length)) {
+        return mjb_output_write(unicode, label, byte_length);
+    }
+
+    // A Punycode label never decodes to more codepoints than it has bytes.
+    size_t end = arena->end;
+    mjb_codepoint *decoded = mjb_idna_arena_codepoints(arena, unicode, byte_length - 4);
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+    if(decoded == NULL) {
+        return MJB_STATUS_OUTPUT_TOO_SMALL;
     }
 
+    size_t count = 0;
+    mjb_status status = mjb_punycode_decode(label + 4, byte_length - 4, decoded, &count);
+
+    if(status == MJB_STATUS_OK) {
+        status = mjb_idna_decode_punycode(label, byte_length, decoded, count, unicode, info);
+    } else {
+        info->errors |= MJB_IDNA_ERROR_PUNYCODE;
+        status = mjb_output_write(unicode, label, byte_length);
+    }
+
+    mjb_idna_arena_release(arena, unicode, end);
+
+    return status;
+}
+
+static mjb_status mjb_idna_decode_domain(mjb_idna_arena *arena, const char *buffer,
+    size_t byte_length, mjb_output *unicode, mjb_idna_info *info) {
     size_t label_start = 0;
 
     for(size_t i = 0; i <= byte_length; ++i) {
@@ -230,22 +262,15 @@ static mjb_status mjb_idna_decode_domain(const char *buffer, size_t byte_length,
             continue;
         }
 
-        status = mjb_idna_decode_label(buffer + label_start, i - label_start, unicode, info);
-
-        if(status != MJB_STATUS_OK) {
-            mjb_free(unicode->buffer);
-            unicode->buffer = NULL;
-            return status;
-        }
+        mjb_status status = mjb_idna_decode_label(arena, buffer + label_start, i - label_start,
+            unicode, info);
 
-        if(i != byte_length) {
+        if(status == MJB_STATUS_OK && i != byte_length) {
             status = mjb_output_write(unicode, ".", 1);
+        }
 
-            if(status != MJB_STATUS_OK) {
-                mjb_free(unicode->buffer);
-                unicode->buffer = NULL;
-                return status;
-            }
+        if(status != MJB_STATUS_OK) {
+            return status;
         }
 
         label_start = i + 1;
@@ -262,9 +287,24 @@ static mjb_bidi_class mjb_idna_bidi_class(mjb_codepoint codepoint) {
     return bidi;
 }
 
-static bool mjb_idna_is_bidi_domain(const mjb_idna_codepoints *domain) {
-    for(size_t i = 0; i < domain->count; ++i) {
-        mjb_bidi_class bidi = mjb_idna_bidi_class(domain->values[i]);
+static bool mjb_idna_is_bidi_domain(const char *buffer, size_t byte_length) {
+    uint8_t state = MJB_UTF_ACCEPT;
+    bool in_error = false;
+    mjb_codepoint codepoint = 0;
+
+    for(size_t index = 0; index < byte_length;) {
+        mjb_decode_result decoded = mjb_next_codepoint(buffer, byte_length, &state, &index,
+            MJB_ENC_UTF_8, &codepoint, &in_error);
+
+        if(decoded == MJB_DECODE_END) {
+            break;
+        }
+
+        if(decoded != MJB_DECODE_OK) {
+            continue;
+        }
+
+        mjb_bidi_class bidi = mjb_idna_bidi_class(codepoint);
 
         if(bidi == MJB_PR_BIDI_CLASS_R || bidi == MJB_PR_BIDI_CLASS_AL ||
             bidi == MJB_PR_BIDI_CLASS_AN) {
@@ -406,18 +446,29 @@ static bool mjb_idna_valid_contextj(const mjb_idna_codepoints *label) {
     return true;
 }
 
-static mjb_status mjb_idna_label_is_nfc(const char *label, size_t byte_length, bool *is_nfc) {
-    mjb_result normalized;
-    mjb_status status = mjb_normalize(label, byte_length, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
-        MJB_ENC_UTF_8, &normalized);
+// The NFC form of a label that fails the quick check is written to the free space of the arena.
+static mjb_status mjb_idna_label_is_nfc(mjb_idna_arena *arena, const char *label,
+    size_t byte_length, bool *is_nfc) {
+    mjb_quick_check_result quick_check;
+    mjb_status status = mjb_normalization_quick_check(label, byte_length, MJB_ENC_UTF_8,
+        MJB_NORMALIZATION_NFC, &quick_check);
+
+    if(status != MJB_STATUS_OK || quick_check == MJB_QC_YES) {
+        *is_nfc = true;
+
+        return status;
+    }
+
+    char *normalized = arena->base + arena->used;
+    size_t normalized_size = arena->end - arena->used;
+    status = mjb_normalize_into(label, byte_length, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+        MJB_ENC_UTF_8, normalized, &normalized_size);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    *is_nfc = normalized.output_size == byte_length &&
-        (byte_length == 0 || memcmp(normalized.output, label, byte_length) == 0);
-    mjb_result_free(&normalized);
+    *is_nfc = normalized_size == byte_length && memcmp(normalized, label, byte_length) == 0;
 
     return MJB_STATUS_OK;
 }
@@ -427,8 +478,8 @@ static bool mjb_idna_is_std3_ascii(mjb_codepoint codepoint) {
         codepoint == '-';
 }
 
-static mjb_status mjb_idna_validate_label(const char *label_buffer, size_t byte_length,
-    const mjb_idna_codepoints *label, bool bidi_domain, mjb_idna_info *info) {
+static mjb_status mjb_idna_validate_label(mjb_idna_arena *arena, const char *label_buffer,
+    size_t byte_length, const mjb_idna_codepoints *label, bool bidi_domain, mjb_idna_info *info) {
     if(label->count == 0) {
         info->errors |= MJB_IDNA_ERROR_EMPTY_LABEL;
         return MJB_STATUS_OK;
@@ -440,7 +491,7 @@ static mjb_status mjb_idna_validate_label(const char *label_buffer, size_t byte_
     }
 
     bool is_nfc;
-    mjb_status status = mjb_idna_label_is_nfc(label_buffer, byte_length, &is_nfc);
+    mjb_status status = mjb_idna_label_is_nfc(arena, label_buffer, byte_length, &is_nfc);
 
     if(status != MJB_STATUS_OK) {
         return status;
@@ -484,17 +535,47 @@ static mjb_status mjb_idna_validate_label(const char *label_buffer, size_t byte_
     return MJB_STATUS_OK;
 }
 
-static mjb_status mjb_idna_validate_domain(const char *buffer, size_t byte_length,
-    mjb_idna_info *info) {
-    mjb_idna_codepoints domain;
-    mjb_status status = mjb_idna_decode_utf8(buffer, byte_length, &domain);
+static mjb_status mjb_idna_check_label(mjb_idna_arena *arena, const char *label,
+    size_t byte_length, bool bidi_domain, mjb_idna_info *info) {
+    size_t end = arena->end;
+    mjb_idna_codepoints codepoints;
+    mjb_status status = mjb_idna_decode_utf8(arena, NULL, label, byte_length, &codepoints);
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+    if(status == MJB_STATUS_OK) {
+        status = mjb_idna_validate_label(arena, label, byte_length, &codepoints, bidi_domain,
+            info);
+    }
+
+    mjb_idna_arena_release(arena, NULL, end);
+
+    return status;
+}
+
+// The cache entry of a label, or NULL if there is no cache or the label cannot be cached. `hit` is
+// set when the entry already holds the label.
+static mjb_idna_cached_label *mjb_idna_cache_slot(mjb_idna_label_cache *cache, const char *label,
+    size_t byte_length, bool *hit) {
+    *hit = false;
+
+    if(cache == NULL || byte_length == 0 || byte_length > MJB_IDNA_LABEL_MAX) {
+        return NULL;
+    }
+
+    uint32_t hash = 2166136261u;
+
+    for(size_t i = 0; i < byte_length; ++i) {
+        hash = (hash ^ (uint8_t)label[i]) * 16777619u;
     }
 
-    bool bidi_domain = mjb_idna_is_bidi_domain(&domain);
-    mjb_idna_codepoints_free(&domain);
+    mjb_idna_cached_label *cached = &cache->labels[hash & (MJB_IDNA_CACHE_SIZE - 1)];
+    *hit = cached->label_length == byte_length && memcmp(cached->label, label, byte_length) == 0;
+
+    return cached;
+}
+
+static mjb_status mjb_idna_validate_domain(mjb_idna_arena *arena, const char *buffer,
+    size_t byte_length, mjb_idna_label_cache *cache, mjb_idna_info *info) {
+    bool bidi_domain = mjb_idna_is_bidi_domain(buffer, byte_length);
     size_t label_start = 0;
 
     for(size_t i = 0; i <= byte_length; ++i) {
@@ -502,25 +583,39 @@ static mjb_status mjb_idna_validate_domain(const char *buffer, size_t byte_lengt
             continue;
         }
 
-        mjb_idna_codepoints label;
-        status = mjb_idna_decode_utf8(buffer + label_start, i - label_start, &label);
-
-        if(status != MJB_STATUS_OK) {
-            return status;
-        }
-
         bool trailing_root = i == byte_length && i > 0 && buffer[i - 1] == '.';
 
-        if(trailing_root) {
-            status = MJB_STATUS_OK;
-        } else {
-            status = mjb_idna_validate_label(buffer + label_start, i - label_start, &label,
-                bidi_domain, info);
-        }
-        mjb_idna_codepoints_free(&label);
+        if(!trailing_root) {
+            const char *label = buffer + label_start;
+            size_t length = i - label_start;
+            bool hit = false;
+            mjb_idna_cached_label *cached = i + 1 >= byte_length ?
+                mjb_idna_cache_slot(cache, label, length, &hit) : NULL;
+            mjb_status status = MJB_STATUS_OK;
+
+            if(cached == NULL) {
+                status = mjb_idna_check_label(arena, label, length, bidi_domain, info);
+            } else if(!hit) {
+                mjb_idna_info label_info = { MJB_IDNA_ERROR_NONE };
+                status = mjb_idna_check_label(arena, label, length, true, &label_info);
+
+                if(status == MJB_STATUS_OK) {
+                    memcpy(cached->label, label, length);
+                    cached->label_length = (uint8_t)length;
+                    cached->ascii_length = 0;
+                    cached->errors = label_info.errors;
+                }
+            }
 
-        if(status != MJB_STATUS_OK) {
-            return status;
+            if(status != MJB_STATUS_OK) {
+                return status;
+            }
+
+            // Only the bidi rule depends on the rest of the domain.
+            if(cached != NULL) {
+                info->errors |= bidi_domain ? cached->errors :
+                                              cached->errors & ~(uint32_t)MJB_IDNA_ERROR_BIDI;
+            }
         }
 
         label_start = i + 1;
@@ -553,14 +648,8 @@ static mjb_status mjb_idna_encode_label(const char *label_buffer, size_t byte_le
     return mjb_punycode_encode(label->values, label->count, ascii);
 }
 
-static mjb_status mjb_idna_encode_domain(const char *buffer, size_t byte_length, mjb_output *ascii,
-    mjb_idna_info *info) {
-    mjb_status status = mjb_idna_new_output(byte_length, ascii);
-
-    if(status != MJB_STATUS_OK) {
-        return status;
-    }
-
+static mjb_status mjb_idna_encode_domain(mjb_idna_arena *arena, const char *buffer,
+    size_t byte_length, mjb_idna_label_cache *cache, mjb_output *ascii, mjb_idna_info *info) {
     size_t label_start = 0;
 
     for(size_t i = 0; i <= byte_length; ++i) {
@@ -568,19 +657,38 @@ static mjb_status mjb_idna_encode_domain(const char *buffer, size_t byte_length,
             continue;
         }
 
-        mjb_idna_codepoints label;
-        status = mjb_idna_decode_utf8(buffer + label_start, i - label_start, &label);
+        const char *label = buffer + label_start;
+        size_t length = i - label_start;
+        size_t output_start = ascii->size;
+        bool hit = false;
+        mjb_idna_cached_label *cached = i + 1 >= byte_length ?
+            mjb_idna_cache_slot(cache, label, length, &hit) : NULL;
+        mjb_status status;
 
-        if(status != MJB_STATUS_OK) {
-            goto fail;
-        }
+        if(hit && cached->ascii_length != 0) {
+            status = mjb_output_write(ascii, cached->ascii, cached->ascii_length);
+        } else {
+            size_t end = arena->end;
+            mjb_idna_codepoints codepoints;
+            status = mjb_idna_decode_utf8(arena, ascii, label, length, &codepoints);
 
-        size_t output_start = ascii->size;
-        status = mjb_idna_encode_label(buffer + label_start, i - label_start, &label, ascii);
-        mjb_idna_codepoints_free(&label);
+            if(status == MJB_STATUS_OK) {
+                status = mjb_idna_encode_label(label, length, &codepoints, ascii);
+            }
+
+            mjb_idna_arena_release(arena, ascii, end);
+
+            // The validation pass stored the label, so a cacheable label is a hit here.
+            size_t written = ascii->size - output_start;
+
+            if(status == MJB_STATUS_OK && hit && written <= MJB_IDNA_LABEL_MAX) {
+                memcpy(cached->ascii, ascii->buffer + output_start, written);
+                cached->ascii_length = (uint8_t)written;
+            }
+        }
 
         if(status != MJB_STATUS_OK) {
-            goto fail;
+            return status;
         }
 
         size_t output_length = ascii->size - output_start;
@@ -593,210 +701,591 @@ static mjb_status mjb_idna_encode_domain(const char *buffer, size_t byte_length,
             status = mjb_output_write(ascii, ".", 1);
 
             if(status != MJB_STATUS_OK) {
-                goto fail;
+                return status;
             }
         }
 
         label_start = i + 1;
     }
 
-    if(ascii->size == 0 || ascii->size > 253) {
+    if(ascii->size == 0 || ascii->size > MJB_IDNA_DOMAIN_MAX) {
         info->errors |= MJB_IDNA_ERROR_DOMAIN_LENGTH;
     }
 
     return MJB_STATUS_OK;
-
-fail:
-    mjb_free(ascii->buffer);
-    ascii->buffer = NULL;
-    return status;
 }
 
-static mjb_status mjb_idna_finish_output(mjb_output *output, mjb_encoding output_encoding,
-    mjb_result *result) {
+static mjb_status mjb_idna_finish_result(const char *domain, size_t size,
+    mjb_encoding output_encoding, mjb_result *result) {
     if(output_encoding == MJB_ENC_UTF_8) {
-        result->output = output->buffer;
-        result->output_size = output->size;
+        char *output = (char *)mjb_alloc(size + 1);
+
+        if(output == NULL) {
+            return MJB_STATUS_NO_MEMORY;
+        }
+
+        memcpy(output, domain, size);
+        output[size] = '\0';
+        result->output = output;
+        result->output_size = size;
         result->transformed = true;
-        output->buffer = NULL;
+
         return MJB_STATUS_OK;
     }
 
-    if(output->size == 0) {
-        mjb_free(output->buffer);
-        output->buffer = NULL;
-        result->output = NULL;
-        result->output_size = 0;
-        result->transformed = false;
+    if(size == 0) {
         return MJB_STATUS_OK;
     }
 
-    mjb_status status = mjb_convert_encoding(output->buffer, output->size, MJB_ENC_UTF_8,
-        output_encoding, result);
-    mjb_free(output->buffer);
-    output->buffer = NULL;
+    return mjb_convert_encoding(domain, size, MJB_ENC_UTF_8, output_encoding, result);
+}
+
+/**
+ * Whether the domain is LDH ASCII that passes every UTS #46 check unchanged, apart from case.
+ * Such a domain has no "xn--" label to decode, is already NFC and has no bidi or CONTEXTJ rule to
+ * apply, so its ASCII and Unicode forms are the lowercased input. Anything else, including a
+ * trailing root label, takes the full path.
+ */
+static bool mjb_idna_is_plain_ldh(const char *buffer, size_t byte_length, mjb_encoding encoding) {
+    if((encoding != MJB_ENC_UTF_8 && encoding != MJB_ENC_ASCII) || byte_length == 0 ||
+        byte_length > MJB_IDNA_DOMAIN_MAX) {
+        return false;
+    }
+
+    size_t label_start = 0;
 
-    return status;
+    for(size_t i = 0; i <= byte_length; ++i) {
+        if(i != byte_length && buffer[i] != '.') {
+            char character = buffer[i];
+
+            if(!mjb_idna_is_std3_ascii((mjb_codepoint)(uint8_t)character) &&
+                !(character >= 'A' && character <= 'Z')) {
+                return false;
+            }
+
+            continue;
+        }
+
+        const char *label = buffer + label_start;
+        size_t length = i - label_start;
+
+        if(length == 0 || length > 63 || label[0] == '-' || label[length - 1] == '-' ||
+            (length >= 4 && label[2] == '-' && label[3] == '-')) {
+            return false;
+        }
+
+        label_start = i + 1;
+    }
+
+    return true;
 }
 
-static mjb_status mjb_idna_process(const char *buffer, size_t byte_length, mjb_encoding encoding,
-    mjb_encoding output_encoding, bool to_ascii, mjb_idna_info *info, mjb_result *result) {
-    if(info == NULL || result == NULL || (buffer == NULL && byte_length > 0)) {
-        return MJB_STATUS_INVALID_ARGUMENT;
+static void mjb_idna_ascii_lower(const char *buffer, size_t byte_length, char *output) {
+    for(size_t i = 0; i < byte_length; ++i) {
+        output[i] = buffer[i] >= 'A' && buffer[i] <= 'Z' ? (char)(buffer[i] | 0x20) : buffer[i];
     }
+}
 
-    info->errors = MJB_IDNA_ERROR_NONE;
-    result->output = NULL;
-    result->output_size = 0;
-    result->transformed = false;
+/**
+ * Validate the arguments shared by every entry point and resolve the input length. `plain` tells
+ * whether the domain can skip the pipeline, see mjb_idna_is_plain_ldh.
+ */
+static mjb_status mjb_idna_prepare(const char *buffer, size_t *byte_length, mjb_encoding encoding,
+    mjb_encoding output_encoding, bool *plain) {
+    *plain = false;
 
     if(!mjb_encoding_is_valid_input(encoding) || !mjb_encoding_is_valid_output(output_encoding)) {
         return MJB_STATUS_INVALID_ENCODING;
     }
 
-    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+    mjb_status status = mjb_resolve_input_byte_length(buffer, byte_length, encoding);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
+    *plain = mjb_idna_is_plain_ldh(buffer, *byte_length, encoding);
+
+    if(*plain) {
+        return MJB_STATUS_OK;
+    }
+
     if(encoding == MJB_ENC_ASCII) {
-        for(size_t i = 0; i < byte_length; ++i) {
+        for(size_t i = 0; i < *byte_length; ++i) {
             if(((uint8_t)buffer[i] & 0x80) != 0) {
                 return MJB_STATUS_MALFORMED_INPUT;
             }
         }
     }
 
-    status = mjb_validate_code_unit_sequence(buffer, byte_length, encoding);
+    return mjb_validate_code_unit_sequence(buffer, *byte_length, encoding);
+}
 
-    if(status != MJB_STATUS_OK) {
-        return status;
-    }
+// Map, normalize, decode, validate and optionally encode the domain inside the arena.
+static mjb_status mjb_idna_run(mjb_idna_arena *arena, const char *buffer, size_t byte_length,
+    mjb_encoding encoding, bool to_ascii, mjb_idna_label_cache *cache, mjb_idna_info *info,
+    mjb_output *domain) {
+    info->errors = MJB_IDNA_ERROR_NONE;
 
     mjb_output mapped;
-    status = mjb_idna_map(buffer, byte_length, encoding, &mapped);
+    mjb_idna_arena_open(arena, &mapped);
+    mjb_status status = mjb_idna_map(buffer, byte_length, encoding, &mapped);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    mjb_result normalized;
-    status = mjb_normalize(mapped.buffer, mapped.size, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
-        MJB_ENC_UTF_8, &normalized);
+    mjb_idna_arena_commit(arena, &mapped);
+
+    char *normalized = arena->base + arena->used;
+    size_t normalized_size = arena->end - arena->used;
+    status = mjb_normalize_into(mapped.buffer, mapped.size, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+        MJB_ENC_UTF_8, normalized, &normalized_size);
 
     if(status != MJB_STATUS_OK) {
-        mjb_free(mapped.buffer);
         return status;
     }
 
-    const char *normalized_buffer = normalized.output;
-    size_t normalized_size = normalized.output_size;
+    arena->used += normalized_size;
+
     mjb_output unicode;
-    status = mjb_idna_decode_domain(normalized_buffer, normalized_size, &unicode, info);
-    mjb_result_free(&normalized);
-    mjb_free(mapped.buffer);
+    mjb_idna_arena_open(arena, &unicode);
+    status = mjb_idna_decode_domain(arena, normalized, normalized_size, &unicode, info);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    status = mjb_idna_validate_domain(unicode.buffer, unicode.size, info);
+    mjb_idna_arena_commit(arena, &unicode);
+    status = mjb_idna_validate_domain(arena, unicode.buffer, unicode.size, cache, info);
 
-    if(status != MJB_STATUS_OK) {
-        mjb_free(unicode.buffer);
-        return status;
-    }
+    if(status != MJB_STATUS_OK || !to_ascii) {
+        *domain = unicode;
 
-    if(!to_ascii) {
-        status = mjb_idna_finish_output(&unicode, output_encoding, result);
-        mjb_free(unicode.buffer);
         return status;
     }
 
-    mjb_output ascii;
-    status = mjb_idna_encode_domain(unicode.buffer, unicode.size, &ascii, info);
-    mjb_free(unicode.buffer);
+    mjb_idna_arena_open(arena, domain);
+    status = mjb_idna_encode_domain(arena, unicode.buffer, unicode.size, cache, domain, info);
 
-    if(status != MJB_STATUS_OK) {
-        return status;
+    if(status == MJB_STATUS_OK) {
+        mjb_idna_arena_commit(arena, domain);
     }
 
-    status = mjb_idna_finish_output(&ascii, output_encoding, result);
-    mjb_free(ascii.buffer);
     return status;
 }
-#endif // MJB_FEATURE_IDNA
 
-MJB_EXPORT mjb_status mjb_idna_to_ascii(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, mjb_result *result) {
-#if MJB_FEATURE_IDNA
-    return mjb_idna_process(buffer, byte_length, encoding, output_encoding, true, info, result);
-#else
-    (void)buffer;
-    (void)byte_length;
-    (void)encoding;
-    (void)output_encoding;
-    (void)info;
-    (void)result;
-    return MJB_STATUS_FEATURE_NOT_ENABLED;
-#endif
+static mjb_status mjb_idna_context_grow(mjb_idna_context *context) {
+    size_t capacity = MJB_IDNA_SCRATCH_SIZE;
+
+    if(context->capacity >= capacity) {
+        if(context->capacity > SIZE_MAX / 2) {
+            return MJB_STATUS_OVERFLOW;
+        }
+
+        capacity = context->capacity * 2;
+    }
+
+    char *scratch = (char *)(context->owned ? mjb_realloc(context->scratch, capacity) :
+                                              mjb_alloc(capacity));
+
+    if(scratch == NULL) {
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    context->scratch = scratch;
+    context->capacity = capacity;
+    context->owned = true;
+
+    return MJB_STATUS_OK;
 }
 
-MJB_EXPORT mjb_status mjb_idna_to_unicode(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, mjb_result *result) {
-#if MJB_FEATURE_IDNA
-    return mjb_idna_process(buffer, byte_length, encoding, output_encoding, false, info, result);
-#else
-    (void)buffer;
-    (void)byte_length;
-    (void)encoding;
-    (void)output_encoding;
-    (void)info;
-    (void)result;
-    return MJB_STATUS_FEATURE_NOT_ENABLED;
-#endif
+// Run the pipeline in the context scratch, growing it until the domain fits.
+static mjb_status mjb_idna_context_run(mjb_idna_context *context, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, bool to_ascii, mjb_idna_label_cache *cache,
+    mjb_idna_info *info, mjb_output *domain) {
+    mjb_status status = MJB_STATUS_OUTPUT_TOO_SMALL;
+
+    if(context->capacity > 0) {
+        mjb_idna_arena arena = { context->scratch, 0, context->capacity };
+        status = mjb_idna_run(&arena, buffer, byte_length, encoding, to_ascii, cache, info,
+            domain);
+    }
+
+    while(status == MJB_STATUS_OUTPUT_TOO_SMALL) {
+        status = mjb_idna_context_grow(context);
+
+        if(status != MJB_STATUS_OK) {
+            break;
+        }
+
+        mjb_idna_arena arena = { context->scratch, 0, context->capacity };
+        status = mjb_idna_run(&arena, buffer, byte_length, encoding, to_ascii, cache, info,
+            domain);
+    }
+
+    return status;
 }
 
-#if MJB_FEATURE_IDNA
-static mjb_status mjb_idna_into(const char *buffer, size_t byte_length, mjb_encoding encoding,
-    mjb_encoding output_encoding, bool to_ascii, mjb_idna_info *info, void *output,
-    size_t *output_size) {
+static mjb_status mjb_idna_process(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    mjb_encoding output_encoding, bool to_ascii, mjb_idna_info *info, mjb_result *result) {
+    if(info == NULL || result == NULL || (buffer == NULL && byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    info->errors = MJB_IDNA_ERROR_NONE;
+    result->output = NULL;
+    result->output_size = 0;
+    result->transformed = false;
+
+    bool plain;
+    mjb_status status = mjb_idna_prepare(buffer, &byte_length, encoding, output_encoding, &plain);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    if(plain) {
+        char lowered[MJB_IDNA_DOMAIN_MAX];
+        mjb_idna_ascii_lower(buffer, byte_length, lowered);
+
+        return mjb_idna_finish_result(lowered, byte_length, output_encoding, result);
+    }
+
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context context = { scratch, sizeof(scratch), false };
+    mjb_output domain;
+    status = mjb_idna_context_run(&context, buffer, byte_length, encoding, to_ascii, NULL, info,
+        &domain);
+
+    if(status == MJB_STATUS_OK) {
+        status = mjb_idna_finish_result(domain.buffer, domain.size, output_encoding, result);
+    }
+
+    mjb_idna_context_free(&context);
+
+    return status;
+}
+
+static mjb_status mjb_idna_into(mjb_idna_context *context, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, mjb_encoding output_encoding, bool to_ascii,
+    mjb_idna_info *info, void *output, size_t *output_size) {
     if(output_size == NULL) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
     size_t capacity = output == NULL ? 0 : *output_size;
     *output_size = 0;
-    mjb_result result;
-    mjb_status status = mjb_idna_process(buffer, byte_length, encoding, output_encoding, to_ascii,
-        info, &result);
+
+    if(info == NULL || (buffer == NULL && byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    info->errors = MJB_IDNA_ERROR_NONE;
+
+    bool plain;
+    mjb_status status = mjb_idna_prepare(buffer, &byte_length, encoding, output_encoding, &plain);
 
     if(status != MJB_STATUS_OK) {
         return status;
     }
 
-    *output_size = result.output_size;
+    char lowered[MJB_IDNA_DOMAIN_MAX];
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context local = { scratch, sizeof(scratch), false };
+    mjb_output domain = { lowered, byte_length, sizeof(lowered), MJB_OUTPUT_FIXED };
 
-    if(output != NULL && capacity < result.output_size) {
-        mjb_result_free(&result);
-        return MJB_STATUS_OUTPUT_TOO_SMALL;
+    if(plain) {
+        mjb_idna_ascii_lower(buffer, byte_length, lowered);
+    } else {
+        status = mjb_idna_context_run(context != NULL ? context : &local, buffer, byte_length,
+            encoding, to_ascii, NULL, info, &domain);
+    }
+
+    if(status == MJB_STATUS_OK) {
+        *output_size = capacity;
+        status = mjb_convert_encoding_into(domain.buffer, domain.size, MJB_ENC_UTF_8,
+            output_encoding, output, output_size);
+    }
+
+    mjb_idna_context_free(&local);
+
+    return status;
+}
+
+// Domains per task of a parallel batch. Every task has its own scratch and label cache.
+#define MJB_IDNA_BATCH_CHUNK 1024
+
+typedef struct mjb_idna_batch_job {
+    size_t first;
+    size_t count;
+    size_t byte_start;
+    mjb_output output;
+    mjb_status status;
+} mjb_idna_batch_job;
+
+typedef struct mjb_idna_batch_context {
+    const char *const *domains;
+    const size_t *byte_lengths;
+    const char *lines;
+    size_t lines_length;
+    bool is_lines;
+    mjb_encoding encoding;
+    mjb_idna_batch_job *jobs;
+    mjb_idna_batch *batch;
+} mjb_idna_batch_context;
+
+// The offset of the line that follows `count` lines starting at `start`.
+static size_t mjb_idna_skip_lines(const char *buffer, size_t byte_length, size_t start,
+    size_t count) {
+    for(size_t i = 0; i < count && start < byte_length; ++i) {
+        const char *newline = (const char *)memchr(buffer + start, '\n', byte_length - start);
+        start = newline == NULL ? byte_length : (size_t)(newline - buffer) + 1;
+    }
+
+    return start;
+}
+
+/**
+ * Convert one domain of a batch and append its ASCII form to the output. Input that is not valid
+ * in the encoding fails the domain, not the batch: UTS #46 replaces it with U+FFFD, which is
+ * disallowed, so the domain gets MJB_IDNA_ERROR_DISALLOWED and an empty result.
+ */
+static mjb_status mjb_idna_batch_entry(mjb_idna_context *context, mjb_idna_label_cache *cache,
+    const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_idna_info *info,
+    mjb_output *output) {
+    info->errors = MJB_IDNA_ERROR_NONE;
+
+    if(buffer == NULL && byte_length > 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    bool plain;
+    mjb_status status = mjb_idna_prepare(buffer, &byte_length, encoding, MJB_ENC_UTF_8, &plain);
+
+    if(status == MJB_STATUS_MALFORMED_INPUT) {
+        info->errors |= MJB_IDNA_ERROR_DISALLOWED;
+
+        return MJB_STATUS_OK;
+    }
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    if(plain) {
+        char lowered[MJB_IDNA_DOMAIN_MAX];
+        mjb_idna_ascii_lower(buffer, byte_length, lowered);
+
+        return mjb_output_write(output, lowered, byte_length);
+    }
+
+    mjb_output domain;
+    status = mjb_idna_context_run(context, buffer, byte_length, encoding, true, cache, info,
+        &domain);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    return mjb_output_write(output, domain.buffer, domain.size);
+}
+
+// Convert the domains of one job into its own output, with offsets relative to it.
+static void mjb_idna_batch_task(void *context, size_t index) {
+    mjb_idna_batch_context *batch = (mjb_idna_batch_context *)context;
+    mjb_idna_batch_job *job = &batch->jobs[index];
+    size_t capacity = (job->count < MJB_IDNA_BATCH_CHUNK ? job->count : MJB_IDNA_BATCH_CHUNK) *
+        16 + 1;
+    char *buffer = (char *)mjb_alloc(capacity);
+
+    if(buffer == NULL) {
+        job->status = MJB_STATUS_NO_MEMORY;
+
+        return;
+    }
+
+    buffer[0] = '\0';
+    mjb_output_init_dynamic(&job->output, buffer, capacity);
+
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context idna = { scratch, sizeof(scratch), false };
+    mjb_idna_label_cache cache;
+    memset(&cache, 0, sizeof(cache));
+    size_t cursor = job->byte_start;
+
+    for(size_t i = job->first; i < job->first + job->count && job->status == MJB_STATUS_OK; ++i) {
+        const char *domain;
+        size_t byte_length;
+
+        if(batch->is_lines) {
+            domain = batch->lines + cursor;
+            const char *newline = (const char *)memchr(domain, '\n', batch->lines_length - cursor);
+            byte_length = newline == NULL ? batch->lines_length - cursor :
+                                            (size_t)(newline - domain);
+            cursor += byte_length + 1;
+
+            if(byte_length > 0 && domain[byte_length - 1] == '\r') {
+                --byte_length;
+            }
+        } else {
+            domain = batch->domains[i];
+            byte_length = batch->byte_lengths == NULL ? MJB_NUL_TERMINATED :
+                                                        batch->byte_lengths[i];
+        }
+
+        batch->batch->offsets[i] = job->output.size;
+        job->status = mjb_idna_batch_entry(&idna, &cache, domain, byte_length, batch->encoding,
+            &batch->batch->infos[i], &job->output);
+    }
+
+    mjb_idna_context_free(&idna);
+}
+
+// Split the batch into jobs, run them and pack their outputs into the result.
+static mjb_status mjb_idna_batch_run(mjb_idna_batch_context *context, size_t count,
+    mjb_parallel_for_fn parallel_for, void *pool) {
+    if(count == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    if(count >= SIZE_MAX / sizeof(size_t) || count > SIZE_MAX / sizeof(mjb_idna_info)) {
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    // Serially, a single job converts every domain straight into the result.
+    size_t chunk = parallel_for == NULL ? count : MJB_IDNA_BATCH_CHUNK;
+    size_t job_count = (count - 1) / chunk + 1;
+    mjb_idna_batch *batch = context->batch;
+    context->jobs = (mjb_idna_batch_job *)mjb_alloc(job_count * sizeof(mjb_idna_batch_job));
+    batch->offsets = (size_t *)mjb_alloc((count + 1) * sizeof(size_t));
+    batch->infos = (mjb_idna_info *)mjb_alloc(count * sizeof(mjb_idna_info));
+
+    if(context->jobs == NULL || batch->offsets == NULL || batch->infos == NULL) {
+        mjb_free(context->jobs);
+        mjb_idna_batch_free(batch);
+
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    size_t cursor = 0;
+
+    for(size_t i = 0; i < job_count; ++i) {
+        mjb_idna_batch_job *job = &context->jobs[i];
+        job->first = i * chunk;
+        job->count = count - job->first < chunk ? count - job->first : chunk;
+        job->byte_start = cursor;
+        job->output.buffer = NULL;
+        job->output.size = 0;
+        job->status = MJB_STATUS_OK;
+
+        if(context->is_lines && i + 1 < job_count) {
+            cursor = mjb_idna_skip_lines(context->lines, context->lines_length, cursor,
+                job->count);
+        }
+    }
+
+    if(parallel_for != NULL) {
+        parallel_for(pool, job_count, mjb_idna_batch_task, context);
+    } else {
+        mjb_idna_batch_task(context, 0);
+    }
+
+    mjb_status status = MJB_STATUS_OK;
+    size_t total = 0;
+
+    for(size_t i = 0; i < job_count && status == MJB_STATUS_OK; ++i) {
+        status = context->jobs[i].status;
+
+        if(status == MJB_STATUS_OK && context->jobs[i].output.size >= SIZE_MAX - total) {
+            status = MJB_STATUS_OVERFLOW;
+        }
+
+        total += context->jobs[i].output.size;
+    }
+
+    if(status == MJB_STATUS_OK && job_count == 1) {
+        batch->domains = context->jobs[0].output.buffer;
+        context->jobs[0].output.buffer = NULL;
+    } else if(status == MJB_STATUS_OK) {
+        batch->domains = (char *)mjb_alloc(total + 1);
+
+        if(batch->domains == NULL) {
+            status = MJB_STATUS_NO_MEMORY;
+        }
+    }
+
+    if(status == MJB_STATUS_OK && job_count > 1) {
+        size_t base = 0;
+
+        for(size_t i = 0; i < job_count; ++i) {
+            const mjb_idna_batch_job *job = &context->jobs[i];
+            memcpy(batch->domains + base, job->output.buffer, job->output.size);
+
+            for(size_t j = job->first; j < job->first + job->count; ++j) {
+                batch->offsets[j] += base;
+            }
+
+            base += job->output.size;
+        }
+
+        batch->domains[total] = '\0';
+    }
+
+    for(size_t i = 0; i < job_count; ++i) {
+        mjb_free(context->jobs[i].output.buffer);
     }
 
-    if(output != NULL && result.output_size > 0) {
-        memcpy(output, result.output, result.output_size);
+    mjb_free(context->jobs);
+
+    if(status != MJB_STATUS_OK) {
+        mjb_idna_batch_free(batch);
+
+        return status;
     }
 
-    mjb_result_free(&result);
+    batch->offsets[count] = total;
+    batch->count = count;
+
     return MJB_STATUS_OK;
 }
 #endif // MJB_FEATURE_IDNA
 
+MJB_EXPORT mjb_status mjb_idna_to_ascii(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, mjb_result *result) {
+#if MJB_FEATURE_IDNA
+    return mjb_idna_process(buffer, byte_length, encoding, output_encoding, true, info, result);
+#else
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)output_encoding;
+    (void)info;
+    (void)result;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
+MJB_EXPORT mjb_status mjb_idna_to_unicode(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, mjb_result *result) {
+#if MJB_FEATURE_IDNA
+    return mjb_idna_process(buffer, byte_length, encoding, output_encoding, false, info, result);
+#else
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)output_encoding;
+    (void)info;
+    (void)result;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
 MJB_EXPORT mjb_status mjb_idna_to_ascii_into(const char *buffer, size_t byte_length,
     mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, void *output,
     size_t *output_size) {
 #if MJB_FEATURE_IDNA
-    return mjb_idna_into(buffer, byte_length, encoding, output_encoding, true, info, output,
+    return mjb_idna_into(NULL, buffer, byte_length, encoding, output_encoding, true, info, output,
         output_size);
 #else
     (void)buffer;
@@ -814,7 +1303,7 @@ MJB_EXPORT mjb_status mjb_idna_to_unicode_into(const char *buffer, size_t byte_l
     mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, void *output,
     size_t *output_size) {
 #if MJB_FEATURE_IDNA
-    return mjb_idna_into(buffer, byte_length, encoding, output_encoding, false, info, output,
+    return mjb_idna_into(NULL, buffer, byte_length, encoding, output_encoding, false, info, output,
         output_size);
 #else
     (void)buffer;
@@ -827,3 +1316,188 @@ MJB_EXPORT mjb_status mjb_idna_to_unicode_into(const char *buffer, size_t byte_l
     return MJB_STATUS_FEATURE_NOT_ENABLED;
 #endif
 }
+
+MJB_EXPORT mjb_status mjb_idna_context_init(mjb_idna_context *context, void *scratch,
+    size_t scratch_size) {
+#if MJB_FEATURE_IDNA
+    if(context == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(context, 0, sizeof(*context));
+
+    if(scratch == NULL && scratch_size > 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    context->scratch = (char *)scratch;
+    context->capacity = scratch_size;
+
+    return MJB_STATUS_OK;
+#else
+    (void)context;
+    (void)scratch;
+    (void)scratch_size;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
+MJB_EXPORT void mjb_idna_context_free(mjb_idna_context *context) {
+#if MJB_FEATURE_IDNA
+    if(context == NULL) {
+        return;
+    }
+
+    if(context->owned) {
+        mjb_free(context->scratch);
+    }
+
+    memset(context, 0, sizeof(*context));
+#else
+    (void)context;
+#endif
+}
+
+MJB_EXPORT mjb_status mjb_idna_context_to_ascii_into(mjb_idna_context *context,
+    const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_encoding output_encoding,
+    mjb_idna_info *info, void *output, size_t *output_size) {
+#if MJB_FEATURE_IDNA
+    if(context == NULL) {
+        if(output_size != NULL) {
+            *output_size = 0;
+        }
+
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    return mjb_idna_into(context, buffer, byte_length, encoding, output_encoding, true, info,
+        output, output_size);
+#else
+    (void)context;
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)output_encoding;
+    (void)info;
+    (void)output;
+    (void)output_size;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
+MJB_EXPORT mjb_status mjb_idna_context_to_unicode_into(mjb_idna_context *context,
+    const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_encoding output_encoding,
+    mjb_idna_info *info, void *output, size_t *output_size) {
+#if MJB_FEATURE_IDNA
+    if(context == NULL) {
+        if(output_size != NULL) {
+            *output_size = 0;
+        }
+
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    return mjb_idna_into(context, buffer, byte_length, encoding, output_encoding, false, info,
+        output, output_size);
+#else
+    (void)context;
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)output_encoding;
+    (void)info;
+    (void)output;
+    (void)output_size;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
+MJB_EXPORT mjb_status mjb_idna_to_ascii_batch(const char *const *domains,
+    const size_t *byte_lengths, size_t count, mjb_encoding encoding,
+    mjb_parallel_for_fn parallel_for, void *pool, mjb_idna_batch *result) {
+#if MJB_FEATURE_IDNA
+    if(result == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(result, 0, sizeof(*result));
+
+    if(domains == NULL && count > 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(!mjb_encoding_is_valid_input(encoding)) {
+        return MJB_STATUS_INVALID_ENCODING;
+    }
+
+    mjb_idna_batch_context context = { domains, byte_lengths, NULL, 0, false, encoding, NULL,
+        result };
+
+    return mjb_idna_batch_run(&context, count, parallel_for, pool);
+#else
+    (void)domains;
+    (void)byte_lengths;
+    (void)count;
+    (void)encoding;
+    (void)parallel_for;
+    (void)pool;
+    (void)result;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
+MJB_EXPORT mjb_status mjb_idna_to_ascii_lines(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_parallel_for_fn parallel_for, void *pool, mjb_idna_batch *result) {
+#if MJB_FEATURE_IDNA
+    if(result == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(result, 0, sizeof(*result));
+
+    if(buffer == NULL && byte_length > 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Lines are split on the byte 0x0A, which only means LF in UTF-8 and ASCII.
+    if(encoding != MJB_ENC_UTF_8 && encoding != MJB_ENC_ASCII) {
+        return MJB_STATUS_INVALID_ENCODING;
+    }
+
+    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    size_t count = 0;
+
+    for(size_t start = 0; start < byte_length; ++count) {
+        start = mjb_idna_skip_lines(buffer, byte_length, start, 1);
+    }
+
+    mjb_idna_batch_context context = { NULL, NULL, buffer, byte_length, true, encoding, NULL,
+        result };
+
+    return mjb_idna_batch_run(&context, count, parallel_for, pool);
+#else
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)parallel_for;
+    (void)pool;
+    (void)result;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+#endif
+}
+
+MJB_EXPORT void mjb_idna_batch_free(mjb_idna_batch *batch) {
+    if(batch == NULL) {
+        return;
+    }
+
+    mjb_free(batch->domains);
+    mjb_free(batch->offsets);
+    mjb_free(batch->infos);
+    memset(batch, 0, sizeof(*batch));
+}
@@ -79,6 +79,103 @@ typedef struct mjb_n_character {
     uint16_t quick_check;
 } mjb_n_character;
 
+// The character properties read by the filter and case mapping loops for every codepoint, unpacked
+// from one generated word. A lighter mjb_character without the name, numeric string and mappings.
+typedef struct mjb_codepoint_record {
+    uint8_t category;
+    uint8_t combining;
+    uint8_t bidirectional;
+    int8_t decimal;
+    bool cased;
+    bool case_ignorable;
+} mjb_codepoint_record;
+
+// The properties the segmentation algorithms read for every codepoint, packed into one word by
+// utils/generate/file-generators/unicode-data/properties.ts. Use the accessors below.
+typedef uint32_t mjb_segmentation_properties;
+
+#define MJB_SEGMENTATION_GCB(properties) ((mjb_gcb)((properties) & 0x1F))
+#define MJB_SEGMENTATION_WBP(properties) ((mjb_wbp)(((properties) >> 5) & 0x1F))
+#define MJB_SEGMENTATION_SBP(properties) ((mjb_sbp)(((properties) >> 10) & 0xF))
+#define MJB_SEGMENTATION_LBP(properties) ((mjb_lbp)(((properties) >> 14) & 0x3F))
+#define MJB_SEGMENTATION_EAW(properties) ((mjb_east_asian_width)(((properties) >> 20) & 0x7))
+#define MJB_SEGMENTATION_INCB(properties) \
+    ((mjb_indic_conjunct_break)(((properties) >> 23) & 0x7))
+#define MJB_SEGMENTATION_EXT_PICT(properties) ((((properties) >> 26) & 0x1) != 0)
+
+// The look-ahead entry that starts at index, or NULL. Entries that do not start there belong to a
+// position the caller has left, so they are dropped.
+static inline mjb_break_lookahead_entry *mjb_break_lookahead_at(mjb_break_lookahead *lookahead,
+    size_t index) {
+    if(lookahead->count == 0) {
+        return NULL;
+    }
+
+    mjb_break_lookahead_entry *entry = &lookahead->entries[lookahead->start];
+
+    if(entry->index != index) {
+        lookahead->count = 0;
+
+        return NULL;
+    }
+
+    return entry;
+}
+
+// The entry after the given one, or NULL if it is the last.
+static inline mjb_break_lookahead_entry *mjb_break_lookahead_next(mjb_break_lookahead *lookahead,
+    const mjb_break_lookahead_entry *entry) {
+    uint8_t position = (uint8_t)(entry - lookahead->entries);
+    uint8_t offset = (uint8_t)((position + MJB_BREAK_LOOKAHEAD_SIZE - lookahead->start) %
+        MJB_BREAK_LOOKAHEAD_SIZE);
+
+    if(offset + 1 >= lookahead->count) {
+        return NULL;
+    }
+
+    return &lookahead->entries[(position + 1) % MJB_BREAK_LOOKAHEAD_SIZE];
+}
+
+// Drop the first entry once the step has consumed it.
+static inline void mjb_break_lookahead_pop(mjb_break_lookahead *lookahead) {
+    lookahead->start = (uint8_t)((lookahead->start + 1) % MJB_BREAK_LOOKAHEAD_SIZE);
+    --lookahead->count;
+}
+
+// Append a classified codepoint. It is kept only if the ring has room and it follows the last
+// entry, or starts the ring at the current position.
+static inline void mjb_break_lookahead_push(mjb_break_lookahead *lookahead, size_t position,
+    size_t index, size_t next_index, mjb_codepoint codepoint, uint32_t properties,
+    uint8_t resolved) {
+    if(lookahead->count == MJB_BREAK_LOOKAHEAD_SIZE) {
+        return;
+    }
+
+    if(lookahead->count == 0) {
+        if(index != position) {
+            return;
+        }
+
+        lookahead->start = 0;
+    } else {
+        uint8_t last = (uint8_t)((lookahead->start + lookahead->count - 1) %
+            MJB_BREAK_LOOKAHEAD_SIZE);
+
+        if(lookahead->entries[last].next_index != index) {
+            return;
+        }
+    }
+
+    mjb_break_lookahead_entry *entry =
+        &lookahead->entries[(lookahead->start + lookahead->count) % MJB_BREAK_LOOKAHEAD_SIZE];
+    entry->index = index;
+    entry->next_index = next_index;
+    entry->codepoint = codepoint;
+    entry->properties = properties;
+    entry->resolved = resolved;
+    ++lookahead->count;
+}
+
 typedef mjb_status (*mjb_output_writer)(mjb_output *output, const void *context);
 
 // Internal functions
@@ -109,15 +206,44 @@ mjb_status mjb_output_copy_into(const void *buffer, size_t byte_length, void *ou
 mjb_status mjb_casefold_default(const char *buffer, size_t byte_length, mjb_encoding encoding,
     mjb_encoding output_encoding, mjb_result *result);
 
+// Full default case folding of a codepoint. Writes up to 3 codepoints and returns their count.
+uint8_t mjb_casefold_codepoint(mjb_codepoint codepoint, mjb_codepoint *folded);
+
+mjb_status mjb_normalization_quick_check_span(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_normalization form, mjb_quick_check_result *quick_check,
+    size_t *span);
+
+mjb_status mjb_normalize_buffer(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    mjb_normalization form, size_t span, char **output, size_t *capacity, size_t *output_size);
+
 size_t mjb_grapheme_prefix_bytes(const char *buffer, size_t byte_length, mjb_encoding encoding,
     size_t max_bytes);
 
+// Write the boundary offsets of a string to offsets, up to capacity, and return their count.
+// See: mjb_segment
+size_t mjb_grapheme_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity);
+
+size_t mjb_word_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity);
+
+size_t mjb_sentence_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity);
+
+size_t mjb_line_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity);
+
 bool mjb_n_codepoint_character(mjb_codepoint codepoint, mjb_n_character *character);
 
+bool mjb_codepoint_record_lookup(mjb_codepoint codepoint, mjb_codepoint_record *record);
+
 mjb_status mjb_codepoint_properties_lookup(mjb_codepoint codepoint, uint8_t *buffer);
 
 uint8_t mjb_codepoint_properties_get(const uint8_t *properties, mjb_property property);
 
+bool mjb_codepoint_segmentation_properties(mjb_codepoint codepoint,
+    mjb_segmentation_properties *properties);
+
 bool mjb_codepoint_has_binary_property(mjb_codepoint codepoint, mjb_property property);
 
 #endif // MJB_MOJIBAKE_INTERNAL_H
@@ -267,6 +267,15 @@ typedef enum mjb_quick_check_result {
     MJB_QC_NFKD_MAYBE = 0x200 // Impossible to happen
 } mjb_quick_check_result;
 
+// Streaming normalization of a string split in chunks. Set up with mjb_normalizer_init and release
+// with mjb_normalizer_free. The state is private to the library.
+typedef struct mjb_normalizer {
+    mjb_encoding encoding;
+    mjb_normalization form;
+    mjb_encoding output_encoding;
+    void *state;
+} mjb_normalizer;
+
 typedef enum mjb_filter_flags {
     MJB_FILTER_NONE = 0x0,
     MJB_FILTER_NORMALIZE = 0x1,
@@ -353,6 +362,28 @@ typedef struct mjb_idna_info {
     uint32_t errors;
 } mjb_idna_info;
 
+// Scratch size that fits a domain of up to 253 octets without a heap allocation.
+#define MJB_IDNA_SCRATCH_SIZE 4096
+
+// Reusable IDNA scratch memory. Set up with mjb_idna_context_init and release with
+// mjb_idna_context_free. It starts on the storage given by the caller and moves to the heap only
+// when a domain does not fit. The fields are private to the library.
+typedef struct mjb_idna_context {
+    char *scratch;
+    size_t capacity;
+    bool owned;
+} mjb_idna_context;
+
+// The domains converted by mjb_idna_to_ascii_batch and mjb_idna_to_ascii_lines. The ASCII form of
+// entry i is the offsets[i + 1] - offsets[i] bytes at domains + offsets[i] and its errors are in
+// infos[i]. Release with mjb_idna_batch_free.
+typedef struct mjb_idna_batch {
+    char *domains;
+    size_t *offsets;
+    mjb_idna_info *infos;
+    size_t count;
+} mjb_idna_batch;
+
 /**
  * Unicode block
  * [see: https://www.unicode.org/glossary/#block]
@@ -441,6 +472,14 @@ typedef enum mjb_break_type {
     MJB_BT_ALLOWED    // ÷
 } mjb_break_type;
 
+// Segmentation performed by mjb_segment
+typedef enum mjb_segment_kind {
+    MJB_SEGMENT_GRAPHEME, // Extended grapheme clusters (UAX #29)
+    MJB_SEGMENT_WORD,     // Word boundaries (UAX #29)
+    MJB_SEGMENT_SENTENCE, // Sentence boundaries (UAX #29)
+    MJB_SEGMENT_LINE      // Line break opportunities (UAX #14)
+} mjb_segment_kind;
+
 // Buffer character used in composition phase
 typedef struct mjb_buffer_character {
     uint32_t codepoint;
@@ -473,8 +512,30 @@ typedef struct mjb_next_state {
     bool zwj_seen;
     bool incb_consonant_seen;
     bool incb_linker_seen;
+    size_t codepoint_index; // First code unit of the last codepoint read
 } mjb_next_state;
 
+#define MJB_BREAK_LOOKAHEAD_SIZE 4
+
+// A codepoint that a look-ahead rule decoded and classified past the current position. resolved
+// is its break class after the defaults of the algorithm (mjb_lbp or mjb_wbp) and properties the
+// packed segmentation properties. Private to the library.
+typedef struct mjb_break_lookahead_entry {
+    size_t index;
+    size_t next_index;
+    mjb_codepoint codepoint;
+    uint32_t properties;
+    uint8_t resolved;
+} mjb_break_lookahead_entry;
+
+// Consecutive look-ahead codepoints, starting at the position of the break state, so the steps
+// that reach them do not decode and classify them again. Private to the library.
+typedef struct mjb_break_lookahead {
+    mjb_break_lookahead_entry entries[MJB_BREAK_LOOKAHEAD_SIZE];
+    uint8_t start;
+    uint8_t count;
+} mjb_break_lookahead;
+
 typedef struct mjb_next_line_state {
     uint8_t state;
     size_t index;
@@ -494,6 +555,8 @@ typedef struct mjb_next_line_state {
     mjb_east_asian_width qu_prev_ea;
     mjb_lbp prev_prev_lbp;
     mjb_lbp prev_num_lbp;
+    size_t codepoint_index; // First code unit of the last codepoint read
+    mjb_break_lookahead lookahead;
 } mjb_next_line_state;
 
 typedef struct mjb_next_word_state {
@@ -510,6 +573,8 @@ typedef struct mjb_next_word_state {
     bool wb4_merged;
     bool zwj_pending;
     bool prev_was_zwj;
+    size_t codepoint_index; // First code unit of the last codepoint read
+    mjb_break_lookahead lookahead;
 } mjb_next_word_state;
 
 typedef struct mjb_next_sentence_state {
@@ -525,10 +590,20 @@ typedef struct mjb_next_sentence_state {
     bool in_sat;
     bool sat_has_sp;
     bool sat_is_aterm;
+    size_t codepoint_index; // First code unit of the last codepoint read
 } mjb_next_sentence_state;
 
 typedef bool (*mjb_for_each_codepoint_fn)(mjb_character *character, mjb_character_position type);
 
+// One unit of work of mjb_parallel_for_fn.
+typedef void (*mjb_parallel_task_fn)(void *context, size_t index);
+
+// Run task(context, index) once for every index in [0, count), in any order and possibly
+// concurrently, and return when all of them have finished. Lets the library use a thread pool of
+// the caller; pool is passed through unchanged.
+typedef void (*mjb_parallel_for_fn)(void *pool, size_t count, mjb_parallel_task_fn task,
+    void *context);
+
 typedef enum mjb_direction {
     MJB_DIRECTION_LTR = 0,
     MJB_DIRECTION_RTL = 1,
@@ -537,7 +612,7 @@ typedef enum mjb_direction {
 
 typedef struct mjb_bidi_char {
     mjb_codepoint codepoint;
-    size_t byte_offset;
+    size_t byte_offset; // First code unit of the codepoint
     uint8_t level;
     mjb_bidi_class resolved_class;
     mjb_codepoint mirroring_glyph;
@@ -557,6 +632,26 @@ typedef struct mjb_bidi_run {
     mjb_direction direction;
 } mjb_bidi_run;
 
+// Reusable bidi working memory. Set up with mjb_bidi_workspace_init and release with
+// mjb_bidi_workspace_free. The buffers only grow and are private to the library.
+typedef struct mjb_bidi_workspace {
+    void *work;
+    size_t *indices;
+    bool *done;
+    mjb_bidi_char *chars;
+    size_t capacity;
+} mjb_bidi_workspace;
+
+// The paragraphs of a document resolved by mjb_bidi_resolve_document. The characters of every
+// paragraph are stored contiguously in chars, in logical order, with byte offsets relative to the
+// start of the document. Release with mjb_bidi_document_free.
+typedef struct mjb_bidi_document {
+    mjb_bidi_char *chars;
+    size_t count;
+    mjb_bidi_paragraph *paragraphs;
+    size_t paragraph_count;
+} mjb_bidi_document;
+
 // Collation variable-weighting strategy (UTS #10, Unicode 18.0.0, Section 4)
 typedef enum mjb_collation_variable_weighting {
     MJB_COLLATION_NON_IGNORABLE, // variable elements keep their weights unchanged
@@ -571,6 +666,22 @@ typedef enum mjb_collation_strength {
     MJB_COLLATION_QUATERNARY // Plus shifted variable elements such as punctuation
 } mjb_collation_strength;
 
+// Reusable collation options and scratch buffers. Set up with mjb_collator_init and release with
+// mjb_collator_free. The buffers only grow and are private to the library.
+typedef struct mjb_collator {
+    mjb_collation_variable_weighting variable_weighting;
+    mjb_collation_strength strength;
+    char *normalized;
+    size_t normalized_capacity;
+    mjb_codepoint *codepoints;
+    bool *used;
+    size_t codepoints_capacity;
+    void *elements;
+    size_t elements_capacity;
+    uint16_t *keys[2];
+    size_t keys_capacity[2];
+} mjb_collator;
+
 // UAX #31 identifier profile (Unicode 18.0.0)
 typedef enum mjb_identifier_profile {
     MJB_IDENTIFIER_DEFAULT, // NFC + ID_Start / ID_Continue
@@ -584,6 +695,22 @@ typedef enum mjb_script_set_kind {
     MJB_SCRIPT_SET_ALL       // Every script resolves the string
 } mjb_script_set_kind;
 
+// A set of reference strings indexed by UTS #39 skeleton. Build it with mjb_confusable_index_init
+// and mjb_confusable_index_add, or open a serialized image with mjb_confusable_index_open, and
+// release it with mjb_confusable_index_free. The fields are private to the library.
+typedef struct mjb_confusable_index {
+    void *slots;
+    size_t slot_count;
+    size_t skeleton_count;
+    void *ids;
+    size_t count;
+    size_t id_capacity;
+    char *pool;
+    size_t pool_size;
+    size_t pool_capacity;
+    bool read_only;
+} mjb_confusable_index;
+
 // This functions list is automatically generated. Do not edit.
 // clang-format off
 
@@ -596,6 +723,18 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_normalize(const char *buffer, size_t byt
 // Normalize a string into a caller-provided buffer.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_normalize_into(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_normalization form, mjb_encoding output_encoding, void *output, size_t *output_size);
 
+// Initialize a streaming normalizer.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_normalizer_init(mjb_normalizer *normalizer, mjb_encoding encoding, mjb_normalization form, mjb_encoding output_encoding);
+
+// Free a streaming normalizer.
+MJB_EXPORT void mjb_normalizer_free(mjb_normalizer *normalizer);
+
+// Normalize the next chunk of a stream into a caller-provided buffer.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_normalizer_feed(mjb_normalizer *normalizer, const char *buffer, size_t byte_length, void *output, size_t *output_size);
+
+// End a normalization stream into a caller-provided buffer.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_normalizer_finish(mjb_normalizer *normalizer, void *output, size_t *output_size);
+
 // Filter a string with the selected mjb_filter_flags.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_filter(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_filter_flags filters, mjb_encoding output_encoding, mjb_result *result);
 
@@ -620,6 +759,27 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_to_unicode(const char *buffer, size
 // Convert a domain name to its UTS #46 nontransitional Unicode form into a caller-provided buffer.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_to_unicode_into(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, void *output, size_t *output_size);
 
+// Initialize a reusable IDNA context.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_context_init(mjb_idna_context *context, void *scratch, size_t scratch_size);
+
+// Free the scratch of an IDNA context.
+MJB_EXPORT void mjb_idna_context_free(mjb_idna_context *context);
+
+// Convert a domain name to its UTS #46 nontransitional ASCII form using an IDNA context.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_context_to_ascii_into(mjb_idna_context *context, const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, void *output, size_t *output_size);
+
+// Convert a domain name to its UTS #46 nontransitional Unicode form using an IDNA context.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_context_to_unicode_into(mjb_idna_context *context, const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_encoding output_encoding, mjb_idna_info *info, void *output, size_t *output_size);
+
+// Convert an array of domain names to their UTS #46 nontransitional ASCII form.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_to_ascii_batch(const char *const *domains, const size_t *byte_lengths, size_t count, mjb_encoding encoding, mjb_parallel_for_fn parallel_for, void *pool, mjb_idna_batch *result);
+
+// Convert a newline-separated list of domain names to their UTS #46 nontransitional ASCII form.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_idna_to_ascii_lines(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_parallel_for_fn parallel_for, void *pool, mjb_idna_batch *result);
+
+// Free an IDNA batch allocated by mjb_idna_to_ascii_batch or mjb_idna_to_ascii_lines.
+MJB_EXPORT void mjb_idna_batch_free(mjb_idna_batch *batch);
+
 // Check if a string is normalized to NFC/NFKC/NFD/NFKD form.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_normalization_quick_check(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_normalization form, mjb_quick_check_result *quick_check);
 
@@ -647,6 +807,12 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_codepoint_property_binary(mjb_codepoint
 // Return the value of an enumerated or integer Unicode property.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_codepoint_property_int(mjb_codepoint codepoint, mjb_property property, int32_t *value);
 
+// Return the enumerated or integer property values of an array of codepoints.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_codepoints_property_int(const mjb_codepoint *codepoints, size_t count, mjb_property property, int32_t *values);
+
+// Return the enumerated or integer property values of the codepoints of a string.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_string_property_int(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_property property, int32_t *values, size_t *count);
+
 // Return the numeric value of a codepoint.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_codepoint_numeric_value(mjb_codepoint codepoint, mjb_numeric_value *value);
 
@@ -671,6 +837,9 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_convert_encoding_into(const char *buffer
 // Compare two strings using a Unicode caseless matching relation.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_caseless_match(const char *s1, size_t s1_byte_length, mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding, mjb_caseless_mode mode, bool *matches);
 
+// Hash a string so that caseless matches have the same hash.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_caseless_hash(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_caseless_mode mode, uint64_t seed, uint64_t *hash);
+
 // Compare two strings using UCA.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_collation_compare(const char *s1, size_t s1_byte_length, mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding, mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength, int *order);
 
@@ -680,6 +849,24 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_collation_key(const char *buffer, size_t
 // Generate a binary collation key into a caller-provided buffer.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_collation_key_into(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength, void *output, size_t *output_size);
 
+// Initialize a reusable collator.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_collator_init(mjb_collator *collator, mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength);
+
+// Free the buffers of a collator.
+MJB_EXPORT void mjb_collator_free(mjb_collator *collator);
+
+// Compare two strings using UCA and a collator.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_collator_compare(mjb_collator *collator, const char *s1, size_t s1_byte_length, mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding, int *order);
+
+// Generate a UCA sort key for a string using a collator.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_collator_key(mjb_collator *collator, const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_result *result);
+
+// Generate a binary collation key into a caller-provided buffer using a collator.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_collator_key_into(mjb_collator *collator, const char *buffer, size_t byte_length, mjb_encoding encoding, void *output, size_t *output_size);
+
+// Generate the binary sort keys of many strings into one arena.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_collator_keys_into(mjb_collator *collator, const char *const *strings, const size_t *byte_lengths, size_t count, mjb_encoding encoding, void *arena, size_t *arena_size, size_t *offsets);
+
 // Change string case.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_map_case(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_map_case_type type, mjb_encoding output_encoding, mjb_result *result);
 
@@ -755,6 +942,9 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_word_count(const char *buffer, size_t by
 // Return the number of bytes whose word-break segments fit within max_columns terminal cells.
 MJB_EXPORT size_t mjb_truncate_word_width(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_terminal_width_profile profile, size_t max_columns);
 
+// Return the boundaries of a string for the given segmentation.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_segment(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_segment_kind kind, size_t *offsets, size_t *count);
+
 // Resolve bidirectional text (TR9) for a paragraph.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_bidi_resolve(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_direction direction, mjb_bidi_paragraph *result);
 
@@ -767,6 +957,21 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_bidi_line_runs(const mjb_bidi_paragraph
 // Free a bidi paragraph allocated by mjb_bidi_resolve.
 MJB_EXPORT void mjb_bidi_paragraph_free(mjb_bidi_paragraph *paragraph);
 
+// Initialize a reusable bidi workspace.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_bidi_workspace_init(mjb_bidi_workspace *workspace);
+
+// Free the buffers of a bidi workspace.
+MJB_EXPORT void mjb_bidi_workspace_free(mjb_bidi_workspace *workspace);
+
+// Resolve bidirectional text (TR9) for a paragraph into a reusable workspace.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_bidi_workspace_resolve(mjb_bidi_workspace *workspace, const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_direction direction, mjb_bidi_paragraph *result);
+
+// Resolve bidirectional text (TR9) for every paragraph of a document.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_bidi_resolve_document(const char *buffer, size_t byte_length, mjb_encoding encoding, mjb_direction direction, mjb_parallel_for_fn parallel_for, void *pool, mjb_bidi_document *result);
+
+// Free a bidi document allocated by mjb_bidi_resolve_document.
+MJB_EXPORT void mjb_bidi_document_free(mjb_bidi_document *document);
+
 // Return true if the codepoint is a valid Unicode identifier start (Unicode 18.0.0 UAX #31 ID_Start).
 MJB_EXPORT bool mjb_codepoint_is_id_start(mjb_codepoint codepoint);
 
@@ -803,6 +1008,24 @@ MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_skeleton_into(const char *buf
 // Determine whether two strings are visually confusable (Unicode 18.0.0 UTS #39 Section 4): skeleton(s1) == skeleton(s2).
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_match(const char *s1, size_t s1_byte_length, mjb_encoding s1_encoding, const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding, bool *confusable);
 
+// Initialize an empty confusable index.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_index_init(mjb_confusable_index *index);
+
+// Free a confusable index.
+MJB_EXPORT void mjb_confusable_index_free(mjb_confusable_index *index);
+
+// Add the skeleton of a reference string to a confusable index.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_index_add(mjb_confusable_index *index, const char *buffer, size_t byte_length, mjb_encoding encoding, uint32_t id);
+
+// Return the IDs of the reference strings confusable with a string.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_index_find(const mjb_confusable_index *index, const char *buffer, size_t byte_length, mjb_encoding encoding, uint32_t *ids, size_t *count);
+
+// Serialize a confusable index into a caller-provided buffer.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_index_serialize(const mjb_confusable_index *index, void *output, size_t *output_size);
+
+// Open a serialized confusable index in place.
+MJB_EXPORT MJB_NODISCARD mjb_status mjb_confusable_index_open(mjb_confusable_index *index, const void *data, size_t data_size);
+
 // Return the emoji properties.
 MJB_EXPORT MJB_NODISCARD mjb_status mjb_codepoint_emoji_properties(mjb_codepoint codepoint, mjb_emoji_properties *emoji);
 
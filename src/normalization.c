@@ -13,12 +13,36 @@
 typedef struct mjb_normalize_context {
     const char *buffer;
     size_t byte_length;
-    size_t potential_output_size;
     mjb_encoding encoding;
     mjb_normalization form;
     mjb_encoding output_encoding;
+    size_t start; // Leading bytes already in the form, copied as is
 } mjb_normalize_context;
 
+// Composition segment. Characters on the stack, moved to the heap for longer segments.
+#define MJB_COMPOSITION_SEGMENT_SIZE 64
+typedef struct mjb_composition_segment {
+    mjb_buffer_character *characters;
+    size_t count;
+    size_t capacity;
+    uint16_t maybe; // MJB_QC_NFC_MAYBE or MJB_QC_NFKC_MAYBE, the characters that compose backwards
+    mjb_buffer_character local[MJB_COMPOSITION_SEGMENT_SIZE];
+} mjb_composition_segment;
+
+// Combining characters buffer.
+#define MJB_MAX_COMBINING_CHARACTERS 32
+
+// Decomposition and composition state, kept between the codepoints of a string or a stream.
+typedef struct mjb_normalize_state {
+    mjb_normalization form;
+    mjb_encoding output_encoding;
+    bool is_composition;
+    bool is_compatibility;
+    mjb_n_character characters_buffer[MJB_MAX_COMBINING_CHARACTERS];
+    size_t buffer_index;
+    mjb_composition_segment segment;
+} mjb_normalize_state;
+
 // Normalization sort.
 static void mjb_normalization_sort(mjb_n_character array[], size_t size) {
     for(size_t step = 1; step < size; ++step) {
@@ -67,54 +91,6 @@ static mjb_status mjb_flush_d_buffer(mjb_n_character *characters_buffer, size_t
     return MJB_STATUS_OK;
 }
 
-// Flush the composition buffer to a bit array.
-static mjb_status mjb_flush_c_buffer(mjb_n_character *characters_buffer, size_t buffer_index,
-    mjb_buffer_character **output, size_t *output_index, size_t *output_size) {
-
-    if(buffer_index == 0) {
-        return MJB_STATUS_OK;
-    }
-
-    // Sort combining characters by Canonical Combining Class (required for all forms)
-    // Skip sorting if only one character (already sorted)
-    if(buffer_index > 1) {
-        mjb_normalization_sort(characters_buffer, buffer_index);
-    }
-
-    for(size_t i = 0; i < buffer_index; ++i) {
-        if(characters_buffer[i].codepoint == MJB_CODEPOINT_NOT_VALID) {
-            continue;
-        }
-
-        // Check if we need to reallocate the output buffer
-        if(*output_index >= *output_size) {
-            size_t new_output_size = *output_size == 0 ? 1 : *output_size * 2;
-
-            if(*output_size > SIZE_MAX / 2 ||
-                new_output_size > SIZE_MAX / sizeof(mjb_buffer_character)) {
-                return MJB_STATUS_OVERFLOW;
-            }
-
-            mjb_buffer_character *new_output = (mjb_buffer_character *)mjb_realloc(*output,
-                new_output_size * sizeof(mjb_buffer_character));
-
-            if(new_output == NULL) {
-                return MJB_STATUS_NO_MEMORY;
-            }
-
-            *output = new_output;
-            *output_size = new_output_size;
-        }
-
-        (*output)[*output_index].codepoint = characters_buffer[i].codepoint;
-        (*output)[*output_index].combining = characters_buffer[i].combining;
-
-        ++(*output_index);
-    }
-
-    return MJB_STATUS_OK;
-}
-
 /**
  * Recompose the string.
  * Canonical Composition Algorithm
@@ -235,6 +211,81 @@ static mjb_status mjb_recompose(mjb_output *output, size_t codepoints_count,
     return MJB_STATUS_OK;
 }
 
+/**
+ * Flush the composition buffer to the composition segment. A starter that no character before it
+ * can compose with closes the segment, which is recomposed and written to the output. This bounds
+ * the memory to the longest segment instead of the whole string.
+ */
+static mjb_status mjb_flush_c_buffer(mjb_n_character *characters_buffer, size_t buffer_index,
+    mjb_composition_segment *segment, mjb_output *output, mjb_encoding output_encoding) {
+
+    if(buffer_index == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    // Sort combining characters by Canonical Combining Class (required for all forms)
+    // Skip sorting if only one character (already sorted)
+    if(buffer_index > 1) {
+        mjb_normalization_sort(characters_buffer, buffer_index);
+    }
+
+    for(size_t i = 0; i < buffer_index; ++i) {
+        if(characters_buffer[i].codepoint == MJB_CODEPOINT_NOT_VALID) {
+            continue;
+        }
+
+        if(segment->count != 0 && characters_buffer[i].combining == MJB_CCC_NOT_REORDERED &&
+            !(characters_buffer[i].quick_check & segment->maybe)) {
+            mjb_status status = mjb_recompose(output, segment->count, segment->characters,
+                output_encoding);
+
+            if(status != MJB_STATUS_OK) {
+                return status;
+            }
+
+            segment->count = 0;
+        }
+
+        // Check if we need to grow the segment
+        if(segment->count >= segment->capacity) {
+            if(segment->capacity > SIZE_MAX / 2 ||
+                segment->capacity * 2 > SIZE_MAX / sizeof(mjb_buffer_character)) {
+                return MJB_STATUS_OVERFLOW;
+            }
+
+            size_t new_capacity = segment->capacity * 2;
+            mjb_buffer_character *characters;
+
+            if(segment->characters == segment->local) {
+                characters = (mjb_buffer_character *)mjb_alloc(new_capacity *
+                    sizeof(mjb_buffer_character));
+
+                if(characters != NULL) {
+                    memcpy(characters, segment->local,
+                        segment->count * sizeof(mjb_buffer_character));
+                }
+            } else {
+                characters = (mjb_buffer_character *)mjb_realloc(segment->characters,
+                    new_capacity * sizeof(mjb_buffer_character));
+            }
+
+            if(characters == NULL) {
+                return MJB_STATUS_NO_MEMORY;
+            }
+
+            segment->characters = characters;
+            segment->capacity = new_capacity;
+        }
+
+        segment->characters[segment->count].codepoint = characters_buffer[i].codepoint;
+        segment->characters[segment->count].combining = characters_buffer[i].combining;
+
+        ++segment->count;
+    }
+
+    return MJB_STATUS_OK;
+}
+
 static bool mjb_normalization_form_is_valid(mjb_normalization form) {
     return form == MJB_NORMALIZATION_NFD || form == MJB_NORMALIZATION_NFKD ||
         form == MJB_NORMALIZATION_NFC || form == MJB_NORMALIZATION_NFKC;
@@ -297,232 +348,300 @@ static mjb_status mjb_normalization_estimate(const char *buffer, size_t byte_len
     return MJB_STATUS_OK;
 }
 
-static mjb_status mjb_normalize_write(mjb_output *output, const void *context_pointer) {
-    const mjb_normalize_context *context = (const mjb_normalize_context *)context_pointer;
-    const char *buffer = context->buffer;
-    size_t byte_length = context->byte_length;
-    mjb_encoding encoding = context->encoding;
-    mjb_normalization form = context->form;
-    mjb_encoding output_encoding = context->output_encoding;
-    uint8_t state = MJB_UTF_ACCEPT;
-    mjb_codepoint codepoint = 0;
-    mjb_n_character current_character;
+// The leading bytes found normalized by the quick check that can be copied to the output as is.
+static size_t mjb_normalization_prefix(size_t span, mjb_encoding encoding,
+    mjb_encoding output_encoding) {
+    // MJB_ENC_UTF_16 and MJB_ENC_UTF_32 resolve their byte order from the start of the input
+    if(encoding != output_encoding || encoding == MJB_ENC_UTF_16 || encoding == MJB_ENC_UTF_32) {
+        return 0;
+    }
 
-// Combining characters buffer.
-#define MJB_MAX_COMBINING_CHARACTERS 32
-    mjb_n_character characters_buffer[MJB_MAX_COMBINING_CHARACTERS];
-    size_t buffer_index = 0;
+    return span;
+}
 
-    mjb_buffer_character *composition_buffer = NULL;
-    size_t output_index = 0;
-    bool is_composition = form == MJB_NORMALIZATION_NFC || form == MJB_NORMALIZATION_NFKC;
-    bool is_compatibility = form == MJB_NORMALIZATION_NFKC || form == MJB_NORMALIZATION_NFKD;
-    size_t composition_capacity = context->potential_output_size;
-    mjb_status status = MJB_STATUS_OK;
+static void mjb_normalize_state_init(mjb_normalize_state *state, mjb_normalization form,
+    mjb_encoding output_encoding) {
+    state->form = form;
+    state->output_encoding = output_encoding;
+    state->is_composition = form == MJB_NORMALIZATION_NFC || form == MJB_NORMALIZATION_NFKC;
+    state->is_compatibility = form == MJB_NORMALIZATION_NFKC || form == MJB_NORMALIZATION_NFKD;
+    state->buffer_index = 0;
+    state->segment.characters = state->segment.local;
+    state->segment.count = 0;
+    state->segment.capacity = MJB_COMPOSITION_SEGMENT_SIZE;
+    state->segment.maybe = form == MJB_NORMALIZATION_NFC ? MJB_QC_NFC_MAYBE : MJB_QC_NFKC_MAYBE;
+}
 
-    if(is_composition) {
-        if(composition_capacity > SIZE_MAX / sizeof(mjb_buffer_character)) {
-            return MJB_STATUS_OVERFLOW;
-        }
+static void mjb_normalize_state_free(mjb_normalize_state *state) {
+    if(state->segment.characters != state->segment.local) {
+        mjb_free(state->segment.characters);
+    }
 
-        composition_buffer = (mjb_buffer_character *)mjb_alloc(composition_capacity *
-            sizeof(mjb_buffer_character));
+    state->segment.characters = state->segment.local;
+    state->segment.count = 0;
+    state->segment.capacity = MJB_COMPOSITION_SEGMENT_SIZE;
+}
 
-        if(composition_buffer == NULL) {
-            return MJB_STATUS_NO_MEMORY;
-        }
+// Flush the combining characters buffer to the composition segment or to the output.
+static mjb_status mjb_normalize_state_flush(mjb_normalize_state *state, mjb_output *output) {
+    mjb_status status;
+
+    if(state->is_composition) {
+        status = mjb_flush_c_buffer(state->characters_buffer, state->buffer_index,
+            &state->segment, output, state->output_encoding);
+    } else {
+        status = mjb_flush_d_buffer(state->characters_buffer, state->buffer_index, output,
+            state->output_encoding);
+    }
+
+    state->buffer_index = 0;
+
+    return status;
+}
+
+// Write everything still buffered, the state can then start a new string.
+static mjb_status mjb_normalize_state_finish(mjb_normalize_state *state, mjb_output *output) {
+    mjb_status status = mjb_normalize_state_flush(state, output);
+
+    if(status != MJB_STATUS_OK || !state->is_composition) {
+        return status;
     }
 
+    status = mjb_recompose(output, state->segment.count, state->segment.characters,
+        state->output_encoding);
+    state->segment.count = 0;
+
+    return status;
+}
+
+/**
+ * Write the ASCII run at the start of a UTF-8 buffer straight to a UTF-8 output, no form changes
+ * it. The last character of the run is left to the caller, it can compose with what follows.
+ * Returns the bytes written.
+ */
+static size_t mjb_normalize_state_ascii(mjb_normalize_state *state, const char *buffer,
+    size_t byte_length, mjb_output *output, mjb_status *status) {
+    size_t run = mjb_utf8_ascii_span(buffer, byte_length);
+
+    if(run < 2) {
+        return 0;
+    }
+
+    // An ASCII character ends the previous segment.
+    *status = mjb_normalize_state_finish(state, output);
+
+    if(*status == MJB_STATUS_OK) {
+        *status = mjb_output_write(output, buffer, run - 1);
+    }
+
+    return run - 1;
+}
+
+// Decompose a codepoint into the combining characters buffer.
+static mjb_status mjb_normalize_state_next(mjb_normalize_state *state, mjb_codepoint codepoint,
+    mjb_output *output) {
+    mjb_n_character current_character;
+    mjb_n_character *characters_buffer = state->characters_buffer;
+    mjb_normalization form = state->form;
+    bool is_composition = state->is_composition;
+    bool is_compatibility = state->is_compatibility;
+    mjb_status status = MJB_STATUS_OK;
+
 // The flush buffer is called multiple times, let's make a macro to avoid code duplication.
 #define MJB_NORMALIZE_FLUSH_BUFFER() \
     do { \
-        if(is_composition) { \
-            status = mjb_flush_c_buffer(characters_buffer, buffer_index, &composition_buffer, \
-                &output_index, &composition_capacity); \
-            if(status != MJB_STATUS_OK) { \
-                goto fail; \
-            } \
-        } else { \
-            status = mjb_flush_d_buffer(characters_buffer, buffer_index, output, output_encoding); \
-            if(status != MJB_STATUS_OK) { \
-                goto fail; \
-            } \
+        status = mjb_normalize_state_flush(state, output); \
+        if(status != MJB_STATUS_OK) { \
+            return status; \
         } \
-        buffer_index = 0; \
     } while(0)
 
-    // Loop through the string.
-    bool in_error = false;
+    // Get current character.
+    if(!mjb_n_codepoint_character(codepoint, &current_character)) {
+        return MJB_STATUS_OK;
+    }
 
-    for(size_t i = 0; i < byte_length;) {
-        // Find next codepoint.
-        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &i,
-            encoding, &codepoint, &in_error);
+    // Count of characters produced by decomposition.
+    int characters_decomposed = 0;
+    bool should_decompose = false;
+
+    /*
+     * Determine whether this character should be decomposed based on the normalization form.
+     * The should_decompose flag controls whether we attempt to decompose the character
+     * or just pass it through unchanged.
+     */
+    if(is_compatibility) {
+        should_decompose = true;
+    } else {
+        should_decompose = current_character.decomposition == MJB_DECOMPOSITION_CANONICAL;
+    }
 
-        if(decode_status == MJB_DECODE_END) {
-            break;
-        }
+    // Hangul syllables have a special decomposition.
+    // Only decompose in NFD/NFKD forms, not in NFC/NFKC forms
+    if(mjb_codepoint_is_hangul_syllable(codepoint) &&
+        (form == MJB_NORMALIZATION_NFD || form == MJB_NORMALIZATION_NFKD)) {
+        mjb_codepoint codepoints[3];
 
-        if(decode_status == MJB_DECODE_INCOMPLETE) {
-            continue;
+        if(mjb_hangul_syllable_decomposition(codepoint, codepoints) != MJB_STATUS_OK) {
+            return MJB_STATUS_OK;
         }
 
-        // Get current character.
-        if(!mjb_n_codepoint_character(codepoint, &current_character)) {
-            continue;
-        }
-
-        // Count of characters produced by decomposition.
-        int characters_decomposed = 0;
-        bool should_decompose = false;
+        for(size_t j = 0; j < 3; ++j) {
+            if(codepoints[j] == 0) {
+                continue;
+            }
 
-        /*
-         * Determine whether this character should be decomposed based on the normalization form.
-         * The should_decompose flag controls whether we attempt to decompose the character
-         * or just pass it through unchanged.
-         */
-        if(is_compatibility) {
-            should_decompose = true;
-        } else {
-            should_decompose = current_character.decomposition == MJB_DECOMPOSITION_CANONICAL;
-        }
+            if(!mjb_n_codepoint_character(codepoints[j], &current_character)) {
+                continue;
+            }
 
-        // Hangul syllables have a special decomposition.
-        // Only decompose in NFD/NFKD forms, not in NFC/NFKC forms
-        if(mjb_codepoint_is_hangul_syllable(codepoint) &&
-            (form == MJB_NORMALIZATION_NFD || form == MJB_NORMALIZATION_NFKD)) {
-            mjb_codepoint codepoints[3];
+            // Starter: Any code point (assigned or not) with combining class of zero (ccc = 0)
+            if(state->buffer_index && current_character.combining == MJB_CCC_NOT_REORDERED) {
+                MJB_NORMALIZE_FLUSH_BUFFER();
+            }
 
-            if(mjb_hangul_syllable_decomposition(codepoint, codepoints) != MJB_STATUS_OK) {
-                continue;
+            if(state->buffer_index >= MJB_MAX_COMBINING_CHARACTERS) {
+                // Buffer full, flush and continue
+                MJB_NORMALIZE_FLUSH_BUFFER();
             }
 
-            for(size_t j = 0; j < 3; ++j) {
-                if(codepoints[j] == 0) {
+            characters_buffer[state->buffer_index++] = current_character;
+            ++characters_decomposed;
+        }
+    } else if(should_decompose) {
+        const mjb_codepoint *decompositions = NULL;
+        uint8_t decomposition_count = 0;
+
+        if(mjb_unicode_decomposition_lookup(codepoint, is_compatibility, &decompositions,
+               &decomposition_count)) {
+            for(uint8_t decomposition_index = 0; decomposition_index < decomposition_count;
+                ++decomposition_index) {
+                mjb_codepoint decomposed = decompositions[decomposition_index];
+
+                if(decomposed == MJB_CODEPOINT_NOT_VALID) {
                     continue;
                 }
 
-                if(!mjb_n_codepoint_character(codepoints[j], &current_character)) {
+                if(!mjb_n_codepoint_character(decomposed, &current_character)) {
                     continue;
                 }
 
-                // Starter: Any code point (assigned or not) with combining class of zero (ccc = 0)
-                if(buffer_index && current_character.combining == MJB_CCC_NOT_REORDERED) {
+                ++characters_decomposed;
+
+                /*
+                 * When we encounter a "starter" character (CCC = 0), we must flush any pending
+                 * combining characters in the buffer to ensure proper ordering.
+                 *
+                 * See
+                 * https://www.unicode.org/versions/Unicode18.0.0/core-spec/chapter-3/#G49579
+                 */
+                if(state->buffer_index && current_character.combining == MJB_CCC_NOT_REORDERED) {
                     MJB_NORMALIZE_FLUSH_BUFFER();
                 }
 
-                if(buffer_index >= MJB_MAX_COMBINING_CHARACTERS) {
+                if(state->buffer_index >= MJB_MAX_COMBINING_CHARACTERS) {
                     // Buffer full, flush and continue
                     MJB_NORMALIZE_FLUSH_BUFFER();
                 }
 
-                characters_buffer[buffer_index++] = current_character;
-                ++characters_decomposed;
-            }
-        } else if(should_decompose) {
-            const mjb_codepoint *decompositions = NULL;
-            uint8_t decomposition_count = 0;
-
-            if(mjb_unicode_decomposition_lookup(codepoint, is_compatibility, &decompositions,
-                   &decomposition_count)) {
-                for(uint8_t decomposition_index = 0; decomposition_index < decomposition_count;
-                    ++decomposition_index) {
-                    mjb_codepoint decomposed = decompositions[decomposition_index];
-
-                    if(decomposed == MJB_CODEPOINT_NOT_VALID) {
-                        continue;
-                    }
-
-                    if(!mjb_n_codepoint_character(decomposed, &current_character)) {
-                        continue;
-                    }
-
-                    // ++codepoints_count;
-                    ++characters_decomposed;
-
-                    /*
-                     * When we encounter a "starter" character (CCC = 0), we must flush any pending
-                     * combining characters in the buffer to ensure proper ordering.
-                     *
-                     * See
-                     * https://www.unicode.org/versions/Unicode18.0.0/core-spec/chapter-3/#G49579
-                     */
-                    if(buffer_index && current_character.combining == MJB_CCC_NOT_REORDERED) {
-                        MJB_NORMALIZE_FLUSH_BUFFER();
-                    }
-
-                    if(buffer_index >= MJB_MAX_COMBINING_CHARACTERS) {
-                        // Buffer full, flush and continue
-                        MJB_NORMALIZE_FLUSH_BUFFER();
-                    }
-
-                    characters_buffer[buffer_index++] = current_character;
-                }
+                characters_buffer[state->buffer_index++] = current_character;
             }
         }
+    }
 
-        if(!characters_decomposed) {
-            // Special handling for Hangul composition.
-            if(is_composition) {
-                // Check if we have a Hangul syllable followed by a trailing consonant.
-                if(buffer_index > 0 &&
-                    mjb_codepoint_is_hangul_syllable(characters_buffer[buffer_index - 1]
-                            .codepoint) &&
-                    mjb_codepoint_is_hangul_trailing_jamo(codepoint)) {
-
-                    // Check if the syllable can accept a trailing consonant
-                    mjb_codepoint syllable = characters_buffer[buffer_index - 1].codepoint;
-                    int s_index = syllable - MJB_CP_HANGUL_S_BASE;
-
-                    if(s_index >= 0 && s_index < MJB_CP_HANGUL_S_COUNT &&
-                        (s_index % MJB_CP_HANGUL_T_COUNT) == 0) {
-                        // The syllable has no trailing consonant, so we can add one
-                        mjb_codepoint trailing = codepoint;
-                        mjb_codepoint composed = syllable + (trailing - MJB_CP_HANGUL_T_BASE);
-                        characters_buffer[buffer_index - 1].codepoint = composed;
-
-                        // Don't add the trailing consonant since it's been composed
-                        continue;
-                    }
+    if(!characters_decomposed) {
+        size_t buffer_index = state->buffer_index;
+
+        // Special handling for Hangul composition.
+        if(is_composition) {
+            // Check if we have a Hangul syllable followed by a trailing consonant.
+            if(buffer_index > 0 &&
+                mjb_codepoint_is_hangul_syllable(characters_buffer[buffer_index - 1].codepoint) &&
+                mjb_codepoint_is_hangul_trailing_jamo(codepoint)) {
+
+                // Check if the syllable can accept a trailing consonant
+                mjb_codepoint syllable = characters_buffer[buffer_index - 1].codepoint;
+                int s_index = syllable - MJB_CP_HANGUL_S_BASE;
+
+                if(s_index >= 0 && s_index < MJB_CP_HANGUL_S_COUNT &&
+                    (s_index % MJB_CP_HANGUL_T_COUNT) == 0) {
+                    // The syllable has no trailing consonant, so we can add one
+                    mjb_codepoint trailing = codepoint;
+                    mjb_codepoint composed = syllable + (trailing - MJB_CP_HANGUL_T_BASE);
+                    characters_buffer[buffer_index - 1].codepoint = composed;
+
+                    // Don't add the trailing consonant since it's been composed
+                    return MJB_STATUS_OK;
                 }
             }
+        }
 
-            if(buffer_index && current_character.combining == MJB_CCC_NOT_REORDERED) {
-                MJB_NORMALIZE_FLUSH_BUFFER();
-            }
-
-            if(buffer_index >= MJB_MAX_COMBINING_CHARACTERS) {
-                // Buffer full, flush and continue.
-                MJB_NORMALIZE_FLUSH_BUFFER();
-            }
+        if(buffer_index && current_character.combining == MJB_CCC_NOT_REORDERED) {
+            MJB_NORMALIZE_FLUSH_BUFFER();
+        }
 
-            characters_buffer[buffer_index++] = current_character;
+        if(state->buffer_index >= MJB_MAX_COMBINING_CHARACTERS) {
+            // Buffer full, flush and continue.
+            MJB_NORMALIZE_FLUSH_BUFFER();
         }
-    }
 
-    // We have combining characters in the buffer, we must output them.
-    if(buffer_index) {
-        MJB_NORMALIZE_FLUSH_BUFFER();
+        characters_buffer[state->buffer_index++] = current_character;
     }
 
-    if(is_composition) {
-        status = mjb_recompose(output, output_index, composition_buffer, output_encoding);
+#undef MJB_NORMALIZE_FLUSH_BUFFER
 
-        if(status != MJB_STATUS_OK) {
-            goto fail;
+    return MJB_STATUS_OK;
+}
+
+static mjb_status mjb_normalize_write(mjb_output *output, const void *context_pointer) {
+    const mjb_normalize_context *context = (const mjb_normalize_context *)context_pointer;
+    const char *buffer = context->buffer;
+    size_t byte_length = context->byte_length;
+    mjb_encoding encoding = context->encoding;
+    uint8_t state = MJB_UTF_ACCEPT;
+    mjb_codepoint codepoint = 0;
+    bool in_error = false;
+
+    bool ascii_runs = (encoding == MJB_ENC_UTF_8 || encoding == MJB_ENC_ASCII) &&
+        (context->output_encoding == MJB_ENC_UTF_8 || context->output_encoding == MJB_ENC_ASCII);
+
+    mjb_normalize_state normalize_state;
+    mjb_normalize_state_init(&normalize_state, context->form, context->output_encoding);
+
+    mjb_status status = mjb_output_write(output, buffer, context->start);
+
+    // Loop through the string.
+    for(size_t i = context->start; status == MJB_STATUS_OK && i < byte_length;) {
+        if(ascii_runs && state == MJB_UTF_ACCEPT && (uint8_t)buffer[i] < 0x80) {
+            i += mjb_normalize_state_ascii(&normalize_state, buffer + i, byte_length - i, output,
+                &status);
+
+            if(status != MJB_STATUS_OK) {
+                break;
+            }
         }
-    }
 
-    mjb_free(composition_buffer);
+        // Find next codepoint.
+        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &i,
+            encoding, &codepoint, &in_error);
+
+        if(decode_status == MJB_DECODE_END) {
+            break;
+        }
 
-#undef MJB_NORMALIZE_FLUSH_BUFFER
+        if(decode_status == MJB_DECODE_INCOMPLETE) {
+            continue;
+        }
 
-    return MJB_STATUS_OK;
+        status = mjb_normalize_state_next(&normalize_state, codepoint, output);
+    }
 
-fail:
-    mjb_free(composition_buffer);
+    // We have characters in the buffers, we must output them.
+    if(status == MJB_STATUS_OK) {
+        status = mjb_normalize_state_finish(&normalize_state, output);
+    }
 
-#undef MJB_NORMALIZE_FLUSH_BUFFER
+    mjb_normalize_state_free(&normalize_state);
 
     return status;
 }
@@ -559,7 +678,9 @@ MJB_EXPORT mjb_status mjb_normalize(const char *buffer, size_t byte_length, mjb_
     result->transformed = false;
 
     mjb_quick_check_result is_normalized;
-    status = mjb_normalization_quick_check(buffer, byte_length, encoding, form, &is_normalized);
+    size_t span = 0;
+    status = mjb_normalization_quick_check_span(buffer, byte_length, encoding, form,
+        &is_normalized, &span);
 
     if(status != MJB_STATUS_OK) {
         return status;
@@ -592,8 +713,8 @@ MJB_EXPORT mjb_status mjb_normalize(const char *buffer, size_t byte_length, mjb_
 
     mjb_output output;
     mjb_output_init_dynamic(&output, allocated, potential_output_size);
-    mjb_normalize_context context = { buffer, byte_length, potential_output_size, encoding, form,
-        output_encoding };
+    mjb_normalize_context context = { buffer, byte_length, encoding, form, output_encoding,
+        mjb_normalization_prefix(span, encoding, output_encoding) };
     status = mjb_normalize_write(&output, &context);
 
     if(status != MJB_STATUS_OK) {
@@ -610,6 +731,50 @@ MJB_EXPORT mjb_status mjb_normalize(const char *buffer, size_t byte_length, mjb_
     return MJB_STATUS_OK;
 }
 
+/**
+ * Normalize to UTF-8 into a reusable buffer allocated with mjb_alloc. `span` is the normalized
+ * prefix reported by mjb_normalization_quick_check_span, or 0. `*output` and `*capacity` follow
+ * the buffer as it grows, also on failure, so the caller always owns a valid buffer.
+ */
+mjb_status mjb_normalize_buffer(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    mjb_normalization form, size_t span, char **output, size_t *capacity, size_t *output_size) {
+    size_t potential_output_size = 0;
+    mjb_status status = mjb_normalization_estimate(buffer, byte_length, encoding, MJB_ENC_UTF_8,
+        &potential_output_size);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    if(*output == NULL || *capacity < potential_output_size) {
+        char *grown = (char *)mjb_realloc(*output, potential_output_size);
+
+        if(grown == NULL) {
+            return MJB_STATUS_NO_MEMORY;
+        }
+
+        *output = grown;
+        *capacity = potential_output_size;
+    }
+
+    mjb_output normalized;
+    mjb_output_init_dynamic(&normalized, *output, *capacity);
+    mjb_normalize_context context = { buffer, byte_length, encoding, form, MJB_ENC_UTF_8,
+        mjb_normalization_prefix(span, encoding, MJB_ENC_UTF_8) };
+    status = mjb_normalize_write(&normalized, &context);
+
+    *output = normalized.buffer;
+    *capacity = normalized.capacity;
+
+    if(status != MJB_STATUS_OK) {
+        return status == MJB_STATUS_UNSUPPORTED ? MJB_STATUS_NO_MEMORY : status;
+    }
+
+    *output_size = normalized.size;
+
+    return MJB_STATUS_OK;
+}
+
 MJB_EXPORT mjb_status mjb_normalize_into(const char *buffer, size_t byte_length,
     mjb_encoding encoding, mjb_normalization form, mjb_encoding output_encoding, void *output,
     size_t *output_size) {
@@ -642,7 +807,9 @@ MJB_EXPORT mjb_status mjb_normalize_into(const char *buffer, size_t byte_length,
     }
 
     mjb_quick_check_result is_normalized;
-    status = mjb_normalization_quick_check(buffer, byte_length, encoding, form, &is_normalized);
+    size_t span = 0;
+    status = mjb_normalization_quick_check_span(buffer, byte_length, encoding, form,
+        &is_normalized, &span);
 
     if(status != MJB_STATUS_OK) {
         *output_size = 0;
@@ -659,9 +826,183 @@ MJB_EXPORT mjb_status mjb_normalize_into(const char *buffer, size_t byte_length,
         return mjb_output_copy_into(buffer, byte_length, output, output_size);
     }
 
-    size_t potential_output_size = 0;
-    status = mjb_normalization_estimate(buffer, byte_length, encoding, output_encoding,
-        &potential_output_size);
+    mjb_normalize_context context = { buffer, byte_length, encoding, form, output_encoding,
+        mjb_normalization_prefix(span, encoding, output_encoding) };
+
+    return mjb_output_into(output, output_size, mjb_normalize_write, &context);
+}
+
+// Streaming normalization state behind mjb_normalizer.
+typedef struct mjb_normalizer_state {
+    mjb_normalize_state normalize;
+    mjb_encoding encoding; // The resolved input encoding, the requested one until the BOM is read
+    uint8_t decoder;
+    bool in_error;
+    mjb_codepoint codepoint;
+    char unit[4]; // A code unit split between chunks, or the BOM still being read
+    size_t unit_size;
+    mjb_output output; // Output not yet delivered to the caller
+} mjb_normalizer_state;
+
+#define MJB_NORMALIZER_OUTPUT_SIZE 256
+
+static size_t mjb_normalizer_unit_size(mjb_encoding encoding) {
+    if(encoding == MJB_ENC_UTF_16 || encoding == MJB_ENC_UTF_16BE ||
+        encoding == MJB_ENC_UTF_16LE) {
+        return 2;
+    }
+
+    if(encoding == MJB_ENC_UTF_32 || encoding == MJB_ENC_UTF_32BE ||
+        encoding == MJB_ENC_UTF_32LE) {
+        return 4;
+    }
+
+    return 1;
+}
+
+static void mjb_normalizer_reset(mjb_normalizer_state *state, mjb_encoding encoding) {
+    state->encoding = encoding;
+    state->decoder = MJB_UTF_ACCEPT;
+    state->in_error = false;
+    state->codepoint = 0;
+    state->unit_size = 0;
+}
+
+// Decode and normalize whole code units, the decoder keeps a sequence split between chunks.
+static mjb_status mjb_normalizer_decode(mjb_normalizer_state *state, const char *buffer,
+    size_t byte_length) {
+    bool ascii_runs = (state->encoding == MJB_ENC_UTF_8 || state->encoding == MJB_ENC_ASCII) &&
+        (state->normalize.output_encoding == MJB_ENC_UTF_8 ||
+            state->normalize.output_encoding == MJB_ENC_ASCII);
+    mjb_status status = MJB_STATUS_OK;
+
+    for(size_t i = 0; i < byte_length;) {
+        if(ascii_runs && state->decoder == MJB_UTF_ACCEPT && (uint8_t)buffer[i] < 0x80) {
+            i += mjb_normalize_state_ascii(&state->normalize, buffer + i, byte_length - i,
+                &state->output, &status);
+
+            if(status != MJB_STATUS_OK) {
+                return status;
+            }
+        }
+
+        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state->decoder,
+            &i, state->encoding, &state->codepoint, &state->in_error);
+
+        if(decode_status == MJB_DECODE_END) {
+            break;
+        }
+
+        if(decode_status == MJB_DECODE_INCOMPLETE) {
+            continue;
+        }
+
+        if(decode_status == MJB_DECODE_ERROR) {
+            return MJB_STATUS_MALFORMED_INPUT;
+        }
+
+        status = mjb_normalize_state_next(&state->normalize, state->codepoint, &state->output);
+
+        if(status != MJB_STATUS_OK) {
+            return status;
+        }
+    }
+
+    return MJB_STATUS_OK;
+}
+
+// Copy the pending output to the caller buffer, following the *_into conventions.
+static mjb_status mjb_normalizer_deliver(mjb_normalizer_state *state, void *output,
+    size_t *output_size) {
+    size_t capacity = *output_size;
+    *output_size = state->output.size;
+
+    if(output == NULL || state->output.size == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    if(capacity < state->output.size) {
+        return MJB_STATUS_OUTPUT_TOO_SMALL;
+    }
+
+    memcpy(output, state->output.buffer, state->output.size);
+    state->output.size = 0;
+
+    return MJB_STATUS_OK;
+}
+
+MJB_EXPORT mjb_status mjb_normalizer_init(mjb_normalizer *normalizer, mjb_encoding encoding,
+    mjb_normalization form, mjb_encoding output_encoding) {
+    if(normalizer == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(normalizer, 0, sizeof(*normalizer));
+
+    if(!mjb_normalization_form_is_valid(form)) {
+        return MJB_STATUS_INVALID_FORM;
+    }
+
+    if(!mjb_encoding_is_valid_input(encoding) || !mjb_encoding_is_valid_output(output_encoding)) {
+        return MJB_STATUS_INVALID_ENCODING;
+    }
+
+    mjb_normalizer_state *state = (mjb_normalizer_state *)mjb_alloc(sizeof(mjb_normalizer_state));
+
+    if(state == NULL) {
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    char *output = (char *)mjb_alloc(MJB_NORMALIZER_OUTPUT_SIZE);
+
+    if(output == NULL) {
+        mjb_free(state);
+
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    mjb_normalize_state_init(&state->normalize, form, output_encoding);
+    mjb_normalizer_reset(state, encoding);
+    mjb_output_init_dynamic(&state->output, output, MJB_NORMALIZER_OUTPUT_SIZE);
+
+    normalizer->encoding = encoding;
+    normalizer->form = form;
+    normalizer->output_encoding = output_encoding;
+    normalizer->state = state;
+
+    return MJB_STATUS_OK;
+}
+
+MJB_EXPORT void mjb_normalizer_free(mjb_normalizer *normalizer) {
+    if(normalizer == NULL) {
+        return;
+    }
+
+    mjb_normalizer_state *state = (mjb_normalizer_state *)normalizer->state;
+
+    if(state != NULL) {
+        mjb_normalize_state_free(&state->normalize);
+        mjb_free(state->output.buffer);
+        mjb_free(state);
+    }
+
+    memset(normalizer, 0, sizeof(*normalizer));
+}
+
+MJB_EXPORT mjb_status mjb_normalizer_feed(mjb_normalizer *normalizer, const char *buffer,
+    size_t byte_length, void *output, size_t *output_size) {
+    if(output_size == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(normalizer == NULL || normalizer->state == NULL || (buffer == NULL && byte_length > 0)) {
+        *output_size = 0;
+
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_normalizer_state *state = (mjb_normalizer_state *)normalizer->state;
+    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, normalizer->encoding);
 
     if(status != MJB_STATUS_OK) {
         *output_size = 0;
@@ -669,10 +1010,95 @@ MJB_EXPORT mjb_status mjb_normalize_into(const char *buffer, size_t byte_length,
         return status;
     }
 
-    mjb_normalize_context context = { buffer, byte_length, potential_output_size, encoding, form,
-        output_encoding };
+    size_t unit = mjb_normalizer_unit_size(state->encoding);
+    size_t i = 0;
 
-    return mjb_output_into(output, output_size, mjb_normalize_write, &context);
+    // Complete the BOM of MJB_ENC_UTF_16 and MJB_ENC_UTF_32, or a code unit split between chunks.
+    if(state->unit_size != 0 || state->encoding == MJB_ENC_UTF_16 ||
+        state->encoding == MJB_ENC_UTF_32) {
+        size_t copied = unit - state->unit_size;
+
+        if(copied > byte_length) {
+            copied = byte_length;
+        }
+
+        if(copied != 0) {
+            memcpy(state->unit + state->unit_size, buffer, copied);
+        }
+        state->unit_size += copied;
+        i = copied;
+
+        if(state->unit_size == unit) {
+            if(state->encoding == MJB_ENC_UTF_16 || state->encoding == MJB_ENC_UTF_32) {
+                size_t bom = 0;
+                state->encoding = mjb_resolve_input_encoding(state->unit, unit,
+                    normalizer->encoding, &bom);
+
+                if(state->encoding == normalizer->encoding) {
+                    *output_size = 0;
+
+                    return MJB_STATUS_MALFORMED_INPUT;
+                }
+            } else {
+                status = mjb_normalizer_decode(state, state->unit, unit);
+            }
+
+            state->unit_size = 0;
+        }
+    }
+
+    if(status == MJB_STATUS_OK && state->unit_size == 0) {
+        size_t whole = (byte_length - i) - (byte_length - i) % unit;
+        status = mjb_normalizer_decode(state, buffer + i, whole);
+        i += whole;
+
+        if(status == MJB_STATUS_OK && i < byte_length) {
+            memcpy(state->unit, buffer + i, byte_length - i);
+            state->unit_size = byte_length - i;
+        }
+    }
+
+    if(status != MJB_STATUS_OK) {
+        *output_size = 0;
+
+        return status;
+    }
+
+    return mjb_normalizer_deliver(state, output, output_size);
+}
+
+MJB_EXPORT mjb_status mjb_normalizer_finish(mjb_normalizer *normalizer, void *output,
+    size_t *output_size) {
+    if(output_size == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(normalizer == NULL || normalizer->state == NULL) {
+        *output_size = 0;
+
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_normalizer_state *state = (mjb_normalizer_state *)normalizer->state;
+
+    // The stream ends inside a code unit, a sequence or a BOM.
+    if(state->unit_size != 0 || mjb_utf_state_is_incomplete(state->decoder)) {
+        *output_size = 0;
+
+        return MJB_STATUS_MALFORMED_INPUT;
+    }
+
+    mjb_status status = mjb_normalize_state_finish(&state->normalize, &state->output);
+
+    if(status != MJB_STATUS_OK) {
+        *output_size = 0;
+
+        return status;
+    }
+
+    mjb_normalizer_reset(state, normalizer->encoding);
+
+    return mjb_normalizer_deliver(state, output, output_size);
 }
 
 // Apply full default case folding and remove Default_Ignorable_Code_Point characters.
@@ -706,21 +1132,8 @@ static mjb_status mjb_nfkc_casefold_pass(const char *buffer, size_t byte_length,
             continue;
         }
 
-        const mjb_codepoint *mapping = NULL;
-        uint8_t mapping_length = 0;
-
-        if(!mjb_unicode_case_folding_lookup(codepoint, &mapping, &mapping_length)) {
-            mjb_unicode_case_mapping simple_mapping;
-
-            if(mjb_codepoint_has_binary_property(codepoint, MJB_PR_CHANGES_WHEN_CASEFOLDED) &&
-                mjb_unicode_case_lookup(codepoint, &simple_mapping) &&
-                simple_mapping.lowercase != 0) {
-                codepoint = simple_mapping.lowercase;
-            }
-
-            mapping = &codepoint;
-            mapping_length = 1;
-        }
+        mjb_codepoint mapping[3];
+        uint8_t mapping_length = mjb_casefold_codepoint(codepoint, mapping);
 
         for(uint8_t j = 0; j < mapping_length; ++j) {
             char *new_folded = mjb_string_output_codepoint(mapping[j], folded, &output_index,
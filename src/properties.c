@@ -8,6 +8,7 @@
 
 #include "mojibake-internal.h"
 #include "unicode-tables.h"
+#include "utf.h"
 
 // clang-format off
 /**
@@ -366,6 +367,126 @@ MJB_EXPORT mjb_status mjb_codepoint_property_int(mjb_codepoint codepoint, mjb_pr
     return MJB_STATUS_OK;
 }
 
+// Return the property value of a codepoint, or 0 ("no value") when it has none or is not valid.
+static int32_t mjb_property_batch_value(mjb_unicode_property_cache *cache,
+    mjb_codepoint codepoint) {
+    if(!mjb_codepoint_is_valid(codepoint)) {
+        return 0;
+    }
+
+    return (int32_t)mjb_unicode_property_cache_lookup(cache, codepoint);
+}
+
+// Return the enumerated or integer property values of an array of codepoints.
+MJB_EXPORT mjb_status mjb_codepoints_property_int(const mjb_codepoint *codepoints, size_t count,
+    mjb_property property, int32_t *values) {
+    if(!mjb_property_valid(property) || mjb_property_binary(property)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(count == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    if(codepoints == NULL || values == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_unicode_property_cache cache;
+    mjb_unicode_property_cache_init(&cache, property);
+
+    for(size_t i = 0; i < count; ++i) {
+        values[i] = mjb_property_batch_value(&cache, codepoints[i]);
+    }
+
+    return MJB_STATUS_OK;
+}
+
+// Decode a string and return the enumerated or integer property value of each codepoint.
+MJB_EXPORT mjb_status mjb_string_property_int(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_property property, int32_t *values, size_t *count) {
+    if(count == NULL || !mjb_property_valid(property) || mjb_property_binary(property)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(values == NULL) {
+        // Query the required count.
+        return mjb_codepoint_count(buffer, byte_length, encoding, count);
+    }
+
+    size_t capacity = *count;
+    *count = 0;
+
+    if(byte_length == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    if(buffer == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(!mjb_encoding_is_valid_input(encoding)) {
+        return MJB_STATUS_INVALID_ENCODING;
+    }
+
+    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+
+    if(status != MJB_STATUS_OK || byte_length == 0) {
+        return status;
+    }
+
+    mjb_unicode_property_cache cache;
+    mjb_unicode_property_cache_init(&cache, property);
+
+    uint8_t state = MJB_UTF_ACCEPT;
+    bool in_error = false;
+    mjb_codepoint codepoint = 0;
+    size_t written = 0;
+    bool utf8 = encoding == MJB_ENC_UTF_8 || encoding == MJB_ENC_ASCII;
+
+    for(size_t i = 0; i < byte_length;) {
+        if(utf8 && state == MJB_UTF_ACCEPT) {
+            // Every byte of an ASCII run is a codepoint.
+            size_t span = mjb_utf8_ascii_span(buffer + i, byte_length - i);
+
+            if(span != 0) {
+                for(size_t k = 0; k < span; ++k, ++written) {
+                    if(written < capacity) {
+                        values[written] = mjb_property_batch_value(&cache,
+                            (mjb_codepoint)(uint8_t)buffer[i + k]);
+                    }
+                }
+
+                i += span;
+                in_error = false;
+
+                continue;
+            }
+        }
+
+        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &i,
+            encoding, &codepoint, &in_error);
+
+        if(decode_status == MJB_DECODE_END) {
+            break;
+        }
+
+        if(decode_status != MJB_DECODE_OK && decode_status != MJB_DECODE_ERROR) {
+            continue;
+        }
+
+        if(written < capacity) {
+            values[written] = mjb_property_batch_value(&cache, codepoint);
+        }
+
+        ++written;
+    }
+
+    *count = written;
+
+    return written > capacity ? MJB_STATUS_OUTPUT_TOO_SMALL : MJB_STATUS_OK;
+}
+
 mjb_status mjb_codepoint_properties_lookup(mjb_codepoint codepoint, uint8_t *buffer) {
     if(buffer == NULL || !mjb_codepoint_is_valid(codepoint)) {
         return MJB_STATUS_INVALID_ARGUMENT;
@@ -388,6 +509,18 @@ uint8_t mjb_codepoint_properties_get(const uint8_t *properties, mjb_property pro
     return properties[property];
 }
 
+// O(1) trie lookup of the segmentation properties. Missing values are 0 (not set).
+bool mjb_codepoint_segmentation_properties(mjb_codepoint codepoint,
+    mjb_segmentation_properties *properties) {
+    if(!mjb_codepoint_is_valid(codepoint)) {
+        return false;
+    }
+
+    *properties = mjb_unicode_segmentation_lookup(codepoint);
+
+    return true;
+}
+
 MJB_EXPORT mjb_script mjb_codepoint_script(mjb_codepoint codepoint) {
     if(!mjb_codepoint_is_valid(codepoint)) {
         return MJB_SC_ZZZZ;
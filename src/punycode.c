@@ -183,34 +183,25 @@ mjb_status mjb_punycode_encode(const mjb_codepoint *codepoints, size_t count, mj
     return MJB_STATUS_OK;
 }
 
-mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codepoint **codepoints,
+// Decode into `codepoints`, which has room for `byte_length` codepoints. A Punycode string never
+// decodes to more codepoints than it has bytes.
+mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codepoint *codepoints,
     size_t *count) {
-    if(codepoints == NULL || count == NULL || (buffer == NULL && byte_length > 0)) {
+    if((codepoints == NULL && byte_length > 0) || count == NULL ||
+        (buffer == NULL && byte_length > 0)) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
-    *codepoints = NULL;
     *count = 0;
 
     if(byte_length == 0) {
         return MJB_STATUS_OK;
     }
 
-    if(byte_length > SIZE_MAX / sizeof(mjb_codepoint)) {
-        return MJB_STATUS_OVERFLOW;
-    }
-
-    mjb_codepoint *decoded = (mjb_codepoint *)mjb_alloc(byte_length * sizeof(mjb_codepoint));
-
-    if(decoded == NULL) {
-        return MJB_STATUS_NO_MEMORY;
-    }
-
     size_t delimiter = SIZE_MAX;
 
     for(size_t i = 0; i < byte_length; ++i) {
         if((uint8_t)buffer[i] >= 0x80) {
-            mjb_free(decoded);
             return MJB_STATUS_MALFORMED_INPUT;
         }
 
@@ -223,7 +214,7 @@ mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codep
 
     if(delimiter != SIZE_MAX) {
         for(size_t i = 0; i < delimiter; ++i) {
-            decoded[*count] = (uint8_t)buffer[i];
+            codepoints[*count] = (uint8_t)buffer[i];
             ++*count;
         }
 
@@ -240,7 +231,6 @@ mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codep
 
         for(uint64_t k = MJB_PUNYCODE_BASE;; k += MJB_PUNYCODE_BASE) {
             if(input_index >= byte_length) {
-                mjb_free(decoded);
                 *count = 0;
                 return MJB_STATUS_MALFORMED_INPUT;
             }
@@ -249,7 +239,6 @@ mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codep
 
             if(!mjb_punycode_decode_digit(buffer[input_index++], &digit) ||
                 digit > (UINT64_MAX - index) / weight) {
-                mjb_free(decoded);
                 *count = 0;
                 return MJB_STATUS_MALFORMED_INPUT;
             }
@@ -264,7 +253,6 @@ mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codep
             uint64_t factor = MJB_PUNYCODE_BASE - threshold;
 
             if(weight > UINT64_MAX / factor) {
-                mjb_free(decoded);
                 *count = 0;
                 return MJB_STATUS_MALFORMED_INPUT;
             }
@@ -276,7 +264,6 @@ mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codep
         bias = mjb_punycode_adapt(index - old_index, points, old_index == 0);
 
         if(index / points > UINT64_MAX - n) {
-            mjb_free(decoded);
             *count = 0;
             return MJB_STATUS_MALFORMED_INPUT;
         }
@@ -285,21 +272,18 @@ mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codep
         index %= points;
 
         if(n > MJB_CODEPOINT_MAX || (n >= 0xD800 && n <= 0xDFFF)) {
-            mjb_free(decoded);
             *count = 0;
             return MJB_STATUS_MALFORMED_INPUT;
         }
 
         size_t insertion = (size_t)index;
-        memmove(&decoded[insertion + 1], &decoded[insertion],
+        memmove(&codepoints[insertion + 1], &codepoints[insertion],
             (*count - insertion) * sizeof(mjb_codepoint));
-        decoded[insertion] = (mjb_codepoint)n;
+        codepoints[insertion] = (mjb_codepoint)n;
         ++*count;
         ++index;
     }
 
-    *codepoints = decoded;
-
     return MJB_STATUS_OK;
 }
 
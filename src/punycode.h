@@ -13,7 +13,7 @@
 
 #if MJB_FEATURE_IDNA
 mjb_status mjb_punycode_encode(const mjb_codepoint *codepoints, size_t count, mjb_output *output);
-mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codepoint **codepoints,
+mjb_status mjb_punycode_decode(const char *buffer, size_t byte_length, mjb_codepoint *codepoints,
     size_t *count);
 #endif
 
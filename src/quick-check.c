@@ -9,16 +9,45 @@
 
 extern mojibake mjb_global;
 
+// Decode the rest of the buffer from `index` and report whether it is well-formed.
+static bool mjb_quick_check_rest_is_valid(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, uint8_t state, size_t index, bool in_error) {
+    mjb_codepoint codepoint = 0;
+
+    while(index < byte_length) {
+        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &index,
+            encoding, &codepoint, &in_error);
+
+        if(decode_status == MJB_DECODE_END) {
+            break;
+        }
+
+        if(decode_status == MJB_DECODE_ERROR) {
+            return false;
+        }
+    }
+
+    return !mjb_utf_state_is_incomplete(state);
+}
+
 /**
- * Check if a string is normalized to NFC/NFKC/NFD/NFKD form.
+ * Check if a string is normalized to NFC/NFKC/NFD/NFKD form. If `span` is not NULL the check
+ * stops at the first codepoint that is not YES, and `span` receives the byte offset of the last
+ * starter before it: normalization leaves the bytes before the offset unchanged whatever follows.
+ * The rest of the input is still validated, as the normalizer resumes from the span.
  * See: https://unicode.org/reports/tr15/#Detecting_Normalization_Forms
  */
-MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_normalization form, mjb_quick_check_result *quick_check) {
+mjb_status mjb_normalization_quick_check_span(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_normalization form, mjb_quick_check_result *quick_check,
+    size_t *span) {
     if(quick_check == NULL) {
         return MJB_STATUS_INVALID_ARGUMENT;
     }
 
+    if(span != NULL) {
+        *span = 0;
+    }
+
     *quick_check = MJB_QC_NO;
 
     if(buffer == NULL && byte_length > 0) {
@@ -46,6 +75,20 @@ MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t b
         return MJB_STATUS_OK;
     }
 
+// Stop at the first codepoint that is not YES, with the prefix ending at the last starter.
+#define MJB_QUICK_CHECK_RETURN(RESULT) \
+    do { \
+        if(span != NULL) { \
+            if(!mjb_quick_check_rest_is_valid(buffer, byte_length, resolved_encoding, state, i, \
+                in_error)) { \
+                return MJB_STATUS_MALFORMED_INPUT; \
+            } \
+            *span = last_starter; \
+        } \
+        *quick_check = (RESULT); \
+        return MJB_STATUS_OK; \
+    } while(0)
+
     size_t resolved_index = 0;
     mjb_encoding resolved_encoding = mjb_resolve_input_encoding(buffer, byte_length, encoding,
         &resolved_index);
@@ -61,11 +104,29 @@ MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t b
     mjb_canonical_combining_class last_canonical_class = MJB_CCC_NOT_REORDERED;
     mjb_n_character current_character;
     bool in_error = false;
+    bool utf8 = resolved_encoding == MJB_ENC_UTF_8 || resolved_encoding == MJB_ENC_ASCII;
+    size_t last_starter = resolved_index;
+
+    for(size_t i = resolved_index; i < byte_length;) {
+        if(utf8 && state == MJB_UTF_ACCEPT) {
+            // ASCII is left unaffected by all of the Normalization Forms, see below.
+            size_t ascii = mjb_utf8_ascii_span(buffer + i, byte_length - i);
+
+            if(ascii != 0) {
+                i += ascii;
+                last_starter = i - 1;
+            }
+
+            if(i >= byte_length) {
+                break;
+            }
+        }
+
+        size_t codepoint_start = i;
 
-    for(size_t i = 0; i < byte_length;) {
         // Find next codepoint.
         mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &i,
-            encoding, &codepoint, &in_error);
+            resolved_encoding, &codepoint, &in_error);
 
         if(decode_status == MJB_DECODE_END) {
             break;
@@ -82,11 +143,15 @@ MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t b
         // Text exclusively containing ASCII characters (U+0000..U+007F) is left unaffected by all
         // of the Normalization Forms.
         if(codepoint < 0x80) {
+            last_starter = codepoint_start;
+
             continue;
         }
 
         // Text with only Latin-1 characters (U+0000..U+00FF) is left unaffected by NFC.
         if(codepoint < 0x100 && form == MJB_NORMALIZATION_NFC) {
+            last_starter = codepoint_start;
+
             continue;
         }
 
@@ -97,15 +162,11 @@ MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t b
 
         if(last_canonical_class > current_character.combining &&
             current_character.combining != MJB_CCC_NOT_REORDERED) {
-            *quick_check = MJB_QC_NO;
-
-            return MJB_STATUS_OK;
+            MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
         }
 
         if(current_character.quick_check == MJB_QC_NO) {
-            *quick_check = MJB_QC_NO;
-
-            return MJB_STATUS_OK;
+            MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
         }
 
         bool is_hangul_syllable = mjb_codepoint_is_hangul_syllable(codepoint);
@@ -113,56 +174,58 @@ MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t b
         switch(form) {
             case MJB_NORMALIZATION_NFC:
                 if(current_character.quick_check & MJB_QC_NFC_MAYBE) {
+                    // The span ends here, a MAYBE can compose with the starter before it
+                    if(span != NULL) {
+                        MJB_QUICK_CHECK_RETURN(MJB_QC_MAYBE);
+                    }
+
                     result = MJB_QC_MAYBE;
                 } else if(current_character.quick_check & MJB_QC_NFC_NO) {
-                    *quick_check = MJB_QC_NO;
-
-                    return MJB_STATUS_OK;
+                    MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
                 }
 
                 break;
             case MJB_NORMALIZATION_NFKC:
                 if(current_character.quick_check & MJB_QC_NFKC_MAYBE) {
+                    // As for NFC
+                    if(span != NULL) {
+                        MJB_QUICK_CHECK_RETURN(MJB_QC_MAYBE);
+                    }
+
                     result = MJB_QC_MAYBE;
                 } else if(current_character.quick_check & MJB_QC_NFKC_NO) {
-                    *quick_check = MJB_QC_NO;
-
-                    return MJB_STATUS_OK;
+                    MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
                 }
 
                 break;
             case MJB_NORMALIZATION_NFD:
                 if(is_hangul_syllable) {
-                    *quick_check = MJB_QC_NO;
-
-                    return MJB_STATUS_OK;
+                    MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
                 }
 
                 // There are no MAYBE values for NFD.
                 if(current_character.quick_check & MJB_QC_NFD_NO) {
-                    *quick_check = MJB_QC_NO;
-
-                    return MJB_STATUS_OK;
+                    MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
                 }
 
                 break;
             case MJB_NORMALIZATION_NFKD:
                 if(is_hangul_syllable) {
-                    *quick_check = MJB_QC_NO;
-
-                    return MJB_STATUS_OK;
+                    MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
                 }
 
                 // There are no MAYBE values for NFKD.
                 if(current_character.quick_check & MJB_QC_NFKD_NO) {
-                    *quick_check = MJB_QC_NO;
-
-                    return MJB_STATUS_OK;
+                    MJB_QUICK_CHECK_RETURN(MJB_QC_NO);
                 }
 
                 break;
         }
 
+        if(current_character.combining == MJB_CCC_NOT_REORDERED) {
+            last_starter = codepoint_start;
+        }
+
         last_canonical_class = (mjb_canonical_combining_class)current_character.combining;
     }
 
@@ -170,7 +233,19 @@ MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t b
         return MJB_STATUS_MALFORMED_INPUT;
     }
 
+#undef MJB_QUICK_CHECK_RETURN
+
     *quick_check = result;
 
+    if(span != NULL) {
+        *span = result == MJB_QC_YES ? byte_length : last_starter;
+    }
+
     return MJB_STATUS_OK;
 }
+
+MJB_EXPORT mjb_status mjb_normalization_quick_check(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_normalization form, mjb_quick_check_result *quick_check) {
+    return mjb_normalization_quick_check_span(buffer, byte_length, encoding, form, quick_check,
+        NULL);
+}
@@ -273,7 +273,9 @@ static mjb_status mjb_confusable_skeleton_finish(const char *buffer, size_t byte
             return MJB_STATUS_MALFORMED_INPUT;
         }
 
-        if(mjb_codepoint_has_binary_property(cp, MJB_PR_DEFAULT_IGNORABLE_CODE_POINT)) {
+        // No ASCII character is a default-ignorable codepoint.
+        if(cp >= 0x80 &&
+            mjb_codepoint_has_binary_property(cp, MJB_PR_DEFAULT_IGNORABLE_CODE_POINT)) {
             continue;
         }
 
@@ -330,6 +332,75 @@ static mjb_status mjb_confusable_skeleton_finish(const char *buffer, size_t byte
     return status;
 }
 
+// Return true when the bidi reordering of the skeleton would keep the logical order. Without R, AL,
+// AN and the explicit formatting characters an LTR paragraph only resolves to levels 0 and 2, and
+// a level 2 run is reversed twice, so nothing moves and no glyph is mirrored. BN characters are
+// removed by X9, so they take the full path too.
+static bool mjb_confusable_is_ltr_only(const char *buffer, size_t byte_length,
+    mjb_encoding encoding) {
+    uint8_t state = MJB_UTF_ACCEPT;
+    bool in_error = false;
+    mjb_codepoint codepoint = 0;
+    bool utf8 = encoding == MJB_ENC_UTF_8 || encoding == MJB_ENC_ASCII;
+
+    for(size_t i = 0; i < byte_length;) {
+        if(utf8 && state == MJB_UTF_ACCEPT) {
+            // No ASCII character is right-to-left or an explicit formatting character, but the C0
+            // controls other than the separators and U+007F are BN.
+            for(; i < byte_length && (uint8_t)buffer[i] < 0x80; ++i) {
+                uint8_t byte = (uint8_t)buffer[i];
+
+                if(byte < 0x09 || (byte >= 0x0E && byte <= 0x1B) || byte == 0x7F) {
+                    return false;
+                }
+            }
+
+            if(i == byte_length) {
+                break;
+            }
+        }
+
+        mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &i,
+            encoding, &codepoint, &in_error);
+
+        if(decode_status == MJB_DECODE_END) {
+            break;
+        }
+
+        if(decode_status == MJB_DECODE_INCOMPLETE) {
+            continue;
+        }
+
+        mjb_codepoint_record record;
+
+        // Unassigned codepoints resolve to L, as in mjb_bidi_resolve.
+        if(!mjb_unicode_record_lookup(codepoint, &record)) {
+            continue;
+        }
+
+        switch((mjb_bidi_class)record.bidirectional) {
+            case MJB_PR_BIDI_CLASS_R:
+            case MJB_PR_BIDI_CLASS_AL:
+            case MJB_PR_BIDI_CLASS_AN:
+            case MJB_PR_BIDI_CLASS_LRE:
+            case MJB_PR_BIDI_CLASS_LRO:
+            case MJB_PR_BIDI_CLASS_RLE:
+            case MJB_PR_BIDI_CLASS_RLO:
+            case MJB_PR_BIDI_CLASS_PDF:
+            case MJB_PR_BIDI_CLASS_LRI:
+            case MJB_PR_BIDI_CLASS_RLI:
+            case MJB_PR_BIDI_CLASS_FSI:
+            case MJB_PR_BIDI_CLASS_PDI:
+            case MJB_PR_BIDI_CLASS_BN:
+                return false;
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
 static mjb_status mjb_confusable_skeleton_process(const char *buffer, size_t byte_length,
     mjb_encoding encoding, mjb_encoding output_encoding, mjb_result *result, void *output,
     size_t *output_size) {
@@ -349,6 +420,12 @@ static mjb_status mjb_confusable_skeleton_process(const char *buffer, size_t byt
         return status;
     }
 
+    if(mjb_confusable_is_ltr_only(buffer, byte_length, encoding)) {
+        // The visual order is the logical order: skip the bidi resolution and the reordered copy.
+        return mjb_confusable_skeleton_finish(buffer, byte_length, encoding, output_encoding,
+            result, output, output_size);
+    }
+
     mjb_bidi_paragraph paragraph;
     status = mjb_bidi_resolve(buffer, byte_length, encoding, MJB_DIRECTION_LTR, &paragraph);
 
@@ -389,7 +466,8 @@ static mjb_status mjb_confusable_skeleton_process(const char *buffer, size_t byt
         }
 
         // UAX #9 L3: when L2 reversal placed nonspacing marks before their base,
-        // move the base back in front of the mark sequence.
+        // move the base back in front of the mark sequence. Only marks at odd (right-to-left)
+        // levels were reversed.
         for(size_t i = 0; i < paragraph.count;) {
             mjb_bidi_class bidi_class = MJB_PR_BIDI_CLASS_NOT_SET;
             bool mirrored;
@@ -397,7 +475,8 @@ static mjb_status mjb_confusable_skeleton_process(const char *buffer, size_t byt
             mjb_unicode_bidi_lookup(paragraph.chars[visual_order[i]].codepoint, &bidi_class,
                 &mirrored);
 
-            if(bidi_class != MJB_PR_BIDI_CLASS_NSM) {
+            if(bidi_class != MJB_PR_BIDI_CLASS_NSM ||
+                (paragraph.chars[visual_order[i]].level & 1) == 0) {
                 ++i;
                 continue;
             }
@@ -541,6 +620,467 @@ MJB_EXPORT mjb_status mjb_confusable_match(const char *s1, size_t s1_byte_length
     return MJB_STATUS_OK;
 }
 
+// One distinct skeleton in the hash table of a confusable index, with the chain of the IDs of the
+// reference strings that share it. The table, the IDs and the skeleton pool are stored as is in
+// the serialized image, so an opened image is used in place.
+typedef struct mjb_confusable_index_entry {
+    uint32_t hash; // 0 marks an empty slot
+    uint32_t offset;
+    uint32_t length;
+    uint32_t count;
+    uint32_t head; // Index of the last added ID
+} mjb_confusable_index_entry;
+
+typedef struct mjb_confusable_index_id {
+    uint32_t id;
+    uint32_t next; // MJB_CONFUSABLE_INDEX_END ends the chain
+} mjb_confusable_index_id;
+
+// The serialized image: this header, the slots, the IDs and the padded skeleton pool, in native
+// byte order.
+typedef struct mjb_confusable_index_header {
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t format_version;
+    uint32_t unicode_version;
+    uint32_t slot_count;
+    uint32_t skeleton_count;
+    uint32_t count;
+    uint32_t pool_size;
+} mjb_confusable_index_header;
+
+#define MJB_CONFUSABLE_INDEX_MAGIC "MJBCIDX"
+#define MJB_CONFUSABLE_INDEX_BYTE_ORDER 0x01020304u
+#define MJB_CONFUSABLE_INDEX_FORMAT_VERSION 1u
+#define MJB_CONFUSABLE_INDEX_UNICODE_VERSION                                                       \
+    ((uint32_t)MJB_UNICODE_VERSION_MAJOR << 16 | (uint32_t)MJB_UNICODE_VERSION_MINOR << 8 |       \
+        (uint32_t)MJB_UNICODE_VERSION_REVISION)
+#define MJB_CONFUSABLE_INDEX_MIN_SLOTS 64u
+#define MJB_CONFUSABLE_INDEX_MAX_SLOTS 0x80000000u
+#define MJB_CONFUSABLE_INDEX_END 0xFFFFFFFFu
+// The pool is padded so that images are a whole number of 32-bit words.
+#define MJB_CONFUSABLE_INDEX_PADDED(SIZE) (((SIZE) + 3u) & ~(size_t)3u)
+
+// FNV-1a of a skeleton. 0 is reserved for empty slots.
+static uint32_t mjb_confusable_index_hash(const char *skeleton, size_t length) {
+    uint32_t hash = 2166136261u;
+
+    for(size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)skeleton[i];
+        hash *= 16777619u;
+    }
+
+    return hash == 0 ? 1 : hash;
+}
+
+// Return the slot of a skeleton, or the empty slot that ends its probe sequence. The walk is
+// bounded so that a damaged image cannot loop forever, and returns NULL if it is exhausted.
+static const mjb_confusable_index_entry *mjb_confusable_index_slot(
+    const mjb_confusable_index *index, uint32_t hash, const char *skeleton, size_t length) {
+    const mjb_confusable_index_entry *slots = (const mjb_confusable_index_entry *)index->slots;
+    size_t mask = index->slot_count - 1;
+    size_t slot = hash & mask;
+
+    for(size_t probes = 0; probes < index->slot_count; ++probes) {
+        const mjb_confusable_index_entry *entry = &slots[slot];
+
+        if(entry->hash == 0 ||
+            (entry->hash == hash && entry->length == length &&
+                (size_t)entry->offset + entry->length <= index->pool_size &&
+                memcmp(index->pool + entry->offset, skeleton, length) == 0)) {
+            return entry;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+// Double the table, keeping the load factor at most one half.
+static mjb_status mjb_confusable_index_grow(mjb_confusable_index *index) {
+    size_t slot_count = index->slot_count == 0 ? MJB_CONFUSABLE_INDEX_MIN_SLOTS :
+                                                 index->slot_count * 2;
+
+    if(slot_count > MJB_CONFUSABLE_INDEX_MAX_SLOTS) {
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    mjb_confusable_index_entry *slots = (mjb_confusable_index_entry *)mjb_alloc(
+        slot_count * sizeof(mjb_confusable_index_entry));
+
+    if(slots == NULL) {
+        return MJB_STATUS_NO_MEMORY;
+    }
+
+    memset(slots, 0, slot_count * sizeof(mjb_confusable_index_entry));
+
+    const mjb_confusable_index_entry *old_slots = (const mjb_confusable_index_entry *)index->slots;
+    size_t mask = slot_count - 1;
+
+    for(size_t i = 0; i < index->slot_count; ++i) {
+        if(old_slots[i].hash == 0) {
+            continue;
+        }
+
+        size_t slot = old_slots[i].hash & mask;
+
+        while(slots[slot].hash != 0) {
+            slot = (slot + 1) & mask;
+        }
+
+        slots[slot] = old_slots[i];
+    }
+
+    mjb_free(index->slots);
+    index->slots = slots;
+    index->slot_count = slot_count;
+
+    return MJB_STATUS_OK;
+}
+
+// Initialize an empty confusable index.
+MJB_EXPORT mjb_status mjb_confusable_index_init(mjb_confusable_index *index) {
+    if(index == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(index, 0, sizeof(*index));
+
+    return MJB_STATUS_OK;
+}
+
+// Free the table and the skeletons of a built index. An opened image is left to the caller.
+MJB_EXPORT void mjb_confusable_index_free(mjb_confusable_index *index) {
+    if(index == NULL) {
+        return;
+    }
+
+    if(!index->read_only) {
+        mjb_free(index->slots);
+        mjb_free(index->ids);
+        mjb_free(index->pool);
+    }
+
+    memset(index, 0, sizeof(*index));
+}
+
+// Add the skeleton of a reference string to the index.
+MJB_EXPORT mjb_status mjb_confusable_index_add(mjb_confusable_index *index, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, uint32_t id) {
+    if(index == NULL || (buffer == NULL && byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(index->read_only) {
+        return MJB_STATUS_UNSUPPORTED;
+    }
+
+    mjb_result skeleton;
+    mjb_status status = mjb_confusable_skeleton(buffer, byte_length, encoding, MJB_ENC_UTF_8,
+        &skeleton);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    // An empty skeleton is never confusable (see mjb_confusable_match).
+    if(skeleton.output_size == 0) {
+        mjb_result_free(&skeleton);
+
+        return MJB_STATUS_OK;
+    }
+
+    if(index->count >= MJB_CONFUSABLE_INDEX_END ||
+        skeleton.output_size > UINT32_MAX - index->pool_size) {
+        mjb_result_free(&skeleton);
+
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    // Reserve room for a new skeleton first, so that the slot found below stays valid.
+    if((index->skeleton_count + 1) * 2 > index->slot_count) {
+        status = mjb_confusable_index_grow(index);
+    }
+
+    if(status == MJB_STATUS_OK && index->count == index->id_capacity) {
+        size_t capacity = index->id_capacity == 0 ? 64 : index->id_capacity * 2;
+        void *ids = mjb_realloc(index->ids, capacity * sizeof(mjb_confusable_index_id));
+
+        if(ids == NULL) {
+            status = MJB_STATUS_NO_MEMORY;
+        } else {
+            index->ids = ids;
+            index->id_capacity = capacity;
+        }
+    }
+
+    if(status != MJB_STATUS_OK) {
+        mjb_result_free(&skeleton);
+
+        return status;
+    }
+
+    uint32_t hash = mjb_confusable_index_hash(skeleton.output, skeleton.output_size);
+    mjb_confusable_index_entry *entry = (mjb_confusable_index_entry *)mjb_confusable_index_slot(
+        index, hash, skeleton.output, skeleton.output_size);
+
+    // The table is at most half full, so the probe sequence always ends.
+    if(entry == NULL) {
+        mjb_result_free(&skeleton);
+
+        return MJB_STATUS_OVERFLOW;
+    }
+
+    if(entry->hash == 0) {
+        if(index->pool_size + skeleton.output_size > index->pool_capacity) {
+            size_t capacity = index->pool_capacity == 0 ? 1024 : index->pool_capacity * 2;
+
+            while(capacity < index->pool_size + skeleton.output_size) {
+                capacity *= 2;
+            }
+
+            char *pool = (char *)mjb_realloc(index->pool, capacity);
+
+            if(pool == NULL) {
+                mjb_result_free(&skeleton);
+
+                return MJB_STATUS_NO_MEMORY;
+            }
+
+            index->pool = pool;
+            index->pool_capacity = capacity;
+        }
+
+        entry->hash = hash;
+        entry->offset = (uint32_t)index->pool_size;
+        entry->length = (uint32_t)skeleton.output_size;
+        entry->count = 0;
+        entry->head = MJB_CONFUSABLE_INDEX_END;
+        memcpy(index->pool + index->pool_size, skeleton.output, skeleton.output_size);
+        index->pool_size += skeleton.output_size;
+        ++index->skeleton_count;
+    }
+
+    mjb_result_free(&skeleton);
+
+    // Reference strings with the same skeleton share its slot and bytes.
+    mjb_confusable_index_id *ids = (mjb_confusable_index_id *)index->ids;
+    ids[index->count].id = id;
+    ids[index->count].next = entry->head;
+    entry->head = (uint32_t)index->count;
+    ++entry->count;
+    ++index->count;
+
+    return MJB_STATUS_OK;
+}
+
+// Return the IDs of the reference strings confusable with a string.
+MJB_EXPORT mjb_status mjb_confusable_index_find(const mjb_confusable_index *index,
+    const char *buffer, size_t byte_length, mjb_encoding encoding, uint32_t *ids, size_t *count) {
+    if(count == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    size_t capacity = *count;
+    *count = 0;
+
+    if(index == NULL || (buffer == NULL && byte_length > 0)) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_result skeleton;
+    mjb_status status = mjb_confusable_skeleton(buffer, byte_length, encoding, MJB_ENC_UTF_8,
+        &skeleton);
+
+    if(status != MJB_STATUS_OK) {
+        return status;
+    }
+
+    const mjb_confusable_index_entry *entry = NULL;
+
+    if(skeleton.output_size != 0 && index->slot_count != 0) {
+        entry = mjb_confusable_index_slot(index,
+            mjb_confusable_index_hash(skeleton.output, skeleton.output_size), skeleton.output,
+            skeleton.output_size);
+    }
+
+    mjb_result_free(&skeleton);
+
+    if(entry == NULL || entry->hash == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    size_t matches = entry->count;
+    *count = matches;
+
+    if(ids == NULL) {
+        return MJB_STATUS_OK;
+    }
+
+    if(capacity < matches) {
+        return MJB_STATUS_OUTPUT_TOO_SMALL;
+    }
+
+    // The chain is bounded by its count so that a damaged image cannot loop forever.
+    const mjb_confusable_index_id *chain = (const mjb_confusable_index_id *)index->ids;
+    uint32_t next = entry->head;
+
+    for(size_t i = 0; i < matches; ++i) {
+        if(next >= index->count) {
+            *count = 0;
+
+            return MJB_STATUS_MALFORMED_INPUT;
+        }
+
+        uint32_t id = chain[next].id;
+        size_t j = i;
+
+        // Ascending IDs, independently of the insertion order.
+        for(; j > 0 && ids[j - 1] > id; --j) {
+            ids[j] = ids[j - 1];
+        }
+
+        ids[j] = id;
+        next = chain[next].next;
+    }
+
+    return MJB_STATUS_OK;
+}
+
+// Serialize a confusable index into a caller-provided buffer.
+MJB_EXPORT mjb_status mjb_confusable_index_serialize(const mjb_confusable_index *index,
+    void *output, size_t *output_size) {
+    if(output_size == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(index == NULL) {
+        *output_size = 0;
+
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    size_t slots_size = index->slot_count * sizeof(mjb_confusable_index_entry);
+    size_t ids_size = index->count * sizeof(mjb_confusable_index_id);
+    size_t pool_size = MJB_CONFUSABLE_INDEX_PADDED(index->pool_size);
+    size_t required = sizeof(mjb_confusable_index_header) + slots_size + ids_size + pool_size;
+    size_t capacity = *output_size;
+    *output_size = required;
+
+    if(output == NULL) {
+        return MJB_STATUS_OK;
+    }
+
+    if(capacity < required) {
+        return MJB_STATUS_OUTPUT_TOO_SMALL;
+    }
+
+    mjb_confusable_index_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MJB_CONFUSABLE_INDEX_MAGIC, sizeof(MJB_CONFUSABLE_INDEX_MAGIC));
+    header.byte_order = MJB_CONFUSABLE_INDEX_BYTE_ORDER;
+    header.format_version = MJB_CONFUSABLE_INDEX_FORMAT_VERSION;
+    header.unicode_version = MJB_CONFUSABLE_INDEX_UNICODE_VERSION;
+    header.slot_count = (uint32_t)index->slot_count;
+    header.skeleton_count = (uint32_t)index->skeleton_count;
+    header.count = (uint32_t)index->count;
+    header.pool_size = (uint32_t)index->pool_size;
+
+    char *bytes = (char *)output;
+    memcpy(bytes, &header, sizeof(header));
+    bytes += sizeof(header);
+
+    if(slots_size != 0) {
+        memcpy(bytes, index->slots, slots_size);
+        bytes += slots_size;
+    }
+
+    if(ids_size != 0) {
+        memcpy(bytes, index->ids, ids_size);
+        bytes += ids_size;
+    }
+
+    if(index->pool_size != 0) {
+        memcpy(bytes, index->pool, index->pool_size);
+    }
+
+    memset(bytes + index->pool_size, 0, pool_size - index->pool_size);
+
+    return MJB_STATUS_OK;
+}
+
+// Open a serialized confusable index in place.
+MJB_EXPORT mjb_status mjb_confusable_index_open(mjb_confusable_index *index, const void *data,
+    size_t data_size) {
+    if(index == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(index, 0, sizeof(*index));
+
+    // The slots and the IDs are read in place as 32-bit words.
+    if(data == NULL || ((uintptr_t)data & 3u) != 0) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    mjb_confusable_index_header header;
+
+    if(data_size < sizeof(header)) {
+        return MJB_STATUS_MALFORMED_INPUT;
+    }
+
+    memcpy(&header, data, sizeof(header));
+
+    if(memcmp(header.magic, MJB_CONFUSABLE_INDEX_MAGIC, sizeof(MJB_CONFUSABLE_INDEX_MAGIC)) != 0) {
+        return MJB_STATUS_MALFORMED_INPUT;
+    }
+
+    // Skeletons of another byte order, format or Unicode version cannot be looked up.
+    if(header.byte_order != MJB_CONFUSABLE_INDEX_BYTE_ORDER ||
+        header.format_version != MJB_CONFUSABLE_INDEX_FORMAT_VERSION ||
+        header.unicode_version != MJB_CONFUSABLE_INDEX_UNICODE_VERSION) {
+        return MJB_STATUS_UNSUPPORTED;
+    }
+
+    size_t slot_count = header.slot_count;
+    size_t count = header.count;
+    size_t body_size = data_size - sizeof(header);
+
+    if((slot_count & (slot_count - 1)) != 0 || header.skeleton_count > slot_count / 2 ||
+        header.skeleton_count > count || count == MJB_CONFUSABLE_INDEX_END ||
+        slot_count > body_size / sizeof(mjb_confusable_index_entry)) {
+        return MJB_STATUS_MALFORMED_INPUT;
+    }
+
+    size_t slots_size = slot_count * sizeof(mjb_confusable_index_entry);
+
+    if(count > (body_size - slots_size) / sizeof(mjb_confusable_index_id)) {
+        return MJB_STATUS_MALFORMED_INPUT;
+    }
+
+    size_t ids_size = count * sizeof(mjb_confusable_index_id);
+
+    if(body_size - slots_size - ids_size != MJB_CONFUSABLE_INDEX_PADDED((size_t)header.pool_size)) {
+        return MJB_STATUS_MALFORMED_INPUT;
+    }
+
+    const char *bytes = (const char *)data + sizeof(header);
+    // The image is never written through: a read-only index rejects mjb_confusable_index_add.
+    index->slots = (void *)(uintptr_t)bytes;
+    index->slot_count = slot_count;
+    index->skeleton_count = header.skeleton_count;
+    index->ids = (void *)(uintptr_t)(bytes + slots_size);
+    index->count = count;
+    index->id_capacity = count;
+    index->pool = (char *)(uintptr_t)(bytes + slots_size + ids_size);
+    index->pool_size = header.pool_size;
+    index->pool_capacity = header.pool_size;
+    index->read_only = true;
+
+    return MJB_STATUS_OK;
+}
+
 #else
 
 MJB_EXPORT mjb_status mjb_resolved_script_set(const char *buffer, size_t byte_length,
@@ -588,4 +1128,50 @@ MJB_EXPORT mjb_status mjb_confusable_match(const char *s1, size_t s1_byte_length
     return MJB_STATUS_FEATURE_NOT_ENABLED;
 }
 
+MJB_EXPORT mjb_status mjb_confusable_index_init(mjb_confusable_index *index) {
+    (void)index;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT void mjb_confusable_index_free(mjb_confusable_index *index) {
+    (void)index;
+}
+
+MJB_EXPORT mjb_status mjb_confusable_index_add(mjb_confusable_index *index, const char *buffer,
+    size_t byte_length, mjb_encoding encoding, uint32_t id) {
+    (void)index;
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)id;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT mjb_status mjb_confusable_index_find(const mjb_confusable_index *index,
+    const char *buffer, size_t byte_length, mjb_encoding encoding, uint32_t *ids, size_t *count) {
+    (void)index;
+    (void)buffer;
+    (void)byte_length;
+    (void)encoding;
+    (void)ids;
+    (void)count;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT mjb_status mjb_confusable_index_serialize(const mjb_confusable_index *index,
+    void *output, size_t *output_size) {
+    (void)index;
+    (void)output;
+    (void)output_size;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
+MJB_EXPORT mjb_status mjb_confusable_index_open(mjb_confusable_index *index, const void *data,
+    size_t data_size) {
+    (void)index;
+    (void)data;
+    (void)data_size;
+    return MJB_STATUS_FEATURE_NOT_ENABLED;
+}
+
 #endif // MJB_FEATURE_SECURITY
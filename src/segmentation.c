@@ -12,9 +12,10 @@
 
 extern mojibake mjb_global;
 
-static inline void mjb_update_sequence_flags(mjb_next_state *state, uint8_t *buffer) {
+static inline void mjb_update_sequence_flags(mjb_next_state *state,
+    mjb_segmentation_properties properties) {
     // Update GB11: Extended_Pictographic + ZWJ sequences
-    if(mjb_codepoint_properties_get(buffer, MJB_PR_EXTENDED_PICTOGRAPHIC)) {
+    if(MJB_SEGMENTATION_EXT_PICT(properties)) {
         // Start of new Extended_Pictographic sequence
         state->ext_pict_seen = true;
         state->zwj_seen = false;
@@ -28,7 +29,7 @@ static inline void mjb_update_sequence_flags(mjb_next_state *state, uint8_t *buf
     }
 
     // Update GB9c: remember whether the consumed suffix is Linker Extend*.
-    uint8_t incb_value = mjb_codepoint_properties_get(buffer, MJB_PR_INDIC_CONJUNCT_BREAK);
+    mjb_indic_conjunct_break incb_value = MJB_SEGMENTATION_INCB(properties);
 
     if(incb_value == MJB_INCB_LINKER) {
         state->incb_linker_seen = true;
@@ -37,29 +38,24 @@ static inline void mjb_update_sequence_flags(mjb_next_state *state, uint8_t *buf
     }
 }
 
-// Grapheme Cluster Breaking
-// See: https://unicode.org/reports/tr29/
-MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byte_length,
-    mjb_encoding encoding, mjb_next_state *state) {
-    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
-        return MJB_BT_NOT_SET;
-    }
-
-    if(state->index == 0) {
-        // Initialize the state.
-        state->state = MJB_UTF_ACCEPT;
-        state->previous = MJB_GBP_NOT_SET;
-        state->current = MJB_GBP_NOT_SET;
-        state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
-        state->in_error = false;
-        state->ri_count = 0;
-        state->ext_pict_seen = false;
-        state->zwj_seen = false;
-        state->incb_consonant_seen = false;
-        state->incb_linker_seen = false;
-    }
+static inline void mjb_grapheme_state_init(mjb_next_state *state) {
+    state->state = MJB_UTF_ACCEPT;
+    state->previous = MJB_GBP_NOT_SET;
+    state->current = MJB_GBP_NOT_SET;
+    state->previous_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->current_codepoint = MJB_CODEPOINT_NOT_VALID;
+    state->in_error = false;
+    state->ri_count = 0;
+    state->ext_pict_seen = false;
+    state->zwj_seen = false;
+    state->incb_consonant_seen = false;
+    state->incb_linker_seen = false;
+    state->codepoint_index = 0;
+}
 
+// Apply the GB rules up to the next break opportunity. Arguments are checked by the callers.
+static mjb_break_type mjb_grapheme_step(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_state *state) {
     if(state->state == MJB_UTF_TERMINATED) {
         return MJB_BT_NOT_SET;
     }
@@ -77,9 +73,16 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
 
     mjb_codepoint codepoint = 0;
     bool first_codepoint = state->index == 0;
-    uint8_t cpb[MJB_PR_BUFFER_SIZE] = { 0 };
+    mjb_segmentation_properties properties = 0;
+    size_t codepoint_index = state->index;
 
     for(; state->index < byte_length;) {
+        // A codepoint starts where the decoder is between sequences, also after a code unit
+        // dropped from an ill-formed subsequence.
+        if(state->state == MJB_UTF_ACCEPT) {
+            codepoint_index = state->index;
+        }
+
         mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state->state,
             &state->index, encoding, &codepoint, &state->in_error);
 
@@ -98,25 +101,25 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // GB1 sot ÷ Any
         // Not needed
 
-        memset(cpb, 0, MJB_PR_BUFFER_SIZE);
-
-        if(mjb_codepoint_properties_lookup(codepoint, cpb) != MJB_STATUS_OK) {
+        if(!mjb_codepoint_segmentation_properties(codepoint, &properties)) {
             continue;
         }
 
-        mjb_gcb gcb = (mjb_gcb)mjb_codepoint_properties_get(cpb, MJB_PR_GRAPHEME_CLUSTER_BREAK);
+        mjb_gcb gcb = MJB_SEGMENTATION_GCB(properties);
 
         if(gcb == MJB_GBP_NOT_SET) {
             // # @missing: 0000..10FFFF; Other
             gcb = MJB_GBP_OTHER;
         }
 
+        state->codepoint_index = codepoint_index;
+
         if(first_codepoint) {
             // First codepoint
             state->current = gcb;
             state->current_codepoint = codepoint;
             first_codepoint = false;
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             continue;
         }
@@ -132,7 +135,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // Do not break between a CR and LF. Otherwise, break before and after controls.
         // GB3 CR × LF
         if(state->previous == MJB_GBP_CR && state->current == MJB_GBP_LF) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -140,7 +143,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // GB4 (Control | CR | LF) ÷
         if(state->previous == MJB_GBP_CONTROL || state->previous == MJB_GBP_CR ||
             state->previous == MJB_GBP_LF) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_ALLOWED;
         }
@@ -148,7 +151,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // GB5 ÷ (Control | CR | LF)
         if(state->current == MJB_GBP_CONTROL || state->current == MJB_GBP_CR ||
             state->current == MJB_GBP_LF) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_ALLOWED;
         }
@@ -158,7 +161,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         if(state->previous == MJB_GBP_L &&
             (state->current == MJB_GBP_L || state->current == MJB_GBP_V ||
                 state->current == MJB_GBP_LV || state->current == MJB_GBP_LVT)) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -166,7 +169,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // GB7 (LV | V) × (V | T)
         if((state->previous == MJB_GBP_LV || state->previous == MJB_GBP_V) &&
             (state->current == MJB_GBP_V || state->current == MJB_GBP_T)) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -174,7 +177,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // GB8 (LVT | T) × T
         if((state->previous == MJB_GBP_LVT || state->previous == MJB_GBP_T) &&
             state->current == MJB_GBP_T) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -182,7 +185,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // Do not break before extending characters or ZWJ.
         // GB9 × (Extend | ZWJ)
         if(state->current == MJB_GBP_EXTEND || state->current == MJB_GBP_ZWJ) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -191,14 +194,14 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // Do not break before SpacingMarks, or after Prepend characters.
         // GB9a × SpacingMark
         if(state->current == MJB_GBP_SPACING_MARK) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
 
         // GB9b Prepend ×
         if(state->previous == MJB_GBP_PREPEND) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -206,18 +209,18 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         // The GB9c rule only applies to extended grapheme clusters:
         // Do not break within certain combinations with Indic_Conjunct_Break (InCB)=Linker.
         // GB9c \p{InCB=Linker} \p{InCB=Extend}* × \p{InCB=Consonant}
-        uint8_t curr_incb = mjb_codepoint_properties_get(cpb, MJB_PR_INDIC_CONJUNCT_BREAK);
+        mjb_indic_conjunct_break curr_incb = MJB_SEGMENTATION_INCB(properties);
 
         if(state->incb_linker_seen && curr_incb == MJB_INCB_CONSONANT) {
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
 
         // Do not break within emoji modifier sequences or emoji zwj sequences.
         // GB11 \p{Extended_Pictographic} Extend* ZWJ × \p{Extended_Pictographic}
-        if(prev_ext_pict_zwj && mjb_codepoint_properties_get(cpb, MJB_PR_EXTENDED_PICTOGRAPHIC)) {
-            mjb_update_sequence_flags(state, cpb);
+        if(prev_ext_pict_zwj && MJB_SEGMENTATION_EXT_PICT(properties)) {
+            mjb_update_sequence_flags(state, properties);
 
             return MJB_BT_NO_BREAK;
         }
@@ -229,7 +232,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
         if(state->previous == MJB_GBP_REGIONAL_INDICATOR &&
             state->current == MJB_GBP_REGIONAL_INDICATOR) {
             mjb_break_type result = (state->ri_count++ % 2) == 0 ? MJB_BT_NO_BREAK : MJB_BT_ALLOWED;
-            mjb_update_sequence_flags(state, cpb);
+            mjb_update_sequence_flags(state, properties);
 
             return result;
         } else {
@@ -238,7 +241,7 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
 
         // Otherwise, break everywhere.
         // GB999 Any ÷ Any
-        mjb_update_sequence_flags(state, cpb);
+        mjb_update_sequence_flags(state, properties);
 
         return MJB_BT_ALLOWED;
     }
@@ -248,6 +251,51 @@ MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byt
     return MJB_BT_ALLOWED;
 }
 
+// Grapheme Cluster Breaking
+// See: https://unicode.org/reports/tr29/
+MJB_EXPORT mjb_break_type mjb_next_grapheme_break(const char *buffer, size_t byte_length,
+    mjb_encoding encoding, mjb_next_state *state) {
+    if(buffer == NULL || state == NULL || byte_length == 0 || byte_length == MJB_NUL_TERMINATED) {
+        return MJB_BT_NOT_SET;
+    }
+
+    if(state->index == 0) {
+        mjb_grapheme_state_init(state);
+    }
+
+    return mjb_grapheme_step(buffer, byte_length, encoding, state);
+}
+
+// Write the grapheme cluster boundaries of a string to offsets, up to capacity, and return their count.
+size_t mjb_grapheme_boundaries(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    size_t *offsets, size_t capacity) {
+    mjb_next_state state;
+    state.index = 0;
+    mjb_grapheme_state_init(&state);
+
+    mjb_break_type bt;
+    size_t count = 0;
+    size_t last_break = 0;
+
+    while((bt = mjb_grapheme_step(buffer, byte_length, encoding, &state)) != MJB_BT_NOT_SET) {
+        if(bt == MJB_BT_NO_BREAK) {
+            continue;
+        }
+
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
+
+        if(count < capacity) {
+            offsets[count] = break_pos;
+        }
+
+        ++count;
+        last_break = break_pos;
+    }
+
+    return count;
+}
+
 // Return the largest prefix no longer than max_bytes that ends at a grapheme boundary.
 // See: mjb_truncate_grapheme
 size_t mjb_grapheme_prefix_bytes(const char *buffer, size_t byte_length, mjb_encoding encoding,
@@ -271,8 +319,8 @@ size_t mjb_grapheme_prefix_bytes(const char *buffer, size_t byte_length, mjb_enc
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state.index, byte_length,
-            state.current_codepoint, encoding, state.state == MJB_UTF_TERMINATED, last_break);
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
 
         if(break_pos > max_bytes) {
             return last_break;
@@ -308,8 +356,8 @@ MJB_EXPORT size_t mjb_truncate_grapheme(const char *buffer, size_t byte_length,
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state.index, byte_length,
-            state.current_codepoint, encoding, state.state == MJB_UTF_TERMINATED, last_break);
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, last_break);
         last_break = break_pos;
 
         if(++cluster_count >= max_graphemes) {
@@ -390,8 +438,8 @@ MJB_EXPORT size_t mjb_truncate_grapheme_width(const char *buffer, size_t byte_le
             continue;
         }
 
-        size_t break_pos = mjb_monotonic_boundary_position(state.index, byte_length,
-            state.current_codepoint, encoding, state.state == MJB_UTF_TERMINATED, prev_break);
+        size_t break_pos = mjb_break_boundary_position(state.index, byte_length,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, prev_break);
         size_t cluster_width = 0;
 
         if(mjb_terminal_width(buffer + prev_break, break_pos - prev_break, encoding, profile,
@@ -409,3 +457,58 @@ MJB_EXPORT size_t mjb_truncate_grapheme_width(const char *buffer, size_t byte_le
 
     return state.state == MJB_UTF_TERMINATED ? prev_break : byte_length;
 }
+
+// Return the boundaries of a string for the given segmentation.
+MJB_EXPORT mjb_status mjb_segment(const char *buffer, size_t byte_length, mjb_encoding encoding,
+    mjb_segment_kind kind, size_t *offsets, size_t *count) {
+    if(count == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    size_t capacity = offsets == NULL ? 0 : *count;
+    *count = 0;
+
+    if(kind != MJB_SEGMENT_GRAPHEME && kind != MJB_SEGMENT_WORD &&
+        kind != MJB_SEGMENT_SENTENCE && kind != MJB_SEGMENT_LINE) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(byte_length == 0) {
+        return MJB_STATUS_OK;
+    }
+
+    if(buffer == NULL) {
+        return MJB_STATUS_INVALID_ARGUMENT;
+    }
+
+    if(!mjb_encoding_is_valid_input(encoding)) {
+        return MJB_STATUS_INVALID_ENCODING;
+    }
+
+    mjb_status status = mjb_resolve_input_byte_length(buffer, &byte_length, encoding);
+
+    if(status != MJB_STATUS_OK || byte_length == 0) {
+        return status;
+    }
+
+    size_t total;
+
+    switch(kind) {
+        case MJB_SEGMENT_GRAPHEME:
+            total = mjb_grapheme_boundaries(buffer, byte_length, encoding, offsets, capacity);
+            break;
+        case MJB_SEGMENT_WORD:
+            total = mjb_word_boundaries(buffer, byte_length, encoding, offsets, capacity);
+            break;
+        case MJB_SEGMENT_SENTENCE:
+            total = mjb_sentence_boundaries(buffer, byte_length, encoding, offsets, capacity);
+            break;
+        default:
+            total = mjb_line_boundaries(buffer, byte_length, encoding, offsets, capacity);
+            break;
+    }
+
+    *count = total;
+
+    return offsets != NULL && total > capacity ? MJB_STATUS_OUTPUT_TOO_SMALL : MJB_STATUS_OK;
+}
@@ -207,8 +207,22 @@ MJB_EXPORT mjb_status mjb_codepoint_count(const char *buffer, size_t byte_length
     bool in_error = false;
     mjb_codepoint codepoint = 0;
     size_t codepoint_count = 0;
+    bool utf8 = encoding == MJB_ENC_UTF_8 || encoding == MJB_ENC_ASCII;
 
     for(size_t i = 0; i < byte_length;) {
+        if(utf8 && state == MJB_UTF_ACCEPT) {
+            // Every byte of an ASCII run is a codepoint.
+            size_t span = mjb_utf8_ascii_span(buffer + i, byte_length - i);
+
+            if(span != 0) {
+                i += span;
+                codepoint_count += span;
+                in_error = false;
+
+                continue;
+            }
+        }
+
         mjb_decode_result decode_status = mjb_next_codepoint(buffer, byte_length, &state, &i,
             encoding, &codepoint, &in_error);
 
@@ -132,9 +132,8 @@ MJB_EXPORT mjb_status mjb_terminal_width(const char *buffer, size_t byte_length,
             continue;
         }
 
-        size_t break_position = mjb_monotonic_boundary_position(state.index, normalized.output_size,
-            state.current_codepoint, MJB_ENC_UTF_8, state.state == MJB_UTF_TERMINATED,
-            previous_break);
+        size_t break_position = mjb_break_boundary_position(state.index, normalized.output_size,
+            state.codepoint_index, state.state == MJB_UTF_TERMINATED, previous_break);
         size_t cluster_width = 0;
         status = mjb_terminal_cluster_width(normalized.output + previous_break,
             break_position - previous_break, profile, &cluster_width);
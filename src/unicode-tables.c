@@ -516,6 +516,68 @@ bool mjb_unicode_has_property(mjb_codepoint codepoint, mjb_property property, ui
     return false;
 }
 
+void mjb_unicode_property_cache_init(mjb_unicode_property_cache *cache, mjb_property property) {
+    cache->property = property;
+    cache->page = UINT32_MAX;
+    cache->start = 0;
+    cache->count = 0;
+    // No slot matches: every codepoint is below UINT32_MAX.
+    memset(cache->codepoints, 0xFF, sizeof(cache->codepoints));
+}
+
+// Return the property value of a codepoint, or 0 when it has none. A codepoint seen before in the
+// batch is answered from its slot, else the ranges of its page are scanned, and the page search
+// is skipped while the codepoints stay in the page of the previous scan.
+uint8_t mjb_unicode_property_cache_lookup(mjb_unicode_property_cache *cache,
+    mjb_codepoint codepoint) {
+    size_t slot = (codepoint ^ (codepoint >> 8)) % MJB_UNICODE_PROPERTY_CACHE_SIZE;
+
+    if(cache->codepoints[slot] == codepoint) {
+        return cache->values[slot];
+    }
+
+    uint32_t page = codepoint >> 8;
+
+    if(page != cache->page) {
+        cache->page = page;
+
+        if(!mjb_unicode_property_page_lookup(codepoint, &cache->start, &cache->count)) {
+            // A missing page has no ranges.
+            cache->start = 0;
+            cache->count = 0;
+        }
+    }
+
+    uint8_t codepoint_low = (uint8_t)codepoint;
+    uint8_t value = 0;
+
+    for(size_t i = cache->start; i < cache->start + cache->count; ++i) {
+        uint32_t entry = mjb_unicode_property_ranges[i];
+        uint8_t start = (uint8_t)(entry & 0xFF);
+        uint8_t end = start + (uint8_t)((entry >> 8) & 0xFF);
+        uint16_t offset = (uint16_t)(entry >> 16);
+        uint8_t length = mjb_unicode_property_data[offset];
+
+        if(start > codepoint_low) {
+            break;
+        }
+
+        if(codepoint_low > end || length < 2) {
+            continue;
+        }
+
+        if(mjb_unicode_blob_has_property(&mjb_unicode_property_data[offset + 1], length,
+               cache->property, &value)) {
+            break;
+        }
+    }
+
+    cache->codepoints[slot] = codepoint;
+    cache->values[slot] = value;
+
+    return value;
+}
+
 bool mjb_unicode_properties(mjb_codepoint codepoint, uint8_t *buffer) {
     size_t start_index = 0;
     size_t count = 0;
@@ -547,6 +609,18 @@ bool mjb_unicode_properties(mjb_codepoint codepoint, uint8_t *buffer) {
     return true;
 }
 
+uint32_t mjb_unicode_segmentation_lookup(mjb_codepoint codepoint) {
+    size_t page = codepoint >> 8;
+
+    if(page >= MJB_COUNT_OF(mjb_unicode_segmentation_page_index)) {
+        return 0;
+    }
+
+    size_t index = ((size_t)mjb_unicode_segmentation_page_index[page] << 8) | (codepoint & 0xFF);
+
+    return mjb_unicode_segmentation_values[mjb_unicode_segmentation_pages[index]];
+}
+
 bool mjb_unicode_script_extensions_lookup(mjb_codepoint codepoint, const uint8_t **scripts,
     uint8_t *count) {
     size_t low = 0;
@@ -734,6 +808,39 @@ bool mjb_unicode_case_lookup(mjb_codepoint codepoint, mjb_unicode_case_mapping *
     return true;
 }
 
+// The records are packed by generateCodepointRecords() in
+// utils/generate/file-generators/unicode-data/n-characters.ts: category in bits 0-4, combining
+// class in 5-12, bidi class in 13-17, decimal value plus one in 18-21, an assigned flag in 22 and
+// the Cased and Case_Ignorable flags in 23 and 24.
+bool mjb_unicode_record_lookup(mjb_codepoint codepoint, mjb_codepoint_record *record) {
+    size_t page = codepoint >> 8;
+
+    if(page >= MJB_COUNT_OF(mjb_unicode_record_page_index)) {
+        return false;
+    }
+
+    size_t index = ((size_t)mjb_unicode_record_page_index[page] << 8) | (codepoint & 0xFF);
+    uint32_t value = mjb_unicode_record_values[mjb_unicode_record_pages[index]];
+
+    if((value & 0x400000) == 0) {
+        return false;
+    }
+
+    uint8_t bidirectional = (uint8_t)((value >> 13) & 0x1F);
+    uint8_t decimal = (uint8_t)((value >> 18) & 0xF);
+
+    record->category = (uint8_t)(value & 0x1F);
+    record->combining = (uint8_t)((value >> 5) & 0xFF);
+    record->bidirectional = bidirectional == 0 || bidirectional >= MJB_BIDI_CLASS_COUNT ?
+        (uint8_t)MJB_PR_BIDI_CLASS_L :
+        bidirectional;
+    record->decimal = decimal == 0 ? MJB_NUMBER_NOT_VALID : (int8_t)(decimal - 1);
+    record->cased = (value & 0x800000) != 0;
+    record->case_ignorable = (value & 0x1000000) != 0;
+
+    return true;
+}
+
 bool mjb_unicode_special_casing_lookup(mjb_codepoint codepoint, mjb_map_case_type case_type,
     const mjb_codepoint **values, uint8_t *length) {
     size_t low = 0;
@@ -1047,26 +1154,36 @@ bool mjb_unicode_decomposition_lookup(mjb_codepoint codepoint, bool compatibilit
         MJB_UNICODE_CANONICAL_DECOMPOSITION_EXCEPTION_COUNT, codepoint, values, length);
 }
 
+// Keep in sync with compositionHash() in utils/generate/file-generators/unicode-data/composition.ts
+static inline uint32_t mjb_unicode_composition_hash(mjb_codepoint starter, mjb_codepoint combining,
+    uint32_t seed) {
+    uint32_t hash = (starter * 0x9E3779B1u + combining) ^ seed;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+// The pairs are stored in a perfect hash: the pair selects a bucket, whose displacement selects
+// the only slot the pair can be in. A lookup is two table reads and one comparison.
 mjb_codepoint mjb_unicode_compose_pair(mjb_codepoint starter, mjb_codepoint combining) {
-    size_t low = 0;
-    size_t high = MJB_COUNT_OF(mjb_unicode_compositions);
+    if((starter | combining) > 0x1FFFFF) {
+        return MJB_CODEPOINT_NOT_VALID;
+    }
 
-    while(low < high) {
-        size_t mid = low + (high - low) / 2;
-        uint64_t entry = mjb_unicode_compositions[mid];
-        mjb_codepoint entry_starter = (mjb_codepoint)(entry & 0x1FFFFF);
-        mjb_codepoint entry_combining = (mjb_codepoint)((entry >> 21) & 0x1FFFFF);
-        mjb_codepoint entry_composite = (mjb_codepoint)((entry >> 42) & 0x1FFFFF);
+    uint32_t bucket = mjb_unicode_composition_hash(starter, combining, 0) >>
+        (32 - MJB_UNICODE_COMPOSITION_BUCKET_BITS);
+    uint32_t seed = mjb_unicode_composition_displacements[bucket];
+    uint32_t slot = mjb_unicode_composition_hash(starter, combining, seed) &
+        ((1u << MJB_UNICODE_COMPOSITION_TABLE_BITS) - 1);
+    uint64_t entry = mjb_unicode_compositions[slot];
 
-        if(starter < entry_starter || (starter == entry_starter && combining < entry_combining)) {
-            high = mid;
-        } else if(starter > entry_starter ||
-            (starter == entry_starter && combining > entry_combining)) {
-            low = mid + 1;
-        } else {
-            return entry_composite;
-        }
+    if(entry == 0 || (entry & 0x3FFFFFFFFFFULL) != ((uint64_t)combining << 21 | starter)) {
+        return MJB_CODEPOINT_NOT_VALID;
     }
 
-    return MJB_CODEPOINT_NOT_VALID;
+    return (mjb_codepoint)(entry >> 42);
 }
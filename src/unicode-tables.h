@@ -22,6 +22,19 @@ typedef struct mjb_unicode_case_mapping {
     mjb_codepoint titlecase;
 } mjb_unicode_case_mapping;
 
+#define MJB_UNICODE_PROPERTY_CACHE_SIZE 256
+
+// The lookups of one property in a batch of neighbouring codepoints: the property page of the last
+// scan and the values of recently seen codepoints.
+typedef struct mjb_unicode_property_cache {
+    mjb_property property;
+    uint32_t page;
+    size_t start;
+    size_t count;
+    mjb_codepoint codepoints[MJB_UNICODE_PROPERTY_CACHE_SIZE];
+    uint8_t values[MJB_UNICODE_PROPERTY_CACHE_SIZE];
+} mjb_unicode_property_cache;
+
 #if MJB_FEATURE_COLLATION
 typedef uint32_t mjb_unicode_collation_contraction_entry;
 #endif
@@ -42,7 +55,11 @@ bool mjb_unicode_emoji_lookup(mjb_codepoint codepoint, mjb_emoji_properties *emo
 bool mjb_unicode_emoji_sequence_lookup(const mjb_codepoint *codepoints, size_t count,
     mjb_emoji_sequence *emoji);
 bool mjb_unicode_has_property(mjb_codepoint codepoint, mjb_property property, uint8_t *value);
+void mjb_unicode_property_cache_init(mjb_unicode_property_cache *cache, mjb_property property);
+uint8_t mjb_unicode_property_cache_lookup(mjb_unicode_property_cache *cache,
+    mjb_codepoint codepoint);
 bool mjb_unicode_properties(mjb_codepoint codepoint, uint8_t *buffer);
+uint32_t mjb_unicode_segmentation_lookup(mjb_codepoint codepoint);
 bool mjb_unicode_script_extensions_lookup(mjb_codepoint codepoint, const uint8_t **scripts,
     uint8_t *count);
 bool mjb_unicode_n_character_lookup(mjb_codepoint codepoint, mjb_n_character *character);
@@ -51,6 +68,7 @@ bool mjb_unicode_codepoint_assigned(mjb_codepoint codepoint);
 bool mjb_unicode_bidi_lookup(mjb_codepoint codepoint, mjb_bidi_class *bidi, bool *mirrored);
 bool mjb_unicode_numeric_value_lookup(mjb_codepoint codepoint, mjb_numeric_value *value);
 bool mjb_unicode_case_lookup(mjb_codepoint codepoint, mjb_unicode_case_mapping *mapping);
+bool mjb_unicode_record_lookup(mjb_codepoint codepoint, mjb_codepoint_record *record);
 bool mjb_unicode_special_casing_lookup(mjb_codepoint codepoint, mjb_map_case_type case_type,
     const mjb_codepoint **values, uint8_t *length);
 bool mjb_unicode_case_folding_lookup(mjb_codepoint codepoint, const mjb_codepoint **values,
@@ -140,14 +140,12 @@ static inline bool MJB_USED mjb_decode_step(const char *buffer, size_t byte_leng
 }
 
 /**
- * Get the next codepoint from a string.
+ * Decode the next code unit of a string in a resolved |encoding|. The specialized decoders below
+ * pass a constant encoding, so the encoding branches fold away.
  */
-static inline mjb_decode_result MJB_USED mjb_next_codepoint(const char *buffer, size_t byte_length,
+static inline mjb_decode_result MJB_USED mjb_next_code_unit(const char *buffer, size_t byte_length,
     uint8_t *state, size_t *index, mjb_encoding encoding, mjb_codepoint *codepoint,
     bool *in_error) {
-    mjb_encoding requested_encoding = encoding;
-    encoding = mjb_resolve_input_encoding(buffer, byte_length, encoding, index);
-
     if(*index >= byte_length) {
         // Check if we have an incomplete sequence at end of buffer
         if(mjb_utf_state_is_incomplete(*state)) {
@@ -160,16 +158,6 @@ static inline mjb_decode_result MJB_USED mjb_next_codepoint(const char *buffer,
         return MJB_DECODE_END;
     }
 
-    if((requested_encoding == MJB_ENC_UTF_16 || requested_encoding == MJB_ENC_UTF_32) &&
-        encoding == requested_encoding) {
-        *codepoint = MJB_CODEPOINT_REPLACEMENT;
-        *state = MJB_UTF_ACCEPT;
-        *index = byte_length;
-        *in_error = true;
-
-        return MJB_DECODE_ERROR;
-    }
-
     uint8_t prev_state = *state;
 
     if(!mjb_decode_step(buffer, byte_length, state, index, encoding, codepoint)) {
@@ -229,6 +217,98 @@ static inline mjb_decode_result MJB_USED mjb_next_codepoint(const char *buffer,
     return MJB_DECODE_INCOMPLETE;
 }
 
+/**
+ * Decoders specialized to one resolved encoding. They consume the code units of a sequence until
+ * its codepoint is complete. MJB_DECODE_INCOMPLETE is returned when the buffer ends inside a
+ * sequence, and after each code unit dropped from an ill-formed subsequence, so the index a caller
+ * saves before the call is always the first code unit of the codepoint it returns.
+ */
+#define MJB_DEFINE_NEXT_CODEPOINT(NAME, ENCODING) \
+    static inline mjb_decode_result MJB_USED NAME(const char *buffer, size_t byte_length, \
+        uint8_t *state, size_t *index, mjb_codepoint *codepoint, bool *in_error) { \
+        mjb_decode_result result; \
+        do { \
+            result = mjb_next_code_unit(buffer, byte_length, state, index, ENCODING, codepoint, \
+                in_error); \
+        } while(result == MJB_DECODE_INCOMPLETE && *state != MJB_UTF_ACCEPT && \
+            *index < byte_length); \
+        return result; \
+    }
+
+MJB_DEFINE_NEXT_CODEPOINT(mjb_next_codepoint_ascii, MJB_ENC_ASCII)
+MJB_DEFINE_NEXT_CODEPOINT(mjb_next_codepoint_utf8, MJB_ENC_UTF_8)
+MJB_DEFINE_NEXT_CODEPOINT(mjb_next_codepoint_utf16be, MJB_ENC_UTF_16BE)
+MJB_DEFINE_NEXT_CODEPOINT(mjb_next_codepoint_utf16le, MJB_ENC_UTF_16LE)
+MJB_DEFINE_NEXT_CODEPOINT(mjb_next_codepoint_utf32be, MJB_ENC_UTF_32BE)
+MJB_DEFINE_NEXT_CODEPOINT(mjb_next_codepoint_utf32le, MJB_ENC_UTF_32LE)
+
+#undef MJB_DEFINE_NEXT_CODEPOINT
+
+/**
+ * Resolve the encoding once and run the decoder specialized to it.
+ */
+static inline mjb_decode_result MJB_USED mjb_next_codepoint_dispatch(const char *buffer,
+    size_t byte_length, uint8_t *state, size_t *index, mjb_encoding encoding,
+    mjb_codepoint *codepoint, bool *in_error) {
+    // Only MJB_ENC_UTF_16 and MJB_ENC_UTF_32 need the BOM to choose the byte order.
+    if(encoding == MJB_ENC_UTF_16 || encoding == MJB_ENC_UTF_32) {
+        mjb_encoding requested_encoding = encoding;
+        encoding = mjb_resolve_input_encoding(buffer, byte_length, encoding, index);
+
+        if(*index < byte_length && encoding == requested_encoding) {
+            *codepoint = MJB_CODEPOINT_REPLACEMENT;
+            *state = MJB_UTF_ACCEPT;
+            *index = byte_length;
+            *in_error = true;
+
+            return MJB_DECODE_ERROR;
+        }
+    }
+
+    switch(encoding) {
+        case MJB_ENC_ASCII:
+            return mjb_next_codepoint_ascii(buffer, byte_length, state, index, codepoint,
+                in_error);
+        case MJB_ENC_UTF_8:
+            return mjb_next_codepoint_utf8(buffer, byte_length, state, index, codepoint, in_error);
+        case MJB_ENC_UTF_16BE:
+            return mjb_next_codepoint_utf16be(buffer, byte_length, state, index, codepoint,
+                in_error);
+        case MJB_ENC_UTF_16LE:
+            return mjb_next_codepoint_utf16le(buffer, byte_length, state, index, codepoint,
+                in_error);
+        case MJB_ENC_UTF_32BE:
+            return mjb_next_codepoint_utf32be(buffer, byte_length, state, index, codepoint,
+                in_error);
+        case MJB_ENC_UTF_32LE:
+            return mjb_next_codepoint_utf32le(buffer, byte_length, state, index, codepoint,
+                in_error);
+        default:
+            return mjb_next_code_unit(buffer, byte_length, state, index, encoding, codepoint,
+                in_error);
+    }
+}
+
+/**
+ * Get the next codepoint from a string.
+ */
+static inline mjb_decode_result MJB_USED mjb_next_codepoint(const char *buffer, size_t byte_length,
+    uint8_t *state, size_t *index, mjb_encoding encoding, mjb_codepoint *codepoint,
+    bool *in_error) {
+    // An ASCII byte outside of a sequence is a codepoint on its own and needs no DFA step.
+    if((encoding == MJB_ENC_UTF_8 || encoding == MJB_ENC_ASCII) && *state == MJB_UTF_ACCEPT &&
+        *index < byte_length && (uint8_t)buffer[*index] < 0x80) {
+        *codepoint = (uint8_t)buffer[*index];
+        ++*index;
+        *in_error = false;
+
+        return MJB_DECODE_OK;
+    }
+
+    return mjb_next_codepoint_dispatch(buffer, byte_length, state, index, encoding, codepoint,
+        in_error);
+}
+
 /**
  * Return the number of encoded bytes a codepoint occupies in the given encoding.
  * UTF-8:  1–4 bytes depending on codepoint value (ASCII shares the UTF-8 decode path).
@@ -265,22 +345,6 @@ static inline size_t MJB_USED mjb_codepoint_encoded_bytes(mjb_codepoint cp, mjb_
     return 4;
 }
 
-/**
- * Byte offset at which the codepoint most recently decoded into |index| begins. Guards against
- * underflow when a replacement codepoint reports more encoded bytes than were consumed from a
- * malformed sequence.
- */
-static inline size_t MJB_USED mjb_cluster_start(size_t index, size_t size, mjb_codepoint cp,
-    mjb_encoding encoding) {
-    if(index > size) {
-        return size;
-    }
-
-    size_t encoded = mjb_codepoint_encoded_bytes(cp, encoding);
-
-    return encoded > index ? 0 : index - encoded;
-}
-
 static inline void MJB_USED mjb_mark_decode_terminated(uint8_t *state, size_t *index,
     mjb_codepoint *current_codepoint, mjb_encoding encoding) {
     if(*current_codepoint == MJB_CODEPOINT_NOT_VALID) {
@@ -291,20 +355,14 @@ static inline void MJB_USED mjb_mark_decode_terminated(uint8_t *state, size_t *i
     *state = MJB_UTF_TERMINATED;
 }
 
-static inline size_t MJB_USED mjb_boundary_position(size_t index, size_t size, mjb_codepoint cp,
-    mjb_encoding encoding, bool terminated) {
-    if(terminated) {
-        size_t encoded = mjb_codepoint_encoded_bytes(cp, encoding);
-
-        return encoded > index ? 0 : index - encoded;
-    }
-
-    return mjb_cluster_start(index, size, cp, encoding);
-}
-
-static inline size_t MJB_USED mjb_monotonic_boundary_position(size_t index, size_t size,
-    mjb_codepoint cp, mjb_encoding encoding, bool terminated, size_t previous) {
-    size_t position = mjb_boundary_position(index, size, cp, encoding, terminated);
+/**
+ * Byte offset of a boundary reported by a break iterator: the start of the codepoint it was
+ * reported before, or the end of the text once the iterator has read past it. Never moves back
+ * before |previous|.
+ */
+static inline size_t MJB_USED mjb_break_boundary_position(size_t index, size_t size,
+    size_t codepoint_index, bool terminated, size_t previous) {
+    size_t position = terminated || index > size ? size : codepoint_index;
 
     return position < previous ? previous : position;
 }
@@ -401,9 +459,19 @@ static inline mjb_status MJB_USED mjb_validate_code_unit_sequence(const char *bu
     bool in_error = false;
     mjb_codepoint codepoint = 0;
 
-    for(size_t i = 0; i < byte_length;) {
-        mjb_decode_result result = mjb_next_codepoint(buffer, byte_length, &state, &i, encoding,
-            &codepoint, &in_error);
+    bool utf8 = resolved_encoding == MJB_ENC_UTF_8 || resolved_encoding == MJB_ENC_ASCII;
+
+    for(size_t i = resolved_index; i < byte_length;) {
+        if(utf8 && state == MJB_UTF_ACCEPT) {
+            i += mjb_utf8_ascii_span(buffer + i, byte_length - i);
+
+            if(i >= byte_length) {
+                break;
+            }
+        }
+
+        mjb_decode_result result = mjb_next_codepoint(buffer, byte_length, &state, &i,
+            resolved_encoding, &codepoint, &in_error);
 
         if(result == MJB_DECODE_END) {
             break;
@@ -7,9 +7,20 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
 
 #include "mojibake-internal.h"
 
+// clang-format off
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MJB_UTF8_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define MJB_UTF8_NEON 1
+#endif
+// clang-format on
+
 static const uint32_t utf8_classtab[16] = {
     0X88888888UL,
     0X88888888UL,
@@ -71,3 +82,42 @@ static inline uint8_t MJB_USED mjb_utf8_decode_step(uint8_t state, uint8_t octet
 
     return (utf8_statetab[c_class] >> ((state & 7) << 2)) & 0xF;
 }
+
+/**
+ * Return the length of the leading run of ASCII bytes. Blocks of 16 bytes are tested with SSE2 or
+ * NEON when the target has them, then 8 bytes at a time, then byte by byte.
+ */
+static inline size_t MJB_USED mjb_utf8_ascii_span(const char *buffer, size_t byte_length) {
+    size_t i = 0;
+
+#if defined(MJB_UTF8_SSE2)
+    for(; i + 16 <= byte_length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(const void *)(buffer + i));
+
+        if(_mm_movemask_epi8(block) != 0) {
+            break;
+        }
+    }
+#elif defined(MJB_UTF8_NEON)
+    for(; i + 16 <= byte_length; i += 16) {
+        if(vmaxvq_u8(vld1q_u8((const uint8_t *)buffer + i)) >= 0x80) {
+            break;
+        }
+    }
+#endif
+
+    for(; i + 8 <= byte_length; i += 8) {
+        uint64_t word;
+        memcpy(&word, buffer + i, sizeof(word));
+
+        if(word & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+
+    while(i < byte_length && (uint8_t)buffer[i] < 0x80) {
+        ++i;
+    }
+
+    return i;
+}
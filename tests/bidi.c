@@ -228,6 +228,203 @@ static void read_bidi_test_file(const char *filename) {
     fclose(file);
 }
 
+static void test_bidi_workspace(void) {
+    mjb_bidi_workspace workspace;
+    mjb_bidi_paragraph para;
+    mjb_bidi_paragraph expected;
+
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_init(NULL), MJB_STATUS_INVALID_ARGUMENT,
+        "workspace init rejects NULL")
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_init(&workspace), MJB_STATUS_OK, "workspace init")
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(NULL, "a", 1, MJB_ENC_UTF_8,
+                          MJB_DIRECTION_AUTO, &para),
+        MJB_STATUS_INVALID_ARGUMENT, "workspace resolve rejects NULL workspace")
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(&workspace, "a", 1, MJB_ENC_UTF_8,
+                          MJB_DIRECTION_AUTO, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "workspace resolve rejects NULL result")
+
+    // Hello مرحبا (١٢) [with brackets and digits]
+    const char *lines[] = { "Hello \xD9\x85\xD8\xB1\xD8\xAD\xD8\xA8\xD8\xA7 (\xD9\xA1\xD9\xA2)",
+        "\xD7\x90\xD7\x91 [12] abc", "abc", "" };
+    size_t order[32];
+
+    for(size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); ++i) {
+        ATT_ASSERT_STATUS(mjb_bidi_resolve(lines[i], strlen(lines[i]), MJB_ENC_UTF_8,
+                              MJB_DIRECTION_AUTO, &expected),
+            MJB_STATUS_OK, "workspace reference resolve")
+        ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(&workspace, lines[i], strlen(lines[i]),
+                              MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, &para),
+            MJB_STATUS_OK, "workspace resolve")
+        ATT_ASSERT(para.count, expected.count, "workspace resolve count")
+        ATT_ASSERT(para.paragraph_level, expected.paragraph_level, "workspace paragraph level")
+
+        bool same = para.count == expected.count;
+
+        for(size_t j = 0; same && j < para.count; ++j) {
+            same = para.chars[j].codepoint == expected.chars[j].codepoint &&
+                para.chars[j].byte_offset == expected.chars[j].byte_offset &&
+                para.chars[j].level == expected.chars[j].level &&
+                para.chars[j].resolved_class == expected.chars[j].resolved_class &&
+                para.chars[j].mirroring_glyph == expected.chars[j].mirroring_glyph;
+        }
+
+        ATT_ASSERT(same, true, "workspace resolve matches mjb_bidi_resolve")
+        mjb_bidi_paragraph_free(&expected);
+    }
+
+    ATT_ASSERT(para.chars == NULL, true, "workspace empty paragraph has no chars")
+
+    // Size by codepoints: the Arabic line has 16 codepoints in 23 bytes.
+    ATT_ASSERT(workspace.capacity, (size_t)16, "workspace sized by codepoint count")
+
+    // Once the buffers fit, resolving and reordering shorter lines does not allocate.
+    mjb_test_allocator_fail_after(0);
+
+    for(size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); ++i) {
+        ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(&workspace, lines[i], strlen(lines[i]),
+                              MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, &para),
+            MJB_STATUS_OK, "workspace resolve without allocating")
+
+        if(para.count > 0) {
+            ATT_ASSERT_STATUS(mjb_bidi_reorder_line(&para, 0, para.count, order), MJB_STATUS_OK,
+                "reorder without allocating")
+        }
+    }
+
+    ATT_ASSERT(order[0], (size_t)0, "workspace reorder LTR line")
+
+    // A longer paragraph needs the buffers to grow.
+    const char *longer = "abc def ghi jkl mno pqr";
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(&workspace, longer, strlen(longer),
+                          MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, &para),
+        MJB_STATUS_NO_MEMORY, "workspace reports allocation failure")
+    mjb_test_allocator_reset();
+    ATT_ASSERT(workspace.capacity, (size_t)0, "workspace is released after allocation failure")
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(&workspace, longer, strlen(longer),
+                          MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, &para),
+        MJB_STATUS_OK, "workspace grows")
+    ATT_ASSERT(para.count, (size_t)23, "workspace grown paragraph count")
+
+    mjb_bidi_workspace_free(&workspace);
+    ATT_ASSERT(workspace.chars == NULL, true, "workspace free clears chars")
+
+    // A freed workspace is empty again. Stray continuation bytes decode to more codepoints than
+    // lead bytes, so the buffers grow while decoding.
+    const char *malformed = "\x80\x80" "a\x80";
+    ATT_ASSERT_STATUS(mjb_bidi_workspace_resolve(&workspace, malformed, strlen(malformed),
+                          MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, &para),
+        MJB_STATUS_OK, "workspace resolve malformed input")
+    ATT_ASSERT(para.count, (size_t)3, "workspace malformed input count")
+    ATT_ASSERT(para.chars[2].codepoint, (mjb_codepoint)MJB_CODEPOINT_REPLACEMENT,
+        "workspace malformed input replacement")
+
+    mjb_bidi_workspace_free(&workspace);
+    mjb_bidi_workspace_free(NULL);
+}
+
+// A pool that runs the tasks in reverse order, to check they do not depend on each other.
+static void reverse_parallel_for(void *pool, size_t count, mjb_parallel_task_fn task,
+    void *context) {
+    size_t *calls = (size_t *)pool;
+
+    for(size_t i = count; i > 0; --i) {
+        task(context, i - 1);
+        ++*calls;
+    }
+}
+
+static void test_bidi_document(void) {
+    mjb_bidi_document document;
+    mjb_bidi_document serial;
+    mjb_bidi_paragraph expected;
+
+    ATT_ASSERT_STATUS(mjb_bidi_resolve_document("a", 1, MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, NULL,
+                          NULL, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "document resolve rejects NULL result")
+    ATT_ASSERT_STATUS(mjb_bidi_resolve_document(NULL, 1, MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, NULL,
+                          NULL, &document),
+        MJB_STATUS_INVALID_ARGUMENT, "document resolve rejects NULL buffer")
+    ATT_ASSERT_STATUS(mjb_bidi_resolve_document("", 0, MJB_ENC_UTF_8, MJB_DIRECTION_AUTO, NULL,
+                          NULL, &document),
+        MJB_STATUS_OK, "empty document resolve")
+    ATT_ASSERT(document.paragraph_count, (size_t)0, "empty document has no paragraphs")
+    mjb_bidi_document_free(&document);
+
+    // abc LF אב CR LF def
+    const char *text = "abc\n\xD7\x90\xD7\x91\r\ndef";
+    const size_t starts[] = { 0, 4, 10 };
+    const size_t lengths[] = { 4, 6, 3 };
+    const uint8_t levels[] = { 0, 1, 0 };
+
+    ATT_ASSERT_STATUS(mjb_bidi_resolve_document(text, strlen(text), MJB_ENC_UTF_8,
+                          MJB_DIRECTION_AUTO, NULL, NULL, &serial),
+        MJB_STATUS_OK, "document resolve")
+    ATT_ASSERT(serial.paragraph_count, (size_t)3, "document paragraphs, CR LF is one separator")
+    ATT_ASSERT(serial.count, (size_t)11, "document characters")
+
+    if(serial.paragraph_count == 3) {
+        size_t first = 0;
+
+        for(size_t i = 0; i < 3; ++i) {
+            mjb_bidi_paragraph *para = &serial.paragraphs[i];
+
+            ATT_ASSERT(para->paragraph_level, levels[i], "document paragraph level")
+            ATT_ASSERT(para->chars == serial.chars + first, true, "document paragraphs are packed")
+            ATT_ASSERT_STATUS(mjb_bidi_resolve(text + starts[i], lengths[i], MJB_ENC_UTF_8,
+                                  MJB_DIRECTION_AUTO, &expected),
+                MJB_STATUS_OK, "document reference resolve")
+            ATT_ASSERT(para->count, expected.count, "document paragraph count")
+
+            bool same = para->count == expected.count;
+
+            for(size_t j = 0; same && j < para->count; ++j) {
+                same = para->chars[j].codepoint == expected.chars[j].codepoint &&
+                    para->chars[j].byte_offset == expected.chars[j].byte_offset + starts[i] &&
+                    para->chars[j].level == expected.chars[j].level &&
+                    para->chars[j].resolved_class == expected.chars[j].resolved_class;
+            }
+
+            ATT_ASSERT(same, true, "document paragraph matches mjb_bidi_resolve")
+            first += para->count;
+            mjb_bidi_paragraph_free(&expected);
+        }
+
+        ATT_ASSERT(serial.paragraphs[1].chars[0].codepoint, (mjb_codepoint)0x05D0,
+            "document second paragraph starts with alef")
+        ATT_ASSERT(serial.paragraphs[1].chars[0].byte_offset, (size_t)4,
+            "document offsets are relative to the document")
+    }
+
+    // The tasks are independent: any order gives the same document.
+    size_t calls = 0;
+    ATT_ASSERT_STATUS(mjb_bidi_resolve_document(text, strlen(text), MJB_ENC_UTF_8,
+                          MJB_DIRECTION_AUTO, reverse_parallel_for, &calls, &document),
+        MJB_STATUS_OK, "document resolve on a pool")
+    ATT_ASSERT(calls, (size_t)3, "document pool runs one task per paragraph")
+    ATT_ASSERT(document.count, serial.count, "document pool count")
+
+    bool same = document.count == serial.count;
+
+    for(size_t i = 0; same && i < document.count; ++i) {
+        same = document.chars[i].codepoint == serial.chars[i].codepoint &&
+            document.chars[i].byte_offset == serial.chars[i].byte_offset &&
+            document.chars[i].level == serial.chars[i].level;
+    }
+
+    ATT_ASSERT(same, true, "document pool matches serial resolve")
+    mjb_bidi_document_free(&document);
+    mjb_bidi_document_free(&serial);
+    ATT_ASSERT(serial.chars == NULL, true, "document free clears chars")
+    mjb_bidi_document_free(NULL);
+
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_bidi_resolve_document(text, strlen(text), MJB_ENC_UTF_8,
+                          MJB_DIRECTION_AUTO, NULL, NULL, &document),
+        MJB_STATUS_NO_MEMORY, "document reports allocation failure")
+    mjb_test_allocator_reset();
+    ATT_ASSERT(document.chars == NULL, true, "document is empty after allocation failure")
+}
+
 int test_bidi(void *arg) {
     mjb_bidi_paragraph para;
     mjb_status status;
@@ -279,6 +476,57 @@ int test_bidi(void *arg) {
     ATT_ASSERT(para.paragraph_level, (uint8_t)0, "explicit LTR paragraph level")
     mjb_bidi_paragraph_free(&para);
 
+    // Pure left-to-right: numbers, brackets, NSM and BN resolve without the later passes.
+    const char *pure_ltr = "(12) e\xCC\x81\xC2\xAD\t$3";
+    status = mjb_bidi_resolve(pure_ltr, strlen(pure_ltr), MJB_ENC_UTF_8, MJB_DIRECTION_AUTO,
+        &para);
+    ATT_ASSERT_STATUS(status, MJB_STATUS_OK, "pure LTR resolve ok")
+    ATT_ASSERT(para.count, (size_t)10, "pure LTR drops BN")
+
+    bool all_ltr = para.count == 10;
+
+    for(size_t i = 0; all_ltr && i < para.count; ++i) {
+        all_ltr = para.chars[i].level == 0 &&
+            para.chars[i].resolved_class == MJB_PR_BIDI_CLASS_L &&
+            para.chars[i].mirroring_glyph == 0;
+    }
+
+    ATT_ASSERT(all_ltr, true, "pure LTR levels and classes")
+    ATT_ASSERT(para.chars[7].byte_offset, (size_t)10, "pure LTR offset after BN")
+    mjb_bidi_paragraph_free(&para);
+
+    // The offset of a codepoint is its first code unit: é (2 bytes), € (3 bytes), 😀 (4 bytes)
+    const char *multibyte = "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80!";
+    status = mjb_bidi_resolve(multibyte, strlen(multibyte), MJB_ENC_UTF_8, MJB_DIRECTION_AUTO,
+        &para);
+    ATT_ASSERT_STATUS(status, MJB_STATUS_OK, "multibyte resolve ok")
+    ATT_ASSERT(para.count, (size_t)4, "multibyte count")
+
+    if(para.count == 4) {
+        ATT_ASSERT(para.chars[0].byte_offset, (size_t)0, "2-byte codepoint offset")
+        ATT_ASSERT(para.chars[1].byte_offset, (size_t)2, "3-byte codepoint offset")
+        ATT_ASSERT(para.chars[2].byte_offset, (size_t)5, "4-byte codepoint offset")
+        ATT_ASSERT(para.chars[3].byte_offset, (size_t)9, "offset after a 4-byte codepoint")
+    }
+
+    mjb_bidi_paragraph_free(&para);
+
+    // Continuation bytes dropped after an ill-formed sequence are not part of the next offset.
+    const char *ill_formed = "a\xC3\xE3\x80\x82j";
+    status = mjb_bidi_resolve(ill_formed, strlen(ill_formed), MJB_ENC_UTF_8, MJB_DIRECTION_AUTO,
+        &para);
+    ATT_ASSERT_STATUS(status, MJB_STATUS_OK, "ill-formed resolve ok")
+    ATT_ASSERT(para.count, (size_t)3, "ill-formed count")
+
+    if(para.count == 3) {
+        ATT_ASSERT(para.chars[1].codepoint, (mjb_codepoint)MJB_CODEPOINT_REPLACEMENT,
+            "ill-formed replacement")
+        ATT_ASSERT(para.chars[1].byte_offset, (size_t)1, "ill-formed replacement offset")
+        ATT_ASSERT(para.chars[2].byte_offset, (size_t)5, "ill-formed next codepoint offset")
+    }
+
+    mjb_bidi_paragraph_free(&para);
+
     status = mjb_bidi_resolve(ltr, strlen(ltr), MJB_ENC_UTF_8, MJB_DIRECTION_RTL, &para);
     ATT_ASSERT_STATUS(status, MJB_STATUS_OK, "explicit RTL dir resolve")
     ATT_ASSERT(para.paragraph_level, (uint8_t)1, "explicit RTL paragraph level")
@@ -372,6 +620,9 @@ int test_bidi(void *arg) {
 
     mjb_bidi_paragraph_free(&para);
 
+    test_bidi_workspace();
+    test_bidi_document();
+
     read_bidi_test_file("./utils/generate/unicode-data/UCD/BidiCharacterTest.txt");
 
     return 0;
@@ -47,6 +47,13 @@ static void test_truncate_word(void) {
     ATT_ASSERT((uint8_t)mjb_next_word_break("A", 1, MJB_ENC_UTF_8, NULL), (uint8_t)MJB_BT_NOT_SET,
         "Word break rejects NULL state")
 
+    // A state restarted on another buffer does not reuse the look-ahead of the previous one
+    ATT_ASSERT((uint8_t)mjb_next_word_break("1.2", 3, MJB_ENC_UTF_8, &state),
+        (uint8_t)MJB_BT_NO_BREAK, "Word break: WB12 look-ahead")
+    state.index = 0;
+    ATT_ASSERT((uint8_t)mjb_next_word_break("1.a", 3, MJB_ENC_UTF_8, &state),
+        (uint8_t)MJB_BT_ALLOWED, "Word break: restarted state reads the new buffer")
+
     // Edge cases
     ATT_ASSERT(mjb_truncate_word("", 0, MJB_ENC_UTF_8, 3), (size_t)0, "Truncate word: empty string")
     ATT_ASSERT(mjb_truncate_word(NULL, 1, MJB_ENC_UTF_8, 3), (size_t)0,
@@ -130,6 +137,9 @@ static void test_word_count(void) {
     ATT_ASSERT_STATUS(mjb_word_count("e.g. example.com", 16, MJB_ENC_UTF_8, &count),
         MJB_STATUS_OK, "Count: abbreviation status")
     ATT_ASSERT(count, (size_t)2, "Count: mid-letter punctuation stays inside the word")
+    ATT_ASSERT_STATUS(mjb_word_count("a'\xCC\x81\xCC\x81" "b c", 9, MJB_ENC_UTF_8, &count),
+        MJB_STATUS_OK, "Count: look-ahead over Extend status")
+    ATT_ASSERT(count, (size_t)2, "Count: look-ahead skips Extend after the apostrophe")
 
     // Hyphenated compounds count each part (WB999 breaks at the hyphens)
     ATT_ASSERT_STATUS(mjb_word_count("state-of-the-art", 16, MJB_ENC_UTF_8, &count),
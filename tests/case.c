@@ -275,6 +275,22 @@ int test_case(void *arg) {
     ATT_ASSERT(result, (char *)"Straße", "UTF-8 titlecase: straße")
     mjb_test_free(result);
 
+    // The bytes dropped after an ill-formed sequence do not move the start of the next word.
+    result = run_mjb_map_case("ab\xC3\xE3\x80\x82jqxh", 10, MJB_CASE_TITLE, encoding);
+    ATT_ASSERT(result, (char *)"Ab\xEF\xBF\xBDJqxh", "UTF-8 titlecase after ill-formed bytes")
+    mjb_test_free(result);
+
+    // A replacement character wider than the byte it replaces does not move the word start back.
+    result = run_mjb_map_case("\xC3\xA9" "c\xFF" "b", 5, MJB_CASE_TITLE, encoding);
+    ATT_ASSERT(result, (char *)"\xC3\x89" "c\xEF\xBF\xBD" "B",
+        "UTF-8 titlecase around a replaced byte")
+    mjb_test_free(result);
+
+    result = run_mjb_map_case("\xD1\x81" "c\xFF" "b", 5, MJB_CASE_TITLE, encoding);
+    ATT_ASSERT(result, (char *)"\xD0\xA1" "c\xEF\xBF\xBD" "B",
+        "UTF-8 titlecase around a replaced byte after Cyrillic")
+    mjb_test_free(result);
+
     result = run_mjb_map_case("παράδειγμα", 20, MJB_CASE_TITLE, encoding);
     ATT_ASSERT(result, (char *)"Παράδειγμα", "UTF-8 titlecase: παράδειγμα")
     mjb_test_free(result);
@@ -18,6 +18,70 @@ static void check_match(const char *s1, size_t s1_byte_length, mjb_encoding s1_e
     ATT_ASSERT(matches, expected, name)
 }
 
+static void check_hash(const char *s1, size_t s1_byte_length, mjb_encoding s1_encoding,
+    const char *s2, size_t s2_byte_length, mjb_encoding s2_encoding, mjb_caseless_mode mode,
+    const char *name) {
+    uint64_t left = 0;
+    uint64_t right = 1;
+
+    MJB_TEST_COVERAGE(mjb_caseless_hash);
+    ATT_ASSERT_STATUS(mjb_caseless_hash(s1, s1_byte_length, s1_encoding, mode, 42, &left),
+        MJB_STATUS_OK, name)
+    ATT_ASSERT_STATUS(mjb_caseless_hash(s2, s2_byte_length, s2_encoding, mode, 42, &right),
+        MJB_STATUS_OK, name)
+    ATT_ASSERT(left, right, name)
+}
+
+static void test_caseless_hash(void) {
+    uint64_t hash = 1;
+
+    ATT_ASSERT_STATUS(mjb_caseless_hash("a", 1, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "Caseless hash rejects a NULL result")
+    ATT_ASSERT_STATUS(mjb_caseless_hash(NULL, 1, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0, &hash),
+        MJB_STATUS_INVALID_ARGUMENT, "Caseless hash rejects a NULL input")
+    ATT_ASSERT_STATUS(mjb_caseless_hash("a", 1, MJB_ENC_UTF_8, (mjb_caseless_mode)99, 0, &hash),
+        MJB_STATUS_INVALID_ARGUMENT, "Caseless hash rejects an invalid mode")
+    ATT_ASSERT_STATUS(mjb_caseless_hash("\x80", 1, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0,
+                          &hash),
+        MJB_STATUS_MALFORMED_INPUT, "Caseless hash rejects malformed input")
+
+    // FNV-1a of the UTF-8 folded form.
+    ATT_ASSERT_STATUS(mjb_caseless_hash("", 0, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0, &hash),
+        MJB_STATUS_OK, "Caseless hash of an empty string")
+    ATT_ASSERT(hash, (uint64_t)0xCBF29CE484222325ull, "Caseless hash of an empty string")
+    ATT_ASSERT_STATUS(mjb_caseless_hash("ABC", 3, MJB_ENC_UTF_8, MJB_CASELESS_UNNORMALIZED, 0,
+                          &hash),
+        MJB_STATUS_OK, "Caseless hash of ASCII")
+    ATT_ASSERT(hash, (uint64_t)0xE71FA2190541574Bull, "Caseless hash is FNV-1a of the folded form")
+    ATT_ASSERT_STATUS(mjb_caseless_hash("ABC", 3, MJB_ENC_UTF_8, MJB_CASELESS_UNNORMALIZED, 1,
+                          &hash),
+        MJB_STATUS_OK, "Caseless hash with a seed")
+    ATT_ASSERT(hash != 0xE71FA2190541574Bull, true, "Caseless hash depends on the seed")
+
+    check_hash("Stra\xC3\x9F"
+               "e",
+        7, MJB_ENC_UTF_8, "STRASSE", 7, MJB_ENC_UTF_8, MJB_CASELESS_UNNORMALIZED,
+        "Caseless hash of a full case folding match");
+    check_hash("\xC3\x85", 2, MJB_ENC_UTF_8, "a\xCC\x8A", 3, MJB_ENC_UTF_8,
+        MJB_CASELESS_CANONICAL, "Caseless hash of a canonical match");
+    check_hash("\xE3\x8E\x92", 3, MJB_ENC_UTF_8, "mhz", 3, MJB_ENC_UTF_8,
+        MJB_CASELESS_COMPATIBILITY, "Caseless hash of a compatibility match");
+    check_hash("ab\xC2\xAD", 4, MJB_ENC_UTF_8, "AB", 2, MJB_ENC_UTF_8, MJB_CASELESS_IDENTIFIER,
+        "Caseless hash of an identifier match");
+
+    const char utf16le_strasse[] = { 'S', '\0', 'T', '\0', 'R', '\0', 'A', '\0', 'S', '\0', 'S',
+        '\0', 'E', '\0' };
+    check_hash("stra\xC3\x9F"
+               "e",
+        7, MJB_ENC_UTF_8, utf16le_strasse, sizeof(utf16le_strasse), MJB_ENC_UTF_16LE,
+        MJB_CASELESS_CANONICAL, "Caseless hash does not depend on the encoding");
+
+    mjb_test_allocator_fail_after(0);
+    check_hash("\xC3\x85", 2, MJB_ENC_UTF_8, "A\xCC\x8A", 3, MJB_ENC_UTF_8,
+        MJB_CASELESS_COMPATIBILITY, "Caseless hash does not allocate");
+    mjb_test_allocator_reset();
+}
+
 int test_caseless(void *arg) {
     bool matches = true;
 
@@ -106,6 +170,39 @@ int test_caseless(void *arg) {
         7, MJB_ENC_UTF_8, utf16le_strasse, sizeof(utf16le_strasse), MJB_ENC_UTF_16LE,
         MJB_CASELESS_CANONICAL, true, "Caseless match compares different input encodings");
 
+    // U+1FB3 folds to alpha iota: the iota subscript becomes a starter after folding.
+    check_match("\xE1\xBE\xB3\xCC\x81", 5, MJB_ENC_UTF_8, "\xCE\xB1\xCC\x81\xCE\xB9", 6,
+        MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, true,
+        "Canonical caseless matching orders marks before folding");
+
+    // More combining marks than a normalization run holds.
+    char long_upper[1 + 40 * 2];
+    char long_lower[1 + 40 * 2];
+    long_upper[0] = 'E';
+    long_lower[0] = 'e';
+
+    for(size_t i = 0; i < 40; ++i) {
+        long_upper[1 + i * 2] = long_lower[1 + i * 2] = '\xCC';
+        long_upper[2 + i * 2] = long_lower[2 + i * 2] = (i % 2) ? '\x81' : '\xA3';
+    }
+
+    check_match(long_upper, sizeof(long_upper), MJB_ENC_UTF_8, long_lower, sizeof(long_lower),
+        MJB_ENC_UTF_8, MJB_CASELESS_COMPATIBILITY, true,
+        "Compatibility caseless matching of a long combining sequence");
+    check_match(long_upper, sizeof(long_upper), MJB_ENC_UTF_8, long_lower,
+        sizeof(long_lower) - 2, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, false,
+        "Canonical caseless matching of a shorter combining sequence");
+
+    // The folded and normalized strings are compared as they are produced.
+    mjb_test_allocator_fail_after(0);
+    check_match("Stra\xC3\x9F"
+                "e \xE3\x8E\x92",
+        11, MJB_ENC_UTF_8, "STRASSE MHZ", 11, MJB_ENC_UTF_8, MJB_CASELESS_COMPATIBILITY, true,
+        "Compatibility caseless matching does not allocate");
+    check_match("\xC3\x85x", 3, MJB_ENC_UTF_8, "A\xCC\x8Ay", 4, MJB_ENC_UTF_8,
+        MJB_CASELESS_CANONICAL, false, "Canonical caseless mismatch does not allocate");
+    mjb_test_allocator_reset();
+
     ATT_ASSERT_STATUS(mjb_set_locale(MJB_LOCALE_TR), MJB_STATUS_OK,
         "Set Turkish locale for caseless matching")
     check_match("I", 1, MJB_ENC_UTF_8, "i", 1, MJB_ENC_UTF_8, MJB_CASELESS_UNNORMALIZED, true,
@@ -115,5 +212,7 @@ int test_caseless(void *arg) {
     ATT_ASSERT_STATUS(mjb_set_locale(MJB_LOCALE_EN), MJB_STATUS_OK,
         "Restore default locale after caseless matching")
 
+    test_caseless_hash();
+
     return 0;
 }
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../src/mojibake-internal.h"
 #include "test.h"
 
 static const char *expected_character_name(mjb_codepoint codepoint, const char *name, char *buffer,
@@ -25,6 +26,40 @@ static const char *expected_character_name(mjb_codepoint codepoint, const char *
 #endif
 }
 
+// Return the first codepoint whose compact record differs from mjb_codepoint_info()
+static mjb_codepoint codepoint_record_mismatch(void) {
+    for(mjb_codepoint codepoint = 0; codepoint <= MJB_CODEPOINT_MAX + 1; ++codepoint) {
+        mjb_character character;
+        mjb_codepoint_record record;
+        bool found = mjb_codepoint_info(codepoint, &character) == MJB_STATUS_OK;
+
+        if(mjb_codepoint_record_lookup(codepoint, &record) != found) {
+            return codepoint;
+        }
+
+        if(!found) {
+            // Unassigned codepoints have no case properties
+            if(mjb_codepoint_has_binary_property(codepoint, MJB_PR_CASED) ||
+                mjb_codepoint_has_binary_property(codepoint, MJB_PR_CASE_IGNORABLE)) {
+                return codepoint;
+            }
+
+            continue;
+        }
+
+        if(record.category != character.category || record.combining != character.combining ||
+            record.bidirectional != character.bidirectional ||
+            record.decimal != character.decimal ||
+            record.cased != mjb_codepoint_has_binary_property(codepoint, MJB_PR_CASED) ||
+            record.case_ignorable !=
+                mjb_codepoint_has_binary_property(codepoint, MJB_PR_CASE_IGNORABLE)) {
+            return codepoint;
+        }
+    }
+
+    return MJB_CODEPOINT_NOT_VALID;
+}
+
 #define ATT_ASSERT_CHARACTER_NAME(CODEPOINT, EXPECTED, NAME) \
     ATT_ASSERT((const char *)character.name, \
         expected_character_name((CODEPOINT), (EXPECTED), expected_name, sizeof(expected_name)), \
@@ -39,6 +74,9 @@ int test_codepoint(void *arg) {
     ATT_ASSERT_STATUS(mjb_codepoint_info(0, NULL), MJB_STATUS_INVALID_ARGUMENT,
         "NULL character pointer")
 
+    ATT_ASSERT(codepoint_record_mismatch(), MJB_CODEPOINT_NOT_VALID,
+        "Codepoint records match the character information")
+
     ATT_ASSERT_STATUS(mjb_codepoint_info(0, &character), MJB_STATUS_OK, "Codepoint: 0")
     ATT_ASSERT_CHARACTER_NAME(0, "NULL", "Codepoint: 0")
 
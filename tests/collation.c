@@ -212,6 +212,344 @@ static void assert_collation_malformed_utf8(const unsigned char *buffer, size_t
     ATT_ASSERT(order, 0, "Compare clears order before malformed-input failure")
 }
 
+static int compare_collation_keys(const char *s1, size_t s1_len, const char *s2, size_t s2_len,
+    mjb_collation_variable_weighting variable_weighting, mjb_collation_strength strength) {
+    mjb_result k1 = { NULL, 0, false };
+    mjb_result k2 = { NULL, 0, false };
+
+    if(mjb_collation_key(s1, s1_len, MJB_ENC_UTF_8, variable_weighting, strength, &k1) !=
+            MJB_STATUS_OK ||
+        mjb_collation_key(s2, s2_len, MJB_ENC_UTF_8, variable_weighting, strength, &k2) !=
+            MJB_STATUS_OK) {
+        mjb_result_free(&k1);
+        mjb_result_free(&k2);
+
+        return 2;
+    }
+
+    size_t min_size = k1.output_size < k2.output_size ? k1.output_size : k2.output_size;
+    int result = min_size ? memcmp(k1.output, k2.output, min_size) : 0;
+
+    if(result == 0) {
+        result = k1.output_size < k2.output_size ? -1 : (k1.output_size > k2.output_size);
+    }
+
+    mjb_result_free(&k1);
+    mjb_result_free(&k2);
+
+    return result < 0 ? -1 : (result > 0);
+}
+
+/**
+ * mjb_collation_compare stops at the first differing weight instead of building both keys. Check
+ * that it agrees with the keys on strings built from contraction starters, their continuations,
+ * decomposable characters, reordered marks, ignorables and variable elements.
+ */
+static void assert_compare_matches_keys(void) {
+    const char *pieces[] = { "a", "A", "b", "l", "L", "\xC2\xB7", "\xCE\x87", "\xCC\x81",
+        "\xCC\x88", "\xCC\xB4", "\xC3\xA9", "\xCD\x84", "-", " ", "\xE2\x80\x8B",
+        "\xEA\xB0\x80", "\xE4\xB8\x80", "\xE0\xB7\x99", "\xE0\xB7\x8F", "\xE0\xB7\x8A",
+        "\xE0\xB9\x80", "\xE0\xB8\x81", "\xEF\xBF\xBE" };
+    const size_t piece_count = sizeof(pieces) / sizeof(pieces[0]);
+    const size_t string_count = piece_count * piece_count * piece_count;
+    const mjb_collation_strength strengths[] = { MJB_COLLATION_PRIMARY, MJB_COLLATION_SECONDARY,
+        MJB_COLLATION_TERTIARY, MJB_COLLATION_QUATERNARY };
+    unsigned int mismatches = 0;
+    unsigned int tested = 0;
+    uint32_t seed = 1;
+
+    for(size_t i = 0; i < string_count; ++i) {
+        char left[16] = { 0 };
+        char right[16] = { 0 };
+
+        // Pair every string with one sharing its first two pieces, or with any string.
+        seed = seed * 1103515245u + 12345u;
+        size_t j = i % 2 ? (seed >> 8) % string_count :
+                           i % (piece_count * piece_count) +
+                (seed >> 8) % piece_count * piece_count * piece_count;
+
+        // Every index is a string of one to three pieces: 0 selects "no piece" past the first.
+        snprintf(left, sizeof(left), "%s%s%s", pieces[i % piece_count],
+            (i / piece_count) % piece_count ? pieces[(i / piece_count) % piece_count] : "",
+            i / piece_count / piece_count ? pieces[i / piece_count / piece_count] : "");
+        snprintf(right, sizeof(right), "%s%s%s", pieces[j % piece_count],
+            (j / piece_count) % piece_count ? pieces[(j / piece_count) % piece_count] : "",
+            j / piece_count / piece_count ? pieces[j / piece_count / piece_count] : "");
+
+        for(size_t w = 0; w < 2; ++w) {
+            mjb_collation_variable_weighting weighting = w ? MJB_COLLATION_SHIFTED :
+                                                             MJB_COLLATION_NON_IGNORABLE;
+
+            for(size_t k = 0; k < sizeof(strengths) / sizeof(strengths[0]); ++k) {
+                int order = 42;
+                mjb_status status = mjb_collation_compare(left, strlen(left), MJB_ENC_UTF_8,
+                    right, strlen(right), MJB_ENC_UTF_8, weighting, strengths[k], &order);
+                int expected = compare_collation_keys(left, strlen(left), right, strlen(right),
+                    weighting, strengths[k]);
+
+                if(status != MJB_STATUS_OK || (order < 0 ? -1 : (order > 0)) != expected) {
+                    ++mismatches;
+                }
+
+                ++tested;
+            }
+        }
+    }
+
+    // Contractions decided by the last of three codepoints.
+    const char *pairs[][2] = { { "\xE0\xB7\x99\xE0\xB7\x8F\xE0\xB7\x8A",
+                                   "\xE0\xB7\x99\xE0\xB7\x8F\xE4\xB8\x80" },
+        { "l\xC2\xB7", "l\xE4\xB8\x80" },
+        { "\xE0\xB9\x80\xE0\xB8\x81", "\xE0\xB9\x80\xE4\xB8\x80" } };
+
+    for(size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); ++i) {
+        int order = 42;
+        mjb_status status = mjb_collation_compare(pairs[i][0], strlen(pairs[i][0]), MJB_ENC_UTF_8,
+            pairs[i][1], strlen(pairs[i][1]), MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
+            MJB_COLLATION_TERTIARY, &order);
+
+        if(status != MJB_STATUS_OK ||
+            (order < 0 ? -1 : (order > 0)) !=
+                compare_collation_keys(pairs[i][0], strlen(pairs[i][0]), pairs[i][1],
+                    strlen(pairs[i][1]), MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY)) {
+            ++mismatches;
+        }
+
+        ++tested;
+    }
+
+    char summary[128];
+    snprintf(summary, sizeof(summary), "Compare matches keys: %u/%u pairs", tested - mismatches,
+        tested);
+    ATT_ASSERT(mismatches, 0u, summary)
+}
+
+/**
+ * A collator gives the same keys and orders as the one-shot functions and, once its buffers fit
+ * the input, stops allocating.
+ */
+static void assert_collator(void) {
+    mjb_collator collator;
+
+    ATT_ASSERT_STATUS(mjb_collator_init(NULL, MJB_COLLATION_SHIFTED, MJB_COLLATION_TERTIARY),
+        MJB_STATUS_INVALID_ARGUMENT, "Collator init rejects NULL")
+    ATT_ASSERT_STATUS(mjb_collator_init(&collator, (mjb_collation_variable_weighting)99,
+                          MJB_COLLATION_TERTIARY),
+        MJB_STATUS_INVALID_ARGUMENT, "Collator init rejects invalid weighting")
+    ATT_ASSERT_STATUS(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+                          (mjb_collation_strength)99),
+        MJB_STATUS_INVALID_ARGUMENT, "Collator init rejects invalid strength")
+    mjb_collator_free(&collator);
+    mjb_collator_free(NULL);
+
+    // The last string has a segment longer than the comparison window.
+    char marks[1 + 40 * 2 + 1] = "a";
+    size_t marks_length = 1;
+
+    for(size_t i = 0; i < 40; ++i) {
+        marks[marks_length++] = '\xCC';
+        marks[marks_length++] = (char)(i % 2 ? 0x81 : 0xA3);
+    }
+
+    const char *inputs[] = { "", "apple", "Apple", "r\xC3\xA9sum\xC3\xA9",
+        "re\xCC\x81sume\xCC\x81", "cafe-au-lait", "Caf\xC3\xA9 au lait",
+        "\xEA\xB0\x80\xE4\xB8\x80", "l\xC2\xB7", "\xE2\x80\x8B", marks };
+    const size_t input_count = sizeof(inputs) / sizeof(inputs[0]);
+    unsigned int mismatches = 0;
+
+    for(size_t w = 0; w < 2; ++w) {
+        mjb_collation_variable_weighting weighting = w ? MJB_COLLATION_SHIFTED :
+                                                         MJB_COLLATION_NON_IGNORABLE;
+
+        for(int strength = MJB_COLLATION_PRIMARY; strength <= MJB_COLLATION_QUATERNARY;
+            ++strength) {
+            if(mjb_collator_init(&collator, weighting, (mjb_collation_strength)strength) !=
+                MJB_STATUS_OK) {
+                ++mismatches;
+
+                continue;
+            }
+
+            for(size_t i = 0; i < input_count; ++i) {
+                mjb_result expected = { NULL, 0, false };
+                mjb_result key = { NULL, 0, false };
+                unsigned char output[256];
+                size_t output_size = sizeof(output);
+
+                if(mjb_collation_key(inputs[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8, weighting,
+                       (mjb_collation_strength)strength, &expected) != MJB_STATUS_OK ||
+                    mjb_collator_key(&collator, inputs[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+                        &key) != MJB_STATUS_OK ||
+                    mjb_collator_key_into(&collator, inputs[i], MJB_NUL_TERMINATED,
+                        MJB_ENC_UTF_8, output, &output_size) != MJB_STATUS_OK ||
+                    key.output_size != expected.output_size ||
+                    output_size != expected.output_size ||
+                    (output_size && (memcmp(key.output, expected.output, output_size) != 0 ||
+                                        memcmp(output, expected.output, output_size) != 0))) {
+                    ++mismatches;
+                }
+
+                mjb_result_free(&expected);
+                mjb_result_free(&key);
+
+                for(size_t j = 0; j < input_count; ++j) {
+                    int order = 42;
+                    int expected_order = 42;
+
+                    if(mjb_collator_compare(&collator, inputs[i], MJB_NUL_TERMINATED,
+                           MJB_ENC_UTF_8, inputs[j], MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+                           &order) != MJB_STATUS_OK ||
+                        mjb_collation_compare(inputs[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+                            inputs[j], MJB_NUL_TERMINATED, MJB_ENC_UTF_8, weighting,
+                            (mjb_collation_strength)strength, &expected_order) != MJB_STATUS_OK ||
+                        order != expected_order) {
+                        ++mismatches;
+                    }
+                }
+            }
+
+            mjb_collator_free(&collator);
+        }
+    }
+
+    ATT_ASSERT(mismatches, 0u, "Collator matches one-shot keys and comparisons")
+
+    ATT_ASSERT_STATUS(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+                          MJB_COLLATION_QUATERNARY),
+        MJB_STATUS_OK, "Collator init")
+
+    unsigned char output[256];
+    size_t output_size = sizeof(output);
+    int order = 42;
+
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_collator_key_into(&collator, "apple", 5, MJB_ENC_UTF_8, output,
+                          &output_size),
+        MJB_STATUS_NO_MEMORY, "Collator reports failure to grow its buffers")
+    mjb_test_allocator_reset();
+
+    // Warm up with the longest inputs, then key and compare every row without allocating.
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_collator_key_into(&collator, marks, marks_length, MJB_ENC_UTF_8, output,
+                          &output_size),
+        MJB_STATUS_OK, "Collator key warm-up")
+    ATT_ASSERT_STATUS(mjb_collator_compare(&collator, marks, marks_length, MJB_ENC_UTF_8, marks,
+                          marks_length, MJB_ENC_UTF_8, &order),
+        MJB_STATUS_OK, "Collator compare warm-up")
+
+    mjb_test_allocator_fail_after(0);
+
+    for(size_t i = 0; i < input_count; ++i) {
+        output_size = sizeof(output);
+
+        if(mjb_collator_key_into(&collator, inputs[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8, output,
+               &output_size) != MJB_STATUS_OK ||
+            mjb_collator_compare(&collator, inputs[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8, marks,
+                marks_length, MJB_ENC_UTF_8, &order) != MJB_STATUS_OK) {
+            ++mismatches;
+        }
+    }
+
+    mjb_test_allocator_reset();
+    mjb_collator_free(&collator);
+
+    ATT_ASSERT(mismatches, 0u, "Warm collator does not allocate")
+}
+
+/**
+ * Batch keys match the per-row keys and reuse one arena.
+ */
+static void assert_collator_keys(void) {
+    const char *rows[] = { "banana", "", "apple", "r\xC3\xA9sum\xC3\xA9", "\xE2\x80\x8B",
+        "Caf\xC3\xA9 au lait", "\xEA\xB0\x80\xE4\xB8\x80" };
+    const size_t row_count = sizeof(rows) / sizeof(rows[0]);
+    size_t lengths[sizeof(rows) / sizeof(rows[0])];
+    size_t offsets[sizeof(rows) / sizeof(rows[0]) + 1];
+    unsigned char arena[1024];
+    size_t arena_size = 0;
+    mjb_collator collator;
+
+    for(size_t i = 0; i < row_count; ++i) {
+        lengths[i] = strlen(rows[i]);
+    }
+
+    ATT_ASSERT_STATUS(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+                          MJB_COLLATION_QUATERNARY),
+        MJB_STATUS_OK, "Collator init")
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows, lengths, row_count, MJB_ENC_UTF_8,
+                          NULL, &arena_size, offsets),
+        MJB_STATUS_OK, "Batch keys size query")
+
+    size_t required = arena_size;
+    ATT_ASSERT(offsets[row_count], required, "Batch keys last offset is the arena size")
+
+    arena_size = sizeof(arena);
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows, NULL, row_count, MJB_ENC_UTF_8,
+                          arena, &arena_size, offsets),
+        MJB_STATUS_OK, "Batch keys of NUL-terminated rows")
+    ATT_ASSERT(arena_size, required, "Batch keys written size")
+    ATT_ASSERT(offsets[0], (size_t)0, "Batch keys first offset is zero")
+
+    unsigned int mismatches = 0;
+
+    for(size_t i = 0; i < row_count; ++i) {
+        unsigned char output[256];
+        size_t output_size = sizeof(output);
+
+        if(mjb_collator_key_into(&collator, rows[i], lengths[i], MJB_ENC_UTF_8, output,
+               &output_size) != MJB_STATUS_OK ||
+            offsets[i + 1] - offsets[i] != output_size ||
+            (output_size && memcmp(arena + offsets[i], output, output_size) != 0)) {
+            ++mismatches;
+        }
+    }
+
+    ATT_ASSERT(mismatches, 0u, "Batch keys match per-row keys")
+    ATT_ASSERT(offsets[2], offsets[1], "Batch keys of an empty row are empty")
+
+    arena_size = offsets[3] + 1;
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows, lengths, row_count, MJB_ENC_UTF_8,
+                          arena, &arena_size, offsets),
+        MJB_STATUS_OUTPUT_TOO_SMALL, "Batch keys report a small arena")
+    ATT_ASSERT(arena_size, required, "Batch keys small arena returns the whole size")
+
+    // A warm collator keys another batch into the same arena without allocating.
+    arena_size = sizeof(arena);
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows + 2, lengths + 2, 3, MJB_ENC_UTF_8,
+                          arena, &arena_size, offsets),
+        MJB_STATUS_OK, "Warm batch keys do not allocate")
+    mjb_test_allocator_reset();
+    ATT_ASSERT(offsets[3], arena_size, "Warm batch keys size")
+
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows, lengths, 0, MJB_ENC_UTF_8, arena,
+                          &arena_size, offsets),
+        MJB_STATUS_OK, "Batch keys of no rows")
+    ATT_ASSERT(arena_size, (size_t)0, "Batch keys of no rows are empty")
+    ATT_ASSERT(offsets[0], (size_t)0, "Batch keys of no rows offset")
+
+    const char *invalid[] = { "apple", "\xFF" };
+    arena_size = sizeof(arena);
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, invalid, NULL, 2, MJB_ENC_UTF_8, arena,
+                          &arena_size, offsets),
+        MJB_STATUS_MALFORMED_INPUT, "Batch keys reject malformed rows")
+    ATT_ASSERT(arena_size, (size_t)0, "Batch keys reset the size on error")
+
+    const char *null_row[] = { NULL };
+    size_t null_length = 1;
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, null_row, &null_length, 1, MJB_ENC_UTF_8,
+                          arena, &arena_size, offsets),
+        MJB_STATUS_INVALID_ARGUMENT, "Batch keys reject a NULL row with a size")
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows, lengths, row_count, MJB_ENC_UTF_8,
+                          arena, &arena_size, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "Batch keys require offsets")
+    ATT_ASSERT_STATUS(mjb_collator_keys_into(&collator, rows, lengths, row_count, MJB_ENC_UTF_8,
+                          arena, NULL, offsets),
+        MJB_STATUS_INVALID_ARGUMENT, "Batch keys require a size")
+
+    mjb_collator_free(&collator);
+}
+
 /**
  * Run collation conformance test against one UCA test file.
  * Each non-comment line contains a string (as hex codepoints).
@@ -606,6 +944,54 @@ int test_collation(void *arg) {
         1,
         "Collation: UTF-32LE apple < UTF-8 banana")
 
+    MJB_TEST_COVERAGE(mjb_collation_compare);
+    assert_compare_matches_keys();
+
+    MJB_TEST_COVERAGE(mjb_collator_init);
+    MJB_TEST_COVERAGE(mjb_collator_compare);
+    MJB_TEST_COVERAGE(mjb_collator_key);
+    MJB_TEST_COVERAGE(mjb_collator_key_into);
+    assert_collator();
+
+    MJB_TEST_COVERAGE(mjb_collator_keys_into);
+    assert_collator_keys();
+
+    // Typical inputs are compared without building sort keys.
+    mjb_test_allocator_fail_after(0);
+    order = 42;
+    ATT_ASSERT_STATUS(mjb_collation_compare("Caf\xC3\xA9 au lait", 13, MJB_ENC_UTF_8,
+                          "cafe-au-lait", 12, MJB_ENC_UTF_8, MJB_COLLATION_SHIFTED,
+                          MJB_COLLATION_QUATERNARY, &order),
+        MJB_STATUS_OK, "Compare does not allocate for typical input")
+    ATT_ASSERT(order, 1, "Compare without allocation orders accented strings")
+    mjb_test_allocator_reset();
+
+    ATT_ASSERT(test_collation_compare("a\xCC\x81\xCC\xB4", 5, MJB_ENC_UTF_8,
+                   "a\xCC\xB4\xCC\x81", 5, MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
+                   MJB_COLLATION_TERTIARY),
+        0, "Compare reorders combining marks canonically")
+    ATT_ASSERT(test_collation_compare("\xC3\xA9l\xC2\xB7", 5, MJB_ENC_UTF_8,
+                   "e\xCC\x81l\xCE\x87", 6, MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
+                   MJB_COLLATION_TERTIARY),
+        0, "Compare decomposes before matching contractions")
+
+    // A segment longer than the comparison window falls back to full sort keys.
+    char marks[2 + 40 * 2 + 1] = "a";
+    size_t marks_length = 1;
+
+    for(size_t i = 0; i < 40; ++i) {
+        marks[marks_length++] = '\xCC';
+        marks[marks_length++] = (char)(i % 2 ? 0x81 : 0xA3);
+    }
+
+    marks[marks_length++] = 'b';
+    ATT_ASSERT(test_collation_compare(marks, marks_length, MJB_ENC_UTF_8, marks, marks_length,
+                   MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY),
+        0, "Compare falls back for long combining sequences")
+    ATT_ASSERT(test_collation_compare(marks, marks_length, MJB_ENC_UTF_8, "ab", 2, MJB_ENC_UTF_8,
+                   MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_SECONDARY),
+        1, "Compare orders long combining sequences")
+
     // UCA conformance tests
     run_collation_test_file("./utils/generate/unicode-data/collation/CollationTest/"
                             "CollationTest_NON_IGNORABLE.txt",
@@ -639,6 +1025,12 @@ int test_collation(void *arg) {
                           MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY, &order),
         MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled collation comparison reports feature status")
 
+    mjb_collator collator;
+    ATT_ASSERT_STATUS(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+                          MJB_COLLATION_TERTIARY),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled collator reports feature status")
+    mjb_collator_free(&collator);
+
     return 0;
 }
 
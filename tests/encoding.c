@@ -202,6 +202,38 @@ int test_encoding(void *arg) {
     ATT_ASSERT(mjb_is_utf8(utf8_test, strlen(utf8_test)), true,
         "Various Unicode punctuation and symbols")
 
+    // Non-ASCII bytes at every position of a long string, across the bulk ASCII blocks.
+    char long_test[40];
+    bool ascii_rejected = true;
+    bool utf8_accepted = true;
+    bool continuation_rejected = true;
+    bool truncated_rejected = true;
+
+    for(size_t i = 0; i + 2 <= sizeof(long_test); ++i) {
+        memset(long_test, 'a', sizeof(long_test));
+        long_test[i] = '\xC3';
+        long_test[i + 1] = '\xA9';
+        ascii_rejected = ascii_rejected && !mjb_is_ascii(long_test, sizeof(long_test));
+        utf8_accepted = utf8_accepted && mjb_is_utf8(long_test, sizeof(long_test));
+
+        long_test[i] = '\x80';
+        continuation_rejected = continuation_rejected &&
+            !mjb_is_utf8(long_test, sizeof(long_test));
+
+        long_test[i] = 'a';
+        long_test[i + 1] = 'a';
+        long_test[sizeof(long_test) - 1] = '\xE2';
+        truncated_rejected = truncated_rejected && !mjb_is_utf8(long_test, sizeof(long_test)) &&
+            !mjb_is_utf8(long_test + i, sizeof(long_test) - i);
+    }
+
+    MJB_TEST_COVERAGE(mjb_is_ascii);
+    ATT_ASSERT(ascii_rejected, true, "ASCII rejects a non-ASCII byte at any position")
+    MJB_TEST_COVERAGE(mjb_is_utf8);
+    ATT_ASSERT(utf8_accepted, true, "UTF-8 accepts a 2-byte sequence at any position")
+    ATT_ASSERT(continuation_rejected, true, "UTF-8 rejects a lone continuation at any position")
+    ATT_ASSERT(truncated_rejected, true, "UTF-8 rejects a truncated trailing sequence")
+
     // UTF-16 tests
     ATT_ASSERT(mjb_is_utf16(NULL, 0), false, "Void UTF-16 string")
     ATT_ASSERT(mjb_is_utf16("", 0), false, "Empty UTF-16 string")
@@ -73,6 +73,130 @@ int test_example(void *arg) {
     ATT_ASSERT(test_buffer, "NFC payload (no terminator): Café", "mjb_normalize_into test failed") // Added by the script
 }
 
+{
+    // Example for mjb_normalizer_init
+    MJB_TEST_COVERAGE(mjb_normalizer_init); // Added by the script
+    mjb_normalizer normalizer;
+
+    if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+        MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_normalizer_init test failed") // Added by the script
+        return 1;
+    }
+
+    bool nfd = normalizer.form == MJB_NORMALIZATION_NFD;
+    mjb_normalizer_free(&normalizer);
+
+    // Normalizer form is NFD: yes
+    // printf("Normalizer form is NFD: %s", nfd ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Normalizer form is NFD: %s", nfd ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Normalizer form is NFD: yes", "mjb_normalizer_init test failed") // Added by the script
+}
+
+{
+    // Example for mjb_normalizer_free
+    MJB_TEST_COVERAGE(mjb_normalizer_free); // Added by the script
+    mjb_normalizer normalizer;
+
+    if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+        MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_normalizer_free test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_normalizer_free(&normalizer);
+
+    // Normalizer released: yes
+    // printf("Normalizer released: %s", normalizer.state == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Normalizer released: %s", normalizer.state == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Normalizer released: yes", "mjb_normalizer_free test failed") // Added by the script
+}
+
+{
+    // Example for mjb_normalizer_feed
+    MJB_TEST_COVERAGE(mjb_normalizer_feed); // Added by the script
+    mjb_normalizer normalizer;
+    char output[16];
+    size_t written = 0;
+    size_t size = sizeof(output);
+
+    if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+        MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_normalizer_feed test failed") // Added by the script
+        return 1;
+    }
+
+    // The combining acute accent arrives in the second chunk.
+    if(mjb_normalizer_feed(&normalizer, "Cafe", 4, output, &size) != MJB_STATUS_OK) {
+        mjb_normalizer_free(&normalizer);
+        ATT_ASSERT(0, 1, "mjb_normalizer_feed test failed") // Added by the script
+        return 1;
+    }
+
+    written = size;
+    size = sizeof(output) - written;
+
+    if(mjb_normalizer_feed(&normalizer, "\xCC\x81", 2, output + written,
+        &size) != MJB_STATUS_OK) {
+        mjb_normalizer_free(&normalizer);
+        ATT_ASSERT(0, 1, "mjb_normalizer_feed test failed") // Added by the script
+        return 1;
+    }
+
+    written += size;
+    size = sizeof(output) - written;
+
+    if(mjb_normalizer_finish(&normalizer, output + written, &size) != MJB_STATUS_OK) {
+        mjb_normalizer_free(&normalizer);
+        ATT_ASSERT(0, 1, "mjb_normalizer_feed test failed") // Added by the script
+        return 1;
+    }
+
+    written += size;
+    mjb_normalizer_free(&normalizer);
+
+    // NFC stream: Café
+    // printf("NFC stream: %.*s", (int)written, output);
+    snprintf(test_buffer, sizeof(test_buffer), "NFC stream: %.*s", (int)written, output); // Added by the script
+    ATT_ASSERT(test_buffer, "NFC stream: Café", "mjb_normalizer_feed test failed") // Added by the script
+}
+
+{
+    // Example for mjb_normalizer_finish
+    MJB_TEST_COVERAGE(mjb_normalizer_finish); // Added by the script
+    mjb_normalizer normalizer;
+    char output[8];
+    size_t size = 0;
+
+    if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+        MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_normalizer_finish test failed") // Added by the script
+        return 1;
+    }
+
+    // The last character waits for a combining mark that never comes.
+    if(mjb_normalizer_feed(&normalizer, "\xC3\xA9", 2, NULL, &size) != MJB_STATUS_OK) {
+        mjb_normalizer_free(&normalizer);
+        ATT_ASSERT(0, 1, "mjb_normalizer_finish test failed") // Added by the script
+        return 1;
+    }
+
+    size = sizeof(output);
+
+    if(mjb_normalizer_finish(&normalizer, output, &size) != MJB_STATUS_OK) {
+        mjb_normalizer_free(&normalizer);
+        ATT_ASSERT(0, 1, "mjb_normalizer_finish test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_normalizer_free(&normalizer);
+
+    // Bytes written by finish: 3
+    // printf("Bytes written by finish: %zu", size);
+    snprintf(test_buffer, sizeof(test_buffer), "Bytes written by finish: %zu", size); // Added by the script
+    ATT_ASSERT(test_buffer, "Bytes written by finish: 3", "mjb_normalizer_finish test failed") // Added by the script
+}
+
 {
     // Example for mjb_filter
     MJB_TEST_COVERAGE(mjb_filter); // Added by the script
@@ -223,6 +347,162 @@ int test_example(void *arg) {
 }
 #endif // MJB_FEATURE_IDNA
 
+#if MJB_FEATURE_IDNA
+{
+    // Example for mjb_idna_context_init
+    MJB_TEST_COVERAGE(mjb_idna_context_init); // Added by the script
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context context;
+
+    if(mjb_idna_context_init(&context, scratch, sizeof(scratch)) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_idna_context_init test failed") // Added by the script
+        return 1;
+    }
+
+    size_t capacity = context.capacity;
+    mjb_idna_context_free(&context);
+
+    // Scratch capacity: 4096
+    // printf("Scratch capacity: %zu", capacity);
+    snprintf(test_buffer, sizeof(test_buffer), "Scratch capacity: %zu", capacity); // Added by the script
+    ATT_ASSERT(test_buffer, "Scratch capacity: 4096", "mjb_idna_context_init test failed") // Added by the script
+}
+#endif // MJB_FEATURE_IDNA
+
+{
+    // Example for mjb_idna_context_free
+    MJB_TEST_COVERAGE(mjb_idna_context_free); // Added by the script
+    mjb_idna_context context;
+
+    if(mjb_idna_context_init(&context, NULL, 0) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_idna_context_free test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_idna_context_free(&context);
+
+    // Context released: yes
+    // printf("Context released: %s", context.scratch == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Context released: %s", context.scratch == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Context released: yes", "mjb_idna_context_free test failed") // Added by the script
+}
+
+#if MJB_FEATURE_IDNA
+{
+    // Example for mjb_idna_context_to_ascii_into
+    MJB_TEST_COVERAGE(mjb_idna_context_to_ascii_into); // Added by the script
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context context;
+    mjb_idna_info info;
+    char output[64];
+    size_t output_size = sizeof(output);
+
+    if(mjb_idna_context_init(&context, scratch, sizeof(scratch)) != MJB_STATUS_OK ||
+        mjb_idna_context_to_ascii_into(&context, "b\xC3\xBC" "cher.example", MJB_NUL_TERMINATED,
+            MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size) != MJB_STATUS_OK) {
+        mjb_idna_context_free(&context);
+        ATT_ASSERT(0, 1, "mjb_idna_context_to_ascii_into test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_idna_context_free(&context);
+
+    // xn--bcher-kva.example
+    // printf("%.*s", (int)output_size, output);
+    snprintf(test_buffer, sizeof(test_buffer), "%.*s", (int)output_size, output); // Added by the script
+    ATT_ASSERT(test_buffer, "xn--bcher-kva.example", "mjb_idna_context_to_ascii_into test failed") // Added by the script
+}
+#endif // MJB_FEATURE_IDNA
+
+#if MJB_FEATURE_IDNA
+{
+    // Example for mjb_idna_context_to_unicode_into
+    MJB_TEST_COVERAGE(mjb_idna_context_to_unicode_into); // Added by the script
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context context;
+    mjb_idna_info info;
+    char output[64];
+    size_t output_size = sizeof(output);
+
+    if(mjb_idna_context_init(&context, scratch, sizeof(scratch)) != MJB_STATUS_OK ||
+        mjb_idna_context_to_unicode_into(&context, "xn--bcher-kva.example", MJB_NUL_TERMINATED,
+            MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size) != MJB_STATUS_OK) {
+        mjb_idna_context_free(&context);
+        ATT_ASSERT(0, 1, "mjb_idna_context_to_unicode_into test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_idna_context_free(&context);
+
+    // bücher.example
+    // printf("%.*s", (int)output_size, output);
+    snprintf(test_buffer, sizeof(test_buffer), "%.*s", (int)output_size, output); // Added by the script
+    ATT_ASSERT(test_buffer, "bücher.example", "mjb_idna_context_to_unicode_into test failed") // Added by the script
+}
+#endif // MJB_FEATURE_IDNA
+
+#if MJB_FEATURE_IDNA
+{
+    // Example for mjb_idna_to_ascii_batch
+    MJB_TEST_COVERAGE(mjb_idna_to_ascii_batch); // Added by the script
+    const char *domains[] = { "B\xC3\xBC" "cher.example", "WWW.Example.COM" };
+    mjb_idna_batch batch;
+
+    if(mjb_idna_to_ascii_batch(domains, NULL, 2, MJB_ENC_UTF_8, NULL, NULL, &batch) !=
+        MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_idna_to_ascii_batch test failed") // Added by the script
+        return 1;
+    }
+
+    char first[64];
+    snprintf(first, sizeof(first), "%.*s", (int)(batch.offsets[1] - batch.offsets[0]),
+        batch.domains);
+    mjb_idna_batch_free(&batch);
+
+    // xn--bcher-kva.example
+    // printf("%s", first);
+    snprintf(test_buffer, sizeof(test_buffer), "%s", first); // Added by the script
+    ATT_ASSERT(test_buffer, "xn--bcher-kva.example", "mjb_idna_to_ascii_batch test failed") // Added by the script
+}
+#endif // MJB_FEATURE_IDNA
+
+#if MJB_FEATURE_IDNA
+{
+    // Example for mjb_idna_to_ascii_lines
+    MJB_TEST_COVERAGE(mjb_idna_to_ascii_lines); // Added by the script
+    mjb_idna_batch batch;
+
+    if(mjb_idna_to_ascii_lines("a.example\r\nM\xC3\xBCnchen.DE\n", MJB_NUL_TERMINATED,
+        MJB_ENC_UTF_8, NULL, NULL, &batch) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_idna_to_ascii_lines test failed") // Added by the script
+        return 1;
+    }
+
+    char second[64];
+    snprintf(second, sizeof(second), "%.*s", (int)(batch.offsets[2] - batch.offsets[1]),
+        batch.domains + batch.offsets[1]);
+    size_t count = batch.count;
+    mjb_idna_batch_free(&batch);
+
+    // Domains: 2, second: xn--mnchen-3ya.de
+    // printf("Domains: %zu, second: %s", count, second);
+    snprintf(test_buffer, sizeof(test_buffer), "Domains: %zu, second: %s", count, second); // Added by the script
+    ATT_ASSERT(test_buffer, "Domains: 2, second: xn--mnchen-3ya.de", "mjb_idna_to_ascii_lines test failed") // Added by the script
+}
+#endif // MJB_FEATURE_IDNA
+
+{
+    // Example for mjb_idna_batch_free
+    MJB_TEST_COVERAGE(mjb_idna_batch_free); // Added by the script
+    mjb_idna_batch batch = { NULL, NULL, NULL, 0 };
+    mjb_idna_batch_free(&batch);
+
+    // Batch released: yes
+    // printf("Batch released: %s", batch.domains == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Batch released: %s", batch.domains == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Batch released: yes", "mjb_idna_batch_free test failed") // Added by the script
+}
+
 {
     // Example for mjb_normalization_quick_check
     MJB_TEST_COVERAGE(mjb_normalization_quick_check); // Added by the script
@@ -364,6 +644,45 @@ int test_example(void *arg) {
     ATT_ASSERT(test_buffer, "U+0041 uses the Latin script: yes", "mjb_codepoint_property_int test failed") // Added by the script
 }
 
+{
+    // Example for mjb_codepoints_property_int
+    MJB_TEST_COVERAGE(mjb_codepoints_property_int); // Added by the script
+    const mjb_codepoint codepoints[] = { 'A', 0x03A9, '1' };
+    int32_t scripts[3];
+
+    if(mjb_codepoints_property_int(codepoints, 3, MJB_PR_SCRIPT, scripts) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_codepoints_property_int test failed") // Added by the script
+        return 1;
+    }
+
+    bool expected = scripts[0] == MJB_SC_LATN && scripts[1] == MJB_SC_GREK &&
+        scripts[2] == MJB_SC_ZYYY;
+
+    // Latin, Greek, Common: yes
+    // printf("Latin, Greek, Common: %s", expected ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Latin, Greek, Common: %s", expected ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Latin, Greek, Common: yes", "mjb_codepoints_property_int test failed") // Added by the script
+}
+
+{
+    // Example for mjb_string_property_int
+    MJB_TEST_COVERAGE(mjb_string_property_int); // Added by the script
+    const char *input = "a\xCE\xA9"; // "a" + U+03A9 GREEK CAPITAL LETTER OMEGA
+    int32_t widths[2];
+    size_t count = 2;
+
+    if(mjb_string_property_int(input, strlen(input), MJB_ENC_UTF_8, MJB_PR_EAST_ASIAN_WIDTH,
+        widths, &count) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_string_property_int test failed") // Added by the script
+        return 1;
+    }
+
+    // U+03A9 is ambiguous: yes
+    // printf("U+03A9 is ambiguous: %s", widths[1] == MJB_EAW_AMBIGUOUS ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "U+03A9 is ambiguous: %s", widths[1] == MJB_EAW_AMBIGUOUS ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "U+03A9 is ambiguous: yes", "mjb_string_property_int test failed") // Added by the script
+}
+
 {
     // Example for mjb_codepoint_numeric_value
     MJB_TEST_COVERAGE(mjb_codepoint_numeric_value); // Added by the script
@@ -517,6 +836,26 @@ int test_example(void *arg) {
     ATT_ASSERT(test_buffer, "Canonical caseless match: yes", "mjb_caseless_match test failed") // Added by the script
 }
 
+{
+    // Example for mjb_caseless_hash
+    MJB_TEST_COVERAGE(mjb_caseless_hash); // Added by the script
+    uint64_t left;
+    uint64_t right;
+
+    if(mjb_caseless_hash("Stra\xC3\x9F" "e", MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+        MJB_CASELESS_CANONICAL, 0, &left) != MJB_STATUS_OK ||
+        mjb_caseless_hash("STRASSE", 7, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0,
+            &right) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_caseless_hash test failed") // Added by the script
+        return 1;
+    }
+
+    // Same hash: yes
+    // printf("Same hash: %s", left == right ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Same hash: %s", left == right ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Same hash: yes", "mjb_caseless_hash test failed") // Added by the script
+}
+
 #if MJB_FEATURE_COLLATION
 {
     // Example for mjb_collation_compare
@@ -586,6 +925,176 @@ int test_example(void *arg) {
 }
 #endif // MJB_FEATURE_COLLATION
 
+#if MJB_FEATURE_COLLATION
+{
+    // Example for mjb_collator_init
+    MJB_TEST_COVERAGE(mjb_collator_init); // Added by the script
+    mjb_collator collator;
+
+    if(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+        MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_init test failed") // Added by the script
+        return 1;
+    }
+
+    bool shifted = collator.variable_weighting == MJB_COLLATION_SHIFTED;
+    mjb_collator_free(&collator);
+
+    // Collator is shifted: yes
+    // printf("Collator is shifted: %s", shifted ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Collator is shifted: %s", shifted ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Collator is shifted: yes", "mjb_collator_init test failed") // Added by the script
+}
+#endif // MJB_FEATURE_COLLATION
+
+#if MJB_FEATURE_COLLATION
+{
+    // Example for mjb_collator_free
+    MJB_TEST_COVERAGE(mjb_collator_free); // Added by the script
+    mjb_collator collator;
+
+    if(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+        MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_free test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_collator_free(&collator);
+
+    // Collator released: yes
+    // printf("Collator released: %s", collator.keys[0] == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Collator released: %s", collator.keys[0] == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Collator released: yes", "mjb_collator_free test failed") // Added by the script
+}
+#endif // MJB_FEATURE_COLLATION
+
+#if MJB_FEATURE_COLLATION
+{
+    // Example for mjb_collator_compare
+    MJB_TEST_COVERAGE(mjb_collator_compare); // Added by the script
+    mjb_collator collator;
+    int order;
+
+    if(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+        MJB_COLLATION_PRIMARY) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_compare test failed") // Added by the script
+        return 1;
+    }
+
+    if(mjb_collator_compare(&collator, "r\xC3\xA9sum\xC3\xA9", 8, MJB_ENC_UTF_8,
+        "resume", 6, MJB_ENC_UTF_8, &order) != MJB_STATUS_OK) {
+        mjb_collator_free(&collator);
+        ATT_ASSERT(0, 1, "mjb_collator_compare test failed") // Added by the script
+        return 1;
+    }
+
+    // Equal at primary strength: yes
+    // printf("Equal at primary strength: %s", order == 0 ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Equal at primary strength: %s", order == 0 ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Equal at primary strength: yes", "mjb_collator_compare test failed") // Added by the script
+    mjb_collator_free(&collator);
+}
+#endif // MJB_FEATURE_COLLATION
+
+#if MJB_FEATURE_COLLATION
+{
+    // Example for mjb_collator_key
+    MJB_TEST_COVERAGE(mjb_collator_key); // Added by the script
+    mjb_collator collator;
+    mjb_result key;
+
+    if(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+        MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_key test failed") // Added by the script
+        return 1;
+    }
+
+    if(mjb_collator_key(&collator, "apple", 5, MJB_ENC_UTF_8, &key) != MJB_STATUS_OK) {
+        mjb_collator_free(&collator);
+        ATT_ASSERT(0, 1, "mjb_collator_key test failed") // Added by the script
+        return 1;
+    }
+
+    // Sort key is non-empty: yes
+    // printf("Sort key is non-empty: %s", key.output_size > 0 ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Sort key is non-empty: %s", key.output_size > 0 ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Sort key is non-empty: yes", "mjb_collator_key test failed") // Added by the script
+    mjb_result_free(&key);
+    mjb_collator_free(&collator);
+}
+#endif // MJB_FEATURE_COLLATION
+
+#if MJB_FEATURE_COLLATION
+{
+    // Example for mjb_collator_key_into
+    MJB_TEST_COVERAGE(mjb_collator_key_into); // Added by the script
+    const char *rows[] = { "banana", "apple", "cherry" };
+    unsigned char keys[3][64];
+    size_t key_sizes[3];
+    mjb_collator collator;
+
+    if(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+        MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_key_into test failed") // Added by the script
+        return 1;
+    }
+
+    for(size_t i = 0; i < 3; ++i) {
+        key_sizes[i] = sizeof(keys[i]);
+
+        if(mjb_collator_key_into(&collator, rows[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+            keys[i], &key_sizes[i]) != MJB_STATUS_OK) {
+            break;
+        }
+    }
+
+    mjb_collator_free(&collator);
+    size_t common = key_sizes[1] < key_sizes[0] ? key_sizes[1] : key_sizes[0];
+
+    // apple sorts before banana: yes
+    // printf("apple sorts before banana: %s", memcmp(keys[1], keys[0], common) < 0 ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "apple sorts before banana: %s", memcmp(keys[1], keys[0], common) < 0 ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "apple sorts before banana: yes", "mjb_collator_key_into test failed") // Added by the script
+}
+#endif // MJB_FEATURE_COLLATION
+
+#if MJB_FEATURE_COLLATION
+{
+    // Example for mjb_collator_keys_into
+    MJB_TEST_COVERAGE(mjb_collator_keys_into); // Added by the script
+    const char *rows[] = { "banana", "apple", "cherry" };
+    unsigned char arena[256];
+    size_t arena_size = sizeof(arena);
+    size_t offsets[4];
+    mjb_collator collator;
+
+    if(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+        MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_keys_into test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_status status = mjb_collator_keys_into(&collator, rows, NULL, 3, MJB_ENC_UTF_8, arena,
+        &arena_size, offsets);
+    mjb_collator_free(&collator);
+
+    if(status != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_collator_keys_into test failed") // Added by the script
+        return 1;
+    }
+
+    size_t apple = offsets[2] - offsets[1];
+    size_t banana = offsets[1] - offsets[0];
+    size_t common = apple < banana ? apple : banana;
+    bool before = memcmp(arena + offsets[1], arena, common) < 0;
+
+    // apple sorts before banana: yes
+    // printf("apple sorts before banana: %s", before ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "apple sorts before banana: %s", before ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "apple sorts before banana: yes", "mjb_collator_keys_into test failed") // Added by the script
+}
+#endif // MJB_FEATURE_COLLATION
+
 {
     // Example for mjb_map_case
     MJB_TEST_COVERAGE(mjb_map_case); // Added by the script
@@ -914,6 +1423,25 @@ int test_example(void *arg) {
     ATT_ASSERT(test_buffer, "Six columns include 6 bytes", "mjb_truncate_word_width test failed") // Added by the script
 }
 
+{
+    // Example for mjb_segment
+    MJB_TEST_COVERAGE(mjb_segment); // Added by the script
+    const char *input = "Hello, world!";
+    size_t offsets[8];
+    size_t count = 8;
+
+    if(mjb_segment(input, strlen(input), MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets,
+        &count) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_segment test failed") // Added by the script
+        return 1;
+    }
+
+    // 5 word segments, the second ends at byte 6
+    // printf("%zu word segments, the second ends at byte %zu", count, offsets[1]);
+    snprintf(test_buffer, sizeof(test_buffer), "%zu word segments, the second ends at byte %zu", count, offsets[1]); // Added by the script
+    ATT_ASSERT(test_buffer, "5 word segments, the second ends at byte 6", "mjb_segment test failed") // Added by the script
+}
+
 {
     // Example for mjb_bidi_resolve
     MJB_TEST_COVERAGE(mjb_bidi_resolve); // Added by the script
@@ -997,6 +1525,118 @@ int test_example(void *arg) {
     ATT_ASSERT(test_buffer, "Paragraph released: yes", "mjb_bidi_paragraph_free test failed") // Added by the script
 }
 
+{
+    // Example for mjb_bidi_workspace_init
+    MJB_TEST_COVERAGE(mjb_bidi_workspace_init); // Added by the script
+    mjb_bidi_workspace workspace;
+
+    if(mjb_bidi_workspace_init(&workspace) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_bidi_workspace_init test failed") // Added by the script
+        return 1;
+    }
+
+    size_t capacity = workspace.capacity;
+    mjb_bidi_workspace_free(&workspace);
+
+    // Initial capacity: 0
+    // printf("Initial capacity: %zu", capacity);
+    snprintf(test_buffer, sizeof(test_buffer), "Initial capacity: %zu", capacity); // Added by the script
+    ATT_ASSERT(test_buffer, "Initial capacity: 0", "mjb_bidi_workspace_init test failed") // Added by the script
+}
+
+{
+    // Example for mjb_bidi_workspace_free
+    MJB_TEST_COVERAGE(mjb_bidi_workspace_free); // Added by the script
+    mjb_bidi_workspace workspace;
+    mjb_bidi_paragraph paragraph;
+
+    if(mjb_bidi_workspace_init(&workspace) != MJB_STATUS_OK ||
+        mjb_bidi_workspace_resolve(&workspace, "abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR,
+            &paragraph) != MJB_STATUS_OK) {
+        mjb_bidi_workspace_free(&workspace);
+        ATT_ASSERT(0, 1, "mjb_bidi_workspace_free test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_bidi_workspace_free(&workspace);
+
+    // Workspace released: yes
+    // printf("Workspace released: %s", workspace.chars == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Workspace released: %s", workspace.chars == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Workspace released: yes", "mjb_bidi_workspace_free test failed") // Added by the script
+}
+
+{
+    // Example for mjb_bidi_workspace_resolve
+    MJB_TEST_COVERAGE(mjb_bidi_workspace_resolve); // Added by the script
+    const char *lines[] = { "abc", "\xD7\x90\xD7\x91 12", "xyz" }; // אב 12
+    mjb_bidi_workspace workspace;
+    mjb_bidi_paragraph paragraph;
+    size_t rtl_lines = 0;
+
+    if(mjb_bidi_workspace_init(&workspace) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_bidi_workspace_resolve test failed") // Added by the script
+        return 1;
+    }
+
+    for(size_t i = 0; i < 3; ++i) {
+        if(mjb_bidi_workspace_resolve(&workspace, lines[i], strlen(lines[i]), MJB_ENC_UTF_8,
+            MJB_DIRECTION_AUTO, &paragraph) != MJB_STATUS_OK) {
+            mjb_bidi_workspace_free(&workspace);
+            return 1;
+        }
+
+        rtl_lines += paragraph.direction == MJB_DIRECTION_RTL;
+    }
+
+    mjb_bidi_workspace_free(&workspace);
+
+    // Right-to-left lines: 1
+    // printf("Right-to-left lines: %zu", rtl_lines);
+    snprintf(test_buffer, sizeof(test_buffer), "Right-to-left lines: %zu", rtl_lines); // Added by the script
+    ATT_ASSERT(test_buffer, "Right-to-left lines: 1", "mjb_bidi_workspace_resolve test failed") // Added by the script
+}
+
+{
+    // Example for mjb_bidi_resolve_document
+    MJB_TEST_COVERAGE(mjb_bidi_resolve_document); // Added by the script
+    mjb_bidi_document document;
+
+    if(mjb_bidi_resolve_document("abc\n\xD7\x90\xD7\x91", MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+        MJB_DIRECTION_AUTO, NULL, NULL, &document) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_bidi_resolve_document test failed") // Added by the script
+        return 1;
+    }
+
+    size_t paragraphs = document.paragraph_count;
+    uint8_t level = document.paragraphs[1].paragraph_level;
+    mjb_bidi_document_free(&document);
+
+    // Paragraphs: 2, second level: 1
+    // printf("Paragraphs: %zu, second level: %u", paragraphs, (unsigned)level);
+    snprintf(test_buffer, sizeof(test_buffer), "Paragraphs: %zu, second level: %u", paragraphs, (unsigned)level); // Added by the script
+    ATT_ASSERT(test_buffer, "Paragraphs: 2, second level: 1", "mjb_bidi_resolve_document test failed") // Added by the script
+}
+
+{
+    // Example for mjb_bidi_document_free
+    MJB_TEST_COVERAGE(mjb_bidi_document_free); // Added by the script
+    mjb_bidi_document document;
+
+    if(mjb_bidi_resolve_document("abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR, NULL, NULL,
+        &document) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_bidi_document_free test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_bidi_document_free(&document);
+
+    // Document released: yes
+    // printf("Document released: %s", document.chars == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Document released: %s", document.chars == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Document released: yes", "mjb_bidi_document_free test failed") // Added by the script
+}
+
 {
     // Example for mjb_codepoint_is_id_start
     MJB_TEST_COVERAGE(mjb_codepoint_is_id_start); // Added by the script
@@ -1185,6 +1825,176 @@ int test_example(void *arg) {
 }
 #endif // MJB_FEATURE_SECURITY
 
+#if MJB_FEATURE_SECURITY
+{
+    // Example for mjb_confusable_index_init
+    MJB_TEST_COVERAGE(mjb_confusable_index_init); // Added by the script
+    mjb_confusable_index index;
+
+    if(mjb_confusable_index_init(&index) != MJB_STATUS_OK) {
+        ATT_ASSERT(0, 1, "mjb_confusable_index_init test failed") // Added by the script
+        return 1;
+    }
+
+    size_t count = index.count;
+    mjb_confusable_index_free(&index);
+
+    // Empty index: yes
+    // printf("Empty index: %s", count == 0 ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Empty index: %s", count == 0 ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Empty index: yes", "mjb_confusable_index_init test failed") // Added by the script
+}
+#endif // MJB_FEATURE_SECURITY
+
+#if MJB_FEATURE_SECURITY
+{
+    // Example for mjb_confusable_index_free
+    MJB_TEST_COVERAGE(mjb_confusable_index_free); // Added by the script
+    mjb_confusable_index index;
+
+    if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK) {
+        mjb_confusable_index_free(&index);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_free test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_confusable_index_free(&index);
+
+    // Index released: yes
+    // printf("Index released: %s", index.slots == NULL ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Index released: %s", index.slots == NULL ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Index released: yes", "mjb_confusable_index_free test failed") // Added by the script
+}
+#endif // MJB_FEATURE_SECURITY
+
+#if MJB_FEATURE_SECURITY
+{
+    // Example for mjb_confusable_index_add
+    MJB_TEST_COVERAGE(mjb_confusable_index_add); // Added by the script
+    mjb_confusable_index index;
+
+    if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&index, "google", 6, MJB_ENC_UTF_8, 2) != MJB_STATUS_OK) {
+        mjb_confusable_index_free(&index);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_add test failed") // Added by the script
+        return 1;
+    }
+
+    size_t count = index.count;
+    mjb_confusable_index_free(&index);
+
+    // 2 reference strings
+    // printf("%zu reference strings", count);
+    snprintf(test_buffer, sizeof(test_buffer), "%zu reference strings", count); // Added by the script
+    ATT_ASSERT(test_buffer, "2 reference strings", "mjb_confusable_index_add test failed") // Added by the script
+}
+#endif // MJB_FEATURE_SECURITY
+
+#if MJB_FEATURE_SECURITY
+{
+    // Example for mjb_confusable_index_find
+    MJB_TEST_COVERAGE(mjb_confusable_index_find); // Added by the script
+    mjb_confusable_index index;
+
+    if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&index, "google", 6, MJB_ENC_UTF_8, 2) != MJB_STATUS_OK) {
+        mjb_confusable_index_free(&index);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_find test failed") // Added by the script
+        return 1;
+    }
+
+    const char *candidate = "p\xD0\xB0ypal"; // Cyrillic а
+    uint32_t ids[4];
+    size_t count = 4;
+    mjb_status status = mjb_confusable_index_find(&index, candidate, strlen(candidate),
+        MJB_ENC_UTF_8, ids, &count);
+    mjb_confusable_index_free(&index);
+
+    if(status != MJB_STATUS_OK || count != 1) {
+        ATT_ASSERT(0, 1, "mjb_confusable_index_find test failed") // Added by the script
+        return 1;
+    }
+
+    // Confusable with reference 1
+    // printf("Confusable with reference %u", ids[0]);
+    snprintf(test_buffer, sizeof(test_buffer), "Confusable with reference %u", ids[0]); // Added by the script
+    ATT_ASSERT(test_buffer, "Confusable with reference 1", "mjb_confusable_index_find test failed") // Added by the script
+}
+#endif // MJB_FEATURE_SECURITY
+
+#if MJB_FEATURE_SECURITY
+{
+    // Example for mjb_confusable_index_serialize
+    MJB_TEST_COVERAGE(mjb_confusable_index_serialize); // Added by the script
+    mjb_confusable_index index;
+    size_t size = 0;
+
+    if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+        mjb_confusable_index_serialize(&index, NULL, &size) != MJB_STATUS_OK) {
+        mjb_confusable_index_free(&index);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_serialize test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_confusable_index_free(&index);
+
+    // Image has a header: yes
+    // printf("Image has a header: %s", size > 32 ? "yes" : "no");
+    snprintf(test_buffer, sizeof(test_buffer), "Image has a header: %s", size > 32 ? "yes" : "no"); // Added by the script
+    ATT_ASSERT(test_buffer, "Image has a header: yes", "mjb_confusable_index_serialize test failed") // Added by the script
+}
+#endif // MJB_FEATURE_SECURITY
+
+#if MJB_FEATURE_SECURITY
+{
+    // Example for mjb_confusable_index_open
+    MJB_TEST_COVERAGE(mjb_confusable_index_open); // Added by the script
+    mjb_confusable_index built;
+    size_t size = 0;
+
+    if(mjb_confusable_index_init(&built) != MJB_STATUS_OK ||
+        mjb_confusable_index_add(&built, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+        mjb_confusable_index_serialize(&built, NULL, &size) != MJB_STATUS_OK) {
+        mjb_confusable_index_free(&built);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_open test failed") // Added by the script
+        return 1;
+    }
+
+    uint32_t *data = (uint32_t *)malloc(size);
+
+    if(data == NULL || mjb_confusable_index_serialize(&built, data, &size) != MJB_STATUS_OK) {
+        free(data);
+        mjb_confusable_index_free(&built);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_open test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_confusable_index_free(&built);
+    mjb_confusable_index opened;
+    uint32_t ids[1];
+    size_t count = 1;
+
+    if(mjb_confusable_index_open(&opened, data, size) != MJB_STATUS_OK ||
+        mjb_confusable_index_find(&opened, "paypa1", 6, MJB_ENC_UTF_8, ids, &count) != MJB_STATUS_OK) {
+        free(data);
+        ATT_ASSERT(0, 1, "mjb_confusable_index_open test failed") // Added by the script
+        return 1;
+    }
+
+    mjb_confusable_index_free(&opened);
+    free(data);
+
+    // Found reference 1
+    // printf("Found reference %u", ids[0]);
+    snprintf(test_buffer, sizeof(test_buffer), "Found reference %u", ids[0]); // Added by the script
+    ATT_ASSERT(test_buffer, "Found reference 1", "mjb_confusable_index_open test failed") // Added by the script
+}
+#endif // MJB_FEATURE_SECURITY
+
 {
     // Example for mjb_codepoint_emoji_properties
     MJB_TEST_COVERAGE(mjb_codepoint_emoji_properties); // Added by the script
@@ -142,5 +142,18 @@ int test_cpp_break(void *arg) {
     ATT_ASSERT((int)rtl.direction(), MJB_DIRECTION_RTL, "BidiParagraph RTL direction")
     ATT_ASSERT(rtl_order[0], 2u, "BidiParagraph RTL visual order")
 
+    mjb::BidiWorkspace workspace;
+    ATT_ASSERT((int)workspace.resolve(hebrew).direction, MJB_DIRECTION_RTL,
+        "BidiWorkspace::resolve RTL line")
+    const mjb_bidi_paragraph &line = workspace.resolve("abcd");
+    ATT_ASSERT(line.count, (size_t)4, "BidiWorkspace::resolve reuses the workspace")
+    ATT_ASSERT((int)line.direction, MJB_DIRECTION_LTR, "BidiWorkspace::resolve LTR line")
+
+    const mjb::BidiDocument document("abc\n" + hebrew);
+    ATT_ASSERT(document.size(), 2u, "BidiDocument::size")
+    ATT_ASSERT((int)document[0].direction, MJB_DIRECTION_LTR, "BidiDocument first paragraph")
+    ATT_ASSERT((int)document.at(1).direction, MJB_DIRECTION_RTL, "BidiDocument::at")
+    ATT_ASSERT(document[1].chars[0].byte_offset, 4u, "BidiDocument document offsets")
+
     return 0;
 }
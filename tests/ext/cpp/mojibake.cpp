@@ -25,6 +25,17 @@ int test_cpp_mojibake(void *arg) {
     ATT_ASSERT(mjb::property_int(U'A', MJB_PR_SCRIPT).value_or(0), MJB_SC_LATN,
         "C++ typed enumerated property")
 
+    const auto batch_scripts = mjb::property_int(std::vector<mjb_codepoint>{ U'A', U'\u03A9' },
+        MJB_PR_SCRIPT);
+
+    ATT_ASSERT(batch_scripts.size(), 2u, "C++ batch property count")
+    ATT_ASSERT(batch_scripts[1], MJB_SC_GREK, "C++ batch property Greek")
+
+    const auto string_scripts = mjb::property_int("a\xCE\xA9", MJB_PR_SCRIPT);
+
+    ATT_ASSERT(string_scripts.size(), 2u, "C++ string property count")
+    ATT_ASSERT(string_scripts[0], MJB_SC_LATN, "C++ string property Latin")
+
     const auto script_extensions = mjb::script_extensions(U'\u30FC');
 
     ATT_ASSERT(script_extensions.size(), 2u, "C++ Script_Extensions count")
@@ -112,6 +123,20 @@ int test_cpp_mojibake(void *arg) {
     ATT_ASSERT(mjb::confusable_match("a", "b"), false, "is_confusable: a / b")
     ATT_ASSERT(mjb::confusable_skeleton("h\xD0\xB5llo"), std::string("hello"),
         "confusable_skeleton")
+
+    mjb::ConfusableIndex confusable_index;
+    confusable_index.add("paypal", 1);
+    confusable_index.add("google", 2);
+    ATT_ASSERT(confusable_index.size(), (size_t)2, "ConfusableIndex: size")
+    ATT_ASSERT(confusable_index.find("p\xD0\xB0ypal") == std::vector<uint32_t>{ 1 }, true,
+        "ConfusableIndex: find Cyrillic a")
+    ATT_ASSERT(confusable_index.find("apple").empty(), true, "ConfusableIndex: find miss")
+
+    const std::vector<uint32_t> confusable_image = confusable_index.serialize();
+    mjb::ConfusableIndex opened_index = mjb::ConfusableIndex::open(confusable_image.data(),
+        confusable_image.size() * sizeof(uint32_t));
+    ATT_ASSERT(opened_index.find("goog1e") == std::vector<uint32_t>{ 2 }, true,
+        "ConfusableIndex: find in opened image")
 #else
     bool confusables_disabled = false;
 
@@ -140,6 +165,17 @@ int test_cpp_mojibake(void *arg) {
     ATT_ASSERT(idna_invalid.valid(), false, "C++ IDNA reports invalid domain")
     ATT_ASSERT(idna_invalid.has_error(MJB_IDNA_ERROR_EMPTY_LABEL), true,
         "C++ IDNA exposes error flags")
+
+    const mjb::IdnaBatch idna_batch({ "WWW.Example.COM", "a..b" });
+    ATT_ASSERT(idna_batch.size(), 2u, "C++ IdnaBatch::size")
+    ATT_ASSERT(std::string(idna_batch[0]), std::string("www.example.com"), "C++ IdnaBatch domain")
+    ATT_ASSERT((idna_batch.errors(1) & MJB_IDNA_ERROR_EMPTY_LABEL) != 0, true,
+        "C++ IdnaBatch::errors")
+
+    const auto idna_lines = mjb::IdnaBatch::lines("a.example\nxn--bcher-kva.example\n");
+    ATT_ASSERT(idna_lines.size(), 2u, "C++ IdnaBatch::lines size")
+    ATT_ASSERT(std::string(idna_lines[1]), std::string("xn--bcher-kva.example"),
+        "C++ IdnaBatch::lines domain")
 #else
     bool idna_disabled = false;
 
@@ -185,6 +221,25 @@ int test_cpp_mojibake(void *arg) {
         mjb::collation_key("a", mjb::CollationVariableWeighting::NonIgnorable,
             mjb::CollationStrength::Secondary),
         "collation_key: secondary ignores case")
+
+    mjb::Collator collator(mjb::CollationVariableWeighting::NonIgnorable,
+        mjb::CollationStrength::Primary);
+    std::string collator_key;
+    collator.key_into("banana", collator_key);
+    ATT_ASSERT(collator_key, mjb::collation_key("banana",
+        mjb::CollationVariableWeighting::NonIgnorable, mjb::CollationStrength::Primary),
+        "Collator: key_into matches collation_key")
+    ATT_ASSERT(collator.key("a") < collator.key("b"), true, "Collator: a < b")
+    ATT_ASSERT(collator.compare("r\xC3\xA9sum\xC3\xA9", "resume"), 0,
+        "Collator: primary ignores accents")
+
+    std::string arena;
+    std::vector<size_t> offsets;
+    collator.keys_into({ "banana", "", "apple" }, arena, offsets);
+    ATT_ASSERT(offsets.size(), 4u, "Collator: keys_into offsets")
+    ATT_ASSERT(arena.substr(offsets[2], offsets[3] - offsets[2]), collator.key("apple"),
+        "Collator: keys_into matches key")
+    ATT_ASSERT(offsets[2] - offsets[1], 0u, "Collator: keys_into empty key")
 #else
     bool collation_disabled = false;
 
@@ -211,6 +266,11 @@ int test_cpp_mojibake(void *arg) {
     ATT_ASSERT(mjb::sentence_count(""), (size_t)0, "sentence_count: empty")
     ATT_ASSERT(mjb::word_count("Hello, world! It works."), (size_t)4, "word_count: four words")
     ATT_ASSERT(mjb::word_count(""), (size_t)0, "word_count: empty")
+
+    const std::vector<size_t> words = mjb::segment("Hello world", MJB_SEGMENT_WORD);
+    ATT_ASSERT(words.size(), (size_t)3, "segment: three word segments")
+    ATT_ASSERT(words[1], (size_t)6, "segment: space ends at 6")
+    ATT_ASSERT(mjb::segment("", MJB_SEGMENT_LINE).empty(), true, "segment: empty")
     ATT_ASSERT(mjb::grapheme_count("a\xCC\x81"), (size_t)1, "grapheme_count: combining mark")
     ATT_ASSERT(mjb::grapheme_count("\xF0\x9F\x87\xAE\xF0\x9F\x87\xB9"), (size_t)1,
         "grapheme_count: flag emoji")
@@ -24,6 +24,18 @@ int test_cpp_normalization(void *arg) {
 
     ATT_ASSERT((int)mjb::normalization_quick_check("a", mjb::NormalizationForm::NFC),
         MJB_QC_YES, "normalization_quick_check")
+
+    mjb::Normalizer normalizer(mjb::NormalizationForm::NFC);
+    std::string streamed;
+    normalizer.feed("Caf", streamed);
+    normalizer.feed("e\xCC", streamed);
+    normalizer.feed("\x81!", streamed);
+    normalizer.finish(streamed);
+    ATT_ASSERT(streamed, std::string("Caf\xC3\xA9!"), "Normalizer: chunks split a sequence")
+    streamed.clear();
+    normalizer.feed("e\xCC\x81", streamed);
+    normalizer.finish(streamed);
+    ATT_ASSERT(streamed, std::string("\xC3\xA9"), "Normalizer: second stream")
     ATT_ASSERT(mjb::filter("a  b", MJB_FILTER_COLLAPSE_SPACES), std::string("a b"),
         "filter")
     ATT_ASSERT(mjb::filter("a\x01  b", mjb::Filter::Controls | mjb::Filter::CollapseSpaces),
@@ -37,6 +49,8 @@ int test_cpp_normalization(void *arg) {
     ATT_ASSERT(mjb::caseless_match("Stra\xC3\x9F" "e", "STRASSE"), true, "caseless_match")
     ATT_ASSERT(mjb::caseless_match("\xC3\x85", "A\xCC\x8A", mjb::CaselessMode::Unnormalized),
         false, "caseless_match unnormalized")
+    ATT_ASSERT(mjb::caseless_hash("Stra\xC3\x9F" "e") == mjb::caseless_hash("STRASSE"), true,
+        "caseless_hash")
     ATT_ASSERT(mjb::caseless_match("\xC3\x85", "A\xCC\x8A"), true,
         "caseless_match canonical")
 
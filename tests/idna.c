@@ -304,6 +304,123 @@ static void test_idna_api(void) {
     ATT_ASSERT((int)memcmp(output, unicode, output_size), 0, "IDNA ToUnicode into output")
     ATT_ASSERT(output[output_size], '#', "IDNA ToUnicode into omits terminator")
 
+    // Lowercase LDH domains skip mapping, normalization and Punycode.
+    const char *hostname = "WWW.Example-1.COM";
+    mjb_test_allocator_fail_after(1);
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii(hostname, MJB_NUL_TERMINATED, MJB_ENC_UTF_8, MJB_ENC_UTF_8,
+                          &info, &result),
+        MJB_STATUS_OK, "IDNA ToASCII of an LDH domain allocates only its result")
+    mjb_test_allocator_reset();
+    ATT_ASSERT(info.errors, (uint32_t)MJB_IDNA_ERROR_NONE, "IDNA LDH domain is valid")
+    ATT_ASSERT(result.output_size, strlen(hostname), "IDNA LDH domain size")
+    ATT_ASSERT((int)memcmp(result.output, "www.example-1.com", result.output_size), 0,
+        "IDNA LDH domain is lowercased")
+    ATT_ASSERT_STATUS(mjb_result_free(&result), MJB_STATUS_OK, "IDNA LDH result frees")
+
+    memset(output, '#', sizeof(output));
+    output_size = sizeof(output);
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_idna_to_unicode_into(hostname, strlen(hostname), MJB_ENC_ASCII,
+                          MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_OK, "IDNA into does not allocate for an LDH domain")
+    mjb_test_allocator_reset();
+    ATT_ASSERT(output_size, strlen(hostname), "IDNA LDH into size")
+    ATT_ASSERT((int)memcmp(output, "www.example-1.com", output_size), 0, "IDNA LDH into output")
+    ATT_ASSERT(output[output_size], '#', "IDNA LDH into omits terminator")
+
+    small_size = 4;
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_into(hostname, strlen(hostname), MJB_ENC_UTF_8,
+                          MJB_ENC_UTF_8, &info, output, &small_size),
+        MJB_STATUS_OUTPUT_TOO_SMALL, "IDNA LDH into reports small buffer")
+    ATT_ASSERT(small_size, strlen(hostname), "IDNA LDH into returns required size")
+
+    // Labels the checks would flag still take the full path.
+    ATT_ASSERT_STATUS(mjb_idna_to_unicode("XN--BCHER-KVA.example", MJB_NUL_TERMINATED,
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, &result),
+        MJB_STATUS_OK, "IDNA decodes an uppercase ACE label")
+    ATT_ASSERT(result.output_size, strlen(unicode), "IDNA uppercase ACE label size")
+    ATT_ASSERT((int)memcmp(result.output, unicode, result.output_size), 0,
+        "IDNA uppercase ACE label output")
+    ATT_ASSERT_STATUS(mjb_result_free(&result), MJB_STATUS_OK, "IDNA uppercase ACE result frees")
+
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii("-a.b", 4, MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, &result),
+        MJB_STATUS_OK, "IDNA converts a leading hyphen")
+    ATT_ASSERT((info.errors & MJB_IDNA_ERROR_HYPHEN) != 0, true, "IDNA reports a leading hyphen")
+    ATT_ASSERT_STATUS(mjb_result_free(&result), MJB_STATUS_OK, "IDNA hyphen result frees")
+
+    // A context converts domains in its scratch without touching the heap.
+    char scratch[MJB_IDNA_SCRATCH_SIZE];
+    mjb_idna_context context;
+    ATT_ASSERT_STATUS(mjb_idna_context_init(&context, scratch, sizeof(scratch)), MJB_STATUS_OK,
+        "IDNA context init")
+    output_size = sizeof(output);
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_idna_context_to_ascii_into(&context, unicode, strlen(unicode),
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_OK, "IDNA context ToASCII does not allocate")
+    ATT_ASSERT(output_size, strlen(ascii), "IDNA context ToASCII size")
+    ATT_ASSERT((int)memcmp(output, ascii, output_size), 0, "IDNA context ToASCII output")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_idna_context_to_unicode_into(&context, ascii, strlen(ascii),
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_OK, "IDNA context ToUnicode does not allocate")
+    ATT_ASSERT(output_size, strlen(unicode), "IDNA context ToUnicode size")
+    ATT_ASSERT((int)memcmp(output, unicode, output_size), 0, "IDNA context ToUnicode output")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_into(unicode, strlen(unicode), MJB_ENC_UTF_8,
+                          MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_OK, "IDNA into uses stack scratch")
+    mjb_test_allocator_reset();
+    MJB_TEST_COVERAGE(mjb_idna_context_free);
+    mjb_idna_context_free(&context);
+
+    // A domain larger than the scratch moves it to the heap, where it stays.
+    char long_domain[600];
+    memset(long_domain, 'a', sizeof(long_domain));
+
+    for(size_t i = 0; i < sizeof(long_domain); i += 60) {
+        long_domain[i] = '\xC3';
+        long_domain[i + 1] = '\xA4';
+        long_domain[i + 59] = '.';
+    }
+
+    char small_scratch[16];
+    char long_output[1024];
+    size_t long_size = sizeof(long_output);
+    ATT_ASSERT_STATUS(mjb_idna_context_init(&context, small_scratch, sizeof(small_scratch)),
+        MJB_STATUS_OK, "IDNA context init with a small scratch")
+    ATT_ASSERT_STATUS(mjb_idna_context_to_ascii_into(&context, long_domain, sizeof(long_domain) - 1,
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, long_output, &long_size),
+        MJB_STATUS_OK, "IDNA context grows its scratch")
+    ATT_ASSERT(context.owned, true, "IDNA context scratch moved to the heap")
+    ATT_ASSERT((info.errors & MJB_IDNA_ERROR_DOMAIN_LENGTH) != 0, true,
+        "IDNA context reports the domain length")
+
+    size_t expected_size = 0;
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_into(long_domain, sizeof(long_domain) - 1, MJB_ENC_UTF_8,
+                          MJB_ENC_UTF_8, &info, NULL, &expected_size),
+        MJB_STATUS_OK, "IDNA into measures a long domain")
+    ATT_ASSERT(long_size, expected_size, "IDNA context matches the one-shot size")
+
+    long_size = sizeof(long_output);
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_idna_context_to_ascii_into(&context, long_domain, sizeof(long_domain) - 1,
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, long_output, &long_size),
+        MJB_STATUS_OK, "IDNA grown context does not allocate")
+    mjb_test_allocator_reset();
+    mjb_idna_context_free(&context);
+    mjb_idna_context_free(NULL);
+
+    ATT_ASSERT_STATUS(mjb_idna_context_init(NULL, NULL, 0), MJB_STATUS_INVALID_ARGUMENT,
+        "IDNA context init rejects NULL")
+    ATT_ASSERT_STATUS(mjb_idna_context_init(&context, NULL, 1), MJB_STATUS_INVALID_ARGUMENT,
+        "IDNA context init rejects a NULL scratch with a size")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_idna_context_to_unicode_into(NULL, ascii, strlen(ascii), MJB_ENC_UTF_8,
+                          MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_INVALID_ARGUMENT, "IDNA context conversion requires a context")
+    ATT_ASSERT(output_size, (size_t)0, "IDNA context conversion resets the size")
+
     ATT_ASSERT_STATUS(mjb_idna_to_ascii("a..b", 4, MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, &result),
         MJB_STATUS_OK, "IDNA produces output with validation errors")
     ATT_ASSERT((info.errors & MJB_IDNA_ERROR_EMPTY_LABEL) != 0, true,
@@ -337,6 +454,150 @@ static void test_idna_api(void) {
         MJB_STATUS_INVALID_ARGUMENT, "IDNA requires a result")
 }
 
+// A pool that runs the tasks in reverse order, to check they do not depend on each other.
+static void idna_reverse_parallel_for(void *pool, size_t count, mjb_parallel_task_fn task,
+    void *context) {
+    size_t *calls = (size_t *)pool;
+
+    for(size_t i = count; i > 0; --i) {
+        task(context, i - 1);
+        ++*calls;
+    }
+}
+
+// Whether every entry of a batch matches mjb_idna_to_ascii on the same domain.
+static bool idna_batch_matches(const mjb_idna_batch *batch, const char *const *domains,
+    size_t count) {
+    if(batch->count != count) {
+        return false;
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        mjb_idna_info info;
+        mjb_result result;
+
+        if(mjb_idna_to_ascii(domains[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info,
+               &result) != MJB_STATUS_OK) {
+            return false;
+        }
+
+        size_t size = batch->offsets[i + 1] - batch->offsets[i];
+        bool matches = info.errors == batch->infos[i].errors && size == result.output_size &&
+            memcmp(batch->domains + batch->offsets[i], result.output, size) == 0;
+
+        if(mjb_result_free(&result) != MJB_STATUS_OK || !matches) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_idna_batch(void) {
+    // The last two share a TLD that breaks the bidi rule only in a bidi domain, in both orders.
+    const char *domains[] = { "B\xC3\xBC"
+                              "cher.example",
+        "WWW.Example.COM", "a..b", "xn--bcher-kva.\xD1\x80\xD1\x84", "M\xC3\xBCnchen.\xD1\x80\xD1\x84",
+        "x.1a", "\xD7\x90.1a", "y.1a", "\xD7\x91.1b", "z.1b" };
+    size_t count = sizeof(domains) / sizeof(domains[0]);
+    mjb_idna_batch batch;
+
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_batch(domains, NULL, count, MJB_ENC_UTF_8, NULL, NULL,
+                          &batch),
+        MJB_STATUS_OK, "IDNA batch converts an array")
+    ATT_ASSERT(idna_batch_matches(&batch, domains, count), true,
+        "IDNA batch matches one-shot conversions")
+    ATT_ASSERT((batch.infos[6].errors & MJB_IDNA_ERROR_BIDI) != 0, true,
+        "IDNA batch cached TLD keeps the bidi rule of its domain")
+    ATT_ASSERT(batch.infos[7].errors, (uint32_t)MJB_IDNA_ERROR_NONE,
+        "IDNA batch cached TLD drops the bidi rule outside a bidi domain")
+    ATT_ASSERT(batch.domains[batch.offsets[count]], '\0', "IDNA batch domains are terminated")
+    MJB_TEST_COVERAGE(mjb_idna_batch_free);
+    mjb_idna_batch_free(&batch);
+    ATT_ASSERT(batch.domains == NULL && batch.count == 0, true, "IDNA batch free resets it")
+
+    const size_t byte_lengths[] = { 3, 1 };
+    const char *prefixes[] = { "abc.def", "\xC3" };
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_batch(prefixes, byte_lengths, 2, MJB_ENC_UTF_8, NULL,
+                          NULL, &batch),
+        MJB_STATUS_OK, "IDNA batch honours byte lengths")
+    ATT_ASSERT(batch.offsets[1], (size_t)3, "IDNA batch converts the given bytes")
+    ATT_ASSERT(batch.infos[1].errors, (uint32_t)MJB_IDNA_ERROR_DISALLOWED,
+        "IDNA batch reports malformed input as disallowed")
+    ATT_ASSERT(batch.offsets[2], (size_t)3, "IDNA batch writes nothing for malformed input")
+    mjb_idna_batch_free(&batch);
+
+    // More lines than one task, converted serially and by a pool in reverse order.
+    size_t line_count = 2500;
+    char *lines = (char *)malloc(line_count * 32);
+    char (*hosts)[32] = (char (*)[32])malloc(line_count * 32);
+    const char **line_domains = (const char **)malloc(line_count * sizeof(char *));
+    size_t lines_size = 0;
+
+    for(size_t i = 0; i < line_count; ++i) {
+        snprintf(hosts[i], sizeof(hosts[i]), i % 3 == 0 ? "Host%zu.b\xC3\xBC"
+                                                          "cher" :
+                                                          "host%zu.Example",
+            i);
+        line_domains[i] = hosts[i];
+        lines_size += (size_t)snprintf(lines + lines_size, 32, "%s%s", hosts[i],
+            i % 2 == 0 ? "\r\n" : "\n");
+    }
+
+    mjb_idna_batch parallel;
+    size_t calls = 0;
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines(lines, lines_size, MJB_ENC_UTF_8, NULL, NULL,
+                          &batch),
+        MJB_STATUS_OK, "IDNA lines converts serially")
+    ATT_ASSERT(idna_batch_matches(&batch, line_domains, line_count), true,
+        "IDNA lines match one-shot conversions")
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines(lines, lines_size, MJB_ENC_UTF_8,
+                          idna_reverse_parallel_for, &calls, &parallel),
+        MJB_STATUS_OK, "IDNA lines converts in parallel")
+    ATT_ASSERT(calls, (size_t)3, "IDNA lines runs one task per 1024 domains")
+    ATT_ASSERT(parallel.count, batch.count, "IDNA parallel lines count")
+    ATT_ASSERT((int)memcmp(parallel.offsets, batch.offsets, (line_count + 1) * sizeof(size_t)), 0,
+        "IDNA parallel lines offsets")
+    ATT_ASSERT((int)memcmp(parallel.domains, batch.domains, batch.offsets[line_count]), 0,
+        "IDNA parallel lines domains")
+    ATT_ASSERT((int)memcmp(parallel.infos, batch.infos, line_count * sizeof(mjb_idna_info)), 0,
+        "IDNA parallel lines errors")
+    mjb_idna_batch_free(&parallel);
+    mjb_idna_batch_free(&batch);
+
+    mjb_test_allocator_fail_after(3);
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines(lines, lines_size, MJB_ENC_UTF_8,
+                          idna_reverse_parallel_for, &calls, &batch),
+        MJB_STATUS_NO_MEMORY, "IDNA lines reports a failed task allocation")
+    mjb_test_allocator_reset();
+    ATT_ASSERT(batch.domains == NULL && batch.offsets == NULL, true,
+        "IDNA failed batch is left empty")
+
+    free(line_domains);
+    free(hosts);
+    free(lines);
+
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines("a.example\r\n\nb", MJB_NUL_TERMINATED,
+                          MJB_ENC_ASCII, NULL, NULL, &batch),
+        MJB_STATUS_OK, "IDNA lines keeps empty lines")
+    ATT_ASSERT(batch.count, (size_t)3, "IDNA lines count")
+    ATT_ASSERT(batch.offsets[1], (size_t)9, "IDNA lines drops the CR")
+    ATT_ASSERT((batch.infos[1].errors & MJB_IDNA_ERROR_DOMAIN_LENGTH) != 0, true,
+        "IDNA lines reports an empty line")
+    mjb_idna_batch_free(&batch);
+
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines("", 0, MJB_ENC_UTF_8, NULL, NULL, &batch),
+        MJB_STATUS_OK, "IDNA lines accepts empty input")
+    ATT_ASSERT(batch.count, (size_t)0, "IDNA empty lines count")
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines("a", 1, MJB_ENC_UTF_16LE, NULL, NULL, &batch),
+        MJB_STATUS_INVALID_ENCODING, "IDNA lines requires UTF-8 or ASCII")
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines("a", 1, MJB_ENC_UTF_8, NULL, NULL, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "IDNA lines requires a result")
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_batch(NULL, NULL, 1, MJB_ENC_UTF_8, NULL, NULL, &batch),
+        MJB_STATUS_INVALID_ARGUMENT, "IDNA batch rejects NULL domains")
+    mjb_idna_batch_free(NULL);
+}
+
 #else
 
 static void test_idna_disabled(void) {
@@ -358,6 +619,26 @@ static void test_idna_disabled(void) {
     ATT_ASSERT_STATUS(mjb_idna_to_unicode_into(domain, strlen(domain), MJB_ENC_UTF_8, MJB_ENC_UTF_8,
                           &info, output, &output_size),
         MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled IDNA ToUnicode into reports feature status")
+
+    mjb_idna_context context;
+    ATT_ASSERT_STATUS(mjb_idna_context_init(&context, NULL, 0), MJB_STATUS_FEATURE_NOT_ENABLED,
+        "Disabled IDNA context init reports feature status")
+    ATT_ASSERT_STATUS(mjb_idna_context_to_ascii_into(&context, domain, strlen(domain),
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled IDNA context ToASCII reports feature status")
+    ATT_ASSERT_STATUS(mjb_idna_context_to_unicode_into(&context, domain, strlen(domain),
+                          MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled IDNA context ToUnicode reports feature status")
+    mjb_idna_context_free(&context);
+
+    const char *domains[] = { domain };
+    mjb_idna_batch batch = { NULL, NULL, NULL, 0 };
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_batch(domains, NULL, 1, MJB_ENC_UTF_8, NULL, NULL, &batch),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled IDNA batch reports feature status")
+    ATT_ASSERT_STATUS(mjb_idna_to_ascii_lines(domain, strlen(domain), MJB_ENC_UTF_8, NULL, NULL,
+                          &batch),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled IDNA lines reports feature status")
+    mjb_idna_batch_free(&batch);
 }
 
 #endif
@@ -366,6 +647,7 @@ int test_idna(void *arg) {
     (void)arg;
 #if MJB_FEATURE_IDNA
     test_idna_api();
+    test_idna_batch();
     test_idna_conformance();
 #else
     test_idna_disabled();
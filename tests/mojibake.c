@@ -81,17 +81,20 @@ int test_mojibake(void *arg) {
     ATT_ASSERT(normalize_into_size, (size_t)2,
         "Caller-buffer normalized encoding conversion output size")
 
-    normalize_into_size = 0;
+    normalize_into_size = sizeof(normalize_into_output);
     ATT_ASSERT_STATUS(mjb_normalize_into("e\xCC\x81", 3, MJB_ENC_UTF_8,
-                          MJB_NORMALIZATION_NFC, MJB_ENC_UTF_8, NULL, &normalize_into_size),
-        MJB_STATUS_NO_MEMORY, "Caller-buffer composition handles temporary allocation failure")
-    ATT_ASSERT(normalize_into_size, (size_t)0,
-        "Caller-buffer composition clears size after allocation failure")
+                          MJB_NORMALIZATION_NFC, MJB_ENC_UTF_8, normalize_into_output,
+                          &normalize_into_size),
+        MJB_STATUS_OK, "Caller-buffer composition does not allocate")
+    ATT_ASSERT(normalize_into_size, (size_t)2, "Caller-buffer composition output size")
+    ATT_ASSERT((int)memcmp(normalize_into_output, "\xC3\xA9", 2), 0,
+        "Caller-buffer composition output")
 
     filter_into_size = sizeof(filter_into_output);
     ATT_ASSERT_STATUS(mjb_filter_into("e\xCC\x81", 3, MJB_ENC_UTF_8, MJB_FILTER_NORMALIZE,
                           MJB_ENC_UTF_8, filter_into_output, &filter_into_size),
-        MJB_STATUS_NO_MEMORY, "Caller-buffer normalization handles temporary allocation failure")
+        MJB_STATUS_OK, "Caller-buffer normalization does not allocate")
+    ATT_ASSERT(filter_into_size, (size_t)2, "Caller-buffer normalization output size")
 
     size_t nfkc_casefold_into_size = 0;
     ATT_ASSERT_STATUS(mjb_nfkc_casefold_into("a", 1, MJB_ENC_UTF_8, MJB_ENC_UTF_8, NULL,
@@ -136,6 +139,20 @@ int test_mojibake(void *arg) {
     int order;
     ATT_ASSERT_STATUS(mjb_collation_compare("a", 1, MJB_ENC_UTF_8, "b", 1, MJB_ENC_UTF_8,
                           MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY, &order),
+        MJB_STATUS_OK, "Collation comparison does not allocate")
+
+    // Combining sequences longer than the comparison buffers fall back to sort keys.
+    char marks[1 + 31 * 2];
+    marks[0] = 'a';
+
+    for(size_t i = 0; i < 31; ++i) {
+        marks[1 + i * 2] = '\xCC';
+        marks[2 + i * 2] = '\x81';
+    }
+
+    ATT_ASSERT_STATUS(mjb_collation_compare(marks, sizeof(marks), MJB_ENC_UTF_8, "b", 1,
+                          MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY,
+                          &order),
         MJB_STATUS_NO_MEMORY, "Collation comparison handles allocation failure")
 #endif
 #if MJB_FEATURE_SECURITY
@@ -8,6 +8,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../src/mojibake-internal.h"
+#include "../src/unicode-tables.h"
 #include "../src/utf8.h"
 #include "test.h"
 
@@ -331,6 +333,220 @@ static void test_nfkc_casefold_file(void) {
     fclose(file);
 }
 
+// Feed a string to a normalizer in chunks of chunk_size bytes and collect the output.
+static mjb_status feed_normalizer(mjb_normalizer *normalizer, const char *source,
+    size_t source_size, size_t chunk_size, char *output, size_t *output_size) {
+    size_t written = 0;
+    size_t size;
+    mjb_status status;
+
+    for(size_t i = 0; i < source_size; i += chunk_size) {
+        size_t chunk = source_size - i < chunk_size ? source_size - i : chunk_size;
+        size = *output_size - written;
+        status = mjb_normalizer_feed(normalizer, source + i, chunk, output + written, &size);
+
+        if(status != MJB_STATUS_OK) {
+            return status;
+        }
+
+        written += size;
+    }
+
+    size = *output_size - written;
+    status = mjb_normalizer_finish(normalizer, output + written, &size);
+    *output_size = written + size;
+
+    return status;
+}
+
+static void test_normalizer(void) {
+    mjb_normalizer normalizer;
+    char output[64];
+    size_t output_size;
+
+    MJB_TEST_COVERAGE(mjb_normalizer_init);
+    ATT_ASSERT_STATUS(mjb_normalizer_init(NULL, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+                          MJB_ENC_UTF_8),
+        MJB_STATUS_INVALID_ARGUMENT, "Normalizer init rejects NULL")
+    ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, (mjb_normalization)99,
+                          MJB_ENC_UTF_8),
+        MJB_STATUS_INVALID_FORM, "Normalizer init rejects an invalid form")
+    ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+                          MJB_ENC_UTF_16),
+        MJB_STATUS_INVALID_ENCODING, "Normalizer init rejects an output encoding without order")
+    MJB_TEST_COVERAGE(mjb_normalizer_free);
+    mjb_normalizer_free(&normalizer);
+    mjb_normalizer_free(NULL);
+
+    MJB_TEST_COVERAGE(mjb_normalizer_feed);
+    MJB_TEST_COVERAGE(mjb_normalizer_finish);
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, "a", 1, output, &output_size),
+        MJB_STATUS_INVALID_ARGUMENT, "Normalizer feed rejects an uninitialized normalizer")
+    ATT_ASSERT_STATUS(mjb_normalizer_finish(&normalizer, output, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "Normalizer finish rejects NULL size")
+
+    // Chunks split UTF-8 sequences, combining sequences and Hangul syllables.
+    const char *source = "Cafe\xCC\x81 \xE1\x84\x80\xE1\x85\xA1\xE1\x86\xA8 a\xCC\x81\xCC\xA3!";
+    const char *nfc = "Caf\xC3\xA9 \xEA\xB0\x81 \xE1\xBA\xA1\xCC\x81!";
+    const char *nfd = "Cafe\xCC\x81 \xE1\x84\x80\xE1\x85\xA1\xE1\x86\xA8 a\xCC\xA3\xCC\x81!";
+
+    for(size_t chunk_size = 1; chunk_size <= 4; ++chunk_size) {
+        ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+                              MJB_ENC_UTF_8),
+            MJB_STATUS_OK, "Normalizer init NFC")
+        output_size = sizeof(output);
+        ATT_ASSERT_STATUS(feed_normalizer(&normalizer, source, strlen(source), chunk_size,
+                              output, &output_size),
+            MJB_STATUS_OK, "Normalizer NFC stream")
+        ATT_ASSERT(output_size, strlen(nfc), "Normalizer NFC stream size")
+        ATT_ASSERT((int)memcmp(output, nfc, strlen(nfc)), 0, "Normalizer NFC stream output")
+
+        // A finished normalizer starts a new stream.
+        ATT_ASSERT_STATUS(feed_normalizer(&normalizer, "e\xCC\x81", 3, chunk_size, output,
+                              &output_size),
+            MJB_STATUS_OK, "Normalizer NFC second stream")
+        ATT_ASSERT(output_size, (size_t)2, "Normalizer NFC second stream size")
+        mjb_normalizer_free(&normalizer);
+
+        ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+                              MJB_ENC_UTF_8),
+            MJB_STATUS_OK, "Normalizer init NFD")
+        output_size = sizeof(output);
+        ATT_ASSERT_STATUS(feed_normalizer(&normalizer, source, strlen(source), chunk_size,
+                              output, &output_size),
+            MJB_STATUS_OK, "Normalizer NFD stream")
+        ATT_ASSERT(output_size, strlen(nfd), "Normalizer NFD stream size")
+        ATT_ASSERT((int)memcmp(output, nfd, strlen(nfd)), 0, "Normalizer NFD stream output")
+        mjb_normalizer_free(&normalizer);
+    }
+
+    // The byte order of MJB_ENC_UTF_16 comes from a BOM split between chunks.
+    ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_16, MJB_NORMALIZATION_NFC,
+                          MJB_ENC_UTF_8),
+        MJB_STATUS_OK, "Normalizer init UTF-16")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(feed_normalizer(&normalizer, "\xFF\xFE" "e\0\x01\x03", 6, 1, output,
+                          &output_size),
+        MJB_STATUS_OK, "Normalizer UTF-16 stream with a BOM")
+    ATT_ASSERT(output_size, (size_t)2, "Normalizer UTF-16 stream size")
+    ATT_ASSERT((int)memcmp(output, "\xC3\xA9", 2), 0, "Normalizer UTF-16 stream output")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, "e\0\x01\x03", 4, output, &output_size),
+        MJB_STATUS_MALFORMED_INPUT, "Normalizer UTF-16 stream without a BOM")
+    mjb_normalizer_free(&normalizer);
+
+    // Pending output is kept until the caller has room for it.
+    ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+                          MJB_ENC_UTF_8),
+        MJB_STATUS_OK, "Normalizer init small output")
+    output_size = 0;
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, "\xC3\xA9\xC3\xA9", 4, NULL,
+                          &output_size),
+        MJB_STATUS_OK, "Normalizer feed queries the pending size")
+    ATT_ASSERT(output_size, (size_t)3, "Normalizer pending size")
+    memset(output, '#', sizeof(output));
+    output_size = 2;
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, NULL, 0, output, &output_size),
+        MJB_STATUS_OUTPUT_TOO_SMALL, "Normalizer feed reports a small output buffer")
+    ATT_ASSERT(output_size, (size_t)3, "Normalizer feed required size")
+    ATT_ASSERT(output[0], '#', "Normalizer feed leaves a small buffer untouched")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_finish(&normalizer, output, &output_size),
+        MJB_STATUS_OK, "Normalizer finish collects the pending output")
+    ATT_ASSERT(output_size, (size_t)6, "Normalizer finish size")
+    ATT_ASSERT((int)memcmp(output, "e\xCC\x81" "e\xCC\x81", 6), 0, "Normalizer finish output")
+
+    // Malformed input, also across chunks.
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, "a\xC3", 2, output, &output_size),
+        MJB_STATUS_OK, "Normalizer feed keeps an incomplete sequence")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_finish(&normalizer, output, &output_size),
+        MJB_STATUS_MALFORMED_INPUT, "Normalizer finish rejects an incomplete sequence")
+    mjb_normalizer_free(&normalizer);
+
+    ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+                          MJB_ENC_UTF_8),
+        MJB_STATUS_OK, "Normalizer init malformed")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, "\xC3", 1, output, &output_size),
+        MJB_STATUS_OK, "Normalizer feed keeps a lead byte")
+    output_size = sizeof(output);
+    ATT_ASSERT_STATUS(mjb_normalizer_feed(&normalizer, "a", 1, output, &output_size),
+        MJB_STATUS_MALFORMED_INPUT, "Normalizer feed rejects a sequence broken by a chunk")
+    mjb_normalizer_free(&normalizer);
+
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+                          MJB_ENC_UTF_8),
+        MJB_STATUS_NO_MEMORY, "Normalizer init handles allocation failure")
+    mjb_test_allocator_reset();
+    mjb_normalizer_free(&normalizer);
+}
+
+// Compose a full canonical decomposition back from its first codepoint, one pair at a time.
+static mjb_codepoint compose_decomposition(const mjb_codepoint *values, uint8_t length) {
+    mjb_codepoint result = values[0];
+
+    for(uint8_t i = 1; i < length && result != MJB_CODEPOINT_NOT_VALID; ++i) {
+        result = mjb_unicode_compose_pair(result, values[i]);
+    }
+
+    return result;
+}
+
+// Return the first codepoint whose canonical decomposition composes back to a codepoint with a
+// different decomposition. Excluded codepoints can share theirs with a primary composite.
+static mjb_codepoint compose_pair_mismatch(size_t *composed) {
+    for(mjb_codepoint codepoint = 0; codepoint <= MJB_CODEPOINT_MAX; ++codepoint) {
+        const mjb_codepoint *values = NULL;
+        uint8_t length = 0;
+
+        if(!mjb_unicode_decomposition_lookup(codepoint, false, &values, &length) || length < 2) {
+            continue;
+        }
+
+        mjb_codepoint result = compose_decomposition(values, length);
+
+        if(result == MJB_CODEPOINT_NOT_VALID) {
+            continue;
+        }
+
+        const mjb_codepoint *result_values = NULL;
+        uint8_t result_length = 0;
+
+        if(!mjb_unicode_decomposition_lookup(result, false, &result_values, &result_length) ||
+            result_length != length ||
+            memcmp(result_values, values, length * sizeof(mjb_codepoint)) != 0) {
+            return codepoint;
+        }
+
+        *composed += result == codepoint;
+    }
+
+    return MJB_CODEPOINT_NOT_VALID;
+}
+
+static void test_compose_pair(void) {
+    size_t composed = 0;
+
+    ATT_ASSERT(mjb_unicode_compose_pair(0x41, 0x300), 0xC0, "Compose A and grave accent")
+    ATT_ASSERT(mjb_unicode_compose_pair(0x1F00, 0x345), 0x1F80,
+        "Compose a composite starter with ypogegrammeni")
+    ATT_ASSERT(mjb_unicode_compose_pair(0x41, 0x41), MJB_CODEPOINT_NOT_VALID,
+        "Two starters do not compose")
+    ATT_ASSERT(mjb_unicode_compose_pair(0x300, 0x41), MJB_CODEPOINT_NOT_VALID,
+        "A swapped pair does not compose")
+    ATT_ASSERT(mjb_unicode_compose_pair(0x915, 0x93C), MJB_CODEPOINT_NOT_VALID,
+        "An excluded composition does not compose")
+    ATT_ASSERT(mjb_unicode_compose_pair(0x200041, 0x300), MJB_CODEPOINT_NOT_VALID,
+        "An out of range starter does not compose")
+    ATT_ASSERT(compose_pair_mismatch(&composed), MJB_CODEPOINT_NOT_VALID,
+        "Composition pairs match the canonical decompositions")
+    ATT_ASSERT(composed, 965, "Every primary composite is composed")
+}
+
 /**
  * Run utils/generate/unicode-data/UCD/NormalizationTest.txt tests
  */
@@ -342,6 +558,8 @@ int test_normalization(void *arg) {
 
     test_nfkc_casefold();
     test_nfkc_casefold_file();
+    test_normalizer();
+    test_compose_pair();
 
     ATT_ASSERT_STATUS(mjb_normalize(NULL, 1, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC, MJB_ENC_UTF_8,
                           &guard_result),
@@ -359,6 +577,110 @@ int test_normalization(void *arg) {
     check_normalization(hangul_source, 13, hangul_normalized, 7, MJB_NORMALIZATION_NFC, 0,
         "NFC composes after Hangul compaction");
 
+    // The already normalized prefix is copied, normalization resumes at the last starter.
+    char span_source[] = "Normalized prefix cafe\xCC\x81";
+    char span_nfc[] = "Normalized prefix caf\xC3\xA9";
+    check_normalization(span_source, 24, span_nfc, 23, MJB_NORMALIZATION_NFC, 0,
+        "NFC composes a MAYBE with the starter before the span end");
+    char span_nfd_source[] = "Normalized prefix caf\xC3\xA9 suffix";
+    char span_nfd[] = "Normalized prefix cafe\xCC\x81 suffix";
+    check_normalization(span_nfd_source, 30, span_nfd, 31, MJB_NORMALIZATION_NFD, 0,
+        "NFD decomposes after the span end");
+    char span_reorder_source[] = "Prefix a\xCC\x81\xCC\xA3";
+    char span_reorder_nfd[] = "Prefix a\xCC\xA3\xCC\x81";
+    check_normalization(span_reorder_source, 12, span_reorder_nfd, 12, MJB_NORMALIZATION_NFD, 0,
+        "NFD reorders the marks after the span end");
+    char span_hangul_source[] = "Prefix \xEA\xB0\x80\xE1\x86\xA8";
+    char span_hangul_nfc[] = "Prefix \xEA\xB0\x81";
+    check_normalization(span_hangul_source, 13, span_hangul_nfc, 10, MJB_NORMALIZATION_NFC, 0,
+        "NFC composes an LV syllable and a trailing T after the span end");
+
+    // The input after the span end is still validated. U+00E9 is NO for NFD/NFKD and U+0301 is
+    // MAYBE for NFC/NFKC, so every form stops before the ill-formed sequence.
+    const mjb_normalization span_forms[] = { MJB_NORMALIZATION_NFC, MJB_NORMALIZATION_NFKC,
+        MJB_NORMALIZATION_NFD, MJB_NORMALIZATION_NFKD };
+    const char *span_form_names[] = { "NFC", "NFKC", "NFD", "NFKD" };
+    char span_test_name[128];
+
+    for(size_t i = 0; i < 4; ++i) {
+        char span_malformed_output[16];
+        size_t span_malformed_size = sizeof(span_malformed_output);
+
+        snprintf(span_test_name, 128, "%s rejects malformed input after the span end",
+            span_form_names[i]);
+        ATT_ASSERT_STATUS(mjb_normalize("A\xC3\xA9\xCC\x81\xC3S", 7, MJB_ENC_UTF_8, span_forms[i],
+                              MJB_ENC_UTF_8, &guard_result),
+            MJB_STATUS_MALFORMED_INPUT, span_test_name)
+        snprintf(span_test_name, 128, "%s into rejects malformed input after the span end",
+            span_form_names[i]);
+        ATT_ASSERT_STATUS(mjb_normalize_into("A\xC3\xA9\xCC\x81\xC3S", 7, MJB_ENC_UTF_8,
+                              span_forms[i], MJB_ENC_UTF_8, span_malformed_output,
+                              &span_malformed_size),
+            MJB_STATUS_MALFORMED_INPUT, span_test_name)
+
+        span_malformed_size = sizeof(span_malformed_output);
+        snprintf(span_test_name, 128, "%s rejects truncated input after the span end",
+            span_form_names[i]);
+        ATT_ASSERT_STATUS(mjb_normalize("A\xC3\xA9\xCC\x81\xC3", 6, MJB_ENC_UTF_8, span_forms[i],
+                              MJB_ENC_UTF_8, &guard_result),
+            MJB_STATUS_MALFORMED_INPUT, span_test_name)
+        snprintf(span_test_name, 128, "%s into rejects truncated input after the span end",
+            span_form_names[i]);
+        ATT_ASSERT_STATUS(mjb_normalize_into("A\xC3\xA9\xCC\x81\xC3", 6, MJB_ENC_UTF_8,
+                              span_forms[i], MJB_ENC_UTF_8, span_malformed_output,
+                              &span_malformed_size),
+            MJB_STATUS_MALFORMED_INPUT, span_test_name)
+    }
+
+    ATT_ASSERT_STATUS(mjb_normalize("a\0b\0e\0\x01\x03", 8, MJB_ENC_UTF_16LE,
+                          MJB_NORMALIZATION_NFC, MJB_ENC_UTF_16LE, &guard_result),
+        MJB_STATUS_OK, "Normalize UTF-16LE resumes from the span")
+    ATT_ASSERT(guard_result.output_size, (size_t)6, "Normalize UTF-16LE span size")
+    ATT_ASSERT((int)memcmp(guard_result.output, "a\0b\0\xE9\0", 6), 0,
+        "Normalize UTF-16LE span bytes")
+    if(guard_result.transformed) {
+        (void)mjb_result_free(&guard_result);
+    }
+
+    // Vowel jamos can compose with the character before them, so they all stay in one composition
+    // segment, longer than the one kept on the stack.
+    char segment_source[1 + 100 * 3];
+    char segment_output[sizeof(segment_source)];
+    size_t segment_size = sizeof(segment_output);
+    segment_source[0] = 'a';
+
+    for(size_t i = 0; i < 100; ++i) {
+        memcpy(segment_source + 1 + i * 3, "\xE1\x85\xA1", 3);
+    }
+
+    ATT_ASSERT_STATUS(mjb_normalize_into(segment_source, sizeof(segment_source), MJB_ENC_UTF_8,
+                          MJB_NORMALIZATION_NFC, MJB_ENC_UTF_8, segment_output, &segment_size),
+        MJB_STATUS_OK, "NFC composes a segment longer than the stack buffer")
+    ATT_ASSERT(segment_size, sizeof(segment_source), "NFC long segment size")
+    ATT_ASSERT((int)memcmp(segment_output, segment_source, sizeof(segment_source)), 0,
+        "NFC long segment output")
+
+    mjb_test_allocator_fail_after(0);
+    segment_size = sizeof(segment_output);
+    ATT_ASSERT_STATUS(mjb_normalize_into(segment_source, sizeof(segment_source), MJB_ENC_UTF_8,
+                          MJB_NORMALIZATION_NFC, MJB_ENC_UTF_8, segment_output, &segment_size),
+        MJB_STATUS_NO_MEMORY, "NFC long segment handles allocation failure")
+    segment_size = sizeof(segment_output);
+    ATT_ASSERT_STATUS(mjb_normalize_into(segment_source, 1 + 60 * 3, MJB_ENC_UTF_8,
+                          MJB_NORMALIZATION_NFC, MJB_ENC_UTF_8, segment_output, &segment_size),
+        MJB_STATUS_OK, "NFC short segments into a caller buffer do not allocate")
+    mjb_test_allocator_reset();
+
+    ATT_ASSERT_STATUS(mjb_normalize("ab\xC3\xA9", 4, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+                          MJB_ENC_UTF_16LE, &guard_result),
+        MJB_STATUS_OK, "Normalize does not copy the span across encodings")
+    ATT_ASSERT(guard_result.output_size, (size_t)8, "Normalize span across encodings size")
+    ATT_ASSERT((int)memcmp(guard_result.output, "a\0b\0e\0\x01\x03", 8), 0,
+        "Normalize span across encodings bytes")
+    if(guard_result.transformed) {
+        (void)mjb_result_free(&guard_result);
+    }
+
     ATT_ASSERT_STATUS(mjb_normalize("A", 1, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC, MJB_ENC_UTF_16LE,
                           &guard_result),
         MJB_STATUS_OK, "Normalize converts output encoding for already-normalized input")
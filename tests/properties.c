@@ -4,6 +4,7 @@
  * This file is distributed under the MIT License. See LICENSE for details.
  */
 
+#include "../src/mojibake-internal.h"
 #include "test.h"
 
 typedef struct test_script_alias {
@@ -139,6 +140,70 @@ static void test_script_extensions_file(const char *filename, const test_script_
     ATT_ASSERT(tested > 0, true, "ScriptExtensions.txt ranges tested")
 }
 
+static int32_t property_int_or_zero(mjb_codepoint codepoint, mjb_property property) {
+    int32_t value = 0;
+
+    return mjb_codepoint_property_int(codepoint, property, &value) == MJB_STATUS_OK ? value : 0;
+}
+
+// Return the first codepoint whose packed segmentation properties differ from the property tables.
+static mjb_codepoint segmentation_properties_mismatch(void) {
+    for(mjb_codepoint codepoint = 0; codepoint <= MJB_CODEPOINT_MAX; ++codepoint) {
+        mjb_segmentation_properties properties = 0;
+
+        if(!mjb_codepoint_segmentation_properties(codepoint, &properties)) {
+            if(mjb_codepoint_is_valid(codepoint)) {
+                return codepoint;
+            }
+
+            continue;
+        }
+
+        if((int32_t)MJB_SEGMENTATION_GCB(properties) !=
+                property_int_or_zero(codepoint, MJB_PR_GRAPHEME_CLUSTER_BREAK) ||
+            (int32_t)MJB_SEGMENTATION_WBP(properties) !=
+                property_int_or_zero(codepoint, MJB_PR_WORD_BREAK) ||
+            (int32_t)MJB_SEGMENTATION_SBP(properties) !=
+                property_int_or_zero(codepoint, MJB_PR_SENTENCE_BREAK) ||
+            (int32_t)MJB_SEGMENTATION_LBP(properties) !=
+                property_int_or_zero(codepoint, MJB_PR_LINE_BREAK) ||
+            (int32_t)MJB_SEGMENTATION_EAW(properties) !=
+                property_int_or_zero(codepoint, MJB_PR_EAST_ASIAN_WIDTH) ||
+            (int32_t)MJB_SEGMENTATION_INCB(properties) !=
+                property_int_or_zero(codepoint, MJB_PR_INDIC_CONJUNCT_BREAK) ||
+            MJB_SEGMENTATION_EXT_PICT(properties) !=
+                mjb_codepoint_has_binary_property(codepoint, MJB_PR_EXTENDED_PICTOGRAPHIC)) {
+            return codepoint;
+        }
+    }
+
+    return MJB_CODEPOINT_NOT_VALID;
+}
+
+// Return the first codepoint whose batch property value differs from mjb_codepoint_property_int.
+static mjb_codepoint batch_property_mismatch(mjb_property property) {
+    mjb_codepoint codepoints[1024];
+    int32_t values[1024];
+
+    for(mjb_codepoint first = 0; first <= MJB_CODEPOINT_MAX; first += 1024) {
+        for(mjb_codepoint i = 0; i < 1024; ++i) {
+            codepoints[i] = first + i;
+        }
+
+        if(mjb_codepoints_property_int(codepoints, 1024, property, values) != MJB_STATUS_OK) {
+            return first;
+        }
+
+        for(mjb_codepoint i = 0; i < 1024; ++i) {
+            if(values[i] != property_int_or_zero(first + i, property)) {
+                return first + i;
+            }
+        }
+    }
+
+    return MJB_CODEPOINT_NOT_VALID;
+}
+
 int test_properties(void *arg) {
     bool binary = false;
     int32_t enumerated = -1;
@@ -205,6 +270,68 @@ int test_properties(void *arg) {
     ATT_ASSERT_STATUS(mjb_codepoint_property_int(MJB_CODEPOINT_MAX + 1, MJB_PR_SCRIPT, &enumerated),
         MJB_STATUS_INVALID_ARGUMENT, "Typed getter rejects invalid codepoint")
 
+    MJB_TEST_COVERAGE(mjb_codepoints_property_int);
+    ATT_ASSERT(batch_property_mismatch(MJB_PR_SCRIPT), MJB_CODEPOINT_NOT_VALID,
+        "Batch Script values match the single lookups")
+    ATT_ASSERT(batch_property_mismatch(MJB_PR_LINE_BREAK), MJB_CODEPOINT_NOT_VALID,
+        "Batch Line_Break values match the single lookups")
+
+    const mjb_codepoint batch[] = { 0x41, MJB_CODEPOINT_MAX + 1, 0x0391, 0x41 };
+    int32_t batch_values[4] = { -1, -1, -1, -1 };
+
+    ATT_ASSERT_STATUS(mjb_codepoints_property_int(batch, 4, MJB_PR_SCRIPT, batch_values),
+        MJB_STATUS_OK, "Batch getter")
+    ATT_ASSERT(batch_values[0], MJB_SC_LATN, "Batch U+0041 Script is Latin")
+    ATT_ASSERT(batch_values[1], 0, "Batch invalid codepoint has no value")
+    ATT_ASSERT(batch_values[2], MJB_SC_GREK, "Batch U+0391 Script is Greek")
+    ATT_ASSERT(batch_values[3], MJB_SC_LATN, "Batch repeated U+0041 Script is Latin")
+    ATT_ASSERT_STATUS(mjb_codepoints_property_int(batch, 4, MJB_PR_ALPHABETIC, batch_values),
+        MJB_STATUS_INVALID_ARGUMENT, "Batch getter rejects binary property")
+    ATT_ASSERT_STATUS(mjb_codepoints_property_int(batch, 4, MJB_PR_SCRIPT, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "Batch getter rejects NULL output")
+    ATT_ASSERT_STATUS(mjb_codepoints_property_int(NULL, 0, MJB_PR_SCRIPT, NULL), MJB_STATUS_OK,
+        "Batch getter accepts an empty batch")
+
+    MJB_TEST_COVERAGE(mjb_string_property_int);
+    // "a", U+03A9, an invalid byte and U+4E00
+    const char *string = "a\xCE\xA9\xFF\xE4\xB8\x80";
+    size_t string_count = 0;
+
+    ATT_ASSERT_STATUS(mjb_string_property_int(string, 7, MJB_ENC_UTF_8, MJB_PR_SCRIPT, NULL,
+        &string_count), MJB_STATUS_OK, "String getter count query")
+    ATT_ASSERT(string_count, 4u, "String getter counts four codepoints")
+
+    string_count = 2;
+    ATT_ASSERT_STATUS(mjb_string_property_int(string, 7, MJB_ENC_UTF_8, MJB_PR_SCRIPT,
+        batch_values, &string_count), MJB_STATUS_OUTPUT_TOO_SMALL, "String getter too small")
+    ATT_ASSERT(string_count, 4u, "String getter returns the required count")
+
+    string_count = 4;
+    ATT_ASSERT_STATUS(mjb_string_property_int(string, 7, MJB_ENC_UTF_8, MJB_PR_SCRIPT,
+        batch_values, &string_count), MJB_STATUS_OK, "String getter")
+    ATT_ASSERT(string_count, 4u, "String getter writes four values")
+    ATT_ASSERT(batch_values[0], MJB_SC_LATN, "String U+0061 Script is Latin")
+    ATT_ASSERT(batch_values[1], MJB_SC_GREK, "String U+03A9 Script is Greek")
+    ATT_ASSERT(batch_values[2], property_int_or_zero(0xFFFD, MJB_PR_SCRIPT),
+        "String invalid byte is classified as U+FFFD")
+    ATT_ASSERT(batch_values[3], MJB_SC_HANI, "String U+4E00 Script is Han")
+
+    const char utf16le[] = "a\0\xA9\x03";
+    string_count = 4;
+    ATT_ASSERT_STATUS(mjb_string_property_int(utf16le, 4, MJB_ENC_UTF_16LE, MJB_PR_SCRIPT,
+        batch_values, &string_count), MJB_STATUS_OK, "String getter UTF-16LE")
+    ATT_ASSERT(string_count, 2u, "String getter UTF-16LE writes two values")
+    ATT_ASSERT(batch_values[1], MJB_SC_GREK, "String UTF-16LE U+03A9 Script is Greek")
+
+    ATT_ASSERT_STATUS(mjb_string_property_int(string, 7, MJB_ENC_UTF_8, MJB_PR_ALPHABETIC,
+        batch_values, &string_count), MJB_STATUS_INVALID_ARGUMENT,
+        "String getter rejects binary property")
+    ATT_ASSERT_STATUS(mjb_string_property_int(string, 7, MJB_ENC_UTF_8, MJB_PR_SCRIPT,
+        batch_values, NULL), MJB_STATUS_INVALID_ARGUMENT, "String getter rejects NULL count")
+    ATT_ASSERT_STATUS(mjb_string_property_int(string, 7, MJB_ENC_UNKNOWN, MJB_PR_SCRIPT,
+        batch_values, &string_count), MJB_STATUS_INVALID_ENCODING,
+        "String getter rejects an unknown encoding")
+
     // mjb_codepoint_script
     ATT_ASSERT((int)mjb_codepoint_script(MJB_CODEPOINT_MAX + 1), MJB_SC_ZZZZ,
         "Invalid codepoint script is Unknown")
@@ -217,6 +344,9 @@ int test_properties(void *arg) {
     ATT_ASSERT((int)mjb_codepoint_script(0xAC00), MJB_SC_HANG, "U+AC00 is Hangul")
     ATT_ASSERT((int)mjb_codepoint_script(0x0030), MJB_SC_ZYYY, "U+0030 '0' is Common")
 
+    ATT_ASSERT(segmentation_properties_mismatch(), MJB_CODEPOINT_NOT_VALID,
+        "Segmentation trie matches the property tables")
+
     ATT_ASSERT(mjb_property_name(MJB_PR_CASED), "Cased",
         "Property name for MJB_PR_CASED is 'Cased'")
     ATT_ASSERT(mjb_property_name((mjb_property)MJB_PR_COUNT), "Unknown",
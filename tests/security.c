@@ -284,6 +284,160 @@ static void check_resolved_script_set(const char *input, size_t input_size, mjb_
     ATT_ASSERT((int)memcmp(scripts, expected, expected_count * sizeof(mjb_script)), 0, name)
 }
 
+static void test_confusable_index(void) {
+    mjb_encoding enc = MJB_ENC_UTF_8;
+    mjb_confusable_index index;
+    uint32_t ids[4] = { 0 };
+    size_t count = 0;
+
+    ATT_ASSERT_STATUS(mjb_confusable_index_init(NULL), MJB_STATUS_INVALID_ARGUMENT,
+        "Confusable index init rejects NULL")
+    ATT_ASSERT_STATUS(mjb_confusable_index_init(&index), MJB_STATUS_OK, "Confusable index init")
+
+    count = 4;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "paypal", 6, enc, ids, &count),
+        MJB_STATUS_OK, "Empty confusable index find")
+    ATT_ASSERT(count, (size_t)0, "Empty confusable index has no matches")
+
+    // "paypal" and "paypa1" share a skeleton, and "rn" reads as "m".
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "paypal", 6, enc, 7), MJB_STATUS_OK,
+        "Confusable index add paypal")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "google", 6, enc, 2), MJB_STATUS_OK,
+        "Confusable index add google")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "paypa1", 6, enc, 3), MJB_STATUS_OK,
+        "Confusable index add paypa1")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "rn", 2, enc, 4), MJB_STATUS_OK,
+        "Confusable index add rn")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "", 0, enc, 5), MJB_STATUS_OK,
+        "Confusable index add empty string")
+    ATT_ASSERT(index.count, (size_t)4, "Empty skeletons are not stored")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "\x80", 1, enc, 6),
+        MJB_STATUS_MALFORMED_INPUT, "Confusable index add reports malformed input")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, NULL, 1, enc, 6),
+        MJB_STATUS_INVALID_ARGUMENT, "Confusable index add rejects NULL buffer")
+
+    count = 0;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "p\xD0\xB0ypal", 7, enc, NULL, &count),
+        MJB_STATUS_OK, "Confusable index find count query")
+    ATT_ASSERT(count, (size_t)2, "Confusable index find count")
+
+    count = 0;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "pay\x7Fpal", 7, enc, NULL, &count),
+        MJB_STATUS_OK, "Confusable index find with a boundary neutral")
+    ATT_ASSERT(count, (size_t)2, "Confusable index find ignores a boundary neutral")
+
+    count = 1;
+    ids[0] = 99;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "p\xD0\xB0ypal", 7, enc, ids, &count),
+        MJB_STATUS_OUTPUT_TOO_SMALL, "Confusable index find reports a short buffer")
+    ATT_ASSERT(count, (size_t)2, "Confusable index find reports the required count")
+    ATT_ASSERT(ids[0], (uint32_t)99, "Confusable index find writes nothing when short")
+
+    count = 4;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "p\xD0\xB0ypal", 7, enc, ids, &count),
+        MJB_STATUS_OK, "Confusable index find")
+    ATT_ASSERT(count, (size_t)2, "Confusable index find match count")
+    ATT_ASSERT(ids[0], (uint32_t)3, "Confusable index find sorts IDs")
+    ATT_ASSERT(ids[1], (uint32_t)7, "Confusable index find second ID")
+
+    count = 4;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "m", 1, enc, ids, &count), MJB_STATUS_OK,
+        "Confusable index find multi-codepoint skeleton")
+    ATT_ASSERT(count, (size_t)1, "Confusable index m matches rn")
+    ATT_ASSERT(ids[0], (uint32_t)4, "Confusable index m ID")
+
+    count = 4;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "goggle", 6, enc, ids, &count),
+        MJB_STATUS_OK, "Confusable index find miss")
+    ATT_ASSERT(count, (size_t)0, "Confusable index find has no false positives")
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "a", 1, enc, ids, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "Confusable index find rejects NULL count")
+
+    // Enough strings to grow the table several times.
+    char name[16];
+
+    for(uint32_t i = 0; i < 500; ++i) {
+        int length = snprintf(name, sizeof(name), "user%u", (unsigned int)i);
+
+        if(mjb_confusable_index_add(&index, name, (size_t)length, enc, 100 + i) != MJB_STATUS_OK) {
+            break;
+        }
+    }
+
+    ATT_ASSERT(index.count, (size_t)504, "Confusable index grows")
+    count = 4;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "userl23", 7, enc, ids, &count),
+        MJB_STATUS_OK, "Confusable index find after growing")
+    ATT_ASSERT(count, (size_t)1, "Confusable index finds user123 after growing")
+    ATT_ASSERT(ids[0], (uint32_t)223, "Confusable index user123 ID")
+
+    // Serialize, then look up in the image.
+    size_t size = 0;
+    ATT_ASSERT_STATUS(mjb_confusable_index_serialize(&index, NULL, &size), MJB_STATUS_OK,
+        "Confusable index serialize size query")
+
+    size_t short_size = 8;
+    ATT_ASSERT_STATUS(mjb_confusable_index_serialize(&index, ids, &short_size),
+        MJB_STATUS_OUTPUT_TOO_SMALL, "Confusable index serialize reports a short buffer")
+    ATT_ASSERT(short_size, size, "Confusable index serialize reports the required size")
+
+    uint32_t *image = (uint32_t *)malloc(size);
+    ATT_ASSERT(image != NULL, true, "Confusable index image allocation")
+
+    if(image == NULL) {
+        mjb_confusable_index_free(&index);
+
+        return;
+    }
+
+    ATT_ASSERT_STATUS(mjb_confusable_index_serialize(&index, image, &size), MJB_STATUS_OK,
+        "Confusable index serialize")
+    mjb_confusable_index_free(&index);
+    ATT_ASSERT(index.slots == NULL, true, "Confusable index free resets the index")
+
+    mjb_confusable_index opened;
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, image, size), MJB_STATUS_OK,
+        "Confusable index open")
+    ATT_ASSERT(opened.count, (size_t)504, "Opened confusable index count")
+
+    count = 4;
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&opened, "p\xD0\xB0ypal", 7, enc, ids, &count),
+        MJB_STATUS_OK, "Opened confusable index find")
+    ATT_ASSERT(count, (size_t)2, "Opened confusable index match count")
+    ATT_ASSERT(ids[0], (uint32_t)3, "Opened confusable index first ID")
+    ATT_ASSERT(ids[1], (uint32_t)7, "Opened confusable index second ID")
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&opened, "apple", 5, enc, 8),
+        MJB_STATUS_UNSUPPORTED, "Opened confusable index is read-only")
+    mjb_confusable_index_free(&opened);
+
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, NULL, size),
+        MJB_STATUS_INVALID_ARGUMENT, "Confusable index open rejects NULL data")
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, (const char *)image + 1, size - 1),
+        MJB_STATUS_INVALID_ARGUMENT, "Confusable index open rejects unaligned data")
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, image, 16), MJB_STATUS_MALFORMED_INPUT,
+        "Confusable index open rejects a truncated header")
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, image, size - 1),
+        MJB_STATUS_MALFORMED_INPUT, "Confusable index open rejects a truncated image")
+
+    // Header layout: magic[8], byte order, format version, Unicode version, ...
+    image[4] ^= 1;
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, image, size), MJB_STATUS_UNSUPPORTED,
+        "Confusable index open rejects another Unicode version")
+    image[4] ^= 1;
+    image[0] ^= 1;
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&opened, image, size), MJB_STATUS_MALFORMED_INPUT,
+        "Confusable index open rejects a bad magic")
+    free(image);
+
+    ATT_ASSERT_STATUS(mjb_confusable_index_init(&index), MJB_STATUS_OK,
+        "Confusable index init before allocation failure")
+    mjb_test_allocator_fail_after(0);
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "paypal", 6, enc, 1),
+        MJB_STATUS_NO_MEMORY, "Confusable index add reports allocation failure")
+    mjb_test_allocator_reset();
+    mjb_confusable_index_free(&index);
+}
+
 int test_security(void *arg) {
     mjb_encoding enc = MJB_ENC_UTF_8;
 
@@ -418,6 +572,20 @@ int test_security(void *arg) {
         5, "ab", 2, "Skeleton removes default-ignorables");
     check_skeleton("A1<\xD7\xA9\xD7\x82", 7, "Al<\xD7\xA9\xCC\x87", 7,
         "Skeleton applies LTR bidi processing");
+    check_skeleton("e\xCC\x81x", 4, "e\xCC\x81x", 4,
+        "Skeleton keeps a left-to-right mark after its base");
+    check_skeleton("\xC3\xA9x", 3, "e\xCC\x81x", 4,
+        "Skeleton of a precomposed letter matches its decomposition");
+
+    // Boundary neutrals are removed by the bidi X9 step, also in left-to-right input
+    check_skeleton("pay\x7Fpl", 6, "paypl", 5, "Skeleton removes U+007F");
+    ATT_ASSERT(test_are_confusable("pay\x7Fpl", 6, enc, "paypl", 5, enc), true,
+        "U+007F does not hide a confusable")
+    ATT_ASSERT(test_are_confusable("\xE1\x86\xA8\xC2\xAD", 5, enc, "\xE1\x86\xA8\xC2\x8D", 5,
+                   enc),
+        true, "U+00AD and U+008D are both removed after a jamo")
+    check_skeleton("e\xCC\x81x \xD7\xA9", 7, "e\xCC\x81x \xD7\xA9", 7,
+        "Skeleton keeps a left-to-right mark after its base in bidi text");
     check_skeleton("\xEF\xB7\xBA", 3,
         "\xD8\xB5\xD9\x84\xD9\x89 l\xD9\x84\xD9\x84o \xD8\xB9\xD9\x84\xD9\x89o "
         "\xD9\x88\xD8\xB3\xD9\x84\xD9\x85",
@@ -533,6 +701,8 @@ int test_security(void *arg) {
     ATT_ASSERT(test_are_confusable("pal", 3, enc, "\xD1\x80" "al", 4, enc), true,
         "confusability is symmetric")
 
+    test_confusable_index();
+
     run_intentional_confusable_file("./utils/generate/unicode-data/security/intentional.txt");
 #if !defined(MJB_SHARED)
     run_confusables_file("./utils/generate/unicode-data/security/confusables.txt");
@@ -569,6 +739,27 @@ int test_security(void *arg) {
                           &confusable),
         MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled confusable check reports feature status")
 
+    mjb_confusable_index index = { NULL, 0, 0, NULL, 0, 0, NULL, 0, 0, false };
+    uint32_t ids[1] = { 0 };
+    count = 1;
+    MJB_TEST_COVERAGE(mjb_confusable_index_init);
+    ATT_ASSERT_STATUS(mjb_confusable_index_init(&index), MJB_STATUS_FEATURE_NOT_ENABLED,
+        "Disabled confusable index init reports feature status")
+    MJB_TEST_COVERAGE(mjb_confusable_index_add);
+    ATT_ASSERT_STATUS(mjb_confusable_index_add(&index, "a", 1, MJB_ENC_UTF_8, 1),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled confusable index add reports feature status")
+    MJB_TEST_COVERAGE(mjb_confusable_index_find);
+    ATT_ASSERT_STATUS(mjb_confusable_index_find(&index, "a", 1, MJB_ENC_UTF_8, ids, &count),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled confusable index find reports feature status")
+    MJB_TEST_COVERAGE(mjb_confusable_index_serialize);
+    ATT_ASSERT_STATUS(mjb_confusable_index_serialize(&index, output, &output_size),
+        MJB_STATUS_FEATURE_NOT_ENABLED,
+        "Disabled confusable index serialize reports feature status")
+    MJB_TEST_COVERAGE(mjb_confusable_index_open);
+    ATT_ASSERT_STATUS(mjb_confusable_index_open(&index, ids, sizeof(ids)),
+        MJB_STATUS_FEATURE_NOT_ENABLED, "Disabled confusable index open reports feature status")
+    mjb_confusable_index_free(&index);
+
     return 0;
 }
 
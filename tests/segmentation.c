@@ -270,10 +270,132 @@ static void test_grapheme_count(void) {
     ATT_ASSERT(count, (size_t)2, "Count: UTF-16LE AB")
 }
 
+static void test_segment(void) {
+    size_t offsets[16];
+    size_t count = 6251;
+
+    // Argument validation
+    ATT_ASSERT_STATUS(mjb_segment("A", 1, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets, NULL),
+        MJB_STATUS_INVALID_ARGUMENT, "Segment rejects NULL count")
+    ATT_ASSERT_STATUS(mjb_segment(NULL, 1, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, NULL, &count),
+        MJB_STATUS_INVALID_ARGUMENT, "Segment rejects NULL buffer")
+    ATT_ASSERT(count, (size_t)0, "Segment: count is zero after NULL buffer")
+    ATT_ASSERT_STATUS(mjb_segment("A", 1, MJB_ENC_UTF_8, (mjb_segment_kind)9, NULL, &count),
+        MJB_STATUS_INVALID_ARGUMENT, "Segment rejects an unknown kind")
+    ATT_ASSERT_STATUS(mjb_segment("A", 1, MJB_ENC_UNKNOWN, MJB_SEGMENT_WORD, NULL, &count),
+        MJB_STATUS_INVALID_ENCODING, "Segment rejects invalid encoding")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("", 0, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets, &count),
+        MJB_STATUS_OK, "Segment: empty string status")
+    ATT_ASSERT(count, (size_t)0, "Segment: empty string has no boundaries")
+
+    // Count-only mode
+    ATT_ASSERT_STATUS(mjb_segment("Hello world", 11, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, NULL,
+        &count), MJB_STATUS_OK, "Segment: count-only status")
+    ATT_ASSERT(count, (size_t)3, "Segment: count-only words")
+
+    // "Hello world": Hello | space | world
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("Hello world", 11, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets,
+        &count), MJB_STATUS_OK, "Segment: words status")
+    ATT_ASSERT(count, (size_t)3, "Segment: words count")
+    ATT_ASSERT(offsets[0], (size_t)5, "Segment: first word ends at 5")
+    ATT_ASSERT(offsets[1], (size_t)6, "Segment: space ends at 6")
+    ATT_ASSERT(offsets[2], (size_t)11, "Segment: last word ends at the string end")
+
+    // A short array still reports the whole count
+    count = 2;
+    ATT_ASSERT_STATUS(mjb_segment("Hello world", 11, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets,
+        &count), MJB_STATUS_OUTPUT_TOO_SMALL, "Segment: short array status")
+    ATT_ASSERT(count, (size_t)3, "Segment: short array reports the required count")
+    ATT_ASSERT(offsets[1], (size_t)6, "Segment: short array is filled up to its capacity")
+
+    // A🇮🇹 is two grapheme clusters
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("A\xF0\x9F\x87\xAE\xF0\x9F\x87\xB9", 9, MJB_ENC_UTF_8,
+        MJB_SEGMENT_GRAPHEME, offsets, &count), MJB_STATUS_OK, "Segment: graphemes status")
+    ATT_ASSERT(count, (size_t)2, "Segment: graphemes count")
+    ATT_ASSERT(offsets[0], (size_t)1, "Segment: first grapheme ends at 1")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("Hi. Bye.", MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+        MJB_SEGMENT_SENTENCE, offsets, &count), MJB_STATUS_OK, "Segment: sentences status")
+    ATT_ASSERT(count, (size_t)2, "Segment: sentences count")
+    ATT_ASSERT(offsets[0], (size_t)4, "Segment: first sentence includes the space")
+
+    // Line break opportunities after the spaces
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("a b c", 5, MJB_ENC_UTF_8, MJB_SEGMENT_LINE, offsets, &count),
+        MJB_STATUS_OK, "Segment: lines status")
+    ATT_ASSERT(count, (size_t)3, "Segment: lines count")
+    ATT_ASSERT(offsets[1], (size_t)4, "Segment: second line opportunity")
+
+    // UTF-16LE offsets are in bytes
+    const char utf16le_ab[] = { 'A', '\0', 'B', '\0' };
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment(utf16le_ab, 4, MJB_ENC_UTF_16LE, MJB_SEGMENT_GRAPHEME, offsets,
+        &count), MJB_STATUS_OK, "Segment: UTF-16LE status")
+    ATT_ASSERT(count, (size_t)2, "Segment: UTF-16LE count")
+    ATT_ASSERT(offsets[0], (size_t)2, "Segment: UTF-16LE first boundary")
+
+    // An ill-formed sequence is one U+FFFD that spans its bytes
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("a\xFF" "b", 3, MJB_ENC_UTF_8, MJB_SEGMENT_GRAPHEME, offsets,
+        &count), MJB_STATUS_OK, "Segment: malformed graphemes status")
+    ATT_ASSERT(count, (size_t)3, "Segment: a replaced byte is its own grapheme")
+    ATT_ASSERT(offsets[0], (size_t)1, "Segment: grapheme before a replaced byte")
+    ATT_ASSERT(offsets[1], (size_t)2, "Segment: grapheme of a replaced byte")
+    ATT_ASSERT(offsets[2], (size_t)3, "Segment: grapheme after a replaced byte")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("ab\xFF\xFF" "cd", 6, MJB_ENC_UTF_8, MJB_SEGMENT_GRAPHEME,
+        offsets, &count), MJB_STATUS_OK, "Segment: malformed run graphemes status")
+    ATT_ASSERT(count, (size_t)5, "Segment: malformed run graphemes count")
+    ATT_ASSERT(offsets[1], (size_t)2, "Segment: malformed run starts after b")
+    ATT_ASSERT(offsets[2], (size_t)4, "Segment: malformed run is one grapheme")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("ab\xFF\xFF" "cd", 6, MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets,
+        &count), MJB_STATUS_OK, "Segment: malformed run words status")
+    ATT_ASSERT(count, (size_t)3, "Segment: malformed run words count")
+    ATT_ASSERT(offsets[0], (size_t)2, "Segment: word before a malformed run")
+    ATT_ASSERT(offsets[1], (size_t)4, "Segment: word of a malformed run")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("a\xC3\xE3\x80\x82j", 6, MJB_ENC_UTF_8, MJB_SEGMENT_WORD,
+        offsets, &count), MJB_STATUS_OK, "Segment: dropped code units words status")
+    ATT_ASSERT(count, (size_t)3, "Segment: dropped code units words count")
+    ATT_ASSERT(offsets[0], (size_t)1, "Segment: word before dropped code units")
+    ATT_ASSERT(offsets[1], (size_t)5, "Segment: dropped code units stay with the replacement")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("hello \xFFworld. Next", 18, MJB_ENC_UTF_8,
+        MJB_SEGMENT_SENTENCE, offsets, &count), MJB_STATUS_OK,
+        "Segment: malformed sentences status")
+    ATT_ASSERT(count, (size_t)2, "Segment: malformed sentences count")
+    ATT_ASSERT(offsets[0], (size_t)14, "Segment: sentence with a replaced byte")
+
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("hello \xFFworld. Next", 18, MJB_ENC_UTF_8, MJB_SEGMENT_LINE,
+        offsets, &count), MJB_STATUS_OK, "Segment: malformed lines status")
+    ATT_ASSERT(count, (size_t)3, "Segment: malformed lines count")
+    ATT_ASSERT(offsets[0], (size_t)6, "Segment: line opportunity before a replaced byte")
+    ATT_ASSERT(offsets[1], (size_t)14, "Segment: line opportunity after a replaced byte")
+
+    // An incomplete trailing sequence stays in the last segment
+    count = 16;
+    ATT_ASSERT_STATUS(mjb_segment("ab\xC3", 3, MJB_ENC_UTF_8, MJB_SEGMENT_GRAPHEME, offsets,
+        &count), MJB_STATUS_OK, "Segment: truncated graphemes status")
+    ATT_ASSERT(count, (size_t)2, "Segment: truncated graphemes count")
+    ATT_ASSERT(offsets[1], (size_t)3, "Segment: truncated sequence ends the last grapheme")
+}
+
 int test_segmentation(void *arg) {
     test_basic_segmentation();
     test_truncate();
     test_grapheme_count();
+    test_segment();
     read_test_file("./utils/generate/unicode-data/UCD/auxiliary/GraphemeBreakTest.txt",
         &segmentation_callback);
 
@@ -51,6 +51,31 @@ int test_utf(void *arg) {
     in_error = false; \
     codepoint = 0;
 
+    // A multi-byte sequence is decoded by a single call.
+    const char *buffer_utf8 = "\xC3\xA9";
+
+    RESET_STATE()
+
+    result = mjb_next_codepoint(buffer_utf8, 2, &state, &index, MJB_ENC_UTF_8, &codepoint,
+        &in_error);
+
+    ATT_ASSERT((int)result, (int)MJB_DECODE_OK, "UTF-8: MJB_DECODE_OK")
+    ATT_ASSERT(codepoint, 0xE9, "UTF-8: U+00E9")
+    ATT_ASSERT(index, 2, "UTF-8: index 2")
+
+    RESET_STATE()
+
+    result = mjb_next_codepoint(buffer_utf8, 1, &state, &index, MJB_ENC_UTF_8, &codepoint,
+        &in_error);
+
+    ATT_ASSERT((int)result, (int)MJB_DECODE_INCOMPLETE, "UTF-8 truncated: MJB_DECODE_INCOMPLETE")
+
+    result = mjb_next_codepoint(buffer_utf8, 1, &state, &index, MJB_ENC_UTF_8, &codepoint,
+        &in_error);
+
+    ATT_ASSERT((int)result, (int)MJB_DECODE_ERROR, "UTF-8 truncated: MJB_DECODE_ERROR")
+    ATT_ASSERT(codepoint, MJB_CODEPOINT_REPLACEMENT, "UTF-8 truncated: replacement")
+
     RESET_STATE()
 
     result = mjb_next_codepoint(buffer_utf16be, size_utf16be, &state, &index, MJB_ENC_UTF_16BE,
@@ -185,14 +210,7 @@ int test_utf(void *arg) {
 
     RESET_STATE()
 
-    result = mjb_next_codepoint(buffer_utf16be_emoji, 4, &state, &index, MJB_ENC_UTF_16BE,
-        &codepoint, &in_error);
-
-    ATT_ASSERT((int)result, (int)MJB_DECODE_INCOMPLETE,
-        "UTF-16BE surrogate: high surrogate incomplete")
-    ATT_ASSERT((int)state, (int)MJB_UTF_PENDING_SURROGATE, "UTF-16BE surrogate: pending state")
-    ATT_ASSERT(index, 2, "UTF-16BE surrogate: index 2")
-
+    // Both surrogates are consumed by a single call.
     result = mjb_next_codepoint(buffer_utf16be_emoji, 4, &state, &index, MJB_ENC_UTF_16BE,
         &codepoint, &in_error);
 
@@ -202,18 +220,21 @@ int test_utf(void *arg) {
     ATT_ASSERT(index, 4, "UTF-16BE surrogate: index 4")
     ATT_ASSERT(in_error, false, "UTF-16BE surrogate: not error state")
 
-    const char *buffer_utf16le_emoji = "\x3D\xD8\x42\xDE";
-
     RESET_STATE()
 
-    result = mjb_next_codepoint(buffer_utf16le_emoji, 4, &state, &index, MJB_ENC_UTF_16LE,
+    result = mjb_next_codepoint(buffer_utf16be_emoji, 2, &state, &index, MJB_ENC_UTF_16BE,
         &codepoint, &in_error);
 
     ATT_ASSERT((int)result, (int)MJB_DECODE_INCOMPLETE,
-        "UTF-16LE surrogate: high surrogate incomplete")
-    ATT_ASSERT((int)state, (int)MJB_UTF_PENDING_SURROGATE, "UTF-16LE surrogate: pending state")
-    ATT_ASSERT(index, 2, "UTF-16LE surrogate: index 2")
+        "UTF-16BE surrogate: high surrogate at end incomplete")
+    ATT_ASSERT((int)state, (int)MJB_UTF_PENDING_SURROGATE, "UTF-16BE surrogate: pending state")
+    ATT_ASSERT(index, 2, "UTF-16BE surrogate: index 2")
+
+    const char *buffer_utf16le_emoji = "\x3D\xD8\x42\xDE";
+
+    RESET_STATE()
 
+    // Both surrogates are consumed by a single call.
     result = mjb_next_codepoint(buffer_utf16le_emoji, 4, &state, &index, MJB_ENC_UTF_16LE,
         &codepoint, &in_error);
 
@@ -223,6 +244,16 @@ int test_utf(void *arg) {
     ATT_ASSERT(index, 4, "UTF-16LE surrogate: index 4")
     ATT_ASSERT(in_error, false, "UTF-16LE surrogate: not error state")
 
+    RESET_STATE()
+
+    result = mjb_next_codepoint(buffer_utf16le_emoji, 2, &state, &index, MJB_ENC_UTF_16LE,
+        &codepoint, &in_error);
+
+    ATT_ASSERT((int)result, (int)MJB_DECODE_INCOMPLETE,
+        "UTF-16LE surrogate: high surrogate at end incomplete")
+    ATT_ASSERT((int)state, (int)MJB_UTF_PENDING_SURROGATE, "UTF-16LE surrogate: pending state")
+    ATT_ASSERT(index, 2, "UTF-16LE surrogate: index 2")
+
     // Truncated trailing units must terminate decoding (one replacement, then end), not loop.
     MJB_TEST_COVERAGE(mjb_codepoint_count);
 
@@ -151,7 +151,7 @@ async function readUnicodeData(blocks: Block[], exclusions: number[], stripSigns
   addEmojiProperties(emojis);
   addEmojiSequences(emojiSequences);
   addSpecialCasing(newCases);
-  addPropertyRanges(propertyRanges);
+  addPropertyRanges(propertyRanges, properties);
   addScriptExtensions(await readScriptExtensions(properties));
 
   const caseFolds = await generateCasefold(characters);
@@ -16,10 +16,10 @@ import { generateDecompositionAndCompositionTables } from './unicode-data/compos
 import { generateConfusables } from './unicode-data/confusable';
 import { generateEmoji } from './unicode-data/emoji';
 import { generateIdnaMappings } from './unicode-data/idna';
-import { generateNCharacters } from './unicode-data/n-characters';
+import { generateCodepointRecords, generateNCharacters } from './unicode-data/n-characters';
 import { generateNames } from './unicode-data/names';
 import { generateNumericValues } from './unicode-data/numeric';
-import { generateProperties } from './unicode-data/properties';
+import { generateProperties, generateSegmentationProperties } from './unicode-data/properties';
 import { generateScriptExtensions } from './unicode-data/script-extensions';
 
 // Writes the generated Unicode C tables from the in-memory generation data.
@@ -44,8 +44,11 @@ ${generateEmoji(data.emoji, data.emojiSequences)}
 ${generateIdnaMappings(data.idnaMappings)}
 #endif // MJB_FEATURE_IDNA
 ${generateProperties(data.properties)}
+${generateSegmentationProperties(data.properties, data.propertyIds)}
 ${generateScriptExtensions(data.scriptExtensions)}
 ${generateNCharacters(data.nCharacters)}
+${generateCodepointRecords(data.nCharacters, data.numericValues, data.properties,
+  data.propertyIds)}
 ${generateDecompositionAndCompositionTables(data.decompositions,
   data.compatibilityDecompositions, data.compositions)}
 ${generateNumericValues(data.numericValues)}
@@ -41,6 +41,103 @@ function collectDecompositionGroups(rows: DecompositionRow[]) {
   return groups;
 }
 
+// Composition pairs are stored in a perfect hash: the pair selects a bucket, the bucket a
+// displacement, and the pair hashed with the displacement its slot. Keep these and
+// compositionHash() in sync with mjb_unicode_compose_pair() in src/unicode-tables.c.
+const COMPOSITION_BUCKET_BITS = 8;
+const COMPOSITION_TABLE_BITS = 10;
+
+// Hashes a starter and combining pair with a seed.
+function compositionHash(starter: number, combining: number, seed: number) {
+  let hash = ((Math.imul(starter, 0x9E3779B1) + combining) ^ seed) >>> 0;
+  hash ^= hash >>> 16;
+  hash = Math.imul(hash, 0x85EBCA6B) >>> 0;
+  hash ^= hash >>> 13;
+  hash = Math.imul(hash, 0xC2B2AE35) >>> 0;
+  hash ^= hash >>> 16;
+
+  return hash >>> 0;
+}
+
+// Emits the composition pairs as a hash and displace table, one probe per lookup.
+export function generateCompositionTable(compositionRows: CompositionRow[]) {
+  const tableSize = 1 << COMPOSITION_TABLE_BITS;
+  const bucketCount = 1 << COMPOSITION_BUCKET_BITS;
+
+  if(compositionRows.length > tableSize) {
+    throw new Error(`Too many composition pairs for the hash table: ${compositionRows.length}`);
+  }
+
+  const buckets: CompositionRow[][] = Array.from({ length: bucketCount }, () => []);
+
+  for(const row of compositionRows) {
+    if(row.starter_codepoint > 0x1FFFFF ||
+      row.combining_codepoint > 0x1FFFFF ||
+      row.composite_codepoint > 0x1FFFFF) {
+      throw new Error(`Composition codepoint is too large to pack: ${row.composite_codepoint}`);
+    }
+
+    const hash = compositionHash(row.starter_codepoint, row.combining_codepoint, 0);
+    buckets[hash >>> (32 - COMPOSITION_BUCKET_BITS)].push(row);
+  }
+
+  const displacements = new Array<number>(bucketCount).fill(0);
+  const entries = new Array<bigint>(tableSize).fill(0n);
+  const used = new Array<boolean>(tableSize).fill(false);
+  const order = buckets.map((_, index) => index)
+    .sort((a, b) => buckets[b].length - buckets[a].length || a - b);
+
+  // Place the largest buckets first, while most of the slots are still free.
+  for(const index of order) {
+    const bucket = buckets[index];
+
+    if(bucket.length === 0) {
+      break;
+    }
+
+    let placed = false;
+
+    for(let seed = 0; seed <= 0xFFFF && !placed; ++seed) {
+      const slots = bucket.map((row) =>
+        compositionHash(row.starter_codepoint, row.combining_codepoint, seed) & (tableSize - 1));
+
+      if(slots.some((slot, i) => used[slot] || slots.indexOf(slot) !== i)) {
+        continue;
+      }
+
+      slots.forEach((slot, i) => {
+        const row = bucket[i];
+        used[slot] = true;
+        entries[slot] = BigInt(row.starter_codepoint) |
+          (BigInt(row.combining_codepoint) << 21n) |
+          (BigInt(row.composite_codepoint) << 42n);
+      });
+
+      displacements[index] = seed;
+      placed = true;
+    }
+
+    if(!placed) {
+      throw new Error(`No displacement found for composition bucket ${index}`);
+    }
+  }
+
+  return `enum {
+    MJB_UNICODE_COMPOSITION_BUCKET_BITS = ${COMPOSITION_BUCKET_BITS},
+    MJB_UNICODE_COMPOSITION_TABLE_BITS = ${COMPOSITION_TABLE_BITS},
+    MJB_UNICODE_COMPOSITION_COUNT = ${compositionRows.length}
+};
+
+static const uint16_t mjb_unicode_composition_displacements[] = {
+${formatHalfwords(displacements)}
+};
+
+static const mjb_unicode_composition_entry mjb_unicode_compositions[] = {
+${formatLongWords(entries)}
+};
+`;
+}
+
 // Emits shared decomposition data, packed decomposition entries, and composition pairs.
 export function generateDecompositionAndCompositionTables(
   canonicalRows: DecompositionRow[],
@@ -148,18 +245,6 @@ ${formatBytes(emittedExceptionLengths)}
 `;
   };
 
-  const compositionEntries = compositionRows.map((row) => {
-    if(row.starter_codepoint > 0x1FFFFF ||
-      row.combining_codepoint > 0x1FFFFF ||
-      row.composite_codepoint > 0x1FFFFF) {
-      throw new Error(`Composition codepoint is too large to pack: ${row.composite_codepoint}`);
-    }
-
-    return BigInt(row.starter_codepoint) |
-      (BigInt(row.combining_codepoint) << 21n) |
-      (BigInt(row.composite_codepoint) << 42n);
-  });
-
   const canonicalTable = emitTable('canonical', canonicalGroups);
   const compatibilityTable = emitTable('compatibility', compatibilityGroups);
 
@@ -171,8 +256,5 @@ ${formatCodepoints(data)}
 
 ${canonicalTable}
 ${compatibilityTable}
-static const mjb_unicode_composition_entry mjb_unicode_compositions[] = {
-${formatLongWords(compositionEntries)}
-};
-`;
+${generateCompositionTable(compositionRows)}`;
 }
@@ -5,8 +5,11 @@
  */
 
 import { iLog } from '../../log';
-import { bitset, formatBytes, formatPages, formatWords, indexedPages } from '../../utils';
-import { NCharacterRow } from '../types';
+import {
+  bitset, formatBytes, formatPages, formatWords, indexedPages, packedValueTrie,
+} from '../../utils';
+import { NCharacterRow, NumericRow, PropertyRangeRow } from '../types';
+import { decodePropertyBlob } from './properties';
 
 // Builds per-256-codepoint page start/count metadata for codepoint ranges.
 function codepointRangePages(rows: { start: number; end: number }[]) {
@@ -127,3 +130,67 @@ ${formatBytes(mirrored)}
 };
 `;
 }
+
+// Emits the character properties the string loops read for every codepoint as a three-stage trie
+// of packed records. Keep the layout in sync with mjb_unicode_record_lookup() in
+// src/unicode-tables.c.
+export function generateCodepointRecords(rows: NCharacterRow[], numericRows: NumericRow[],
+  propertyRows: PropertyRangeRow[], propertyIds: Record<string, number>) {
+  iLog('Codepoint records');
+
+  const cased = propertyIds['Cased'];
+  const caseIgnorable = propertyIds['CI'];
+
+  if(cased === undefined || caseIgnorable === undefined) {
+    throw new Error('Codepoint record property metadata is missing');
+  }
+
+  const packed = new Uint32Array(0x110000);
+
+  for(const row of rows) {
+    packed[row.codepoint] = (row.category |
+      ((row.combining ?? 0) << 5) |
+      (row.bidirectional << 13) |
+      (1 << 22)) >>> 0;
+  }
+
+  // Decimal values are stored plus one, zero when there is none.
+  for(const row of numericRows) {
+    if(row.decimal !== null && (packed[row.codepoint] & (1 << 22)) !== 0) {
+      packed[row.codepoint] = (packed[row.codepoint] | ((row.decimal + 1) << 18)) >>> 0;
+    }
+  }
+
+  // Cased and Case_Ignorable, on assigned codepoints only.
+  for(const row of propertyRows) {
+    const values = decodePropertyBlob(row.properties);
+    const bits = (values.has(cased) ? 1 << 23 : 0) | (values.has(caseIgnorable) ? 1 << 24 : 0);
+
+    if(bits === 0) {
+      continue;
+    }
+
+    const end = row.end_codepoint ?? row.start_codepoint;
+
+    for(let codepoint = row.start_codepoint; codepoint <= end; ++codepoint) {
+      if((packed[codepoint] & (1 << 22)) !== 0) {
+        packed[codepoint] = (packed[codepoint] | bits) >>> 0;
+      }
+    }
+  }
+
+  const { pageIndex, pages, values } = packedValueTrie(packed, 'codepoint record');
+
+  return `static const uint8_t mjb_unicode_record_page_index[] = {
+${formatBytes(pageIndex, 24)}
+};
+
+static const uint8_t mjb_unicode_record_pages[] = {
+${formatBytes(pages, 24)}
+};
+
+static const uint32_t mjb_unicode_record_values[] = {
+${formatWords(values, 12)}
+};
+`;
+}
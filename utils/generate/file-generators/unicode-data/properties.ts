@@ -5,7 +5,7 @@
  */
 
 import { iLog } from '../../log';
-import { formatBytes, formatHalfwords, formatWords } from '../../utils';
+import { formatBytes, formatHalfwords, formatWords, packedValueTrie } from '../../utils';
 import { PropertyRangeRow } from '../types';
 
 // Emits interned property blobs and page-local property ranges.
@@ -104,3 +104,105 @@ ${formatWords(entries, 12)}
 };
 `;
 }
+
+// Bit layout of the packed segmentation properties. Keep in sync with the MJB_SEGMENTATION_*
+// accessors in src/mojibake-internal.h.
+const segmentationFields = [
+  { name: 'GCB', shift: 0, bits: 5 },
+  { name: 'WB', shift: 5, bits: 5 },
+  { name: 'SB', shift: 10, bits: 4 },
+  { name: 'lb', shift: 14, bits: 6 },
+  { name: 'ea', shift: 20, bits: 3 },
+  { name: 'InCB', shift: 23, bits: 3 },
+  { name: 'ExtPict', shift: 26, bits: 1 },
+];
+
+// Decodes a property blob into a property ID to value map. Boolean properties have value 1.
+export function decodePropertyBlob(blob: Buffer) {
+  const values = new Map<number, number>();
+  let offset = 0;
+  const boolCount = blob[offset++];
+
+  for(let i = 0; i < boolCount && offset < blob.length; ++i) {
+    values.set(blob[offset++], 1);
+  }
+
+  if(offset >= blob.length) {
+    return values;
+  }
+
+  const enumCount = blob[offset++];
+
+  for(let i = 0; i < enumCount && offset + 1 < blob.length; ++i) {
+    values.set(blob[offset], blob[offset + 1]);
+    offset += 2;
+  }
+
+  return values;
+}
+
+// Emits the segmentation properties of every codepoint as a three-stage trie: a page index
+// (codepoint >> 8), deduplicated 256-entry pages of value indices and the packed values.
+export function generateSegmentationProperties(rows: PropertyRangeRow[],
+  propertyIds: Record<string, number>) {
+  iLog('Segmentation properties');
+
+  const fields = segmentationFields.map((field) => {
+    const id = propertyIds[field.name];
+
+    if(id === undefined) {
+      throw new Error(`Segmentation property metadata is missing: ${field.name}`);
+    }
+
+    return { ...field, id };
+  });
+
+  const packed = new Uint32Array(0x110000);
+
+  // Later rows override earlier ones, as in mjb_unicode_properties().
+  for(const row of rows) {
+    const values = decodePropertyBlob(row.properties);
+    let bits = 0;
+    let mask = 0;
+
+    for(const field of fields) {
+      const value = values.get(field.id);
+
+      if(value === undefined) {
+        continue;
+      }
+
+      if(value >= (1 << field.bits)) {
+        throw new Error(`Segmentation property ${field.name} value is too large to pack: ${value}`);
+      }
+
+      bits |= value << field.shift;
+      mask |= ((1 << field.bits) - 1) << field.shift;
+    }
+
+    if(mask === 0) {
+      continue;
+    }
+
+    const end = row.end_codepoint ?? row.start_codepoint;
+
+    for(let codepoint = row.start_codepoint; codepoint <= end; ++codepoint) {
+      packed[codepoint] = ((packed[codepoint] & ~mask) | bits) >>> 0;
+    }
+  }
+
+  const { pageIndex, pages, values } = packedValueTrie(packed, 'segmentation property');
+
+  return `static const uint8_t mjb_unicode_segmentation_page_index[] = {
+${formatBytes(pageIndex, 24)}
+};
+
+static const uint8_t mjb_unicode_segmentation_pages[] = {
+${formatBytes(pages, 24)}
+};
+
+static const uint32_t mjb_unicode_segmentation_values[] = {
+${formatWords(values, 12)}
+};
+`;
+}
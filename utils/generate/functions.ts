@@ -331,6 +331,256 @@ printf("NFC payload (no terminator): %.*s", (int)output_size, output);`,
       'mjb_nfkc_casefold_into'],
     specs: [uax(15, 'Unicode Normalization Forms')]
   },
+  {
+    comment: 'Initialize a streaming normalizer.',
+    ret: 'mjb_status',
+    name: 'mjb_normalizer_init',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'normalizer',
+        type: 'mjb_normalizer *',
+        description: 'The normalizer to initialize',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_normalizer_free`'
+      },
+      encoding('The encoding of the input chunks'),
+      {
+        name: 'form',
+        type: 'mjb_normalization',
+        description: 'The normalization form to use',
+        wasm_generated: false,
+        is_enum: true
+      },
+      encoding('The output encoding', 'output_encoding')
+    ],
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Prepare a normalizer for a string that arrives in chunks, such as a log stream or ' +
+      'an upload read from a socket. Feed the chunks with `mjb_normalizer_feed` and end the ' +
+      'stream with `mjb_normalizer_finish`. The output is the same as `mjb_normalize` on the ' +
+      'whole string. `MJB_ENC_UTF_16` and `MJB_ENC_UTF_32` read the byte order from the BOM at ' +
+      'the start of the stream. The normalizer allocates its state once; its buffers then only ' +
+      'grow with the longest combining sequence and the output of a chunk. A normalizer is not ' +
+      'thread-safe. Release it with `mjb_normalizer_free`, also after a failed initialization.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The normalizer was initialized' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`normalizer` is NULL' },
+      { value: 'MJB_STATUS_INVALID_FORM', description: 'The normalization form is invalid' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The input or output encoding is invalid' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' }
+    ],
+    example: `mjb_normalizer normalizer;
+
+if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+    MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+    return 1;
+}
+
+bool nfd = normalizer.form == MJB_NORMALIZATION_NFD;
+mjb_normalizer_free(&normalizer);
+
+// Normalizer form is NFD: yes
+printf("Normalizer form is NFD: %s", nfd ? "yes" : "no");`,
+    related: ['mjb_normalizer_feed', 'mjb_normalizer_finish', 'mjb_normalizer_free',
+      'mjb_normalize'],
+    specs: [uax(15, 'Unicode Normalization Forms')]
+  },
+  {
+    comment: 'Free a streaming normalizer.',
+    ret: 'void',
+    name: 'mjb_normalizer_free',
+    attributes: [],
+    args: [
+      {
+        name: 'normalizer',
+        type: 'mjb_normalizer *',
+        description: 'The normalizer to free',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Release the state owned by a normalizer and reset it. Passing NULL is a no-op. ' +
+      'Output that was not delivered is discarded. The normalizer must be initialized again ' +
+      'before it is reused.',
+    example: `mjb_normalizer normalizer;
+
+if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+    MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+    return 1;
+}
+
+mjb_normalizer_free(&normalizer);
+
+// Normalizer released: yes
+printf("Normalizer released: %s", normalizer.state == NULL ? "yes" : "no");`,
+    related: ['mjb_normalizer_init']
+  },
+  {
+    comment: 'Normalize the next chunk of a stream into a caller-provided buffer.',
+    ret: 'mjb_status',
+    name: 'mjb_normalizer_feed',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'normalizer',
+        type: 'mjb_normalizer *',
+        description: 'The normalizer initialized with `mjb_normalizer_init`',
+        wasm_generated: false
+      },
+      buffer('The next chunk of the string'),
+      byte_length('The length of the chunk in bytes, or `MJB_NUL_TERMINATED`'),
+      {
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided output buffer, or NULL to query the pending size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
+        type: 'size_t *',
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Decode and normalize a chunk. Chunks can split a code unit, a UTF-8 or UTF-16 ' +
+      'sequence or a combining sequence anywhere: the characters that can still change are ' +
+      'kept until a later chunk closes their segment. The whole chunk is always consumed. The ' +
+      'output ready so far is written to `output` following the `mjb_normalize_into` ' +
+      'conventions: NULL queries its size, and a buffer that is too small is left untouched ' +
+      'with the required size in `*output_size`. The output is kept in both cases; call again ' +
+      'with a NULL or empty chunk to collect it. After an error other than ' +
+      '`MJB_STATUS_OUTPUT_TOO_SMALL` the stream cannot continue.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The chunk was consumed and the pending output was measured or written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`normalizer` is not initialized, `output_size` is NULL, or `buffer` is NULL with a ' +
+        'non-zero size' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The chunk contains an ill-formed code-unit sequence, or a UTF-16/UTF-32 stream has no BOM' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The chunk was consumed but the output buffer is too small for the pending output' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' }
+    ],
+    example: `mjb_normalizer normalizer;
+char output[16];
+size_t written = 0;
+size_t size = sizeof(output);
+
+if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFC,
+    MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// The combining acute accent arrives in the second chunk.
+if(mjb_normalizer_feed(&normalizer, "Cafe", 4, output, &size) != MJB_STATUS_OK) {
+    mjb_normalizer_free(&normalizer);
+    return 1;
+}
+
+written = size;
+size = sizeof(output) - written;
+
+if(mjb_normalizer_feed(&normalizer, "\\xCC\\x81", 2, output + written,
+    &size) != MJB_STATUS_OK) {
+    mjb_normalizer_free(&normalizer);
+    return 1;
+}
+
+written += size;
+size = sizeof(output) - written;
+
+if(mjb_normalizer_finish(&normalizer, output + written, &size) != MJB_STATUS_OK) {
+    mjb_normalizer_free(&normalizer);
+    return 1;
+}
+
+written += size;
+mjb_normalizer_free(&normalizer);
+
+// NFC stream: Café
+printf("NFC stream: %.*s", (int)written, output);`,
+    related: ['mjb_normalizer_init', 'mjb_normalizer_finish', 'mjb_normalize_into'],
+    specs: [uax(15, 'Unicode Normalization Forms')]
+  },
+  {
+    comment: 'End a normalization stream into a caller-provided buffer.',
+    ret: 'mjb_status',
+    name: 'mjb_normalizer_finish',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'normalizer',
+        type: 'mjb_normalizer *',
+        description: 'The normalizer initialized with `mjb_normalizer_init`',
+        wasm_generated: false
+      },
+      {
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided output buffer, or NULL to query the pending size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
+        type: 'size_t *',
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Normalize the characters still buffered by `mjb_normalizer_feed` and deliver the ' +
+      'remaining output like `mjb_normalizer_feed` does. Call it again with a larger buffer ' +
+      'after `MJB_STATUS_OUTPUT_TOO_SMALL`. The normalizer is then ready for a new stream with ' +
+      'the same options.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The stream ended and the pending output was measured or written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`normalizer` is not initialized or `output_size` is NULL' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The stream ends inside a code unit, a multi-unit sequence or a BOM' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The output buffer is too small for the pending output' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' }
+    ],
+    example: `mjb_normalizer normalizer;
+char output[8];
+size_t size = 0;
+
+if(mjb_normalizer_init(&normalizer, MJB_ENC_UTF_8, MJB_NORMALIZATION_NFD,
+    MJB_ENC_UTF_8) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// The last character waits for a combining mark that never comes.
+if(mjb_normalizer_feed(&normalizer, "\\xC3\\xA9", 2, NULL, &size) != MJB_STATUS_OK) {
+    mjb_normalizer_free(&normalizer);
+    return 1;
+}
+
+size = sizeof(output);
+
+if(mjb_normalizer_finish(&normalizer, output, &size) != MJB_STATUS_OK) {
+    mjb_normalizer_free(&normalizer);
+    return 1;
+}
+
+mjb_normalizer_free(&normalizer);
+
+// Bytes written by finish: 3
+printf("Bytes written by finish: %zu", size);`,
+    related: ['mjb_normalizer_feed', 'mjb_normalizer_init'],
+    specs: [uax(15, 'Unicode Normalization Forms')]
+  },
   {
     comment: 'Filter a string with the selected mjb_filter_flags.',
     ret: 'mjb_status',
@@ -656,7 +906,8 @@ mjb_result_free(&result);`,
     section: Section.TextTransformation,
     details: 'Apply the same strict nontransitional profile as `mjb_idna_to_ascii`. Set `output` ' +
       'to NULL to query the required byte count. No bytes are written if capacity is ' +
-      'insufficient. Processing uses temporary allocations even during a size query. If ' +
+      'insufficient. Processing runs in `MJB_IDNA_SCRATCH_SIZE` bytes of stack scratch and only ' +
+      'allocates for domains that do not fit, also during a size query. If ' +
       '`MJB_FEATURE_IDNA=0` the function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
       { value: 'MJB_STATUS_OK', description:
@@ -769,7 +1020,8 @@ mjb_result_free(&result);`,
     section: Section.TextTransformation,
     details: 'Apply the same strict nontransitional profile as `mjb_idna_to_unicode`. Set ' +
       '`output` to NULL to query the required byte count. No bytes are written if capacity is ' +
-      'insufficient. Processing uses temporary allocations even during a size query. If ' +
+      'insufficient. Processing runs in `MJB_IDNA_SCRATCH_SIZE` bytes of stack scratch and only ' +
+      'allocates for domains that do not fit, also during a size query. If ' +
       '`MJB_FEATURE_IDNA=0` the function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
       { value: 'MJB_STATUS_OK', description:
@@ -793,479 +1045,1374 @@ mjb_result_free(&result);`,
     specs: [uts(46, 'Unicode IDNA Compatibility Processing')]
   },
   {
-    comment: 'Check if a string is normalized to NFC/NFKC/NFD/NFKD form.',
+    comment: 'Initialize a reusable IDNA context.',
     ret: 'mjb_status',
-    name: 'mjb_normalization_quick_check',
+    name: 'mjb_idna_context_init',
     attributes: ['MJB_NODISCARD'],
     args: [
-      buffer('The string to check'),
-      byte_length(),
-      encoding(),
       {
-        name: 'form',
-        type: 'mjb_normalization',
-        description: 'The normalization form to check',
+        name: 'context',
+        type: 'mjb_idna_context *',
+        description: 'The context to initialize',
         wasm_generated: false,
-        is_enum: true
+        ownership: 'Caller-owned; release with `mjb_idna_context_free`'
       },
       {
-        name: 'quick_check',
-        type: 'mjb_quick_check_result *',
-        description: 'The quick-check result to store',
-        wasm_generated: true
+        name: 'scratch',
+        type: 'void *',
+        description: 'The caller-provided scratch memory, or NULL to use the heap',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership; it must outlive the context'
+      },
+      {
+        name: 'scratch_size',
+        type: 'size_t',
+        description: 'The size of `scratch` in bytes',
+        wasm_generated: false
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    details: 'Run the normalization quick-check on a string without allocating. `MJB_QC_MAYBE` ' +
-      'means the string may still be normalized, and only a full normalization pass with ' +
-      '`mjb_normalize` can decide.',
+    wasm: false,
+    section: Section.TextTransformation,
+    exampleFeature: 'MJB_FEATURE_IDNA',
+    details: 'Prepare a context for `mjb_idna_context_to_ascii_into` and ' +
+      '`mjb_idna_context_to_unicode_into`. The scratch holds every intermediate form of a ' +
+      'domain; `MJB_IDNA_SCRATCH_SIZE` bytes fit any domain of up to 253 octets, so a stack ' +
+      'buffer of that size makes the conversions allocation-free. Without a scratch the first ' +
+      'conversion allocates one and later ones reuse it. Initialization does not allocate. ' +
+      'Release the context with `mjb_idna_context_free`. If `MJB_FEATURE_IDNA=0` the function ' +
+      'always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
-      { value: 'MJB_STATUS_OK', description: '`quick_check` contains `MJB_QC_YES`, `MJB_QC_NO`, or `MJB_QC_MAYBE`' },
-      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`quick_check` is NULL, or `buffer` is NULL with a non-zero size' },
-      { value: 'MJB_STATUS_INVALID_ENCODING', description: '`encoding` is invalid or a generic UTF-16/UTF-32 encoding has no byte-order information' },
-      { value: 'MJB_STATUS_INVALID_FORM', description: '`form` is not NFC, NFD, NFKC, or NFKD' },
-      { value: 'MJB_STATUS_MALFORMED_INPUT', description: 'The input contains an ill-formed code-unit sequence' }
+      { value: 'MJB_STATUS_OK', description: 'The context was initialized' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`context` is NULL, or `scratch` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_IDNA=0`' }
     ],
-    example: `const char *input = "caf\\xC3\\xA9";
-mjb_quick_check_result check;
+    example: `char scratch[MJB_IDNA_SCRATCH_SIZE];
+mjb_idna_context context;
 
-if(mjb_normalization_quick_check(input, strlen(input), MJB_ENC_UTF_8,
-    MJB_NORMALIZATION_NFC, &check) != MJB_STATUS_OK) {
+if(mjb_idna_context_init(&context, scratch, sizeof(scratch)) != MJB_STATUS_OK) {
     return 1;
 }
 
-// NFC normalized: yes
-printf("NFC normalized: %s", check == MJB_QC_YES ? "yes" : "no");`,
-    related: ['mjb_normalize'],
-    specs: [uax(15, 'Unicode Normalization Forms')]
-  },
-  {
-    comment: 'Return the string encoding (the most probable).',
-    ret: 'mjb_encoding',
-    name: 'mjb_detect_encoding',
-    attributes: [
-      'MJB_PURE'
-    ],
-    args: [
-      buffer('The string to check'),
-      byte_length('The explicit length of the string, in bytes')
-    ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    details: '`mjb_detect_encoding` reports BOM-derived UTF-16/UTF-32 schemes with the generic ' +
-      'family bit plus the resolved endian bit. Passing that detected value consumes the leading ' +
-      'BOM as a signature. Passing an explicit-endian encoding such as `MJB_ENC_UTF_16BE` preserves ' +
-      'an initial U+FEFF as text. When flags overlap, as with a UTF-32LE BOM that also has the ' +
-      'UTF-16LE BOM prefix, decoding gives UTF-32 precedence. `MJB_NUL_TERMINATED` is not ' +
-      'accepted because the encoding, and therefore the NUL code-unit width, is unknown.',
-    example: `const char utf16le[] = "\\xFF\\xFEH\\0i\\0";
-mjb_encoding detected = mjb_detect_encoding(utf16le, sizeof(utf16le) - 1);
-bool is_utf16le = detected == (MJB_ENC_UTF_16 | MJB_ENC_UTF_16LE);
+size_t capacity = context.capacity;
+mjb_idna_context_free(&context);
 
-// UTF-16LE detected: yes
-printf("UTF-16LE detected: %s", is_utf16le ? "yes" : "no");`
+// Scratch capacity: 4096
+printf("Scratch capacity: %zu", capacity);`,
+    related: ['mjb_idna_context_free', 'mjb_idna_context_to_ascii_into',
+      'mjb_idna_context_to_unicode_into'],
+    specs: [uts(46, 'Unicode IDNA Compatibility Processing')]
   },
   {
-    comment: 'Return true if the string is encoded in ASCII.',
-    ret: 'bool',
-    name: 'mjb_is_ascii',
-    attributes: [
-      'MJB_PURE'
-    ],
+    comment: 'Free the scratch of an IDNA context.',
+    ret: 'void',
+    name: 'mjb_idna_context_free',
+    attributes: [],
     args: [
-      buffer('The string to check'),
-      byte_length()
+      {
+        name: 'context',
+        type: 'mjb_idna_context *',
+        description: 'The context to free',
+        wasm_generated: false
+      }
     ],
-    wasm: true,
-    wasmName: 'isASCII',
-    section: Section.TextAnalysis,
-    example: `const char *input = "Plain ASCII";
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Release the heap scratch of the context, if it grew one, and reset it. Scratch ' +
+      'memory given to `mjb_idna_context_init` is never freed. Passing NULL is a no-op.',
+    example: `mjb_idna_context context;
 
-// ASCII: yes
-printf("ASCII: %s", mjb_is_ascii(input, strlen(input)) ? "yes" : "no");`
-  },
-  {
-    comment: 'Return true if the string is encoded in UTF-8.',
-    ret: 'bool',
-    name: 'mjb_is_utf8',
-    attributes: [
-      'MJB_PURE'
-    ],
-    args: [
-      buffer('The string to check'),
-      byte_length()
-    ],
-    wasm: true,
-    wasmName: 'isUTF8',
-    section: Section.TextAnalysis,
-    example: `const char *input = "caf\\xC3\\xA9";
+if(mjb_idna_context_init(&context, NULL, 0) != MJB_STATUS_OK) {
+    return 1;
+}
 
-// Valid UTF-8: yes
-printf("Valid UTF-8: %s", mjb_is_utf8(input, strlen(input)) ? "yes" : "no");`
+mjb_idna_context_free(&context);
+
+// Context released: yes
+printf("Context released: %s", context.scratch == NULL ? "yes" : "no");`,
+    related: ['mjb_idna_context_init']
   },
   {
-    comment: 'Return true if the string is encoded in UTF-16BE or UTF-16LE.',
-    ret: 'bool',
-    name: 'mjb_is_utf16',
-    attributes: [
-      'MJB_PURE'
-    ],
+    comment: 'Convert a domain name to its UTS #46 nontransitional ASCII form using an IDNA context.',
+    ret: 'mjb_status',
+    name: 'mjb_idna_context_to_ascii_into',
+    attributes: ['MJB_NODISCARD'],
     args: [
-      buffer('The string to check'),
-      byte_length()
-    ],
-    wasm: true,
-    wasmName: 'isUTF16',
-    section: Section.TextAnalysis,
-    example: `const char utf16be[] = "\\xFE\\xFF\\0H\\0i"; // BOM + "Hi" in UTF-16BE
-
-// UTF-16: yes
-printf("UTF-16: %s", mjb_is_utf16(utf16be, sizeof(utf16be) - 1) ? "yes" : "no");`
-  },
-  {
-    comment: 'Count the codepoints in a string.',
-    ret: 'mjb_status',
-    name: 'mjb_codepoint_count',
-    attributes: ['MJB_NODISCARD'],
-    args: [
-      buffer('The string to count'),
+      {
+        name: 'context',
+        type: 'mjb_idna_context *',
+        description: 'The context initialized with `mjb_idna_context_init`',
+        wasm_generated: false
+      },
+      buffer('The domain name to process'),
       byte_length(),
       encoding(),
+      encoding('The output encoding of the ASCII domain name', 'output_encoding'),
       {
-        name: 'count',
+        name: 'info',
+        type: 'mjb_idna_info *',
+        description: 'The UTS #46 validation errors to store',
+        wasm_generated: false
+      },
+      {
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided output buffer, or NULL to query the required size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
         type: 'size_t *',
-        description: 'The number of codepoints to store; set to zero on failure',
-        wasm_generated: true
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    details: 'Count the number of Unicode codepoints in a string. Malformed code-unit sequences ' +
-      'count per the library replacement policy, and an incomplete trailing sequence does not ' +
-      'add a codepoint. On failure, `count` is set to zero.',
+    wasm: false,
+    section: Section.TextTransformation,
+    exampleFeature: 'MJB_FEATURE_IDNA',
+    details: 'Produce the same output as `mjb_idna_to_ascii_into`. Mapping, normalization, ' +
+      'Punycode and validation all run in the scratch of the context, so a context that fits ' +
+      'the domains converts them without any heap allocation. A scratch that is too small is ' +
+      'moved to the heap and grown, and stays grown for the next calls. A context is not ' +
+      'thread-safe; use one per thread. If `MJB_FEATURE_IDNA=0` the function always returns ' +
+      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
-      { value: 'MJB_STATUS_OK', description: 'The count was computed' },
-      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`count` is NULL, or `buffer` is NULL with a non-zero size' },
-      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'The encoding is not a supported input encoding' }
+      { value: 'MJB_STATUS_OK', description:
+        'The required size was returned or the ASCII domain was written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`context`, `info` or `output_size` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'An encoding is invalid' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The requested output encoding cannot represent the result' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'An output or scratch size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Growing the scratch failed' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The output capacity is smaller than the required byte count' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_IDNA=0`' }
     ],
-    example: `// The "Héllö" string is five Unicode characters, but has different byte lengths in different encodings.
-
-const char *utf8 = "H\\xC3\\xA9ll\\xC3\\xB6"; // 7 bytes
-const char utf16le[] = "H\\0\\xE9\\0l\\0l\\0\\xF6\\0"; // 10 bytes
-size_t count;
+    example: `char scratch[MJB_IDNA_SCRATCH_SIZE];
+mjb_idna_context context;
+mjb_idna_info info;
+char output[64];
+size_t output_size = sizeof(output);
 
-if(mjb_codepoint_count(utf8, 7, MJB_ENC_UTF_8, &count) != MJB_STATUS_OK) {
+if(mjb_idna_context_init(&context, scratch, sizeof(scratch)) != MJB_STATUS_OK ||
+    mjb_idna_context_to_ascii_into(&context, "b\\xC3\\xBC" "cher.example", MJB_NUL_TERMINATED,
+        MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size) != MJB_STATUS_OK) {
+    mjb_idna_context_free(&context);
     return 1;
 }
 
-// 5 UTF-8 characters
-printf("%zu UTF-8 characters", count);
-
-if(mjb_codepoint_count(utf16le, 10, MJB_ENC_UTF_16LE, &count) != MJB_STATUS_OK) {
-    return 1;
-}
+mjb_idna_context_free(&context);
 
-// 5 UTF-16LE characters
-printf("%zu UTF-16LE characters", count);`,
-    related: ['mjb_grapheme_count', 'mjb_word_count', 'mjb_sentence_count']
+// xn--bcher-kva.example
+printf("%.*s", (int)output_size, output);`,
+    related: ['mjb_idna_context_init', 'mjb_idna_to_ascii_into',
+      'mjb_idna_context_to_unicode_into'],
+    specs: [uts(46, 'Unicode IDNA Compatibility Processing')]
   },
   {
-    comment: 'Run a callback for each codepoint of a string.',
+    comment: 'Convert a domain name to its UTS #46 nontransitional Unicode form using an IDNA context.',
     ret: 'mjb_status',
-    name: 'mjb_for_each_codepoint',
+    name: 'mjb_idna_context_to_unicode_into',
     attributes: ['MJB_NODISCARD'],
     args: [
-      buffer('The string to check'),
+      {
+        name: 'context',
+        type: 'mjb_idna_context *',
+        description: 'The context initialized with `mjb_idna_context_init`',
+        wasm_generated: false
+      },
+      buffer('The domain name to process'),
       byte_length(),
       encoding(),
+      encoding('The output encoding of the Unicode domain name', 'output_encoding'),
       {
-        name: 'callback',
-        type: 'mjb_for_each_codepoint_fn',
-        description: 'The function to call for each codepoint',
-        wasm_generated: true
+        name: 'info',
+        type: 'mjb_idna_info *',
+        description: 'The UTS #46 validation errors to store',
+        wasm_generated: false
+      },
+      {
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided output buffer, or NULL to query the required size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
+        type: 'size_t *',
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    example: `mjb_status status = mjb_for_each_codepoint("ABC", 3, MJB_ENC_UTF_8, NULL);
+    wasm: false,
+    section: Section.TextTransformation,
+    exampleFeature: 'MJB_FEATURE_IDNA',
+    details: 'Produce the same output as `mjb_idna_to_unicode_into`. Mapping, normalization, ' +
+      'Punycode and validation all run in the scratch of the context, so a context that fits ' +
+      'the domains converts them without any heap allocation. A scratch that is too small is ' +
+      'moved to the heap and grown, and stays grown for the next calls. A context is not ' +
+      'thread-safe; use one per thread. If `MJB_FEATURE_IDNA=0` the function always returns ' +
+      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The required size was returned or the Unicode domain was written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`context`, `info` or `output_size` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'An encoding is invalid' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The requested output encoding cannot represent the result' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'An output or scratch size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Growing the scratch failed' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The output capacity is smaller than the required byte count' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_IDNA=0`' }
+    ],
+    example: `char scratch[MJB_IDNA_SCRATCH_SIZE];
+mjb_idna_context context;
+mjb_idna_info info;
+char output[64];
+size_t output_size = sizeof(output);
 
-// A callback is required: yes
-bool callback_required = status == MJB_STATUS_INVALID_ARGUMENT;
+if(mjb_idna_context_init(&context, scratch, sizeof(scratch)) != MJB_STATUS_OK ||
+    mjb_idna_context_to_unicode_into(&context, "xn--bcher-kva.example", MJB_NUL_TERMINATED,
+        MJB_ENC_UTF_8, MJB_ENC_UTF_8, &info, output, &output_size) != MJB_STATUS_OK) {
+    mjb_idna_context_free(&context);
+    return 1;
+}
 
-// A callback is required: yes
-printf("A callback is required: %s", callback_required ? "yes" : "no");`
+mjb_idna_context_free(&context);
+
+// bücher.example
+printf("%.*s", (int)output_size, output);`,
+    related: ['mjb_idna_context_init', 'mjb_idna_to_unicode_into',
+      'mjb_idna_context_to_ascii_into'],
+    specs: [uts(46, 'Unicode IDNA Compatibility Processing')]
   },
   {
-    comment: 'Return the value of a binary Unicode property.',
+    comment: 'Convert an array of domain names to their UTS #46 nontransitional ASCII form.',
     ret: 'mjb_status',
-    name: 'mjb_codepoint_property_binary',
+    name: 'mjb_idna_to_ascii_batch',
     attributes: ['MJB_NODISCARD'],
     args: [
-      codepoint(),
       {
-        name: 'property',
-        type: 'mjb_property',
-        description: 'The binary property to query',
+        name: 'domains',
+        type: 'const char *const *',
+        description: 'The domain names to process',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'byte_lengths',
+        type: 'const size_t *',
+        description: 'The byte length of each domain, or NULL if all are NUL-terminated',
         wasm_generated: false
       },
       {
-        name: 'value',
-        type: 'bool *',
-        description: 'Where to store the binary property value',
-        wasm_generated: true
+        name: 'count',
+        type: 'size_t',
+        description: 'The number of domains',
+        wasm_generated: false
+      },
+      encoding(),
+      {
+        name: 'parallel_for',
+        type: 'mjb_parallel_for_fn',
+        description: 'Runs the conversion tasks on a thread pool, or NULL to convert in order',
+        wasm_generated: false
+      },
+      {
+        name: 'pool',
+        type: 'void *',
+        description: 'Passed unchanged to `parallel_for`',
+        wasm_generated: false
+      },
+      {
+        name: 'result',
+        type: 'mjb_idna_batch *',
+        description: 'Output batch',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_idna_batch_free`'
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    details: 'Return `true` when the codepoint has the binary property and `false` when it does ' +
-      'not. Passing an enumerated property is a type mismatch and returns ' +
-      '`MJB_STATUS_INVALID_ARGUMENT`.',
-    example: `bool is_alphabetic;
+    wasm: false,
+    section: Section.TextTransformation,
+    exampleFeature: 'MJB_FEATURE_IDNA',
+    details: 'Run `mjb_idna_to_ascii` on every domain and store the UTF-8 results back to back in ' +
+      'one buffer. The result of domain `i` spans the bytes from `offsets[i]` to ' +
+      '`offsets[i + 1]` of `domains`, and its validation errors are in `infos[i]`. A domain ' +
+      'that is not valid in the encoding gets `MJB_IDNA_ERROR_DISALLOWED` and an empty result ' +
+      'instead of failing the batch. The scratch is reused across domains, and the validation ' +
+      'errors and ASCII form of recent top-level labels are cached, so a list that repeats a ' +
+      'few TLDs converts each of them once. With `parallel_for` the domains are split into ' +
+      'tasks of 1024, each with its own scratch and cache. If `MJB_FEATURE_IDNA=0` the ' +
+      'function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'Every domain was converted' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`result` is NULL, `domains` is NULL with a non-zero count, or a domain is NULL with a ' +
+        'non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The input encoding is invalid, or a UTF-16 or UTF-32 domain has no BOM' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The batch size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Memory allocation failed' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_IDNA=0`' }
+    ],
+    example: `const char *domains[] = { "B\\xC3\\xBC" "cher.example", "WWW.Example.COM" };
+mjb_idna_batch batch;
 
-if(mjb_codepoint_property_binary('A', MJB_PR_ALPHABETIC,
-    &is_alphabetic) != MJB_STATUS_OK) {
+if(mjb_idna_to_ascii_batch(domains, NULL, 2, MJB_ENC_UTF_8, NULL, NULL, &batch) !=
+    MJB_STATUS_OK) {
     return 1;
 }
 
-// U+0041 is alphabetic: yes
-printf("U+0041 is alphabetic: %s", is_alphabetic ? "yes" : "no");`,
-    related: ['mjb_codepoint_property_int'],
-    specs: [uax(44, 'Unicode Character Database')]
+char first[64];
+snprintf(first, sizeof(first), "%.*s", (int)(batch.offsets[1] - batch.offsets[0]),
+    batch.domains);
+mjb_idna_batch_free(&batch);
+
+// xn--bcher-kva.example
+printf("%s", first);`,
+    related: ['mjb_idna_to_ascii', 'mjb_idna_to_ascii_lines', 'mjb_idna_batch_free'],
+    specs: [uts(46, 'Unicode IDNA Compatibility Processing')]
   },
   {
-    comment: 'Return the value of an enumerated or integer Unicode property.',
+    comment: 'Convert a newline-separated list of domain names to their UTS #46 nontransitional ASCII form.',
     ret: 'mjb_status',
-    name: 'mjb_codepoint_property_int',
+    name: 'mjb_idna_to_ascii_lines',
     attributes: ['MJB_NODISCARD'],
     args: [
-      codepoint(),
+      buffer('The newline-separated domain names to process'),
+      byte_length(),
+      encoding(),
       {
-        name: 'property',
-        type: 'mjb_property',
-        description: 'The enumerated or integer property to query',
+        name: 'parallel_for',
+        type: 'mjb_parallel_for_fn',
+        description: 'Runs the conversion tasks on a thread pool, or NULL to convert in order',
         wasm_generated: false
       },
       {
-        name: 'value',
-        type: 'int32_t *',
-        description: 'Where to store the property value',
-        wasm_generated: true
+        name: 'pool',
+        type: 'void *',
+        description: 'Passed unchanged to `parallel_for`',
+        wasm_generated: false
+      },
+      {
+        name: 'result',
+        type: 'mjb_idna_batch *',
+        description: 'Output batch',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_idna_batch_free`'
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    details: 'Passing a binary property is a type mismatch and returns ' +
-      '`MJB_STATUS_INVALID_ARGUMENT`. `MJB_STATUS_NOT_FOUND` means that the codepoint has no ' +
-      'stored value for the requested property.',
-    example: `int32_t script;
+    wasm: false,
+    section: Section.TextTransformation,
+    exampleFeature: 'MJB_FEATURE_IDNA',
+    details: 'Split the input on LF, dropping the CR of a CR LF pair, and convert every line as ' +
+      '`mjb_idna_to_ascii_batch` does. A final LF does not start another line, while an empty ' +
+      'line is an empty domain. Only UTF-8 and ASCII input is accepted. If ' +
+      '`MJB_FEATURE_IDNA=0` the function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'Every line was converted' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`result` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The input encoding is not UTF-8 or ASCII' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The batch size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Memory allocation failed' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_IDNA=0`' }
+    ],
+    example: `mjb_idna_batch batch;
 
-if(mjb_codepoint_property_int('A', MJB_PR_SCRIPT, &script) != MJB_STATUS_OK) {
+if(mjb_idna_to_ascii_lines("a.example\\r\\nM\\xC3\\xBCnchen.DE\\n", MJB_NUL_TERMINATED,
+    MJB_ENC_UTF_8, NULL, NULL, &batch) != MJB_STATUS_OK) {
     return 1;
 }
 
-// U+0041 uses the Latin script: yes
-printf("U+0041 uses the Latin script: %s", script == MJB_SC_LATN ? "yes" : "no");`,
-    related: ['mjb_codepoint_property_binary'],
-    specs: [uax(44, 'Unicode Character Database')]
+char second[64];
+snprintf(second, sizeof(second), "%.*s", (int)(batch.offsets[2] - batch.offsets[1]),
+    batch.domains + batch.offsets[1]);
+size_t count = batch.count;
+mjb_idna_batch_free(&batch);
+
+// Domains: 2, second: xn--mnchen-3ya.de
+printf("Domains: %zu, second: %s", count, second);`,
+    related: ['mjb_idna_to_ascii_batch', 'mjb_idna_batch_free'],
+    specs: [uts(46, 'Unicode IDNA Compatibility Processing')]
   },
   {
-    comment: 'Return the numeric value of a codepoint.',
-    ret: 'mjb_status',
-    name: 'mjb_codepoint_numeric_value',
-    attributes: ['MJB_NODISCARD'],
+    comment: 'Free an IDNA batch allocated by mjb_idna_to_ascii_batch or mjb_idna_to_ascii_lines.',
+    ret: 'void',
+    name: 'mjb_idna_batch_free',
+    attributes: [],
     args: [
-      codepoint(),
       {
-        name: 'value',
-        type: 'mjb_numeric_value *',
-        description: 'The numeric value to store the result',
-        wasm_generated: true
+        name: 'batch',
+        type: 'mjb_idna_batch *',
+        description: 'The batch to free',
+        wasm_generated: false
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    details: 'Return the numeric value of a codepoint, if any. If the codepoint has no numeric ' +
-      'value, `value->decimal` and `value->digit` are set to `MJB_NUMBER_NOT_VALID` (-1).',
-    returns: [
-      { value: 'MJB_STATUS_OK', description: 'The character was found and filled' },
-      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`value` is NULL or the codepoint is not valid' },
-    ],
-    example: `mjb_numeric_value num;
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Release the domains, offsets and errors of the batch and reset it. Passing NULL is ' +
+      'a no-op.',
+    example: `mjb_idna_batch batch = { NULL, NULL, NULL, 0 };
+mjb_idna_batch_free(&batch);
+
+// Batch released: yes
+printf("Batch released: %s", batch.domains == NULL ? "yes" : "no");`,
+    related: ['mjb_idna_to_ascii_batch', 'mjb_idna_to_ascii_lines']
+  },
+  {
+    comment: 'Check if a string is normalized to NFC/NFKC/NFD/NFKD form.',
+    ret: 'mjb_status',
+    name: 'mjb_normalization_quick_check',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to check'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'form',
+        type: 'mjb_normalization',
+        description: 'The normalization form to check',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'quick_check',
+        type: 'mjb_quick_check_result *',
+        description: 'The quick-check result to store',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: 'Run the normalization quick-check on a string without allocating. `MJB_QC_MAYBE` ' +
+      'means the string may still be normalized, and only a full normalization pass with ' +
+      '`mjb_normalize` can decide.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: '`quick_check` contains `MJB_QC_YES`, `MJB_QC_NO`, or `MJB_QC_MAYBE`' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`quick_check` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: '`encoding` is invalid or a generic UTF-16/UTF-32 encoding has no byte-order information' },
+      { value: 'MJB_STATUS_INVALID_FORM', description: '`form` is not NFC, NFD, NFKC, or NFKD' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description: 'The input contains an ill-formed code-unit sequence' }
+    ],
+    example: `const char *input = "caf\\xC3\\xA9";
+mjb_quick_check_result check;
 
-if(mjb_codepoint_numeric_value(0x0031, &num) != MJB_STATUS_OK) { // U+0031 = 1
+if(mjb_normalization_quick_check(input, strlen(input), MJB_ENC_UTF_8,
+    MJB_NORMALIZATION_NFC, &check) != MJB_STATUS_OK) {
     return 1;
 }
 
-// decimal=1, digit=1, numeric=1
-printf("decimal=%d, digit=%d, numeric=%s", num.decimal, num.digit, num.numeric);
+// NFC normalized: yes
+printf("NFC normalized: %s", check == MJB_QC_YES ? "yes" : "no");`,
+    related: ['mjb_normalize'],
+    specs: [uax(15, 'Unicode Normalization Forms')]
+  },
+  {
+    comment: 'Return the string encoding (the most probable).',
+    ret: 'mjb_encoding',
+    name: 'mjb_detect_encoding',
+    attributes: [
+      'MJB_PURE'
+    ],
+    args: [
+      buffer('The string to check'),
+      byte_length('The explicit length of the string, in bytes')
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: '`mjb_detect_encoding` reports BOM-derived UTF-16/UTF-32 schemes with the generic ' +
+      'family bit plus the resolved endian bit. Passing that detected value consumes the leading ' +
+      'BOM as a signature. Passing an explicit-endian encoding such as `MJB_ENC_UTF_16BE` preserves ' +
+      'an initial U+FEFF as text. When flags overlap, as with a UTF-32LE BOM that also has the ' +
+      'UTF-16LE BOM prefix, decoding gives UTF-32 precedence. `MJB_NUL_TERMINATED` is not ' +
+      'accepted because the encoding, and therefore the NUL code-unit width, is unknown.',
+    example: `const char utf16le[] = "\\xFF\\xFEH\\0i\\0";
+mjb_encoding detected = mjb_detect_encoding(utf16le, sizeof(utf16le) - 1);
+bool is_utf16le = detected == (MJB_ENC_UTF_16 | MJB_ENC_UTF_16LE);
 
-if(mjb_codepoint_numeric_value(0x00BD, &num) != MJB_STATUS_OK) { // U+00BD = '½'
+// UTF-16LE detected: yes
+printf("UTF-16LE detected: %s", is_utf16le ? "yes" : "no");`
+  },
+  {
+    comment: 'Return true if the string is encoded in ASCII.',
+    ret: 'bool',
+    name: 'mjb_is_ascii',
+    attributes: [
+      'MJB_PURE'
+    ],
+    args: [
+      buffer('The string to check'),
+      byte_length()
+    ],
+    wasm: true,
+    wasmName: 'isASCII',
+    section: Section.TextAnalysis,
+    example: `const char *input = "Plain ASCII";
+
+// ASCII: yes
+printf("ASCII: %s", mjb_is_ascii(input, strlen(input)) ? "yes" : "no");`
+  },
+  {
+    comment: 'Return true if the string is encoded in UTF-8.',
+    ret: 'bool',
+    name: 'mjb_is_utf8',
+    attributes: [
+      'MJB_PURE'
+    ],
+    args: [
+      buffer('The string to check'),
+      byte_length()
+    ],
+    wasm: true,
+    wasmName: 'isUTF8',
+    section: Section.TextAnalysis,
+    example: `const char *input = "caf\\xC3\\xA9";
+
+// Valid UTF-8: yes
+printf("Valid UTF-8: %s", mjb_is_utf8(input, strlen(input)) ? "yes" : "no");`
+  },
+  {
+    comment: 'Return true if the string is encoded in UTF-16BE or UTF-16LE.',
+    ret: 'bool',
+    name: 'mjb_is_utf16',
+    attributes: [
+      'MJB_PURE'
+    ],
+    args: [
+      buffer('The string to check'),
+      byte_length()
+    ],
+    wasm: true,
+    wasmName: 'isUTF16',
+    section: Section.TextAnalysis,
+    example: `const char utf16be[] = "\\xFE\\xFF\\0H\\0i"; // BOM + "Hi" in UTF-16BE
+
+// UTF-16: yes
+printf("UTF-16: %s", mjb_is_utf16(utf16be, sizeof(utf16be) - 1) ? "yes" : "no");`
+  },
+  {
+    comment: 'Count the codepoints in a string.',
+    ret: 'mjb_status',
+    name: 'mjb_codepoint_count',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to count'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'count',
+        type: 'size_t *',
+        description: 'The number of codepoints to store; set to zero on failure',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: 'Count the number of Unicode codepoints in a string. Malformed code-unit sequences ' +
+      'count per the library replacement policy, and an incomplete trailing sequence does not ' +
+      'add a codepoint. On failure, `count` is set to zero.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The count was computed' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`count` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'The encoding is not a supported input encoding' }
+    ],
+    example: `// The "Héllö" string is five Unicode characters, but has different byte lengths in different encodings.
+
+const char *utf8 = "H\\xC3\\xA9ll\\xC3\\xB6"; // 7 bytes
+const char utf16le[] = "H\\0\\xE9\\0l\\0l\\0\\xF6\\0"; // 10 bytes
+size_t count;
+
+if(mjb_codepoint_count(utf8, 7, MJB_ENC_UTF_8, &count) != MJB_STATUS_OK) {
     return 1;
 }
 
-// decimal=-1, digit=-1, numeric=1/2
-printf("decimal=%d, digit=%d, numeric=%s", num.decimal, num.digit, num.numeric);`,
+// 5 UTF-8 characters
+printf("%zu UTF-8 characters", count);
+
+if(mjb_codepoint_count(utf16le, 10, MJB_ENC_UTF_16LE, &count) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// 5 UTF-16LE characters
+printf("%zu UTF-16LE characters", count);`,
+    related: ['mjb_grapheme_count', 'mjb_word_count', 'mjb_sentence_count']
+  },
+  {
+    comment: 'Run a callback for each codepoint of a string.',
+    ret: 'mjb_status',
+    name: 'mjb_for_each_codepoint',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to check'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'callback',
+        type: 'mjb_for_each_codepoint_fn',
+        description: 'The function to call for each codepoint',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    example: `mjb_status status = mjb_for_each_codepoint("ABC", 3, MJB_ENC_UTF_8, NULL);
+
+// A callback is required: yes
+bool callback_required = status == MJB_STATUS_INVALID_ARGUMENT;
+
+// A callback is required: yes
+printf("A callback is required: %s", callback_required ? "yes" : "no");`
+  },
+  {
+    comment: 'Return the value of a binary Unicode property.',
+    ret: 'mjb_status',
+    name: 'mjb_codepoint_property_binary',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      codepoint(),
+      {
+        name: 'property',
+        type: 'mjb_property',
+        description: 'The binary property to query',
+        wasm_generated: false
+      },
+      {
+        name: 'value',
+        type: 'bool *',
+        description: 'Where to store the binary property value',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: 'Return `true` when the codepoint has the binary property and `false` when it does ' +
+      'not. Passing an enumerated property is a type mismatch and returns ' +
+      '`MJB_STATUS_INVALID_ARGUMENT`.',
+    example: `bool is_alphabetic;
+
+if(mjb_codepoint_property_binary('A', MJB_PR_ALPHABETIC,
+    &is_alphabetic) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// U+0041 is alphabetic: yes
+printf("U+0041 is alphabetic: %s", is_alphabetic ? "yes" : "no");`,
+    related: ['mjb_codepoint_property_int'],
     specs: [uax(44, 'Unicode Character Database')]
   },
   {
-    comment: 'Return the character block.',
+    comment: 'Return the value of an enumerated or integer Unicode property.',
     ret: 'mjb_status',
-    name: 'mjb_codepoint_block',
+    name: 'mjb_codepoint_property_int',
     attributes: ['MJB_NODISCARD'],
     args: [
       codepoint(),
       {
-        name: 'block',
-        type: 'mjb_block_info *',
-        description: 'The block to store the result',
-        wasm_generated: true
+        name: 'property',
+        type: 'mjb_property',
+        description: 'The enumerated or integer property to query',
+        wasm_generated: false
+      },
+      {
+        name: 'value',
+        type: 'int32_t *',
+        description: 'Where to store the property value',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: 'Passing a binary property is a type mismatch and returns ' +
+      '`MJB_STATUS_INVALID_ARGUMENT`. `MJB_STATUS_NOT_FOUND` means that the codepoint has no ' +
+      'stored value for the requested property.',
+    example: `int32_t script;
+
+if(mjb_codepoint_property_int('A', MJB_PR_SCRIPT, &script) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// U+0041 uses the Latin script: yes
+printf("U+0041 uses the Latin script: %s", script == MJB_SC_LATN ? "yes" : "no");`,
+    related: ['mjb_codepoint_property_binary', 'mjb_codepoints_property_int',
+      'mjb_string_property_int'],
+    specs: [uax(44, 'Unicode Character Database')]
+  },
+  {
+    comment: 'Return the enumerated or integer property values of an array of codepoints.',
+    ret: 'mjb_status',
+    name: 'mjb_codepoints_property_int',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'codepoints',
+        type: 'const mjb_codepoint *',
+        description: 'The codepoints to query',
+        wasm_generated: false
+      },
+      {
+        name: 'count',
+        type: 'size_t',
+        description: 'The number of codepoints',
+        wasm_generated: false
+      },
+      {
+        name: 'property',
+        type: 'mjb_property',
+        description: 'The enumerated or integer property to query',
+        wasm_generated: false
+      },
+      {
+        name: 'values',
+        type: 'int32_t *',
+        description: 'Where to store `count` property values',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.TextAnalysis,
+    details: 'The batch form of `mjb_codepoint_property_int`. The arguments are validated once, ' +
+      'and the property page is reused while neighbouring codepoints share it. A codepoint with ' +
+      'no stored value, or that is not valid, stores 0, which is the "not set" value of every ' +
+      'enumerated property.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The values were written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`property` is not an enumerated or integer property, or an array is NULL with a ' +
+        'non-zero `count`' }
+    ],
+    example: `const mjb_codepoint codepoints[] = { 'A', 0x03A9, '1' };
+int32_t scripts[3];
+
+if(mjb_codepoints_property_int(codepoints, 3, MJB_PR_SCRIPT, scripts) != MJB_STATUS_OK) {
+    return 1;
+}
+
+bool expected = scripts[0] == MJB_SC_LATN && scripts[1] == MJB_SC_GREK &&
+    scripts[2] == MJB_SC_ZYYY;
+
+// Latin, Greek, Common: yes
+printf("Latin, Greek, Common: %s", expected ? "yes" : "no");`,
+    related: ['mjb_codepoint_property_int', 'mjb_string_property_int'],
+    specs: [uax(44, 'Unicode Character Database')]
+  },
+  {
+    comment: 'Return the enumerated or integer property values of the codepoints of a string.',
+    ret: 'mjb_status',
+    name: 'mjb_string_property_int',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to classify'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'property',
+        type: 'mjb_property',
+        description: 'The enumerated or integer property to query',
+        wasm_generated: false
+      },
+      {
+        name: 'values',
+        type: 'int32_t *',
+        description: 'The caller-provided value buffer, or NULL to query the required count',
+        wasm_generated: false
+      },
+      {
+        name: 'count',
+        type: 'size_t *',
+        description: 'The input capacity and output codepoint count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.TextAnalysis,
+    details: 'Decode the string and store one property value per codepoint in a single pass, as ' +
+      '`mjb_codepoints_property_int` would. Malformed code-unit sequences count per the library ' +
+      'replacement policy and are classified as U+FFFD. Set `values` to NULL to query the ' +
+      'required count. When the buffer is too small, the values that fit are written and ' +
+      '`*count` receives the required count.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The required count was returned or the values were written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`count` is NULL, `property` is not an enumerated or integer property, or `buffer` is ' +
+        'NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The encoding is not a supported input encoding' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The value capacity is smaller than the codepoint count' }
+    ],
+    example: `const char *input = "a\\xCE\\xA9"; // "a" + U+03A9 GREEK CAPITAL LETTER OMEGA
+int32_t widths[2];
+size_t count = 2;
+
+if(mjb_string_property_int(input, strlen(input), MJB_ENC_UTF_8, MJB_PR_EAST_ASIAN_WIDTH,
+    widths, &count) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// U+03A9 is ambiguous: yes
+printf("U+03A9 is ambiguous: %s", widths[1] == MJB_EAW_AMBIGUOUS ? "yes" : "no");`,
+    related: ['mjb_codepoints_property_int', 'mjb_codepoint_count'],
+    specs: [uax(44, 'Unicode Character Database')]
+  },
+  {
+    comment: 'Return the numeric value of a codepoint.',
+    ret: 'mjb_status',
+    name: 'mjb_codepoint_numeric_value',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      codepoint(),
+      {
+        name: 'value',
+        type: 'mjb_numeric_value *',
+        description: 'The numeric value to store the result',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: 'Return the numeric value of a codepoint, if any. If the codepoint has no numeric ' +
+      'value, `value->decimal` and `value->digit` are set to `MJB_NUMBER_NOT_VALID` (-1).',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The character was found and filled' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`value` is NULL or the codepoint is not valid' },
+    ],
+    example: `mjb_numeric_value num;
+
+if(mjb_codepoint_numeric_value(0x0031, &num) != MJB_STATUS_OK) { // U+0031 = 1
+    return 1;
+}
+
+// decimal=1, digit=1, numeric=1
+printf("decimal=%d, digit=%d, numeric=%s", num.decimal, num.digit, num.numeric);
+
+if(mjb_codepoint_numeric_value(0x00BD, &num) != MJB_STATUS_OK) { // U+00BD = '½'
+    return 1;
+}
+
+// decimal=-1, digit=-1, numeric=1/2
+printf("decimal=%d, digit=%d, numeric=%s", num.decimal, num.digit, num.numeric);`,
+    specs: [uax(44, 'Unicode Character Database')]
+  },
+  {
+    comment: 'Return the character block.',
+    ret: 'mjb_status',
+    name: 'mjb_codepoint_block',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      codepoint(),
+      {
+        name: 'block',
+        type: 'mjb_block_info *',
+        description: 'The block to store the result',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    example: `mjb_block_info block;
+
+if(mjb_codepoint_block('A', &block) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// Block: Basic Latin
+printf("Block: %s", block.name);`,
+    specs: [uax(44, 'Unicode Character Database')]
+  },
+  {
+    comment: 'Return the script of a codepoint.',
+    ret: 'mjb_script',
+    name: 'mjb_codepoint_script',
+    attributes: [],
+    args: [codepoint()],
+    wasm: true,
+    section: Section.TextAnalysis,
+    example: `mjb_script script = mjb_codepoint_script(0x03A9); // Greek capital omega
+
+// Greek script: yes
+printf("Greek script: %s", script == MJB_SC_GREK ? "yes" : "no");`,
+    specs: [uax(44, 'Unicode Character Database')]
+  },
+  {
+    comment: 'Return the Script_Extensions set of a codepoint.',
+    ret: 'mjb_status',
+    name: 'mjb_codepoint_script_extensions',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      codepoint(),
+      {
+        name: 'scripts',
+        type: 'mjb_script *',
+        description: 'The caller-provided script buffer, or NULL to query the required count',
+        wasm_generated: true
+      },
+      {
+        name: 'count',
+        type: 'size_t *',
+        description: 'The input capacity and output script count',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.TextAnalysis,
+    details: 'Return the explicit Script_Extensions set, or the ordinary Script value when the ' +
+      'codepoint has no explicit Script_Extensions entry. Call first with `scripts` set to NULL ' +
+      'to obtain the required count.',
+    example: `size_t count = 0;
+
+if(mjb_codepoint_script_extensions(0x30FC, NULL, &count) != MJB_STATUS_OK) {
+    return 1;
+}
+
+mjb_script scripts[3];
+
+if(count > 3 || mjb_codepoint_script_extensions(0x30FC, scripts,
+    &count) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// U+30FC has 2 Script_Extensions
+printf("U+30FC has %zu Script_Extensions", count);`,
+    related: ['mjb_codepoint_script'],
+    specs: [uax(24, 'Unicode Script Property')]
+  },
+  {
+    comment: 'Encode a codepoint to a string.',
+    ret: 'unsigned int',
+    name: 'mjb_codepoint_encode',
+    attributes: [],
+    args: [
+      codepoint('The codepoint to encode'),
+      buffer('The buffer to encode the codepoint to', 'buffer', false, true),
+      byte_length('The length of the buffer, in bytes'),
+      encoding('The encoding to use')
+    ],
+    wasm: true,
+    section: Section.TextTransformation,
+    example: `char encoded[4];
+unsigned int size = mjb_codepoint_encode(0x20AC, encoded, sizeof(encoded), MJB_ENC_UTF_8);
+
+// € sign uses 3 UTF-8 bytes
+printf("%.*s sign uses %u UTF-8 bytes", (int)size, encoded, size);`
+  },
+  {
+    comment: 'Convert from one encoding to another.',
+    ret: 'mjb_status',
+    name: 'mjb_convert_encoding',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to convert'),
+      byte_length(),
+      encoding('The input encoding of the string'),
+      encoding('The output encoding of the string', 'output_encoding'),
+      result()
+    ],
+    wasm: true,
+    section: Section.TextTransformation,
+    details: 'Convert a string between the supported encodings (UTF-8, UTF-16LE/BE, ' +
+      'UTF-32LE/BE). Generic UTF-16/UTF-32 input consumes a leading BOM as the encoding scheme ' +
+      'signature and uses it to resolve byte order. Explicit-endian input preserves an initial ' +
+      'U+FEFF as text. Generic UTF-16/UTF-32 without a BOM, and generic UTF-16/UTF-32 output, are ' +
+      'rejected because the byte order is not specified.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The string was converted' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`result` is NULL, `buffer` is NULL with a non-zero size, or the input is not valid in the source encoding' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'A generic UTF-16/UTF-32 encoding did not provide enough byte order information' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description: 'The requested encoding conversion is not supported' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The output size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' }
+    ],
+    example: `const char *input = "caf\\xC3\\xA9";
+mjb_result result;
+
+if(mjb_convert_encoding(input, strlen(input), MJB_ENC_UTF_8,
+    MJB_ENC_UTF_16LE, &result) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// UTF-16LE bytes: 8
+printf("UTF-16LE bytes: %zu", result.output_size);
+mjb_result_free(&result);`,
+    related: ['mjb_convert_encoding_into', 'mjb_detect_encoding', 'mjb_codepoint_encode']
+  },
+  {
+    comment: 'Convert from one encoding to another into a caller-provided buffer.',
+    ret: 'mjb_status',
+    name: 'mjb_convert_encoding_into',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to convert'),
+      byte_length(),
+      encoding('The input encoding of the string'),
+      encoding('The output encoding of the string', 'output_encoding'),
+      {
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided output buffer, or NULL to query the required size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
+        type: 'size_t *',
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.TextTransformation,
+    details: 'Convert a string using the same encoding and BOM rules as ' +
+      '`mjb_convert_encoding`, without allocating memory. Set `output` to NULL to query the ' +
+      'required size. If `output` is non-NULL, `*output_size` supplies its capacity; on return ' +
+      'it contains the required size when the buffer is too small, or the written size on ' +
+      'success. The size is the encoded payload byte count: terminators are excluded, and ' +
+      'this function does not write a terminator. No bytes are written when capacity is ' +
+      'insufficient.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The required size was returned or the string was converted' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`output_size` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'A generic UTF-16/UTF-32 encoding did not provide enough byte order information' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The requested encoding conversion is not supported' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The required output size would overflow' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The output capacity is smaller than the required byte count' }
+    ],
+    example: `const char *input = "caf\\xC3\\xA9";
+size_t output_size = 0;
+
+if(mjb_convert_encoding_into(input, strlen(input), MJB_ENC_UTF_8,
+    MJB_ENC_UTF_16LE, NULL, &output_size) != MJB_STATUS_OK) {
+    return 1;
+}
+
+unsigned char output[8];
+
+if(output_size > sizeof(output) || mjb_convert_encoding_into(input, strlen(input),
+    MJB_ENC_UTF_8, MJB_ENC_UTF_16LE, output, &output_size) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// UTF-16LE payload bytes (no terminator): 8
+printf("UTF-16LE payload bytes (no terminator): %zu", output_size);`,
+    related: ['mjb_convert_encoding', 'mjb_detect_encoding', 'mjb_codepoint_encode']
+  },
+  {
+    comment: 'Compare two strings using a Unicode caseless matching relation.',
+    ret: 'mjb_status',
+    name: 'mjb_caseless_match',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The first string to compare', 's1'),
+      byte_length('The length of the first string in bytes, or `MJB_NUL_TERMINATED`',
+        's1_byte_length'),
+      encoding('The encoding of the first string', 's1_encoding'),
+      buffer('The second string to compare', 's2'),
+      byte_length('The length of the second string in bytes, or `MJB_NUL_TERMINATED`',
+        's2_byte_length'),
+      encoding('The encoding of the second string', 's2_encoding'),
+      {
+        name: 'mode',
+        type: 'mjb_caseless_mode',
+        description: 'The Unicode caseless matching relation',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'matches',
+        type: 'bool *',
+        description: 'Whether the strings are a caseless match',
+        wasm_generated: true
+      }
+    ],
+    wasm: true,
+    section: Section.SortingComparison,
+    details: 'Compare two strings for case-insensitive equality using Unicode full default case ' +
+      'folding. Canonical mode implements D145 and is recommended for ordinary text. ' +
+      'Unnormalized mode implements D144 without normalization. Compatibility mode implements ' +
+      'the iterated folding and compatibility normalization required by D146. Identifier mode ' +
+      'implements D147 by applying NFD before `mjb_nfkc_casefold`; it removes default-ignorable ' +
+      'codepoints but does not validate identifier syntax.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: '`matches` contains the comparison result' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`matches` is NULL, an input buffer is NULL with a non-zero size, or `mode` is invalid' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'An input encoding is invalid or lacks byte-order information' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'An input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'An intermediate size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The identifier case-folding transform did not converge' }
+    ],
+    example: `const char *left = "Stra\\xC3\\x9F" "e";
+const char *right = "STRASSE";
+bool matches;
+
+if(mjb_caseless_match(left, strlen(left), MJB_ENC_UTF_8,
+    right, strlen(right), MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, &matches) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// Canonical caseless match: yes
+printf("Canonical caseless match: %s", matches ? "yes" : "no");`,
+    related: ['mjb_map_case', 'mjb_nfkc_casefold', 'mjb_normalize',
+      'mjb_collation_compare', 'mjb_is_identifier'],
+    specs: [
+      unicodeCore('Section 3.13.5', 'Default Caseless Matching', 'G33992'),
+      uax(31, 'Unicode Identifiers and Syntax')
+    ]
+  },
+  {
+    comment: 'Hash a string so that caseless matches have the same hash.',
+    ret: 'mjb_status',
+    name: 'mjb_caseless_hash',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to hash'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'mode',
+        type: 'mjb_caseless_mode',
+        description: 'The Unicode caseless matching relation',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'seed',
+        type: 'uint64_t',
+        description: 'A seed mixed into the hash, for example a random per-table value',
+        wasm_generated: false
+      },
+      {
+        name: 'hash',
+        type: 'uint64_t *',
+        description: 'The hash of the folded form of the string',
+        wasm_generated: false
       }
     ],
-    wasm: true,
-    section: Section.TextAnalysis,
-    example: `mjb_block_info block;
+    wasm: false,
+    section: Section.SortingComparison,
+    details: 'Compute the 64-bit FNV-1a hash, with `seed` XORed into the offset basis, of the UTF-8 ' +
+      'form `mjb_caseless_match` compares in `mode`. Two strings that are a caseless match in a ' +
+      'mode have the same hash in that mode, whatever their encodings, so the function can key ' +
+      'a case-insensitive hash table that resolves collisions with `mjb_caseless_match`. The ' +
+      'folded form is hashed as it is produced and is not allocated, except in identifier mode.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: '`hash` contains the hash' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`hash` is NULL, `buffer` is NULL with a non-zero size, or `mode` is invalid' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The encoding is invalid or lacks byte-order information' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The identifier case-folding transform did not converge' }
+    ],
+    example: `uint64_t left;
+uint64_t right;
 
-if(mjb_codepoint_block('A', &block) != MJB_STATUS_OK) {
+if(mjb_caseless_hash("Stra\\xC3\\x9F" "e", MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+    MJB_CASELESS_CANONICAL, 0, &left) != MJB_STATUS_OK ||
+    mjb_caseless_hash("STRASSE", 7, MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, 0,
+        &right) != MJB_STATUS_OK) {
     return 1;
 }
 
-// Block: Basic Latin
-printf("Block: %s", block.name);`,
-    specs: [uax(44, 'Unicode Character Database')]
-  },
-  {
-    comment: 'Return the script of a codepoint.',
-    ret: 'mjb_script',
-    name: 'mjb_codepoint_script',
-    attributes: [],
-    args: [codepoint()],
-    wasm: true,
-    section: Section.TextAnalysis,
-    example: `mjb_script script = mjb_codepoint_script(0x03A9); // Greek capital omega
-
-// Greek script: yes
-printf("Greek script: %s", script == MJB_SC_GREK ? "yes" : "no");`,
-    specs: [uax(44, 'Unicode Character Database')]
+// Same hash: yes
+printf("Same hash: %s", left == right ? "yes" : "no");`,
+    related: ['mjb_caseless_match', 'mjb_nfkc_casefold'],
+    specs: [unicodeCore('Section 3.13.5', 'Default Caseless Matching', 'G33992')]
   },
   {
-    comment: 'Return the Script_Extensions set of a codepoint.',
+    comment: 'Compare two strings using UCA.',
     ret: 'mjb_status',
-    name: 'mjb_codepoint_script_extensions',
+    name: 'mjb_collation_compare',
     attributes: ['MJB_NODISCARD'],
     args: [
-      codepoint(),
+      buffer('The first string to compare', 's1'),
+      byte_length('The length of the first string in bytes, or `MJB_NUL_TERMINATED`',
+        's1_byte_length'),
+      encoding('The encoding of the first string', 's1_encoding'),
+      buffer('The second string to compare', 's2'),
+      byte_length('The length of the second string in bytes, or `MJB_NUL_TERMINATED`',
+        's2_byte_length'),
+      encoding('The encoding of the second string', 's2_encoding'),
       {
-        name: 'scripts',
-        type: 'mjb_script *',
-        description: 'The caller-provided script buffer, or NULL to query the required count',
-        wasm_generated: true
+        name: 'variable_weighting',
+        type: 'mjb_collation_variable_weighting',
+        description: 'The variable weighting strategy',
+        wasm_generated: false,
+        is_enum: true
       },
       {
-        name: 'count',
-        type: 'size_t *',
-        description: 'The input capacity and output script count',
+        name: 'strength',
+        type: 'mjb_collation_strength',
+        description: 'The maximum collation level to compare',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'order',
+        type: 'int *',
+        description: 'The strcmp-style comparison result to store',
         wasm_generated: true
       }
     ],
     wasm: true,
-    section: Section.TextAnalysis,
-    details: 'Return the explicit Script_Extensions set, or the ordinary Script value when the ' +
-      'codepoint has no explicit Script_Extensions entry. Call first with `scripts` set to NULL ' +
-      'to obtain the required count.',
-    example: `size_t count = 0;
-
-if(mjb_codepoint_script_extensions(0x30FC, NULL, &count) != MJB_STATUS_OK) {
-    return 1;
-}
-
-mjb_script scripts[3];
+    section: Section.SortingComparison,
+    exampleFeature: 'MJB_FEATURE_COLLATION',
+    details: 'Compare two strings using the Unicode Collation Algorithm and the default ' +
+      'collation element table (DUCET), with `strcmp`-style semantics. Primary strength compares ' +
+      'base-character weights. Secondary strength also compares accents while ignoring tertiary ' +
+      'case differences. Tertiary strength adds case and variant differences. Quaternary strength ' +
+      'also compares variable elements moved to level 4 by `MJB_COLLATION_SHIFTED`; with ' +
+      '`MJB_COLLATION_NON_IGNORABLE`, it is equivalent to tertiary strength. Collation equality ' +
+      'at a selected strength is not Unicode caseless matching; use `mjb_caseless_match` when ' +
+      'case-insensitive equality is the intended operation. See ' +
+      '[Unicode collation](#unicode-collation) for the comparison process and configuration ' +
+      'guidance. If `MJB_FEATURE_COLLATION=0` the function always returns ' +
+      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: '`order` is negative, zero, or positive according to the collation order' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`order` is NULL, an input buffer is NULL with a non-zero size, or an option is invalid' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'An input encoding is invalid or lacks byte-order information' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description: 'An input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'An intermediate size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
+    ],
+    example: `int order;
 
-if(count > 3 || mjb_codepoint_script_extensions(0x30FC, scripts,
-    &count) != MJB_STATUS_OK) {
+if(mjb_collation_compare("apple", 5, MJB_ENC_UTF_8,
+    "banana", 6, MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
+    MJB_COLLATION_TERTIARY, &order) != MJB_STATUS_OK) {
     return 1;
 }
 
-// U+30FC has 2 Script_Extensions
-printf("U+30FC has %zu Script_Extensions", count);`,
-    related: ['mjb_codepoint_script'],
-    specs: [uax(24, 'Unicode Script Property')]
-  },
-  {
-    comment: 'Encode a codepoint to a string.',
-    ret: 'unsigned int',
-    name: 'mjb_codepoint_encode',
-    attributes: [],
-    args: [
-      codepoint('The codepoint to encode'),
-      buffer('The buffer to encode the codepoint to', 'buffer', false, true),
-      byte_length('The length of the buffer, in bytes'),
-      encoding('The encoding to use')
-    ],
-    wasm: true,
-    section: Section.TextTransformation,
-    example: `char encoded[4];
-unsigned int size = mjb_codepoint_encode(0x20AC, encoded, sizeof(encoded), MJB_ENC_UTF_8);
-
-// € sign uses 3 UTF-8 bytes
-printf("%.*s sign uses %u UTF-8 bytes", (int)size, encoded, size);`
+// apple sorts before banana: yes
+printf("apple sorts before banana: %s", order < 0 ? "yes" : "no");`,
+    related: ['mjb_collation_key', 'mjb_collation_key_into', 'mjb_collator_compare',
+      'mjb_caseless_match'],
+    specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
-    comment: 'Convert from one encoding to another.',
+    comment: 'Generate a UCA sort key for a string.',
     ret: 'mjb_status',
-    name: 'mjb_convert_encoding',
+    name: 'mjb_collation_key',
     attributes: ['MJB_NODISCARD'],
     args: [
-      buffer('The string to convert'),
+      buffer('The string to generate the sort key for'),
       byte_length(),
-      encoding('The input encoding of the string'),
-      encoding('The output encoding of the string', 'output_encoding'),
-      result()
+      encoding(),
+      {
+        name: 'variable_weighting',
+        type: 'mjb_collation_variable_weighting',
+        description: 'The variable weighting strategy',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'strength',
+        type: 'mjb_collation_strength',
+        description: 'The maximum collation level to include',
+        wasm_generated: false,
+        is_enum: true
+      },
+      result('The pointer to store the binary sort key')
     ],
     wasm: true,
-    section: Section.TextTransformation,
-    details: 'Convert a string between the supported encodings (UTF-8, UTF-16LE/BE, ' +
-      'UTF-32LE/BE). Generic UTF-16/UTF-32 input consumes a leading BOM as the encoding scheme ' +
-      'signature and uses it to resolve byte order. Explicit-endian input preserves an initial ' +
-      'U+FEFF as text. Generic UTF-16/UTF-32 without a BOM, and generic UTF-16/UTF-32 output, are ' +
-      'rejected because the byte order is not specified.',
+    section: Section.SortingComparison,
+    exampleFeature: 'MJB_FEATURE_COLLATION',
+    details: 'Generate a binary sort key for a string. Sort keys of different strings can be ' +
+      'compared with `memcmp` and yield the same order as `mjb_collation_compare` when both use ' +
+      'the same variable weighting and strength. Useful when the same strings are compared many ' +
+      'times, such as sorting or database indexing. Empty input and non-empty input with no ' +
+      'effective weights at the selected strength both produce a zero-length key. If ' +
+      '`MJB_FEATURE_COLLATION=0` the function always returns ' +
+      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
-      { value: 'MJB_STATUS_OK', description: 'The string was converted' },
-      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
-        '`result` is NULL, `buffer` is NULL with a non-zero size, or the input is not valid in the source encoding' },
+      { value: 'MJB_STATUS_OK', description: 'The sort key was generated' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT',
+        description:
+          '`result` is NULL, `buffer` is NULL with a non-zero size, or an option is invalid' },
       { value: 'MJB_STATUS_INVALID_ENCODING', description:
-        'A generic UTF-16/UTF-32 encoding did not provide enough byte order information' },
-      { value: 'MJB_STATUS_UNSUPPORTED', description: 'The requested encoding conversion is not supported' },
-      { value: 'MJB_STATUS_OVERFLOW', description: 'The output size would overflow' },
-      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' }
+        'The input encoding is invalid or lacks byte-order information' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The sort key size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
     ],
-    example: `const char *input = "caf\\xC3\\xA9";
-mjb_result result;
+    example: `mjb_result key;
 
-if(mjb_convert_encoding(input, strlen(input), MJB_ENC_UTF_8,
-    MJB_ENC_UTF_16LE, &result) != MJB_STATUS_OK) {
+if(mjb_collation_key("r\\xC3\\xA9sum\\xC3\\xA9", 8, MJB_ENC_UTF_8,
+    MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY, &key) != MJB_STATUS_OK) {
     return 1;
 }
 
-// UTF-16LE bytes: 8
-printf("UTF-16LE bytes: %zu", result.output_size);
-mjb_result_free(&result);`,
-    related: ['mjb_convert_encoding_into', 'mjb_detect_encoding', 'mjb_codepoint_encode']
+// Sort key is non-empty: yes
+printf("Sort key is non-empty: %s", key.output_size > 0 ? "yes" : "no");
+mjb_result_free(&key);`,
+    related: ['mjb_collation_key_into', 'mjb_collation_compare'],
+    specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
-    comment: 'Convert from one encoding to another into a caller-provided buffer.',
+    comment: 'Generate a binary collation key into a caller-provided buffer.',
     ret: 'mjb_status',
-    name: 'mjb_convert_encoding_into',
+    name: 'mjb_collation_key_into',
     attributes: ['MJB_NODISCARD'],
     args: [
-      buffer('The string to convert'),
+      buffer('The string to generate the sort key for'),
       byte_length(),
-      encoding('The input encoding of the string'),
-      encoding('The output encoding of the string', 'output_encoding'),
+      encoding(),
+      {
+        name: 'variable_weighting',
+        type: 'mjb_collation_variable_weighting',
+        description: 'The variable weighting strategy',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'strength',
+        type: 'mjb_collation_strength',
+        description: 'The maximum collation level to include',
+        wasm_generated: false,
+        is_enum: true
+      },
       {
         name: 'output',
         type: 'void *',
-        description: 'The caller-provided output buffer, or NULL to query the required size',
+        description: 'The caller-provided binary output buffer, or NULL to query its size',
         wasm_generated: false,
         ownership: 'The caller retains ownership'
       },
@@ -1277,119 +2424,157 @@ mjb_result_free(&result);`,
       }
     ],
     wasm: false,
-    section: Section.TextTransformation,
-    details: 'Convert a string using the same encoding and BOM rules as ' +
-      '`mjb_convert_encoding`, without allocating memory. Set `output` to NULL to query the ' +
-      'required size. If `output` is non-NULL, `*output_size` supplies its capacity; on return ' +
-      'it contains the required size when the buffer is too small, or the written size on ' +
-      'success. The size is the encoded payload byte count: terminators are excluded, and ' +
-      'this function does not write a terminator. No bytes are written when capacity is ' +
-      'insufficient.',
+    section: Section.SortingComparison,
+    exampleFeature: 'MJB_FEATURE_COLLATION',
+    details: 'Generate the same binary sort key as `mjb_collation_key` without allocating the ' +
+      'final key buffer. Set `output` to NULL to query the required byte count. If `output` is ' +
+      'non-NULL, `*output_size` supplies its capacity; on return it contains the required size ' +
+      'when the buffer is too small, or the written size on success. A collation key is binary: ' +
+      'no terminator is included or written, and no bytes are written when capacity is ' +
+      'insufficient. Collation processing still uses temporary allocations, including during a ' +
+      'size query. Empty input and non-empty input with no effective weights at the selected ' +
+      'strength both require zero bytes. If `MJB_FEATURE_COLLATION=0` the function always returns ' +
+      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
       { value: 'MJB_STATUS_OK', description:
-        'The required size was returned or the string was converted' },
+        'The required size was returned or the binary sort key was written' },
       { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
-        '`output_size` is NULL, or `buffer` is NULL with a non-zero size' },
-      { value: 'MJB_STATUS_INVALID_ENCODING', description:
-        'A generic UTF-16/UTF-32 encoding did not provide enough byte order information' },
-      { value: 'MJB_STATUS_UNSUPPORTED', description:
-        'The requested encoding conversion is not supported' },
-      { value: 'MJB_STATUS_OVERFLOW', description: 'The required output size would overflow' },
+        '`output_size` is NULL, `buffer` is NULL with a non-zero size, or an option is invalid' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'The input encoding is invalid' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The required key size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Temporary allocation failed' },
       { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
-        'The output capacity is smaller than the required byte count' }
+        'The output capacity is smaller than the required byte count' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
     ],
-    example: `const char *input = "caf\\xC3\\xA9";
+    example: `const char *input = "r\\xC3\\xA9sum\\xC3\\xA9";
 size_t output_size = 0;
 
-if(mjb_convert_encoding_into(input, strlen(input), MJB_ENC_UTF_8,
-    MJB_ENC_UTF_16LE, NULL, &output_size) != MJB_STATUS_OK) {
+if(mjb_collation_key_into(input, 8, MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
+    MJB_COLLATION_TERTIARY, NULL, &output_size) != MJB_STATUS_OK) {
     return 1;
 }
 
-unsigned char output[8];
+unsigned char output[64];
 
-if(output_size > sizeof(output) || mjb_convert_encoding_into(input, strlen(input),
-    MJB_ENC_UTF_8, MJB_ENC_UTF_16LE, output, &output_size) != MJB_STATUS_OK) {
+if(output_size > sizeof(output) || mjb_collation_key_into(input, 8, MJB_ENC_UTF_8,
+    MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY, output,
+    &output_size) != MJB_STATUS_OK) {
     return 1;
 }
 
-// UTF-16LE payload bytes (no terminator): 8
-printf("UTF-16LE payload bytes (no terminator): %zu", output_size);`,
-    related: ['mjb_convert_encoding', 'mjb_detect_encoding', 'mjb_codepoint_encode']
+// Sort key is non-empty: yes
+printf("Sort key is non-empty: %s", output_size > 0 ? "yes" : "no");`,
+    related: ['mjb_collation_key', 'mjb_collation_compare', 'mjb_collator_key_into'],
+    specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
-    comment: 'Compare two strings using a Unicode caseless matching relation.',
+    comment: 'Initialize a reusable collator.',
     ret: 'mjb_status',
-    name: 'mjb_caseless_match',
+    name: 'mjb_collator_init',
     attributes: ['MJB_NODISCARD'],
     args: [
-      buffer('The first string to compare', 's1'),
-      byte_length('The length of the first string in bytes, or `MJB_NUL_TERMINATED`',
-        's1_byte_length'),
-      encoding('The encoding of the first string', 's1_encoding'),
-      buffer('The second string to compare', 's2'),
-      byte_length('The length of the second string in bytes, or `MJB_NUL_TERMINATED`',
-        's2_byte_length'),
-      encoding('The encoding of the second string', 's2_encoding'),
       {
-        name: 'mode',
-        type: 'mjb_caseless_mode',
-        description: 'The Unicode caseless matching relation',
+        name: 'collator',
+        type: 'mjb_collator *',
+        description: 'The collator to initialize',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_collator_free`'
+      },
+      {
+        name: 'variable_weighting',
+        type: 'mjb_collation_variable_weighting',
+        description: 'The variable weighting strategy',
         wasm_generated: false,
         is_enum: true
       },
       {
-        name: 'matches',
-        type: 'bool *',
-        description: 'Whether the strings are a caseless match',
-        wasm_generated: true
+        name: 'strength',
+        type: 'mjb_collation_strength',
+        description: 'The maximum collation level to use',
+        wasm_generated: false,
+        is_enum: true
       }
     ],
-    wasm: true,
+    wasm: false,
     section: Section.SortingComparison,
-    details: 'Compare two strings for case-insensitive equality using Unicode full default case ' +
-      'folding. Canonical mode implements D145 and is recommended for ordinary text. ' +
-      'Unnormalized mode implements D144 without normalization. Compatibility mode implements ' +
-      'the iterated folding and compatibility normalization required by D146. Identifier mode ' +
-      'implements D147 by applying NFD before `mjb_nfkc_casefold`; it removes default-ignorable ' +
-      'codepoints but does not validate identifier syntax.',
+    exampleFeature: 'MJB_FEATURE_COLLATION',
+    details: 'Validate the collation options once and prepare a collator for ' +
+      '`mjb_collator_compare`, `mjb_collator_key` and `mjb_collator_key_into`. The collator keeps ' +
+      'its normalization, collation element and sort key buffers between calls and only grows ' +
+      'them, so comparing or keying many strings stops allocating once they fit the longest ' +
+      'input. Initialization itself does not allocate. A collator is not thread-safe; use one per ' +
+      'thread. Release it with `mjb_collator_free`, also after a failed initialization. If ' +
+      '`MJB_FEATURE_COLLATION=0` the function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
-      { value: 'MJB_STATUS_OK', description: '`matches` contains the comparison result' },
+      { value: 'MJB_STATUS_OK', description: 'The collator was initialized' },
       { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
-        '`matches` is NULL, an input buffer is NULL with a non-zero size, or `mode` is invalid' },
-      { value: 'MJB_STATUS_INVALID_ENCODING', description:
-        'An input encoding is invalid or lacks byte-order information' },
-      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
-        'An input contains an ill-formed code-unit sequence' },
-      { value: 'MJB_STATUS_OVERFLOW', description: 'An intermediate size would overflow' },
-      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
-      { value: 'MJB_STATUS_UNSUPPORTED', description:
-        'The identifier case-folding transform did not converge' }
+        '`collator` is NULL or an option is invalid' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
     ],
-    example: `const char *left = "Stra\\xC3\\x9F" "e";
-const char *right = "STRASSE";
-bool matches;
+    example: `mjb_collator collator;
 
-if(mjb_caseless_match(left, strlen(left), MJB_ENC_UTF_8,
-    right, strlen(right), MJB_ENC_UTF_8, MJB_CASELESS_CANONICAL, &matches) != MJB_STATUS_OK) {
+if(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+    MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
     return 1;
 }
 
-// Canonical caseless match: yes
-printf("Canonical caseless match: %s", matches ? "yes" : "no");`,
-    related: ['mjb_map_case', 'mjb_nfkc_casefold', 'mjb_normalize',
-      'mjb_collation_compare', 'mjb_is_identifier'],
-    specs: [
-      unicodeCore('Section 3.13.5', 'Default Caseless Matching', 'G33992'),
-      uax(31, 'Unicode Identifiers and Syntax')
-    ]
+bool shifted = collator.variable_weighting == MJB_COLLATION_SHIFTED;
+mjb_collator_free(&collator);
+
+// Collator is shifted: yes
+printf("Collator is shifted: %s", shifted ? "yes" : "no");`,
+    related: ['mjb_collator_free', 'mjb_collator_compare', 'mjb_collator_key',
+      'mjb_collator_key_into'],
+    specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
-    comment: 'Compare two strings using UCA.',
+    comment: 'Free the buffers of a collator.',
+    ret: 'void',
+    name: 'mjb_collator_free',
+    attributes: [],
+    args: [
+      {
+        name: 'collator',
+        type: 'mjb_collator *',
+        description: 'The collator to free',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.SortingComparison,
+    exampleFeature: 'MJB_FEATURE_COLLATION',
+    details: 'Release the scratch buffers owned by a collator and reset it. Passing NULL is a ' +
+      'no-op. The collator must be initialized again before it is reused.',
+    example: `mjb_collator collator;
+
+if(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+    MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+    return 1;
+}
+
+mjb_collator_free(&collator);
+
+// Collator released: yes
+printf("Collator released: %s", collator.keys[0] == NULL ? "yes" : "no");`,
+    related: ['mjb_collator_init']
+  },
+  {
+    comment: 'Compare two strings using UCA and a collator.',
     ret: 'mjb_status',
-    name: 'mjb_collation_compare',
+    name: 'mjb_collator_compare',
     attributes: ['MJB_NODISCARD'],
     args: [
+      {
+        name: 'collator',
+        type: 'mjb_collator *',
+        description: 'The collator initialized with `mjb_collator_init`',
+        wasm_generated: false
+      },
       buffer('The first string to compare', 's1'),
       byte_length('The length of the first string in bytes, or `MJB_NUL_TERMINATED`',
         's1_byte_length'),
@@ -1398,105 +2583,79 @@ printf("Canonical caseless match: %s", matches ? "yes" : "no");`,
       byte_length('The length of the second string in bytes, or `MJB_NUL_TERMINATED`',
         's2_byte_length'),
       encoding('The encoding of the second string', 's2_encoding'),
-      {
-        name: 'variable_weighting',
-        type: 'mjb_collation_variable_weighting',
-        description: 'The variable weighting strategy',
-        wasm_generated: false,
-        is_enum: true
-      },
-      {
-        name: 'strength',
-        type: 'mjb_collation_strength',
-        description: 'The maximum collation level to compare',
-        wasm_generated: false,
-        is_enum: true
-      },
       {
         name: 'order',
         type: 'int *',
         description: 'The strcmp-style comparison result to store',
-        wasm_generated: true
+        wasm_generated: false
       }
     ],
-    wasm: true,
+    wasm: false,
     section: Section.SortingComparison,
     exampleFeature: 'MJB_FEATURE_COLLATION',
-    details: 'Compare two strings using the Unicode Collation Algorithm and the default ' +
-      'collation element table (DUCET), with `strcmp`-style semantics. Primary strength compares ' +
-      'base-character weights. Secondary strength also compares accents while ignoring tertiary ' +
-      'case differences. Tertiary strength adds case and variant differences. Quaternary strength ' +
-      'also compares variable elements moved to level 4 by `MJB_COLLATION_SHIFTED`; with ' +
-      '`MJB_COLLATION_NON_IGNORABLE`, it is equivalent to tertiary strength. Collation equality ' +
-      'at a selected strength is not Unicode caseless matching; use `mjb_caseless_match` when ' +
-      'case-insensitive equality is the intended operation. See ' +
-      '[Unicode collation](#unicode-collation) for the comparison process and configuration ' +
-      'guidance. If `MJB_FEATURE_COLLATION=0` the function always returns ' +
-      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    details: 'Compare two strings like `mjb_collation_compare`, with the variable weighting and ' +
+      'strength of the collator. Strings that need full sort keys build them in the collator ' +
+      'buffers instead of allocating new ones. If `MJB_FEATURE_COLLATION=0` the function always ' +
+      'returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
       { value: 'MJB_STATUS_OK', description: '`order` is negative, zero, or positive according to the collation order' },
       { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
-        '`order` is NULL, an input buffer is NULL with a non-zero size, or an option is invalid' },
+        '`collator` or `order` is NULL, or an input buffer is NULL with a non-zero size' },
       { value: 'MJB_STATUS_INVALID_ENCODING', description: 'An input encoding is invalid or lacks byte-order information' },
       { value: 'MJB_STATUS_MALFORMED_INPUT', description: 'An input contains an ill-formed code-unit sequence' },
       { value: 'MJB_STATUS_OVERFLOW', description: 'An intermediate size would overflow' },
-      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Growing a collator buffer failed' },
       { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
         'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
     ],
-    example: `int order;
+    example: `mjb_collator collator;
+int order;
 
-if(mjb_collation_compare("apple", 5, MJB_ENC_UTF_8,
-    "banana", 6, MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
-    MJB_COLLATION_TERTIARY, &order) != MJB_STATUS_OK) {
+if(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+    MJB_COLLATION_PRIMARY) != MJB_STATUS_OK) {
     return 1;
 }
 
-// apple sorts before banana: yes
-printf("apple sorts before banana: %s", order < 0 ? "yes" : "no");`,
-    related: ['mjb_collation_key', 'mjb_collation_key_into', 'mjb_caseless_match'],
+if(mjb_collator_compare(&collator, "r\\xC3\\xA9sum\\xC3\\xA9", 8, MJB_ENC_UTF_8,
+    "resume", 6, MJB_ENC_UTF_8, &order) != MJB_STATUS_OK) {
+    mjb_collator_free(&collator);
+    return 1;
+}
+
+// Equal at primary strength: yes
+printf("Equal at primary strength: %s", order == 0 ? "yes" : "no");
+mjb_collator_free(&collator);`,
+    related: ['mjb_collator_init', 'mjb_collation_compare', 'mjb_collator_key'],
     specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
-    comment: 'Generate a UCA sort key for a string.',
+    comment: 'Generate a UCA sort key for a string using a collator.',
     ret: 'mjb_status',
-    name: 'mjb_collation_key',
+    name: 'mjb_collator_key',
     attributes: ['MJB_NODISCARD'],
     args: [
+      {
+        name: 'collator',
+        type: 'mjb_collator *',
+        description: 'The collator initialized with `mjb_collator_init`',
+        wasm_generated: false
+      },
       buffer('The string to generate the sort key for'),
       byte_length(),
       encoding(),
-      {
-        name: 'variable_weighting',
-        type: 'mjb_collation_variable_weighting',
-        description: 'The variable weighting strategy',
-        wasm_generated: false,
-        is_enum: true
-      },
-      {
-        name: 'strength',
-        type: 'mjb_collation_strength',
-        description: 'The maximum collation level to include',
-        wasm_generated: false,
-        is_enum: true
-      },
       result('The pointer to store the binary sort key')
     ],
-    wasm: true,
+    wasm: false,
     section: Section.SortingComparison,
     exampleFeature: 'MJB_FEATURE_COLLATION',
-    details: 'Generate a binary sort key for a string. Sort keys of different strings can be ' +
-      'compared with `memcmp` and yield the same order as `mjb_collation_compare` when both use ' +
-      'the same variable weighting and strength. Useful when the same strings are compared many ' +
-      'times, such as sorting or database indexing. Empty input and non-empty input with no ' +
-      'effective weights at the selected strength both produce a zero-length key. If ' +
-      '`MJB_FEATURE_COLLATION=0` the function always returns ' +
-      '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    details: 'Generate the same binary sort key as `mjb_collation_key`, with the variable ' +
+      'weighting and strength of the collator. Only the returned key is allocated; release it ' +
+      'with `mjb_result_free`. Use `mjb_collator_key_into` to avoid that allocation too. If ' +
+      '`MJB_FEATURE_COLLATION=0` the function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
       { value: 'MJB_STATUS_OK', description: 'The sort key was generated' },
-      { value: 'MJB_STATUS_INVALID_ARGUMENT',
-        description:
-          '`result` is NULL, `buffer` is NULL with a non-zero size, or an option is invalid' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`collator` or `result` is NULL, or `buffer` is NULL with a non-zero size' },
       { value: 'MJB_STATUS_INVALID_ENCODING', description:
         'The input encoding is invalid or lacks byte-order information' },
       { value: 'MJB_STATUS_MALFORMED_INPUT', description:
@@ -1506,102 +2665,215 @@ printf("apple sorts before banana: %s", order < 0 ? "yes" : "no");`,
       { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
         'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
     ],
-    example: `mjb_result key;
+    example: `mjb_collator collator;
+mjb_result key;
 
-if(mjb_collation_key("r\\xC3\\xA9sum\\xC3\\xA9", 8, MJB_ENC_UTF_8,
-    MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY, &key) != MJB_STATUS_OK) {
+if(mjb_collator_init(&collator, MJB_COLLATION_NON_IGNORABLE,
+    MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+    return 1;
+}
+
+if(mjb_collator_key(&collator, "apple", 5, MJB_ENC_UTF_8, &key) != MJB_STATUS_OK) {
+    mjb_collator_free(&collator);
     return 1;
 }
 
 // Sort key is non-empty: yes
 printf("Sort key is non-empty: %s", key.output_size > 0 ? "yes" : "no");
-mjb_result_free(&key);`,
-    related: ['mjb_collation_key_into', 'mjb_collation_compare'],
+mjb_result_free(&key);
+mjb_collator_free(&collator);`,
+    related: ['mjb_collator_key_into', 'mjb_collation_key', 'mjb_collator_compare'],
     specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
-    comment: 'Generate a binary collation key into a caller-provided buffer.',
+    comment: 'Generate a binary collation key into a caller-provided buffer using a collator.',
     ret: 'mjb_status',
-    name: 'mjb_collation_key_into',
+    name: 'mjb_collator_key_into',
     attributes: ['MJB_NODISCARD'],
     args: [
+      {
+        name: 'collator',
+        type: 'mjb_collator *',
+        description: 'The collator initialized with `mjb_collator_init`',
+        wasm_generated: false
+      },
       buffer('The string to generate the sort key for'),
       byte_length(),
       encoding(),
       {
-        name: 'variable_weighting',
-        type: 'mjb_collation_variable_weighting',
-        description: 'The variable weighting strategy',
-        wasm_generated: false,
-        is_enum: true
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided binary output buffer, or NULL to query its size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
+        type: 'size_t *',
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.SortingComparison,
+    exampleFeature: 'MJB_FEATURE_COLLATION',
+    details: 'Generate the same binary sort key as `mjb_collation_key_into`, with the variable ' +
+      'weighting and strength of the collator. The output buffer follows the ' +
+      '`mjb_collation_key_into` rules. Once the collator buffers fit the input the call does not ' +
+      'allocate, which makes it suited to keying many rows for sorting or indexing. If ' +
+      '`MJB_FEATURE_COLLATION=0` the function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The required size was returned or the binary sort key was written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`collator` or `output_size` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'The input encoding is invalid' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The required key size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Growing a collator buffer failed' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The output capacity is smaller than the required byte count' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
+    ],
+    example: `const char *rows[] = { "banana", "apple", "cherry" };
+unsigned char keys[3][64];
+size_t key_sizes[3];
+mjb_collator collator;
+
+if(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+    MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
+    return 1;
+}
+
+for(size_t i = 0; i < 3; ++i) {
+    key_sizes[i] = sizeof(keys[i]);
+
+    if(mjb_collator_key_into(&collator, rows[i], MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+        keys[i], &key_sizes[i]) != MJB_STATUS_OK) {
+        break;
+    }
+}
+
+mjb_collator_free(&collator);
+size_t common = key_sizes[1] < key_sizes[0] ? key_sizes[1] : key_sizes[0];
+
+// apple sorts before banana: yes
+printf("apple sorts before banana: %s", memcmp(keys[1], keys[0], common) < 0 ? "yes" : "no");`,
+    related: ['mjb_collator_key', 'mjb_collation_key_into', 'mjb_collator_init',
+      'mjb_collator_keys_into'],
+    specs: [uts(10, 'Unicode Collation Algorithm')]
+  },
+  {
+    comment: 'Generate the binary sort keys of many strings into one arena.',
+    ret: 'mjb_status',
+    name: 'mjb_collator_keys_into',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'collator',
+        type: 'mjb_collator *',
+        description: 'The collator initialized with `mjb_collator_init`',
+        wasm_generated: false
       },
       {
-        name: 'strength',
-        type: 'mjb_collation_strength',
-        description: 'The maximum collation level to include',
+        name: 'strings',
+        type: 'const char *const *',
+        description: 'The strings to generate the sort keys for',
         wasm_generated: false,
-        is_enum: true
+        ownership: 'The caller retains ownership'
       },
       {
-        name: 'output',
+        name: 'byte_lengths',
+        type: 'const size_t *',
+        description: 'The byte length of each string, or NULL if all are NUL-terminated',
+        wasm_generated: false
+      },
+      {
+        name: 'count',
+        type: 'size_t',
+        description: 'The number of strings',
+        wasm_generated: false
+      },
+      encoding(),
+      {
+        name: 'arena',
         type: 'void *',
-        description: 'The caller-provided binary output buffer, or NULL to query its size',
+        description: 'The caller-provided binary output arena, or NULL to query its size',
         wasm_generated: false,
         ownership: 'The caller retains ownership'
       },
       {
-        name: 'output_size',
+        name: 'arena_size',
         type: 'size_t *',
         description: 'The input capacity and output required or written byte count',
         wasm_generated: false
+      },
+      {
+        name: 'offsets',
+        type: 'size_t *',
+        description: 'The caller-provided array of `count + 1` key offsets',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
       }
     ],
     wasm: false,
     section: Section.SortingComparison,
     exampleFeature: 'MJB_FEATURE_COLLATION',
-    details: 'Generate the same binary sort key as `mjb_collation_key` without allocating the ' +
-      'final key buffer. Set `output` to NULL to query the required byte count. If `output` is ' +
-      'non-NULL, `*output_size` supplies its capacity; on return it contains the required size ' +
-      'when the buffer is too small, or the written size on success. A collation key is binary: ' +
-      'no terminator is included or written, and no bytes are written when capacity is ' +
-      'insufficient. Collation processing still uses temporary allocations, including during a ' +
-      'size query. Empty input and non-empty input with no effective weights at the selected ' +
-      'strength both require zero bytes. If `MJB_FEATURE_COLLATION=0` the function always returns ' +
+    details: 'Generate the `mjb_collator_key_into` sort key of every string and write them back ' +
+      'to back into `arena`. The key of string `i` spans the bytes from `offsets[i]` to ' +
+      '`offsets[i + 1]`, so `offsets` must hold `count + 1` entries. A `byte_length` of ' +
+      '`MJB_NUL_TERMINATED` marks a single NUL-terminated string. If `arena` is NULL, or its ' +
+      'capacity is too small, the offsets and the total byte count of the whole batch are still ' +
+      'returned so the arena can be grown once and the call repeated. Keys are written straight ' +
+      'into the arena and the collator buffers are reused, so keying a column performs no ' +
+      'per-row allocation once the arena and the collator fit the batch. On any other error ' +
+      '`arena_size` is set to 0. If `MJB_FEATURE_COLLATION=0` the function always returns ' +
       '`MJB_STATUS_FEATURE_NOT_ENABLED`.',
     returns: [
       { value: 'MJB_STATUS_OK', description:
-        'The required size was returned or the binary sort key was written' },
+        'The required size was returned or all the sort keys were written' },
       { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
-        '`output_size` is NULL, `buffer` is NULL with a non-zero size, or an option is invalid' },
+        '`collator`, `arena_size` or `offsets` is NULL, `strings` is NULL with a non-zero ' +
+        'count, or a string is NULL with a non-zero size' },
       { value: 'MJB_STATUS_INVALID_ENCODING', description: 'The input encoding is invalid' },
       { value: 'MJB_STATUS_MALFORMED_INPUT', description:
-        'The input contains an ill-formed code-unit sequence' },
-      { value: 'MJB_STATUS_OVERFLOW', description: 'The required key size would overflow' },
-      { value: 'MJB_STATUS_NO_MEMORY', description: 'Temporary allocation failed' },
+        'A string contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The required arena size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Growing a collator buffer failed' },
       { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
-        'The output capacity is smaller than the required byte count' },
+        'The arena capacity is smaller than the required byte count' },
       { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
         'The library was compiled with `MJB_FEATURE_COLLATION=0`' }
     ],
-    example: `const char *input = "r\\xC3\\xA9sum\\xC3\\xA9";
-size_t output_size = 0;
-
-if(mjb_collation_key_into(input, 8, MJB_ENC_UTF_8, MJB_COLLATION_NON_IGNORABLE,
-    MJB_COLLATION_TERTIARY, NULL, &output_size) != MJB_STATUS_OK) {
+    example: `const char *rows[] = { "banana", "apple", "cherry" };
+unsigned char arena[256];
+size_t arena_size = sizeof(arena);
+size_t offsets[4];
+mjb_collator collator;
+
+if(mjb_collator_init(&collator, MJB_COLLATION_SHIFTED,
+    MJB_COLLATION_TERTIARY) != MJB_STATUS_OK) {
     return 1;
 }
 
-unsigned char output[64];
+mjb_status status = mjb_collator_keys_into(&collator, rows, NULL, 3, MJB_ENC_UTF_8, arena,
+    &arena_size, offsets);
+mjb_collator_free(&collator);
 
-if(output_size > sizeof(output) || mjb_collation_key_into(input, 8, MJB_ENC_UTF_8,
-    MJB_COLLATION_NON_IGNORABLE, MJB_COLLATION_TERTIARY, output,
-    &output_size) != MJB_STATUS_OK) {
+if(status != MJB_STATUS_OK) {
     return 1;
 }
 
-// Sort key is non-empty: yes
-printf("Sort key is non-empty: %s", output_size > 0 ? "yes" : "no");`,
-    related: ['mjb_collation_key', 'mjb_collation_compare'],
+size_t apple = offsets[2] - offsets[1];
+size_t banana = offsets[1] - offsets[0];
+size_t common = apple < banana ? apple : banana;
+bool before = memcmp(arena + offsets[1], arena, common) < 0;
+
+// apple sorts before banana: yes
+printf("apple sorts before banana: %s", before ? "yes" : "no");`,
+    related: ['mjb_collator_key_into', 'mjb_collation_key_into', 'mjb_collator_init'],
     specs: [uts(10, 'Unicode Collation Algorithm')]
   },
   {
@@ -2248,6 +3520,72 @@ size_t bytes = mjb_truncate_word_width(input, strlen(input), MJB_ENC_UTF_8,
 // Six columns include 6 bytes
 printf("Six columns include %zu bytes", bytes);`
   },
+  {
+    comment: 'Return the boundaries of a string for the given segmentation.',
+    ret: 'mjb_status',
+    name: 'mjb_segment',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      buffer('The string to segment'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'kind',
+        type: 'mjb_segment_kind',
+        description: 'The grapheme, word, sentence or line segmentation',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'offsets',
+        type: 'size_t *',
+        description: 'The caller-provided array of boundary byte offsets, or NULL to count them',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'count',
+        type: 'size_t *',
+        description: 'The input capacity of `offsets` and output number of boundaries',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Segmentation,
+    details: 'Run the segmentation over the whole string in one call and write the byte offset ' +
+      'where each segment ends, in increasing order, so the last offset is the length of the ' +
+      'string and the number of boundaries is the number of segments. Line segmentation returns ' +
+      'both mandatory and allowed break opportunities. The offsets match the positions found by ' +
+      'calling `mjb_next_grapheme_break`, `mjb_next_word_break`, `mjb_next_sentence_break` or ' +
+      '`mjb_next_line_break` until the end of the string, without a library call per codepoint. ' +
+      'If `offsets` is NULL, or its capacity is too small, the number of boundaries is still ' +
+      'returned so the array can be sized once and the call repeated. An ill-formed code-unit ' +
+      'sequence is segmented as one U+FFFD spanning its bytes, so every offset is the start of ' +
+      'an input codepoint or the end of the string, and an incomplete trailing sequence stays in ' +
+      'the last segment. On any other error `count` is set to 0.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The boundaries were counted or written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`count` is NULL, `kind` is not a segmentation, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description: 'The encoding is not a supported input encoding' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The capacity of `offsets` is smaller than the number of boundaries' }
+    ],
+    example: `const char *input = "Hello, world!";
+size_t offsets[8];
+size_t count = 8;
+
+if(mjb_segment(input, strlen(input), MJB_ENC_UTF_8, MJB_SEGMENT_WORD, offsets,
+    &count) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// 5 word segments, the second ends at byte 6
+printf("%zu word segments, the second ends at byte %zu", count, offsets[1]);`,
+    related: ['mjb_next_grapheme_break', 'mjb_next_word_break', 'mjb_next_sentence_break',
+      'mjb_next_line_break'],
+    specs: [uax(29, 'Unicode Text Segmentation'), uax(14, 'Unicode Line Breaking Algorithm')]
+  },
   {
     comment: 'Resolve bidirectional text (TR9) for a paragraph.',
     ret: 'mjb_status',
@@ -2276,7 +3614,9 @@ printf("Six columns include %zu bytes", bytes);`
     section: Section.Bidirectional,
     details: 'Resolve the embedding levels of a paragraph following the Unicode Bidirectional ' +
       'Algorithm. The resolved paragraph can then be split into lines and reordered visually ' +
-      'with `mjb_bidi_reorder_line` and `mjb_bidi_line_runs`.',
+      'with `mjb_bidi_reorder_line` and `mjb_bidi_line_runs`. The `byte_offset` of each ' +
+      'character is the offset of the first code unit of its codepoint, or of the first byte ' +
+      'of the ill-formed subsequence a `U+FFFD` replaces.',
     returns: [
       { value: 'MJB_STATUS_OK', description: 'The paragraph was resolved' },
       { value: 'MJB_STATUS_INVALID_ARGUMENT',
@@ -2295,7 +3635,8 @@ if(mjb_bidi_resolve(input, strlen(input), MJB_ENC_UTF_8, MJB_DIRECTION_AUTO,
 // Paragraph codepoints: 7
 printf("Paragraph codepoints: %zu", paragraph.count);
 mjb_bidi_paragraph_free(&paragraph);`,
-    related: ['mjb_bidi_paragraph_free', 'mjb_bidi_reorder_line', 'mjb_bidi_line_runs'],
+    related: ['mjb_bidi_paragraph_free', 'mjb_bidi_reorder_line', 'mjb_bidi_line_runs',
+      'mjb_bidi_workspace_resolve'],
     specs: [uax(9, 'Unicode Bidirectional Algorithm')]
   },
   {
@@ -2343,96 +3684,335 @@ if(mjb_bidi_resolve(input, strlen(input), MJB_ENC_UTF_8, MJB_DIRECTION_AUTO,
     return 1;
 }
 
-// First visual index: 2
-printf("First visual index: %zu", visual_order[0]);
-mjb_bidi_paragraph_free(&paragraph);`,
-    related: ['mjb_bidi_resolve', 'mjb_bidi_line_runs'],
+// First visual index: 2
+printf("First visual index: %zu", visual_order[0]);
+mjb_bidi_paragraph_free(&paragraph);`,
+    related: ['mjb_bidi_resolve', 'mjb_bidi_line_runs'],
+    specs: [uax(9, 'Unicode Bidirectional Algorithm')]
+  },
+  {
+    comment: 'Compute visual level runs; pass runs=NULL to count first.',
+    ret: 'mjb_status',
+    name: 'mjb_bidi_line_runs',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'paragraph',
+        type: 'const mjb_bidi_paragraph *',
+        description: 'The resolved paragraph',
+        wasm_generated: false
+      },
+      {
+        name: 'visual_order',
+        type: 'const size_t *',
+        description: 'Visual order array from `mjb_bidi_reorder_line`',
+        wasm_generated: false
+      },
+      {
+        name: 'count',
+        type: 'size_t',
+        description: 'Length of visual_order',
+        wasm_generated: false
+      },
+      {
+        name: 'runs',
+        type: 'mjb_bidi_run *',
+        description: 'Caller-allocated array, or NULL to only count',
+        wasm_generated: false
+      },
+      {
+        name: 'run_count',
+        type: 'size_t *',
+        description: 'On output: number of runs written (or total if `runs` = `NULL`)',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Bidirectional,
+    example: `mjb_bidi_paragraph paragraph;
+size_t visual_order[3];
+size_t run_count = 0;
+
+if(mjb_bidi_resolve("abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR,
+    &paragraph) != MJB_STATUS_OK ||
+    mjb_bidi_reorder_line(&paragraph, 0, 3, visual_order) != MJB_STATUS_OK ||
+    mjb_bidi_line_runs(&paragraph, visual_order, 3, NULL,
+        &run_count) != MJB_STATUS_OK) {
+    return 1;
+}
+
+// Visual runs: 1
+printf("Visual runs: %zu", run_count);
+mjb_bidi_paragraph_free(&paragraph);`,
+    related: ['mjb_bidi_resolve', 'mjb_bidi_reorder_line'],
+    specs: [uax(9, 'Unicode Bidirectional Algorithm')]
+  },
+  {
+    comment: 'Free a bidi paragraph allocated by mjb_bidi_resolve.',
+    ret: 'void',
+    name: 'mjb_bidi_paragraph_free',
+    attributes: [],
+    args: [
+      {
+        name: 'paragraph',
+        type: 'mjb_bidi_paragraph *',
+        description: 'The paragraph to free',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Bidirectional,
+    example: `mjb_bidi_paragraph paragraph;
+
+if(mjb_bidi_resolve("abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR,
+    &paragraph) != MJB_STATUS_OK) {
+    return 1;
+}
+
+mjb_bidi_paragraph_free(&paragraph);
+
+// Paragraph released: yes
+printf("Paragraph released: %s", paragraph.chars == NULL ? "yes" : "no");`,
+    related: ['mjb_bidi_resolve']
+  },
+  {
+    comment: 'Initialize a reusable bidi workspace.',
+    ret: 'mjb_status',
+    name: 'mjb_bidi_workspace_init',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'workspace',
+        type: 'mjb_bidi_workspace *',
+        description: 'The workspace to initialize',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_bidi_workspace_free`'
+      }
+    ],
+    wasm: false,
+    section: Section.Bidirectional,
+    details: 'Prepare an empty workspace for `mjb_bidi_workspace_resolve`. Initialization does not ' +
+      'allocate; the buffers are sized by the first paragraph and only grow afterwards, so ' +
+      'resolving many short lines, as a UI or PDF renderer does, stops allocating once they fit ' +
+      'the longest one.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The workspace was initialized' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`workspace` is NULL' }
+    ],
+    example: `mjb_bidi_workspace workspace;
+
+if(mjb_bidi_workspace_init(&workspace) != MJB_STATUS_OK) {
+    return 1;
+}
+
+size_t capacity = workspace.capacity;
+mjb_bidi_workspace_free(&workspace);
+
+// Initial capacity: 0
+printf("Initial capacity: %zu", capacity);`,
+    related: ['mjb_bidi_workspace_resolve', 'mjb_bidi_workspace_free'],
+    specs: [uax(9, 'Unicode Bidirectional Algorithm')]
+  },
+  {
+    comment: 'Free the buffers of a bidi workspace.',
+    ret: 'void',
+    name: 'mjb_bidi_workspace_free',
+    attributes: [],
+    args: [
+      {
+        name: 'workspace',
+        type: 'mjb_bidi_workspace *',
+        description: 'The workspace to free',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Bidirectional,
+    details: 'Release the buffers of the workspace and reset it. Paragraphs resolved with the ' +
+      'workspace become invalid. Passing NULL is a no-op.',
+    example: `mjb_bidi_workspace workspace;
+mjb_bidi_paragraph paragraph;
+
+if(mjb_bidi_workspace_init(&workspace) != MJB_STATUS_OK ||
+    mjb_bidi_workspace_resolve(&workspace, "abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR,
+        &paragraph) != MJB_STATUS_OK) {
+    mjb_bidi_workspace_free(&workspace);
+    return 1;
+}
+
+mjb_bidi_workspace_free(&workspace);
+
+// Workspace released: yes
+printf("Workspace released: %s", workspace.chars == NULL ? "yes" : "no");`,
+    related: ['mjb_bidi_workspace_init']
+  },
+  {
+    comment: 'Resolve bidirectional text (TR9) for a paragraph into a reusable workspace.',
+    ret: 'mjb_status',
+    name: 'mjb_bidi_workspace_resolve',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'workspace',
+        type: 'mjb_bidi_workspace *',
+        description: 'The workspace initialized with `mjb_bidi_workspace_init`',
+        wasm_generated: false
+      },
+      buffer('The input string'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'direction',
+        type: 'mjb_direction',
+        description: 'The base paragraph direction (LTR, RTL, or AUTO for P2/P3)',
+        wasm_generated: false,
+        is_enum: true
+      },
+      {
+        name: 'result',
+        type: 'mjb_bidi_paragraph *',
+        description: 'Output paragraph; chars is owned by the workspace',
+        wasm_generated: false,
+        ownership: '`result->chars` belongs to the workspace and is valid until the next call ' +
+          'with it or `mjb_bidi_workspace_free()`; do not pass it to `mjb_bidi_paragraph_free()`'
+      }
+    ],
+    wasm: false,
+    section: Section.Bidirectional,
+    details: 'Resolve a paragraph like `mjb_bidi_resolve`, keeping the working arrays and the ' +
+      'resolved characters in the workspace. The buffers are sized by the codepoint count of the ' +
+      'paragraph and reused by later calls, so a resolved paragraph only lives until the next ' +
+      'one. Reordering a line with `mjb_bidi_reorder_line` does not allocate either. A workspace ' +
+      'must not be shared between threads.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The paragraph was resolved' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`workspace` or `result` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The paragraph size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' }
+    ],
+    example: `const char *lines[] = { "abc", "\\xD7\\x90\\xD7\\x91 12", "xyz" }; // אב 12
+mjb_bidi_workspace workspace;
+mjb_bidi_paragraph paragraph;
+size_t rtl_lines = 0;
+
+if(mjb_bidi_workspace_init(&workspace) != MJB_STATUS_OK) {
+    return 1;
+}
+
+for(size_t i = 0; i < 3; ++i) {
+    if(mjb_bidi_workspace_resolve(&workspace, lines[i], strlen(lines[i]), MJB_ENC_UTF_8,
+        MJB_DIRECTION_AUTO, &paragraph) != MJB_STATUS_OK) {
+        mjb_bidi_workspace_free(&workspace);
+        return 1;
+    }
+
+    rtl_lines += paragraph.direction == MJB_DIRECTION_RTL;
+}
+
+mjb_bidi_workspace_free(&workspace);
+
+// Right-to-left lines: 1
+printf("Right-to-left lines: %zu", rtl_lines);`,
+    related: ['mjb_bidi_resolve', 'mjb_bidi_workspace_init', 'mjb_bidi_reorder_line'],
     specs: [uax(9, 'Unicode Bidirectional Algorithm')]
   },
   {
-    comment: 'Compute visual level runs; pass runs=NULL to count first.',
+    comment: 'Resolve bidirectional text (TR9) for every paragraph of a document.',
     ret: 'mjb_status',
-    name: 'mjb_bidi_line_runs',
+    name: 'mjb_bidi_resolve_document',
     attributes: ['MJB_NODISCARD'],
     args: [
+      buffer('The input document'),
+      byte_length(),
+      encoding(),
       {
-        name: 'paragraph',
-        type: 'const mjb_bidi_paragraph *',
-        description: 'The resolved paragraph',
-        wasm_generated: false
-      },
-      {
-        name: 'visual_order',
-        type: 'const size_t *',
-        description: 'Visual order array from `mjb_bidi_reorder_line`',
-        wasm_generated: false
+        name: 'direction',
+        type: 'mjb_direction',
+        description: 'The base direction of every paragraph (LTR, RTL, or AUTO for P2/P3)',
+        wasm_generated: false,
+        is_enum: true
       },
       {
-        name: 'count',
-        type: 'size_t',
-        description: 'Length of visual_order',
+        name: 'parallel_for',
+        type: 'mjb_parallel_for_fn',
+        description: 'Runs the paragraph tasks on a thread pool, or NULL to resolve them in order',
         wasm_generated: false
       },
       {
-        name: 'runs',
-        type: 'mjb_bidi_run *',
-        description: 'Caller-allocated array, or NULL to only count',
+        name: 'pool',
+        type: 'void *',
+        description: 'Passed unchanged to `parallel_for`',
         wasm_generated: false
       },
       {
-        name: 'run_count',
-        type: 'size_t *',
-        description: 'On output: number of runs written (or total if `runs` = `NULL`)',
-        wasm_generated: false
+        name: 'result',
+        type: 'mjb_bidi_document *',
+        description: 'Output document',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_bidi_document_free`'
       }
     ],
     wasm: false,
     section: Section.Bidirectional,
-    example: `mjb_bidi_paragraph paragraph;
-size_t visual_order[3];
-size_t run_count = 0;
+    details: 'Split the input into paragraphs (P1) and resolve each one independently. A paragraph ' +
+      'separator, and a CR LF pair, ends the paragraph it belongs to. The characters of all the ' +
+      'paragraphs are stored in one array, in document order, with byte offsets relative to the ' +
+      'start of the document; each entry of `paragraphs` points into it. With `parallel_for` the ' +
+      'paragraphs are resolved as independent tasks, each with its own working memory; without ' +
+      'it, one workspace is reused for all of them.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The document was resolved' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`result` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The document size would overflow' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Memory allocation failed' }
+    ],
+    example: `mjb_bidi_document document;
 
-if(mjb_bidi_resolve("abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR,
-    &paragraph) != MJB_STATUS_OK ||
-    mjb_bidi_reorder_line(&paragraph, 0, 3, visual_order) != MJB_STATUS_OK ||
-    mjb_bidi_line_runs(&paragraph, visual_order, 3, NULL,
-        &run_count) != MJB_STATUS_OK) {
+if(mjb_bidi_resolve_document("abc\\n\\xD7\\x90\\xD7\\x91", MJB_NUL_TERMINATED, MJB_ENC_UTF_8,
+    MJB_DIRECTION_AUTO, NULL, NULL, &document) != MJB_STATUS_OK) {
     return 1;
 }
 
-// Visual runs: 1
-printf("Visual runs: %zu", run_count);
-mjb_bidi_paragraph_free(&paragraph);`,
-    related: ['mjb_bidi_resolve', 'mjb_bidi_reorder_line'],
+size_t paragraphs = document.paragraph_count;
+uint8_t level = document.paragraphs[1].paragraph_level;
+mjb_bidi_document_free(&document);
+
+// Paragraphs: 2, second level: 1
+printf("Paragraphs: %zu, second level: %u", paragraphs, (unsigned)level);`,
+    related: ['mjb_bidi_resolve', 'mjb_bidi_document_free', 'mjb_bidi_workspace_resolve'],
     specs: [uax(9, 'Unicode Bidirectional Algorithm')]
   },
   {
-    comment: 'Free a bidi paragraph allocated by mjb_bidi_resolve.',
+    comment: 'Free a bidi document allocated by mjb_bidi_resolve_document.',
     ret: 'void',
-    name: 'mjb_bidi_paragraph_free',
+    name: 'mjb_bidi_document_free',
     attributes: [],
     args: [
       {
-        name: 'paragraph',
-        type: 'mjb_bidi_paragraph *',
-        description: 'The paragraph to free',
+        name: 'document',
+        type: 'mjb_bidi_document *',
+        description: 'The document to free',
         wasm_generated: false
       }
     ],
     wasm: false,
     section: Section.Bidirectional,
-    example: `mjb_bidi_paragraph paragraph;
+    details: 'Release the characters and the paragraphs of the document and reset it. Passing ' +
+      'NULL is a no-op.',
+    example: `mjb_bidi_document document;
 
-if(mjb_bidi_resolve("abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR,
-    &paragraph) != MJB_STATUS_OK) {
+if(mjb_bidi_resolve_document("abc", 3, MJB_ENC_UTF_8, MJB_DIRECTION_LTR, NULL, NULL,
+    &document) != MJB_STATUS_OK) {
     return 1;
 }
 
-mjb_bidi_paragraph_free(&paragraph);
+mjb_bidi_document_free(&document);
 
-// Paragraph released: yes
-printf("Paragraph released: %s", paragraph.chars == NULL ? "yes" : "no");`,
-    related: ['mjb_bidi_resolve']
+// Document released: yes
+printf("Document released: %s", document.chars == NULL ? "yes" : "no");`,
+    related: ['mjb_bidi_resolve_document']
   },
   {
     comment: 'Return true if the codepoint is a valid Unicode identifier start (Unicode 18.0.0 UAX #31 ID_Start).',
@@ -2809,7 +4389,362 @@ if(mjb_confusable_match(latin, strlen(latin), MJB_ENC_UTF_8,
 
 // Visually confusable: yes
 printf("Visually confusable: %s", confusable ? "yes" : "no");`,
-    related: ['mjb_confusable_skeleton', 'mjb_confusable_skeleton_into', 'mjb_is_identifier'],
+    related: ['mjb_confusable_skeleton', 'mjb_confusable_skeleton_into', 'mjb_is_identifier',
+      'mjb_confusable_index_find'],
+    specs: [uts(39, 'Unicode Security Mechanisms')]
+  },
+  {
+    comment: 'Initialize an empty confusable index.',
+    ret: 'mjb_status',
+    name: 'mjb_confusable_index_init',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'index',
+        type: 'mjb_confusable_index *',
+        description: 'The index to initialize',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_confusable_index_free`'
+      }
+    ],
+    wasm: false,
+    section: Section.Security,
+    exampleFeature: 'MJB_FEATURE_SECURITY',
+    details: 'Prepare an empty index of reference strings, such as a blocklist of protected names. ' +
+      'Add the strings with `mjb_confusable_index_add`, then look up candidates with ' +
+      '`mjb_confusable_index_find`, which computes one skeleton per lookup instead of one per ' +
+      'reference string. Initialization does not allocate. If `MJB_FEATURE_SECURITY=0` the ' +
+      'function always returns `MJB_STATUS_FEATURE_NOT_ENABLED`.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The index was initialized' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`index` is NULL' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_SECURITY=0`' }
+    ],
+    example: `mjb_confusable_index index;
+
+if(mjb_confusable_index_init(&index) != MJB_STATUS_OK) {
+    return 1;
+}
+
+size_t count = index.count;
+mjb_confusable_index_free(&index);
+
+// Empty index: yes
+printf("Empty index: %s", count == 0 ? "yes" : "no");`,
+    related: ['mjb_confusable_index_free', 'mjb_confusable_index_add', 'mjb_confusable_index_find',
+      'mjb_confusable_index_open'],
+    specs: [uts(39, 'Unicode Security Mechanisms')]
+  },
+  {
+    comment: 'Free a confusable index.',
+    ret: 'void',
+    name: 'mjb_confusable_index_free',
+    attributes: [],
+    args: [
+      {
+        name: 'index',
+        type: 'mjb_confusable_index *',
+        description: 'The index to free',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Security,
+    exampleFeature: 'MJB_FEATURE_SECURITY',
+    details: 'Release the table and the skeletons owned by a built index and reset it. The image ' +
+      'of an index opened with `mjb_confusable_index_open` belongs to the caller and is not ' +
+      'released. Passing NULL is a no-op.',
+    example: `mjb_confusable_index index;
+
+if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK) {
+    mjb_confusable_index_free(&index);
+    return 1;
+}
+
+mjb_confusable_index_free(&index);
+
+// Index released: yes
+printf("Index released: %s", index.slots == NULL ? "yes" : "no");`,
+    related: ['mjb_confusable_index_init', 'mjb_confusable_index_open']
+  },
+  {
+    comment: 'Add the skeleton of a reference string to a confusable index.',
+    ret: 'mjb_status',
+    name: 'mjb_confusable_index_add',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'index',
+        type: 'mjb_confusable_index *',
+        description: 'The index initialized with `mjb_confusable_index_init`',
+        wasm_generated: false
+      },
+      buffer('The reference string'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'id',
+        type: 'uint32_t',
+        description: 'The caller-defined ID returned by `mjb_confusable_index_find`',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Security,
+    exampleFeature: 'MJB_FEATURE_SECURITY',
+    details: 'Compute the skeleton of the string and store it with `id` in the hash table of the ' +
+      'index. Reference strings with the same skeleton share its bytes, and IDs do not need to be ' +
+      'unique. A string with an empty skeleton is never confusable, as in ' +
+      '`mjb_confusable_match`, and is not stored. An index opened from a serialized image is ' +
+      'read-only.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The string was added' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`index` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The encoding is invalid or lacks byte-order information' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The index was opened with `mjb_confusable_index_open`' },
+      { value: 'MJB_STATUS_OVERFLOW', description: 'The index would exceed its 32-bit sizes' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_SECURITY=0`' }
+    ],
+    example: `mjb_confusable_index index;
+
+if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&index, "google", 6, MJB_ENC_UTF_8, 2) != MJB_STATUS_OK) {
+    mjb_confusable_index_free(&index);
+    return 1;
+}
+
+size_t count = index.count;
+mjb_confusable_index_free(&index);
+
+// 2 reference strings
+printf("%zu reference strings", count);`,
+    related: ['mjb_confusable_index_init', 'mjb_confusable_index_find', 'mjb_confusable_skeleton'],
+    specs: [uts(39, 'Unicode Security Mechanisms')]
+  },
+  {
+    comment: 'Return the IDs of the reference strings confusable with a string.',
+    ret: 'mjb_status',
+    name: 'mjb_confusable_index_find',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'index',
+        type: 'const mjb_confusable_index *',
+        description: 'The index to search',
+        wasm_generated: false
+      },
+      buffer('The string to check'),
+      byte_length(),
+      encoding(),
+      {
+        name: 'ids',
+        type: 'uint32_t *',
+        description: 'The caller-provided ID buffer, or NULL to query the required count',
+        wasm_generated: false
+      },
+      {
+        name: 'count',
+        type: 'size_t *',
+        description: 'The input capacity and output match count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Security,
+    exampleFeature: 'MJB_FEATURE_SECURITY',
+    details: 'Compute the skeleton of the string once and return, in ascending order, the IDs of ' +
+      'the reference strings with the same skeleton, that is the ones `mjb_confusable_match` ' +
+      'would report as confusable. Set `ids` to NULL to query the count. No IDs are written when ' +
+      'the capacity is insufficient. The index is not modified, so concurrent lookups are safe.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The count was returned or the IDs were written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`index` or `count` is NULL, or `buffer` is NULL with a non-zero size' },
+      { value: 'MJB_STATUS_INVALID_ENCODING', description:
+        'The encoding is invalid or lacks byte-order information' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The input contains an ill-formed code-unit sequence' },
+      { value: 'MJB_STATUS_NO_MEMORY', description: 'Allocation failed' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The ID capacity is smaller than the match count' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_SECURITY=0`' }
+    ],
+    example: `mjb_confusable_index index;
+
+if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&index, "google", 6, MJB_ENC_UTF_8, 2) != MJB_STATUS_OK) {
+    mjb_confusable_index_free(&index);
+    return 1;
+}
+
+const char *candidate = "p\\xD0\\xB0ypal"; // Cyrillic а
+uint32_t ids[4];
+size_t count = 4;
+mjb_status status = mjb_confusable_index_find(&index, candidate, strlen(candidate),
+    MJB_ENC_UTF_8, ids, &count);
+mjb_confusable_index_free(&index);
+
+if(status != MJB_STATUS_OK || count != 1) {
+    return 1;
+}
+
+// Confusable with reference 1
+printf("Confusable with reference %u", ids[0]);`,
+    related: ['mjb_confusable_index_add', 'mjb_confusable_match'],
+    specs: [uts(39, 'Unicode Security Mechanisms')]
+  },
+  {
+    comment: 'Serialize a confusable index into a caller-provided buffer.',
+    ret: 'mjb_status',
+    name: 'mjb_confusable_index_serialize',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'index',
+        type: 'const mjb_confusable_index *',
+        description: 'The index to serialize',
+        wasm_generated: false
+      },
+      {
+        name: 'output',
+        type: 'void *',
+        description: 'The caller-provided output buffer, or NULL to query the required size',
+        wasm_generated: false,
+        ownership: 'The caller retains ownership'
+      },
+      {
+        name: 'output_size',
+        type: 'size_t *',
+        description: 'The input capacity and output required or written byte count',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Security,
+    exampleFeature: 'MJB_FEATURE_SECURITY',
+    details: 'Write an image of the index that `mjb_confusable_index_open` can use in place, for ' +
+      'example after writing it to a file and mapping it into memory. The image holds a header, ' +
+      'the hash table and the skeletons in native byte order, and records the Unicode version ' +
+      'the skeletons were computed with. Set `output` to NULL to query the required size. No ' +
+      'bytes are written when the capacity is insufficient.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description:
+        'The required size was returned or the image was written' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description: '`index` or `output_size` is NULL' },
+      { value: 'MJB_STATUS_OUTPUT_TOO_SMALL', description:
+        'The output capacity is smaller than the image size' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_SECURITY=0`' }
+    ],
+    example: `mjb_confusable_index index;
+size_t size = 0;
+
+if(mjb_confusable_index_init(&index) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&index, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+    mjb_confusable_index_serialize(&index, NULL, &size) != MJB_STATUS_OK) {
+    mjb_confusable_index_free(&index);
+    return 1;
+}
+
+mjb_confusable_index_free(&index);
+
+// Image has a header: yes
+printf("Image has a header: %s", size > 32 ? "yes" : "no");`,
+    related: ['mjb_confusable_index_open'],
+    specs: [uts(39, 'Unicode Security Mechanisms')]
+  },
+  {
+    comment: 'Open a serialized confusable index in place.',
+    ret: 'mjb_status',
+    name: 'mjb_confusable_index_open',
+    attributes: ['MJB_NODISCARD'],
+    args: [
+      {
+        name: 'index',
+        type: 'mjb_confusable_index *',
+        description: 'The index to open',
+        wasm_generated: false,
+        ownership: 'Caller-owned; release with `mjb_confusable_index_free`'
+      },
+      {
+        name: 'data',
+        type: 'const void *',
+        description: 'The image written by `mjb_confusable_index_serialize`, 4-byte aligned',
+        wasm_generated: false,
+        ownership: 'Borrowed; must outlive the index'
+      },
+      {
+        name: 'data_size',
+        type: 'size_t',
+        description: 'The image size in bytes',
+        wasm_generated: false
+      }
+    ],
+    wasm: false,
+    section: Section.Security,
+    exampleFeature: 'MJB_FEATURE_SECURITY',
+    details: 'Validate the image header and sizes and point the index at the image without ' +
+      'copying or allocating, so a memory-mapped file is ready for `mjb_confusable_index_find` ' +
+      'at once. The opened index is read-only. Images written with another Unicode version, ' +
+      'byte order or format are rejected, since their skeletons would not match.',
+    returns: [
+      { value: 'MJB_STATUS_OK', description: 'The index was opened' },
+      { value: 'MJB_STATUS_INVALID_ARGUMENT', description:
+        '`index` or `data` is NULL, or `data` is not 4-byte aligned' },
+      { value: 'MJB_STATUS_MALFORMED_INPUT', description:
+        'The data is not a confusable index image or its sizes are inconsistent' },
+      { value: 'MJB_STATUS_UNSUPPORTED', description:
+        'The image has another Unicode version, byte order or format version' },
+      { value: 'MJB_STATUS_FEATURE_NOT_ENABLED', description:
+        'The library was compiled with `MJB_FEATURE_SECURITY=0`' }
+    ],
+    example: `mjb_confusable_index built;
+size_t size = 0;
+
+if(mjb_confusable_index_init(&built) != MJB_STATUS_OK ||
+    mjb_confusable_index_add(&built, "paypal", 6, MJB_ENC_UTF_8, 1) != MJB_STATUS_OK ||
+    mjb_confusable_index_serialize(&built, NULL, &size) != MJB_STATUS_OK) {
+    mjb_confusable_index_free(&built);
+    return 1;
+}
+
+uint32_t *data = (uint32_t *)malloc(size);
+
+if(data == NULL || mjb_confusable_index_serialize(&built, data, &size) != MJB_STATUS_OK) {
+    free(data);
+    mjb_confusable_index_free(&built);
+    return 1;
+}
+
+mjb_confusable_index_free(&built);
+mjb_confusable_index opened;
+uint32_t ids[1];
+size_t count = 1;
+
+if(mjb_confusable_index_open(&opened, data, size) != MJB_STATUS_OK ||
+    mjb_confusable_index_find(&opened, "paypa1", 6, MJB_ENC_UTF_8, ids, &count) != MJB_STATUS_OK) {
+    free(data);
+    return 1;
+}
+
+mjb_confusable_index_free(&opened);
+free(data);
+
+// Found reference 1
+printf("Found reference %u", ids[0]);`,
+    related: ['mjb_confusable_index_serialize', 'mjb_confusable_index_find'],
     specs: [uts(39, 'Unicode Security Mechanisms')]
   },
   {
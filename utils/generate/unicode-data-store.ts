@@ -12,7 +12,7 @@ import {
 } from './parse-ucd/collation';
 import { ConfusableEntry } from './parse-ucd/confusables';
 import { EmojiSequence } from './parse-ucd/emoji-sequences';
-import { PropertyRange } from './parse-ucd/properties';
+import { Property, PropertyRange } from './parse-ucd/properties';
 import { NewCases } from './parse-ucd/special-casing';
 import { Prefix } from './prefix-compressor';
 import {
@@ -30,6 +30,7 @@ export type UnicodeTableData = {
   names: NameRow[];
   emoji: EmojiRow[];
   properties: PropertyRangeRow[];
+  propertyIds: Record<string, number>;
   scriptExtensions: ScriptExtensionRow[];
   nCharacters: NCharacterRow[];
   decompositions: DecompositionRow[];
@@ -55,6 +56,7 @@ function emptyUnicodeTableData(): UnicodeTableData {
     names: [],
     emoji: [],
     properties: [],
+    propertyIds: {},
     scriptExtensions: [],
     nCharacters: [],
     decompositions: [],
@@ -102,6 +104,7 @@ export function getUnicodeTableData(): UnicodeTableData {
     names: [...unicodeTableData.names].sort(byCodepoint),
     emoji: [...unicodeTableData.emoji].sort(byCodepoint),
     properties: sortPropertyRanges(unicodeTableData.properties),
+    propertyIds: { ...unicodeTableData.propertyIds },
     scriptExtensions: [...unicodeTableData.scriptExtensions].sort((a, b) => a.start - b.start),
     nCharacters: [...unicodeTableData.nCharacters].sort(byCodepoint),
     decompositions: sortDecompositions(unicodeTableData.decompositions),
@@ -334,8 +337,8 @@ export function addEmojiSequences(sequences: EmojiSequence[]) {
   }
 }
 
-// Add pre-encoded property range rows.
-export function addPropertyRanges(propertyRanges: PropertyRange[]) {
+// Add pre-encoded property range rows and the IDs of their properties, keyed by short name.
+export function addPropertyRanges(propertyRanges: PropertyRange[], properties: Property[]) {
   for(const pr of propertyRanges) {
     unicodeTableData.properties.push({
       start_codepoint: pr.start,
@@ -343,6 +346,10 @@ export function addPropertyRanges(propertyRanges: PropertyRange[]) {
       properties: Buffer.from(pr.properties),
     });
   }
+
+  for(const property of properties) {
+    unicodeTableData.propertyIds[property.shortName] = property.id;
+  }
 }
 
 export function addScriptExtensions(rows: ScriptExtensionRow[]) {
@@ -257,6 +257,54 @@ export function formatCompactIntegers(values: number[], columns: number) {
   return lines.join('\n');
 }
 
+// Splits one packed value per codepoint into a three-stage trie: a page index (codepoint >> 8),
+// deduplicated 256-entry pages of value indices and the distinct values.
+export function packedValueTrie(packed: Uint32Array, name: string) {
+  const values: number[] = [];
+  const valueIndices = new Map<number, number>();
+  const pages: number[] = [];
+  const pageIndices = new Map<string, number>();
+  const pageIndex: number[] = [];
+
+  for(let page = 0; page < 0x1100; ++page) {
+    const indices: number[] = [];
+
+    for(let low = 0; low < 0x100; ++low) {
+      const value = packed[(page << 8) | low];
+      let index = valueIndices.get(value);
+
+      if(index === undefined) {
+        index = values.length;
+        valueIndices.set(value, index);
+        values.push(value);
+      }
+
+      indices.push(index);
+    }
+
+    const key = indices.join(',');
+    let compactPage = pageIndices.get(key);
+
+    if(compactPage === undefined) {
+      compactPage = pageIndices.size;
+      pageIndices.set(key, compactPage);
+      pages.push(...indices);
+    }
+
+    pageIndex.push(compactPage);
+  }
+
+  if(values.length > 0x100) {
+    throw new Error(`Too many ${name} values to pack: ${values.length}`);
+  }
+
+  if(pageIndices.size > 0x100) {
+    throw new Error(`Too many ${name} pages to pack: ${pageIndices.size}`);
+  }
+
+  return { pageIndex, pages, values };
+}
+
 // Appends a NUL-terminated string to a shared byte table and returns its offset.
 export function addStringData(data: number[], offsets: Map<string, number>, value: string) {
   const existing = offsets.get(value);